@@ -32,6 +32,10 @@
 #include "utils/commons.h"
 #include "cigar.h"
 
+#if TARGET_X86
+#include <immintrin.h>
+#endif
+
 /*
  * SAM CIGAR Operations
  */
@@ -73,6 +77,9 @@ cigar_t* cigar_new(
   // CIGAR
   cigar->cigar_length = 0;
   cigar->cigar_buffer = calloc(max_operations,sizeof(uint32_t));
+  // Run-length mode
+  cigar->run_length = false;
+  cigar->expanded = true;
   // Return
   return cigar;
 }
@@ -87,6 +94,7 @@ void cigar_clear(
   cigar->end_h = -1;
   // CIGAR
   cigar->cigar_length = 0;
+  cigar->expanded = true;
 }
 void cigar_resize(
     cigar_t* const cigar,
@@ -107,6 +115,83 @@ void cigar_free(
   free(cigar->cigar_buffer);
   free(cigar);
 }
+/*
+ * Run-length CIGAR
+ */
+void cigar_set_run_length(
+    cigar_t* const cigar,
+    const bool run_length) {
+  cigar->run_length = run_length;
+}
+char cigar_rle_get_operation(
+    const uint32_t cigar_op) {
+  const uint32_t op_code = cigar_op & 0xf;
+  return (op_code==SAM_CIGAR_EQ) ? 'M' : "MIDN----X???????"[op_code];
+}
+void cigar_rle_clear(
+    cigar_t* const cigar) {
+  cigar_clear(cigar);
+  cigar->expanded = false;
+}
+void cigar_rle_append(
+    cigar_t* const cigar,
+    const char operation,
+    const int length) {
+  // Check null operation
+  if (length <= 0) return;
+  // Encode operation (matches are always reported as '=')
+  const uint32_t op_code = (operation=='M') ? SAM_CIGAR_EQ : sam_cigar_lut[(int)operation];
+  // Merge with the last operation (if equal)
+  uint32_t* const cigar_buffer = cigar->cigar_buffer;
+  const int cigar_length = cigar->cigar_length;
+  if (cigar_length > 0 && (cigar_buffer[cigar_length-1] & 0xf) == op_code) {
+    cigar_buffer[cigar_length-1] += ((uint32_t)length << 4);
+  } else {
+    cigar_buffer[cigar->cigar_length++] = ((uint32_t)length << 4) | op_code;
+  }
+  cigar->end_offset += length;
+}
+void cigar_rle_close(
+    cigar_t* const cigar,
+    const bool reversed) {
+  // Parameters
+  uint32_t* const cigar_buffer = cigar->cigar_buffer;
+  const int cigar_length = cigar->cigar_length;
+  // Reverse (if generated backwards)
+  if (reversed) {
+    int i;
+    for (i=0;i<cigar_length/2;++i) {
+      const uint32_t op = cigar_buffer[i];
+      cigar_buffer[i] = cigar_buffer[cigar_length-1-i];
+      cigar_buffer[cigar_length-1-i] = op;
+    }
+  }
+  // Set CIGAR
+  cigar->has_misms = true;
+  cigar->expanded = false;
+}
+void cigar_expand(
+    cigar_t* const cigar) {
+  // Check expanded
+  if (cigar->expanded) return;
+  // Expand run-length operations
+  const uint32_t* const cigar_buffer = cigar->cigar_buffer;
+  const int cigar_length = cigar->cigar_length;
+  char* operations = cigar->operations;
+  int i;
+  for (i=0;i<cigar_length;++i) {
+    const char op = cigar_rle_get_operation(cigar_buffer[i]);
+    const int op_length = cigar_buffer[i] >> 4;
+    memset(operations,op,op_length);
+    operations += op_length;
+  }
+  *operations = '\0';
+  // Set expanded (and invalidate the SAM-CIGAR cache)
+  cigar->begin_offset = 0;
+  cigar->end_offset = operations - cigar->operations;
+  cigar->cigar_length = 0;
+  cigar->expanded = true;
+}
 /*
  * Accessors
  */
@@ -116,6 +201,7 @@ bool cigar_is_null(
 }
 int cigar_count_matches(
     const cigar_t* const cigar) {
+  cigar_expand((cigar_t*)cigar); // Lazy expansion
   int i, num_matches=0;
   for (i=cigar->begin_offset;i<cigar->end_offset;++i) {
     num_matches += (cigar->operations[i]=='M');
@@ -125,6 +211,8 @@ int cigar_count_matches(
 void cigar_append_forward(
     cigar_t* const cigar_dst,
     const cigar_t* const cigar_src) {
+  cigar_expand(cigar_dst); // Lazy expansion
+  cigar_expand((cigar_t*)cigar_src);
   // Parameters
   const int cigar_length = cigar_src->end_offset - cigar_src->begin_offset;
   char* const operations_src = cigar_src->operations + cigar_src->begin_offset;
@@ -137,6 +225,8 @@ void cigar_append_forward(
 void cigar_append_reverse(
     cigar_t* const cigar_dst,
     const cigar_t* const cigar_src) {
+  cigar_expand(cigar_dst); // Lazy expansion
+  cigar_expand((cigar_t*)cigar_src);
   // Parameters
   const int begin_offset = cigar_src->begin_offset;
   const int end_offset = cigar_src->end_offset;
@@ -151,29 +241,31 @@ void cigar_append_reverse(
   // Update offset
   cigar_dst->end_offset += cigar_length;
 }
-void cigar_append_deletion(
+void cigar_append_operation(
     cigar_t* const cigar,
+    const char operation,
     const int length) {
-  // Append deletions
-  char* const operations = cigar->operations + cigar->end_offset;
-  int i;
-  for (i=0;i<length;++i) {
-    operations[i] = 'D';
+  // Check null operation
+  if (length <= 0) return;
+  // Append run-length operation
+  if (!cigar->expanded) {
+    cigar_rle_append(cigar,operation,length);
+    return;
   }
+  // Append operations
+  memset(cigar->operations+cigar->end_offset,operation,length);
   // Update offset
   cigar->end_offset += length;
 }
+void cigar_append_deletion(
+    cigar_t* const cigar,
+    const int length) {
+  cigar_append_operation(cigar,'D',length);
+}
 void cigar_append_insertion(
     cigar_t* const cigar,
     const int length) {
-  // Append insertions
-  char* const operations = cigar->operations + cigar->end_offset;
-  int i;
-  for (i=0;i<length;++i) {
-    operations[i] = 'I';
-  }
-  // Update offset
-  cigar->end_offset += length;
+  cigar_append_operation(cigar,'I',length);
 }
 /*
  * SAM-compliant CIGAR
@@ -181,6 +273,11 @@ void cigar_append_insertion(
 void cigar_compute_CIGAR(
     cigar_t* const cigar,
     const bool show_mismatches) {
+  // Run-length operations are already SAM compliant (showing mismatches)
+  if (!cigar->expanded) {
+    if (show_mismatches) return;
+    cigar_expand(cigar);
+  }
   // Prepare CIGAR (SAM compliant)
   if (cigar->cigar_length==0 || cigar->has_misms!=show_mismatches) {
     const char* const operations = cigar->operations;
@@ -238,18 +335,71 @@ void cigar_get_CIGAR(
   *cigar_buffer = cigar->cigar_buffer;
   *cigar_length = cigar->cigar_length;
 }
+/*
+ * CIGAR runs (iterate operations run-by-run, regardless of the representation)
+ */
+typedef struct {
+  const cigar_t* cigar;    // CIGAR
+  int cursor;              // Next operation (expanded) or next run (run-length)
+} cigar_runs_t;
+void cigar_runs_init(
+    cigar_runs_t* const runs,
+    const cigar_t* const cigar) {
+  runs->cigar = cigar;
+  runs->cursor = (cigar->expanded) ? cigar->begin_offset : 0;
+}
+int cigar_runs_next(
+    cigar_runs_t* const runs,
+    char* const operation) {
+  const cigar_t* const cigar = runs->cigar;
+  // Run-length operations
+  if (!cigar->expanded) {
+    if (runs->cursor >= cigar->cigar_length) return 0;
+    const uint32_t cigar_op = cigar->cigar_buffer[(runs->cursor)++];
+    *operation = cigar_rle_get_operation(cigar_op);
+    return cigar_op >> 4;
+  }
+  // Operations (find the end of the run comparing 8 operations at a time)
+  const char* const operations = cigar->operations;
+  const int end_offset = cigar->end_offset;
+  const int begin = runs->cursor;
+  if (begin >= end_offset) return 0;
+  const char op = operations[begin];
+  const uint64_t op_block = 0x0101010101010101ul * (uint8_t)op;
+  int i = begin + 1;
+  while (i+8 <= end_offset) {
+    uint64_t ops_block;
+    memcpy(&ops_block,operations+i,8);
+    const uint64_t cmp = ops_block ^ op_block;
+    if (cmp != 0) {
+      i += __builtin_ctzl(cmp)/8;
+      break;
+    }
+    i += 8;
+  }
+  if (i+8 > end_offset) {
+    while (i < end_offset && operations[i]==op) ++i;
+  }
+  // Return run
+  runs->cursor = i;
+  *operation = op;
+  return i - begin;
+}
 /*
  * Score
  */
 int cigar_score_edit(
     const cigar_t* const cigar) {
-  int score = 0, i;
-  for (i=cigar->begin_offset;i<cigar->end_offset;++i) {
-    switch (cigar->operations[i]) {
+  cigar_runs_t runs;
+  cigar_runs_init(&runs,cigar);
+  int score = 0, length;
+  char operation;
+  while ((length = cigar_runs_next(&runs,&operation)) > 0) {
+    switch (operation) {
       case 'M': break;
       case 'X':
       case 'D':
-      case 'I': ++score; break;
+      case 'I': score += length; break;
       default:
         fprintf(stderr,"[CIGAR] Computing CIGAR score: Unknown operation\n");
         exit(1);
@@ -260,13 +410,16 @@ int cigar_score_edit(
 int cigar_score_gap_linear(
     const cigar_t* const cigar,
     const linear_penalties_t* const penalties) {
-  int score = 0, i;
-  for (i=cigar->begin_offset;i<cigar->end_offset;++i) {
-    switch (cigar->operations[i]) {
-      case 'M': score -= penalties->match; break;
-      case 'X': score -= penalties->mismatch; break;
-      case 'I': score -= penalties->indel; break;
-      case 'D': score -= penalties->indel; break;
+  cigar_runs_t runs;
+  cigar_runs_init(&runs,cigar);
+  int score = 0, length;
+  char operation;
+  while ((length = cigar_runs_next(&runs,&operation)) > 0) {
+    switch (operation) {
+      case 'M': score -= penalties->match*length; break;
+      case 'X': score -= penalties->mismatch*length; break;
+      case 'I': score -= penalties->indel*length; break;
+      case 'D': score -= penalties->indel*length; break;
       default:
         fprintf(stderr,"[CIGAR] Computing CIGAR score: Unknown operation\n");
         exit(1);
@@ -277,27 +430,26 @@ int cigar_score_gap_linear(
 int cigar_score_gap_affine(
     const cigar_t* const cigar,
     const affine_penalties_t* const penalties) {
-  char last_op = '\0';
-  int score = 0, i;
-  for (i=cigar->begin_offset;i<cigar->end_offset;++i) {
-    switch (cigar->operations[i]) {
+  cigar_runs_t runs;
+  cigar_runs_init(&runs,cigar);
+  int score = 0, length;
+  char operation;
+  while ((length = cigar_runs_next(&runs,&operation)) > 0) {
+    switch (operation) {
       case 'M':
-        score -= penalties->match;
+        score -= penalties->match*length;
         break;
       case 'X':
-        score -= penalties->mismatch;
+        score -= penalties->mismatch*length;
         break;
       case 'D':
-        score -= penalties->gap_extension + ((last_op=='D') ? 0 : penalties->gap_opening);
-        break;
       case 'I':
-        score -= penalties->gap_extension + ((last_op=='I') ? 0 : penalties->gap_opening);
+        score -= penalties->gap_opening + penalties->gap_extension*length;
         break;
       default:
         fprintf(stderr,"[CIGAR] Computing CIGAR score: Unknown operation\n");
         exit(1);
     }
-    last_op = cigar->operations[i];
   }
   return score;
 }
@@ -324,23 +476,85 @@ int cigar_score_gap_affine2p_score_op(
 int cigar_score_gap_affine2p(
     const cigar_t* const cigar,
     const affine2p_penalties_t* const penalties) {
-  char last_op = '\0';
-  int score = 0, op_length = 0;
-  int i;
-  for (i=cigar->begin_offset;i<cigar->end_offset;++i) {
-    // Account for operation
-    if (cigar->operations[i] != last_op && last_op != '\0') {
-      score -= cigar_score_gap_affine2p_score_op(last_op,op_length,penalties);
-      op_length = 0;
-    }
-    last_op = cigar->operations[i];
-    ++op_length;
+  cigar_runs_t runs;
+  cigar_runs_init(&runs,cigar);
+  int score = 0, length;
+  char operation;
+  while ((length = cigar_runs_next(&runs,&operation)) > 0) {
+    score -= cigar_score_gap_affine2p_score_op(operation,length,penalties);
   }
-  // Account for last operation
-  score -= cigar_score_gap_affine2p_score_op(last_op,op_length,penalties);
   return score;
 }
-
+/*
+ * Check matching runs (returns the length of the matching prefix)
+ */
+int cigar_check_matches_scalar(
+    const char* const pattern,
+    const char* const text,
+    const int length) {
+  // Compare 64-bits blocks
+  int i;
+  for (i=0;i+8<=length;i+=8) {
+    uint64_t pattern_block, text_block;
+    memcpy(&pattern_block,pattern+i,8);
+    memcpy(&text_block,text+i,8);
+    const uint64_t cmp = pattern_block ^ text_block;
+    if (cmp != 0) return i + __builtin_ctzl(cmp)/8;
+  }
+  // Compare remaining characters
+  for (;i<length;++i) {
+    if (pattern[i] != text[i]) return i;
+  }
+  return length;
+}
+#if TARGET_X86
+TARGET_AVX2 int cigar_check_matches_avx2(
+    const char* const pattern,
+    const char* const text,
+    const int length) {
+  // Compare 32-bytes blocks
+  int i;
+  for (i=0;i+32<=length;i+=32) {
+    const __m256i pattern_vector = _mm256_loadu_si256((const __m256i*)(pattern+i));
+    const __m256i text_vector = _mm256_loadu_si256((const __m256i*)(text+i));
+    const uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(pattern_vector,text_vector));
+    if (mask != 0xFFFFFFFFu) return i + __builtin_ctz(~mask);
+  }
+  // Compare remaining characters
+  return i + cigar_check_matches_scalar(pattern+i,text+i,length-i);
+}
+TARGET_AVX512 int cigar_check_matches_avx512(
+    const char* const pattern,
+    const char* const text,
+    const int length) {
+  // Compare 64-bytes blocks
+  int i;
+  for (i=0;i+64<=length;i+=64) {
+    const __m512i pattern_vector = _mm512_loadu_si512((const void*)(pattern+i));
+    const __m512i text_vector = _mm512_loadu_si512((const void*)(text+i));
+    const uint64_t mask = _mm512_cmpneq_epi8_mask(pattern_vector,text_vector);
+    if (mask != 0) return i + __builtin_ctzll(mask);
+  }
+  // Compare remaining characters
+  return i + cigar_check_matches_scalar(pattern+i,text+i,length-i);
+}
+#endif
+int cigar_check_matches(
+    const char* const pattern,
+    const char* const text,
+    const int length) {
+#if TARGET_X86
+  if (length >= 64 &&
+      __builtin_cpu_supports("avx512f") &&
+      __builtin_cpu_supports("avx512bw")) {
+    return cigar_check_matches_avx512(pattern,text,length);
+  }
+  if (length >= 32 && __builtin_cpu_supports("avx2")) {
+    return cigar_check_matches_avx2(pattern,text,length);
+  }
+#endif
+  return cigar_check_matches_scalar(pattern,text,length);
+}
 /*
  * Check
  */
@@ -352,46 +566,62 @@ bool cigar_check_alignment(
     const int text_length,
     const cigar_t* const cigar,
     const bool verbose) {
-  // Parameters
-  char* const operations = cigar->operations;
-  // Traverse CIGAR
-  int pattern_pos=0, text_pos=0, i;
-  for (i=cigar->begin_offset;i<cigar->end_offset;++i) {
-    switch (operations[i]) {
+  // Traverse CIGAR (run-by-run)
+  cigar_runs_t runs;
+  cigar_runs_init(&runs,cigar);
+  int pattern_pos=0, text_pos=0, length, i;
+  char operation;
+  while ((length = cigar_runs_next(&runs,&operation)) > 0) {
+    switch (operation) {
       case 'M':
-        // Check match
-        if (pattern[pattern_pos] != text[text_pos]) {
+      case 'X':
+        // Check bounds
+        if (pattern_pos+length > pattern_length || text_pos+length > text_length) {
           if (verbose) {
             fprintf(stream,
-                "[CIGAR] Alignment not matching (pattern[%d]=%c != text[%d]=%c)\n",
-                pattern_pos,pattern[pattern_pos],text_pos,text[text_pos]);
+                "[CIGAR] Alignment exceeds sequences (pattern-aligned=%d,pattern-length=%d,"
+                "text-aligned=%d,text-length=%d)\n",
+                pattern_pos+length,pattern_length,text_pos+length,text_length);
           }
           return false;
         }
-        ++pattern_pos;
-        ++text_pos;
-        break;
-      case 'X':
-        // Check mismatch
-        if (pattern[pattern_pos] == text[text_pos]) {
-          if (verbose) {
-            fprintf(stream,
-                "[CIGAR] Alignment not mismatching (pattern[%d]=%c == text[%d]=%c)\n",
-                pattern_pos,pattern[pattern_pos],text_pos,text[text_pos]);
+        if (operation == 'M') {
+          // Check matches
+          const int num_matches = cigar_check_matches(pattern+pattern_pos,text+text_pos,length);
+          if (num_matches < length) {
+            if (verbose) {
+              const int p = pattern_pos + num_matches, t = text_pos + num_matches;
+              fprintf(stream,
+                  "[CIGAR] Alignment not matching (pattern[%d]=%c != text[%d]=%c)\n",
+                  p,pattern[p],t,text[t]);
+            }
+            return false;
+          }
+        } else {
+          // Check mismatches
+          for (i=0;i<length;++i) {
+            const int p = pattern_pos + i, t = text_pos + i;
+            if (pattern[p] == text[t]) {
+              if (verbose) {
+                fprintf(stream,
+                    "[CIGAR] Alignment not mismatching (pattern[%d]=%c == text[%d]=%c)\n",
+                    p,pattern[p],t,text[t]);
+              }
+              return false;
+            }
           }
-          return false;
         }
-        ++pattern_pos;
-        ++text_pos;
+        pattern_pos += length;
+        text_pos += length;
         break;
       case 'I':
-        ++text_pos;
+        text_pos += length;
         break;
       case 'D':
-        ++pattern_pos;
+        pattern_pos += length;
         break;
       default:
-        fprintf(stream,"[CIGAR] Unknown edit operation '%c'\n",operations[i]);
+        fprintf(stream,"[CIGAR] Unknown edit operation '%c'\n",operation);
         exit(1);
         break;
     }
@@ -442,6 +672,18 @@ int cigar_sprint(
     buffer[0] = '\0';
     return 0;
   }
+  // Print run-length operations
+  if (!cigar->expanded) {
+    int i, cursor = 0;
+    for (i=0;i<cigar->cigar_length;++i) {
+      const char op = cigar_rle_get_operation(cigar->cigar_buffer[i]);
+      if (print_matches || op != 'M') {
+        cursor += sprintf(buffer+cursor,"%d%c",cigar->cigar_buffer[i]>>4,op);
+      }
+    }
+    buffer[cursor] = '\0';
+    return cursor;
+  }
   // Parameters
   const char* const operations = cigar->operations;
   const int begin_offset = cigar->begin_offset;
@@ -514,6 +756,8 @@ void cigar_print_pretty(
     const int pattern_length,
     const char* const text,
     const int text_length) {
+  // Lazy expansion
+  cigar_expand(cigar);
   // Parameters
   char* const operations = cigar->operations;
   const int begin_offset = cigar->begin_offset;
@@ -56,6 +56,9 @@ typedef struct {
   bool has_misms;          // Show 'X' and '=', instead of  just 'M'
   uint32_t* cigar_buffer;  // CIGAR-operations (max_operations length)
   int cigar_length;        // Total CIGAR-operations
+  // Run-length mode
+  bool run_length;         // Producers emit run-length operations (cigar_buffer) directly
+  bool expanded;           // Raw alignment operations are up to date (otherwise, cigar_buffer is)
 } cigar_t;
 
 /*
@@ -71,6 +74,26 @@ void cigar_resize(
 void cigar_free(
     cigar_t* const cigar);
 
+/*
+ * Run-length CIGAR
+ */
+void cigar_set_run_length(
+    cigar_t* const cigar,
+    const bool run_length);
+char cigar_rle_get_operation(
+    const uint32_t cigar_op);
+void cigar_rle_clear(
+    cigar_t* const cigar);
+void cigar_rle_append(
+    cigar_t* const cigar,
+    const char operation,
+    const int length);
+void cigar_rle_close(
+    cigar_t* const cigar,
+    const bool reversed);
+void cigar_expand(
+    cigar_t* const cigar);
+
 /*
  * Accessors
  */
@@ -87,6 +110,10 @@ void cigar_append_reverse(
     cigar_t* const cigar_dst,
     const cigar_t* const cigar_src);
 
+void cigar_append_operation(
+    cigar_t* const cigar,
+    const char operation,
+    const int length);
 void cigar_append_deletion(
     cigar_t* const cigar,
     const int length);
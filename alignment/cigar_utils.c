@@ -37,6 +37,9 @@
 int cigar_cmp(
     const cigar_t* const cigar_a,
     const cigar_t* const cigar_b) {
+  // Lazy expansion
+  cigar_expand((cigar_t*)cigar_a);
+  cigar_expand((cigar_t*)cigar_b);
   // Compare lengths
   const int length_cigar_a = cigar_a->end_offset - cigar_a->begin_offset;
   const int length_cigar_b = cigar_b->end_offset - cigar_b->begin_offset;
@@ -56,10 +59,13 @@ int cigar_cmp(
 void cigar_copy(
     cigar_t* const cigar_dst,
     const cigar_t* const cigar_src) {
+  cigar_expand((cigar_t*)cigar_src); // Lazy expansion
   cigar_dst->max_operations = cigar_src->max_operations;
   cigar_dst->begin_offset = cigar_src->begin_offset;
   cigar_dst->end_offset = cigar_src->end_offset;
   cigar_dst->score = cigar_src->score;
+  cigar_dst->cigar_length = 0;
+  cigar_dst->expanded = true;
   memcpy(cigar_dst->operations+cigar_src->begin_offset,
          cigar_src->operations+cigar_src->begin_offset,
          cigar_src->end_offset-cigar_src->begin_offset);
@@ -73,6 +79,8 @@ void cigar_discover_mismatches(
     const char* const text,
     const int text_length,
     cigar_t* const cigar) {
+  // Lazy expansion
+  cigar_expand(cigar);
   // Refine adding mismatches
   int i, p=0, t=0;
   for (i=cigar->begin_offset;i<cigar->end_offset;++i) {
@@ -112,6 +120,8 @@ void cigar_discover_mismatches(
 bool cigar_maxtrim_gap_linear(
     cigar_t* const cigar,
     const linear_penalties_t* const penalties) {
+  // Lazy expansion
+  cigar_expand(cigar);
   // Parameters
   const char* const operations = cigar->operations;
   const int begin_offset = cigar->begin_offset;
@@ -166,6 +176,8 @@ bool cigar_maxtrim_gap_linear(
 bool cigar_maxtrim_gap_affine(
     cigar_t* const cigar,
     const affine_penalties_t* const penalties) {
+  // Lazy expansion
+  cigar_expand(cigar);
   // Parameters
   const char* const operations = cigar->operations;
   const int begin_offset = cigar->begin_offset;
@@ -254,6 +266,8 @@ int cigar_maxtrim_gap_affine2p_score_op(
 bool cigar_maxtrim_gap_affine2p(
     cigar_t* const cigar,
     const affine2p_penalties_t* const penalties) {
+  // Lazy expansion
+  cigar_expand(cigar);
   // Parameters
   const char* const operations = cigar->operations;
   const int begin_offset = cigar->begin_offset;
@@ -321,6 +335,8 @@ bool cigar_maxlocal_gap_affine2p(
     const affine2p_penalties_t* const penalties,
     const int pattern_length,
     const int text_length) {
+  // Lazy expansion
+  cigar_expand(cigar);
   // Parameters
   const char* const operations = cigar->operations;
   const int begin_offset = cigar->begin_offset;
@@ -266,6 +266,19 @@ void WFAligner::setMaxAlignmentSteps(
     const int maxAlignmentSteps) {
   wavefront_aligner_set_max_alignment_steps(wfAligner,maxAlignmentSteps);
 }
+void WFAligner::setMaxAlignmentScore(
+    const int maxAlignmentScore) {
+  wavefront_aligner_set_max_score(wfAligner,maxAlignmentScore);
+}
+void WFAligner::setPrefilterNone() {
+  wavefront_aligner_set_prefilter(wfAligner,wf_prefilter_none);
+}
+void WFAligner::setPrefilterLength() {
+  wavefront_aligner_set_prefilter(wfAligner,wf_prefilter_length);
+}
+void WFAligner::setPrefilterBaseCount() {
+  wavefront_aligner_set_prefilter(wfAligner,wf_prefilter_basecount);
+}
 void WFAligner::setMaxMemory(
     const uint64_t maxMemoryResident,
     const uint64_t maxMemoryAbort) {
@@ -276,6 +289,11 @@ void WFAligner::setMaxNumThreads(
     const int maxNumThreads) {
   wavefront_aligner_set_max_num_threads(wfAligner, maxNumThreads);
 }
+// CIGAR output
+void WFAligner::setCigarRunLength(
+    const bool runLength) {
+  wavefront_aligner_set_cigar_run_length(wfAligner,runLength);
+}
 /*
  * Accessors
  */
@@ -288,11 +306,13 @@ int WFAligner::getAlignmentScore() {
 void WFAligner::getAlignment(
     char** const cigarOperations,
     int* cigarLength) {
+ cigar_expand(wfAligner->cigar); // Lazy expansion
  *cigarOperations = wfAligner->cigar->operations + wfAligner->cigar->begin_offset;
  *cigarLength = wfAligner->cigar->end_offset - wfAligner->cigar->begin_offset;
 }
 std::string WFAligner::getAlignment() {
   // Fetch Alignment
+  cigar_expand(wfAligner->cigar); // Lazy expansion
   char* const buffer = wfAligner->cigar->operations + wfAligner->cigar->begin_offset;
   const int length = wfAligner->cigar->end_offset - wfAligner->cigar->begin_offset;
   // Create string and return
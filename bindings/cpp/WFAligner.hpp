@@ -65,6 +65,10 @@ public:
     // FAILED Status (<0)
     StatusMaxStepsReached = WF_STATUS_MAX_STEPS_REACHED,
     StatusOOM = WF_STATUS_OOM,
+    StatusMaxScoreReached = WF_STATUS_MAX_SCORE_REACHED,
+    StatusFiltered = WF_STATUS_FILTERED,
+    StatusSequenceExhausted = WF_STATUS_SEQUENCE_EXHAUSTED,
+    StatusSequenceTooLong = WF_STATUS_SEQUENCE_TOO_LONG,
   };
   // Align End-to-end
   AlignmentStatus alignEnd2End( // Regular ASCII Sequences
@@ -165,12 +169,20 @@ public:
   // Limits
   void setMaxAlignmentSteps(
       const int maxAlignmentSteps);
+  void setMaxAlignmentScore(
+      const int maxAlignmentScore);
+  void setPrefilterNone();
+  void setPrefilterLength();
+  void setPrefilterBaseCount();
   void setMaxMemory(
       const uint64_t maxMemoryResident,
       const uint64_t maxMemoryAbort);
   // Parallelization
   void setMaxNumThreads(
       const int maxNumThreads);
+  // CIGAR output
+  void setCigarRunLength(
+      const bool runLength);
   // Accessors
   int getAlignmentStatus();
   int getAlignmentScore();
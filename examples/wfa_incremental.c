@@ -0,0 +1,85 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignment Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignment Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignment Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: WFA Sample-Code (extension over sequences streamed in chunks)
+ */
+
+#include "utils/commons.h"
+#include "wavefront/wavefront_align.h"
+
+#define CHUNK_LENGTH 16
+
+int main(int argc,char* argv[]) {
+  // Pattern & Text
+  char* pattern = "TCTTTACTCGCGCGTTGGAGAAATACAATAGTGGAGAAATACAATAGTTTTTTTTTTTTGCATGCATGCATGCATGCAT";
+  char* text    = "TCTATACTGCGCGTTTGGAGAAATAAAATAGTGGAGAAATAAAATAGTTTTTTTTTTTTACGTACGTACGTACGTACGT";
+  const int pattern_length = strlen(pattern);
+  const int text_length = strlen(text);
+  // Configure alignment attributes
+  wavefront_aligner_attr_t attributes = wavefront_aligner_attr_default;
+  attributes.distance_metric = gap_affine;
+  attributes.affine_penalties.match = -1;
+  attributes.affine_penalties.mismatch = 4;
+  attributes.affine_penalties.gap_opening = 6;
+  attributes.affine_penalties.gap_extension = 2;
+  attributes.alignment_form.span = alignment_endsfree;
+  attributes.alignment_form.extension = true;
+  attributes.heuristic.strategy = wf_heuristic_xdrop;
+  attributes.heuristic.xdrop = 50;
+  attributes.heuristic.steps_between_cutoffs = 1;
+  // Initialize Wavefront Aligner
+  wavefront_aligner_t* const wf_aligner = wavefront_aligner_new(&attributes);
+  // Align the first chunks
+  int pattern_offset = MIN(CHUNK_LENGTH,pattern_length);
+  int text_offset = MIN(CHUNK_LENGTH,text_length);
+  int status = wavefront_align_incremental(wf_aligner,pattern,pattern_offset,text,text_offset);
+  // Stream the remaining chunks (while the alignment pauses at the end of the sequences)
+  while (status == WF_STATUS_SEQUENCE_EXHAUSTED) {
+    const int pattern_chunk = MIN(CHUNK_LENGTH,pattern_length-pattern_offset);
+    const int text_chunk = MIN(CHUNK_LENGTH,text_length-text_offset);
+    if (pattern_chunk == 0 && text_chunk == 0) {
+      status = wavefront_align_incremental_complete(wf_aligner,true,true); // Nothing left
+      break;
+    }
+    fprintf(stderr,"... appending %d pattern and %d text bases\n",pattern_chunk,text_chunk);
+    status = wavefront_align_incremental_append(wf_aligner,
+        pattern+pattern_offset,pattern_chunk,text+text_offset,text_chunk);
+    pattern_offset += pattern_chunk;
+    text_offset += text_chunk;
+  }
+  fprintf(stderr,"WFA-Alignment (incremental) returns score %d\n",
+      cigar_score_gap_affine(wf_aligner->cigar,&attributes.affine_penalties));
+  cigar_print_pretty(stderr,wf_aligner->cigar,pattern,pattern_length,text,text_length);
+  // Align the whole sequences at once (same result)
+  wavefront_align(wf_aligner,pattern,pattern_length,text,text_length);
+  fprintf(stderr,"WFA-Alignment (whole sequences) returns score %d\n",
+      cigar_score_gap_affine(wf_aligner->cigar,&attributes.affine_penalties));
+  cigar_print_pretty(stderr,wf_aligner->cigar,pattern,pattern_length,text,text_length);
+  // Free
+  wavefront_aligner_delete(wf_aligner);
+}
@@ -0,0 +1,79 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignment Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignment Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignment Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: WFA Sample-Code (one pattern pinned against many texts)
+ */
+
+#include "utils/commons.h"
+#include "wavefront/wavefront_align.h"
+
+int main(int argc,char* argv[]) {
+  // Pattern & Texts
+  char* pattern = "TCTTTACTCGCGCGTTGGAGAAATACAATAGT";
+  char* texts[] = {
+      "TCTATACTGCGCGTTTGGAGAAATAAAATAGT",
+      "TCTTTACTCGCGCGTTGGAGAAATACAATAGT",
+      "TCTTTACTCGCGTTGGAGAAATACAATAGTTT",
+  };
+  const int num_texts = sizeof(texts)/sizeof(char*);
+  // Reference (texts are slices of it; read-only)
+  const char* const reference = "GGGGTCTATACTGCGCGTTTGGAGAAATAAAATAGTGGGGTCTTTACTCGCGTTGGAGAAATACAATAGTTTGGGG";
+  const int reference_length = strlen(reference);
+  // Configure alignment attributes
+  wavefront_aligner_attr_t attributes = wavefront_aligner_attr_default;
+  attributes.distance_metric = gap_affine;
+  attributes.affine_penalties.match = 0;
+  attributes.affine_penalties.mismatch = 4;
+  attributes.affine_penalties.gap_opening = 6;
+  attributes.affine_penalties.gap_extension = 2;
+  // Initialize Wavefront Aligner
+  wavefront_aligner_t* const wf_aligner = wavefront_aligner_new(&attributes);
+  // Pin the pattern (prepared once for all the alignments below)
+  wavefront_align_pin_pattern(wf_aligner,pattern,strlen(pattern));
+  // Align texts
+  int i;
+  for (i=0;i<num_texts;++i) {
+    wavefront_align_pinned(wf_aligner,texts[i],strlen(texts[i]));
+    fprintf(stderr,"WFA-Alignment (text %d) returns score %d\n",i,wf_aligner->cigar->score);
+    cigar_print_pretty(stderr,wf_aligner->cigar,
+        pattern,strlen(pattern),texts[i],strlen(texts[i]));
+  }
+  // Align slices of the reference (in place when enough reference follows the slice)
+  const int slices[][2] = { {4,36}, {40,72} };
+  for (i=0;i<2;++i) {
+    const int text_begin = slices[i][0], text_end = slices[i][1];
+    wavefront_align_pinned_slice(wf_aligner,reference,reference_length,text_begin,text_end);
+    fprintf(stderr,"WFA-Alignment (reference[%d,%d)) returns score %d\n",
+        text_begin,text_end,wf_aligner->cigar->score);
+    cigar_print_pretty(stderr,wf_aligner->cigar,
+        pattern,strlen(pattern),reference+text_begin,text_end-text_begin);
+  }
+  // Free
+  wavefront_align_unpin_pattern(wf_aligner);
+  wavefront_aligner_delete(wf_aligner);
+}
@@ -0,0 +1,79 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignment Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignment Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignment Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: WFA Sample-Code (aligner-pool shared among threads)
+ */
+
+#include "utils/commons.h"
+#include "wavefront/wavefront_align.h"
+#include "wavefront/wavefront_aligner_pool.h"
+
+#define NUM_ALIGNMENTS 100000
+
+int main(int argc,char* argv[]) {
+  // Pattern & Text
+  char* pattern = "TCTTTACTCGCGCGTTTCTTACTCGCGCGTTGGAGAAATACAATAGTGGAGAAATACAATAGTTTTTTTTTTTT";
+  char* text    = "TTTTTTCTATACTGCGCGTTTTCTATACTCGCGCGTTGGAGAAATACAATAGTGGAGAAATAAAATAGT";
+  const int pattern_length = strlen(pattern);
+  const int text_length = strlen(text);
+  // Configure alignment attributes
+  wavefront_aligner_attr_t attributes = wavefront_aligner_attr_default;
+  attributes.distance_metric = gap_affine;
+  attributes.affine_penalties.match = 0;
+  attributes.affine_penalties.mismatch = 4;
+  attributes.affine_penalties.gap_opening = 6;
+  attributes.affine_penalties.gap_extension = 2;
+  // Initialize the pool (one aligner per thread, grown on demand)
+  wavefront_aligner_pool_t* const wf_aligner_pool = wavefront_aligner_pool_new(&attributes,4);
+  // Reference score (end-to-end)
+  wavefront_aligner_t* wf_aligner = wavefront_aligner_pool_acquire(wf_aligner_pool);
+  wavefront_align(wf_aligner,pattern,pattern_length,text,text_length);
+  const int score_end2end = wf_aligner->cigar->score;
+  wavefront_aligner_pool_release(wf_aligner_pool,wf_aligner);
+  // Align from several threads (odd alignments are reconfigured as ends-free)
+  int i, num_errors = 0;
+  #pragma omp parallel for reduction(+:num_errors)
+  for (i=0;i<NUM_ALIGNMENTS;++i) {
+    wavefront_aligner_t* const wf_aligner = wavefront_aligner_pool_acquire(wf_aligner_pool);
+    // Any aligner comes back with the pool's configuration
+    if (wf_aligner->alignment_form.span != alignment_end2end) ++num_errors;
+    if (i%2) {
+      wavefront_aligner_set_alignment_free_ends(wf_aligner,0,0,text_length,text_length);
+      wavefront_aligner_set_heuristic_xdrop(wf_aligner,20,1);
+      wavefront_align(wf_aligner,pattern,pattern_length,text,text_length);
+    } else {
+      wavefront_align(wf_aligner,pattern,pattern_length,text,text_length);
+      if (wf_aligner->cigar->score != score_end2end) ++num_errors;
+    }
+    wavefront_aligner_pool_release(wf_aligner_pool,wf_aligner);
+  }
+  fprintf(stderr,"... done %d alignments (%d errors)\n",NUM_ALIGNMENTS,num_errors);
+  // Free
+  wavefront_aligner_pool_delete(wf_aligner_pool);
+  return (num_errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,24 @@
+#!/bin/bash
+# PROJECT: Wavefront Alignments Algorithms 
+# LICENCE: MIT License 
+# AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+# DESCRIPTION: Compare alignment files (*.alg) computed with a max-score bound
+#              (alignments within the bound must match the reference; the rest must be dropped)
+# USAGE: ./wfa.alg.cmp.maxscore.sh reference.alg file.alg max_score
+
+# Parameters
+FILE1=$1
+FILE2=$2
+MAX_SCORE=$3
+
+# Compare
+paste $FILE1 $FILE2 | awk -F'\t' -v max_score=$MAX_SCORE '
+  {
+    score = ($1<0) ? -$1 : $1
+    if (score <= max_score) {
+      if ($1 != $3 || $2 != $4) { print "Line " NR ": " $0; error = 1 }
+    } else {
+      if ($4 != "-") { print "Line " NR ": " $0; error = 1 }
+    }
+  }
+  END { exit error }'
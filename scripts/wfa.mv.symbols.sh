@@ -0,0 +1,26 @@
+#!/bin/bash
+# PROJECT: Wavefront Alignments Algorithms 
+# LICENCE: MIT License 
+# AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+# DESCRIPTION: Check that multiversioned objects only export suffixed symbols
+#              (any external symbol without the _vN suffix would clash across ISA levels)
+# USAGE: ./wfa.mv.symbols.sh level file1.o [file2.o ...]
+
+# Parameters
+LEVEL=$1
+shift
+
+# Check
+STATUS=0
+for OBJ in "$@"
+do
+  SYMBOLS=$(nm -g -P --defined-only $OBJ) || { echo "[WFA::Multiversion] Cannot read $OBJ"; STATUS=1; continue; }
+  UNSUFFIXED=$(echo "$SYMBOLS" | awk -v suffix="_v$LEVEL" '
+    NF { if (substr($1,length($1)-length(suffix)+1) != suffix) print $1 }')
+  if [[ "$UNSUFFIXED" != "" ]]
+  then
+    echo "[WFA::Multiversion] $OBJ exports symbols without the _v$LEVEL suffix:" $UNSUFFIXED
+    STATUS=1
+  fi
+done
+exit $STATUS
@@ -35,6 +35,11 @@
 #include "utils/commons.h"
 #include "mm_allocator.h"
 
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
 /*
  * Debug
  */
@@ -49,6 +54,20 @@
 #define MM_ALLOCATOR_INITIAL_MALLOC_REQUESTS       10
 #define MM_ALLOCATOR_INITIAL_STATES                10
 
+/*
+ * Memory Policy Constants
+ */
+#define MM_ALLOCATOR_MMAP_MIN_BYTES      BUFFER_SIZE_128K // Smaller blocks are always malloc-ed
+#define MM_ALLOCATOR_PAGE_SIZE           BUFFER_SIZE_4K
+#define MM_ALLOCATOR_HUGEPAGE_2MB        (1ul<<21)
+#define MM_ALLOCATOR_HUGEPAGE_1GB        (1ul<<30)
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#define MM_ALLOCATOR_MAP_HUGE_2MB        (21 << MAP_HUGE_SHIFT)
+#define MM_ALLOCATOR_MAP_HUGE_1GB        (30 << MAP_HUGE_SHIFT)
+#define MM_ALLOCATOR_MPOL_BIND           2
+
 /*
  * Allocator Segments Freed Cond
  */
@@ -105,6 +124,105 @@ typedef struct {
   vector_t* requests;           // Memory requests (mm_allocator_request_t)
 } mm_allocator_segment_t;
 
+/*
+ * Memory (backed according to the memory policy)
+ */
+bool mm_allocator_memory_is_mapped(
+    mm_allocator_t* const mm_allocator,
+    const uint64_t num_bytes) {
+#ifdef __linux__
+  const mm_allocator_policy_t* const policy = &mm_allocator->policy;
+  if (policy->pages == mm_pages_default && policy->numa == mm_numa_default) return false;
+  return num_bytes >= MM_ALLOCATOR_MMAP_MIN_BYTES;
+#else
+  return false; // Policies not supported (plain malloc)
+#endif
+}
+uint64_t mm_allocator_memory_hugepage_size(
+    mm_allocator_t* const mm_allocator) {
+  switch (mm_allocator->policy.pages) {
+    case mm_pages_huge_2MB: return MM_ALLOCATOR_HUGEPAGE_2MB;
+    case mm_pages_huge_1GB: return MM_ALLOCATOR_HUGEPAGE_1GB;
+    default: return 0;
+  }
+}
+uint64_t mm_allocator_memory_mapped_size(
+    mm_allocator_t* const mm_allocator,
+    const uint64_t num_bytes) {
+  // Only requests spanning whole hugepages are backed by hugetlb pages
+  const uint64_t hugepage_size = mm_allocator_memory_hugepage_size(mm_allocator);
+  const uint64_t page_size = (hugepage_size > 0 && num_bytes >= hugepage_size) ?
+      hugepage_size : MM_ALLOCATOR_PAGE_SIZE;
+  return DIV_CEIL(num_bytes,page_size) * page_size;
+}
+#ifdef __linux__
+void* mm_allocator_memory_map(
+    mm_allocator_t* const mm_allocator,
+    const uint64_t num_bytes) {
+  const mm_allocator_policy_t* const policy = &mm_allocator->policy;
+  const uint64_t hugepage_size = mm_allocator_memory_hugepage_size(mm_allocator);
+  const uint64_t mapped_size = mm_allocator_memory_mapped_size(mm_allocator,num_bytes);
+  void* memory = MAP_FAILED;
+  // Hugetlb pages (requires reserved hugepages; otherwise fallback)
+  if (hugepage_size > 0 && num_bytes >= hugepage_size) {
+    const int huge_flags = MAP_HUGETLB |
+        ((policy->pages == mm_pages_huge_1GB) ? MM_ALLOCATOR_MAP_HUGE_1GB : MM_ALLOCATOR_MAP_HUGE_2MB);
+    memory = mmap(NULL,mapped_size,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS|huge_flags,-1,0);
+  }
+  // Regular pages (transparent hugepages if requested)
+  if (memory == MAP_FAILED) {
+    memory = mmap(NULL,mapped_size,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+    if (memory == MAP_FAILED) {
+      fprintf(stderr,"MMAllocator error. Could not map %"PRIu64" bytes\n",mapped_size);
+      exit(1);
+    }
+#ifdef MADV_HUGEPAGE
+    if (hugepage_size > 0) madvise(memory,mapped_size,MADV_HUGEPAGE);
+#endif
+  }
+  // NUMA placement
+  if (policy->numa == mm_numa_bind) {
+    const uint64_t max_nodes = 8*sizeof(unsigned long);
+    if (policy->numa_node < 0 || (uint64_t)policy->numa_node >= max_nodes) {
+      fprintf(stderr,"MMAllocator error. Invalid NUMA node (%d)\n",policy->numa_node);
+      exit(1);
+    }
+    const unsigned long node_mask = 1ul << policy->numa_node;
+    if (syscall(SYS_mbind,memory,mapped_size,MM_ALLOCATOR_MPOL_BIND,&node_mask,max_nodes,0) != 0) {
+      fprintf(stderr,"MMAllocator error. Could not bind memory to NUMA node %d\n",policy->numa_node);
+      exit(1);
+    }
+  } else if (policy->numa == mm_numa_local) {
+    // First-touch (fault all pages in from the owning thread)
+    uint8_t* const bytes = (uint8_t*)memory;
+    uint64_t offset;
+    for (offset=0;offset<mapped_size;offset+=MM_ALLOCATOR_PAGE_SIZE) bytes[offset] = 0;
+  }
+  return memory;
+}
+#endif
+void* mm_allocator_memory_allocate(
+    mm_allocator_t* const mm_allocator,
+    const uint64_t num_bytes) {
+#ifdef __linux__
+  if (mm_allocator_memory_is_mapped(mm_allocator,num_bytes)) {
+    return mm_allocator_memory_map(mm_allocator,num_bytes);
+  }
+#endif
+  return malloc(num_bytes);
+}
+void mm_allocator_memory_free(
+    mm_allocator_t* const mm_allocator,
+    void* const memory,
+    const uint64_t num_bytes) {
+#ifdef __linux__
+  if (mm_allocator_memory_is_mapped(mm_allocator,num_bytes)) {
+    munmap(memory,mm_allocator_memory_mapped_size(mm_allocator,num_bytes));
+    return;
+  }
+#endif
+  free(memory);
+}
 /*
  * Segments
  */
@@ -117,7 +235,7 @@ mm_allocator_segment_t* mm_allocator_segment_new(
   segment->idx = segment_idx;
   // Memory
   segment->size = mm_allocator->segment_size;
-  segment->memory = malloc(mm_allocator->segment_size);
+  segment->memory = mm_allocator_memory_allocate(mm_allocator,mm_allocator->segment_size);
   segment->used = 0;
   // Requests
   segment->requests = vector_new(MM_ALLOCATOR_SEGMENT_INITIAL_REQUESTS,mm_allocator_request_t);
@@ -132,9 +250,10 @@ void mm_allocator_segment_clear(
   vector_clear(segment->requests);
 }
 void mm_allocator_segment_delete(
+    mm_allocator_t* const mm_allocator,
     mm_allocator_segment_t* const segment) {
   vector_delete(segment->requests);
-  free(segment->memory);
+  mm_allocator_memory_free(mm_allocator,segment->memory,segment->size);
   free(segment);
 }
 mm_allocator_request_t* mm_allocator_segment_get_request(
@@ -151,9 +270,22 @@ uint64_t mm_allocator_segment_get_num_requests(
  */
 mm_allocator_t* mm_allocator_new(
     const uint64_t segment_size) {
+  return mm_allocator_new_policy(segment_size,NULL);
+}
+mm_allocator_t* mm_allocator_new_policy(
+    const uint64_t segment_size,
+    const mm_allocator_policy_t* const policy) {
   // Allocate handler
   mm_allocator_t* const mm_allocator = (mm_allocator_t*) malloc(sizeof(mm_allocator_t));
   mm_allocator->request_ticker = 0;
+  // Memory policy (set before any segment is allocated)
+  if (policy != NULL) {
+    mm_allocator->policy = *policy;
+  } else {
+    mm_allocator->policy.pages = mm_pages_default;
+    mm_allocator->policy.numa = mm_numa_default;
+    mm_allocator->policy.numa_node = -1;
+  }
   // Segments
   mm_allocator->segment_size = segment_size;
   mm_allocator->segments = vector_new(MM_ALLOCATOR_INITIAL_SEGMENTS,mm_allocator_segment_t*);
@@ -182,7 +314,9 @@ void mm_allocator_clear(
   mm_allocator->current_segment_idx = 0;
   // Clear malloc memory
   VECTOR_ITERATE(mm_allocator->malloc_requests,malloc_request,m,mm_malloc_request_t) {
-    if (malloc_request->size > 0) free(malloc_request->mem); // Free malloc requests
+    if (malloc_request->size > 0) { // Free malloc requests
+      mm_allocator_memory_free(mm_allocator,malloc_request->mem,malloc_request->size);
+    }
   }
   vector_clear(mm_allocator->malloc_requests);
   mm_allocator->malloc_requests_freed = 0;
@@ -191,13 +325,15 @@ void mm_allocator_delete(
     mm_allocator_t* const mm_allocator) {
   // Free segments
   VECTOR_ITERATE(mm_allocator->segments,segment_ptr,p,mm_allocator_segment_t*) {
-    mm_allocator_segment_delete(*segment_ptr);
+    mm_allocator_segment_delete(mm_allocator,*segment_ptr);
   }
   vector_delete(mm_allocator->segments);
   vector_delete(mm_allocator->segments_free);
   // Free malloc memory
   VECTOR_ITERATE(mm_allocator->malloc_requests,malloc_request,m,mm_malloc_request_t) {
-    if (malloc_request->size > 0) free(malloc_request->mem); // Free malloc requests
+    if (malloc_request->size > 0) { // Free malloc requests
+      mm_allocator_memory_free(mm_allocator,malloc_request->mem,malloc_request->size);
+    }
   }
   vector_delete(mm_allocator->malloc_requests);
   // Free handler
@@ -316,7 +452,7 @@ void* mm_allocator_allocate(
     return memory_aligned;
   } else {
     // Malloc memory
-    void* const memory_base = malloc(num_bytes_allocated);
+    void* const memory_base = mm_allocator_memory_allocate(mm_allocator,num_bytes_allocated);
     if (zero_mem) memset(memory_base,0,num_bytes_allocated); // Set zero
     // Compute aligned memory
     void* memory_aligned = memory_base + sizeof(mm_allocator_reference_t) + align_bytes;
@@ -358,8 +494,8 @@ void mm_allocator_free_malloc_request(
     exit(1);
   }
   // Free request
+  mm_allocator_memory_free(mm_allocator,request->mem,request->size);
   request->size = 0;
-  free(request->mem);
   ++(mm_allocator->malloc_requests_freed);
   // Check number of freed requests
   if (mm_allocator->malloc_requests_freed >= 1000) {
@@ -44,6 +44,25 @@
 //#define MM_ALLOCATOR_LOG
 #define MM_ALLOCATOR_ALIGNMENT 8 // 64bits
 
+/*
+ * Memory Policy (backing of segments and large requests)
+ */
+typedef enum {
+  mm_pages_default  = 0, // Regular pages (plain malloc)
+  mm_pages_huge_2MB = 1, // 2MB hugepages (MAP_HUGETLB, fallback to transparent hugepages)
+  mm_pages_huge_1GB = 2, // 1GB hugepages (MAP_HUGETLB, fallback to transparent hugepages)
+} mm_allocator_pages_t;
+typedef enum {
+  mm_numa_default = 0,   // OS default placement
+  mm_numa_local   = 1,   // Fresh pages first-touched by the allocating (owning) thread
+  mm_numa_bind    = 2,   // Pages bound to an explicit NUMA node (mbind)
+} mm_allocator_numa_t;
+typedef struct {
+  mm_allocator_pages_t pages;     // Page size backing the memory
+  mm_allocator_numa_t numa;       // NUMA placement
+  int numa_node;                  // NUMA node (mm_numa_bind)
+} mm_allocator_policy_t;
+
 /*
  * MM-Allocator
  */
@@ -58,6 +77,8 @@ typedef struct {
   // Malloc memory
   vector_t* malloc_requests;      // Malloc requests (mm_malloc_request_t)
   uint64_t malloc_requests_freed; // Total malloc request freed and still in vector
+  // Memory policy
+  mm_allocator_policy_t policy;   // Hugepages/NUMA backing
 } mm_allocator_t;
 
 /*
@@ -65,6 +86,9 @@ typedef struct {
  */
 mm_allocator_t* mm_allocator_new(
     const uint64_t segment_size);
+mm_allocator_t* mm_allocator_new_policy(
+    const uint64_t segment_size,
+    const mm_allocator_policy_t* const policy);
 void mm_allocator_clear(
     mm_allocator_t* const mm_allocator);
 void mm_allocator_delete(
@@ -10,4 +10,5 @@ OUTPUT="./tests"
 
 # Clear
 rm -f $OUTPUT/*.alg $OUTPUT/*.log* &> /dev/null
+rm -rf $OUTPUT/wfa.utest.features $OUTPUT/wfa.utest.bounded $OUTPUT/wfa.utest.scored &> /dev/null
 
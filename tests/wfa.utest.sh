@@ -8,10 +8,12 @@
 # Config
 PREFIX=$(dirname $0)
 INPUT="$PREFIX/wfa.utest.seq"
+INPUT_LONG="$PREFIX/wfa.utest.long.seq"
 OUTPUT="$PREFIX"
 LOG="$PREFIX/wfa.utest.log"
 
 CMP_SCORE=$(readlink -f "$PREFIX/../scripts/wfa.alg.cmp.score.sh")
+CMP_MAXSCORE=$(readlink -f "$PREFIX/../scripts/wfa.alg.cmp.maxscore.sh")
 
 BIN=$1/align_benchmark
 if [ ! -f "$BIN" ]
@@ -28,8 +30,15 @@ then
     fi
 fi
 
+BIN_OFFSET16=$(dirname $BIN)/align_benchmark_offset16 # 16-bit offsets build (cmake)
+
+FEATURES="$OUTPUT/wfa.utest.features"
+BOUNDED="$OUTPUT/wfa.utest.bounded"
+SCORED="$OUTPUT/wfa.utest.scored"
+
 # Clear
 rm -f $OUTPUT/*.alg $OUTPUT/*.log* &> /dev/null
+rm -rf $FEATURES $BOUNDED $SCORED &> /dev/null
 
 # Run tests
 for opt in "--check=correct","test" \
@@ -63,6 +72,99 @@ do
     \time -v $BIN -i $INPUT -o $OUTPUT/$NAME.affine.wfapt1.alg -a gap-affine-wfa $MODE --wfa-heuristic=wfa-adaptive --wfa-heuristic-parameters=10,50,10 >> $LOG 2>&1
 done
 
+# Feature tests (each run must reproduce the reference alignments in wfa.utest.check)
+function utest_feature() {
+    # Params: FEATURE REFERENCE ALGORITHM OPTIONS [INPUT]
+    mkdir -p $FEATURES/$1
+    \time -v $BIN -i ${5:-$INPUT} -o $FEATURES/$1/$2.alg -a $3 $4 >> $LOG 2>&1
+}
+function utest_offset16() {
+    # Params: FEATURE REFERENCE ALGORITHM OPTIONS (pairs exceeding 16-bit offsets are rejected)
+    mkdir -p $FEATURES/$1
+    \time -v $BIN_OFFSET16 -i $INPUT -o $FEATURES/$1/$2.alg -a $3 $4 >> $LOG 2>&1
+}
+STATUS_BOUNDED=0
+function utest_bounded() {
+    # Params: FEATURE REFERENCE ALGORITHM MAX_SCORE OPTIONS
+    mkdir -p $BOUNDED/$1
+    \time -v $BIN -i $INPUT -o $BOUNDED/$1/$2.alg -a $3 --wfa-max-score $4 $5 >> $LOG 2>&1
+    echo "[UTest::$1::$2] max-score=$4" >> $LOG.bounded
+    $CMP_MAXSCORE $OUTPUT/wfa.utest.check/$2.alg $BOUNDED/$1/$2.alg $4 >> $LOG.bounded 2>&1 || STATUS_BOUNDED=1
+}
+STATUS_SCORED=0
+function utest_scored() {
+    # Params: FEATURE REFERENCE ALGORITHM OPTIONS (scores must match; ties may yield other CIGARs)
+    mkdir -p $SCORED/$1
+    \time -v $BIN -i $INPUT -o $SCORED/$1/$2.alg -a $3 --check=correct $4 >> $LOG 2>&1
+    echo "[UTest::$1::$2]" >> $LOG.scored
+    $CMP_SCORE $OUTPUT/wfa.utest.check/$2.alg $SCORED/$1/$2.alg >> $LOG.scored 2>&1 || STATUS_SCORED=1
+}
+STATUS_STATS=0
+function utest_stats() {
+    # Params: FEATURE REFERENCE ALGORITHM OPTIONS (as utest_feature; the stats report must be printed)
+    utest_feature "$1" $2 $3 "--wfa-stats $4"
+    tail -n 50 $LOG | grep -q "\[WFA::Stats\] Steps" || STATUS_STATS=1
+}
+echo ">>> Testing features"
+for ALG in indel edit gap-affine gap-affine2p
+do
+    NAME=${ALG#gap-}
+    utest_feature "batch" test.score.$NAME $ALG-wfa "--wfa-score-only --wfa-batch"
+    utest_feature "extend-fused" test.$NAME $ALG-wfa "--wfa-extend-fused"
+    utest_feature "extend-fused.pb" test.pb.$NAME $ALG-wfa "--wfa-extend-fused --wfa-memory=med"
+    utest_feature "cigar-rle" test.$NAME $ALG-wfa "--wfa-cigar-rle"
+    utest_feature "cigar-rle.pb" test.pb.$NAME $ALG-wfa "--wfa-cigar-rle --wfa-memory=med"
+    utest_feature "cigar-rle.biwfa" test.biwfa.$NAME $ALG-wfa "--wfa-cigar-rle --wfa-memory=ultralow"
+    utest_feature "pinned" test.$NAME $ALG-wfa "--wfa-pinned"
+    utest_feature "pinned.biwfa" test.biwfa.$NAME $ALG-wfa "--wfa-pinned --wfa-memory=ultralow"
+    utest_feature "pinned.slice" test.$NAME $ALG-wfa "--wfa-pinned --input-mmap"
+    utest_feature "pinned.slice.pb" test.pb.$NAME $ALG-wfa "--wfa-pinned --input-mmap --wfa-memory=med"
+    utest_feature "packed2bits" test.$NAME $ALG-wfa "--wfa-packed2bits"
+    utest_feature "packed2bits.scalar" test.$NAME $ALG-wfa "--wfa-packed2bits --wfa-kernels=scalar"
+    utest_feature "packed2bits.pb" test.pb.$NAME $ALG-wfa "--wfa-packed2bits --wfa-memory=med"
+    utest_feature "packed2bits.biwfa" test.biwfa.$NAME $ALG-wfa "--wfa-packed2bits --wfa-memory=ultralow"
+    utest_feature "hugepages" test.$NAME $ALG-wfa "--wfa-hugepages 2MB"
+    utest_feature "hugepages.pb" test.pb.$NAME $ALG-wfa "--wfa-hugepages 2MB --wfa-memory=med"
+    utest_feature "hugepages.biwfa" test.biwfa.$NAME $ALG-wfa "--wfa-hugepages 2MB --wfa-memory=ultralow"
+    utest_feature "numa" test.$NAME $ALG-wfa "--wfa-numa local"
+    utest_stats "stats" test.$NAME $ALG-wfa ""
+    utest_stats "stats.pb" test.pb.$NAME $ALG-wfa "--wfa-memory=med"
+    utest_stats "stats.biwfa" test.biwfa.$NAME $ALG-wfa "--wfa-memory=ultralow"
+    utest_scored "threads.biwfa" test.biwfa.$NAME $ALG-wfa "--wfa-memory=ultralow --wfa-max-threads 4"
+    utest_scored "threads.packed2bits.biwfa" test.biwfa.$NAME $ALG-wfa "--wfa-packed2bits --wfa-memory=ultralow --wfa-max-threads 4"
+    utest_bounded "max-score.20" test.$NAME $ALG-wfa 20
+    utest_bounded "max-score.100" test.pb.$NAME $ALG-wfa 100 "--wfa-memory=med"
+    utest_bounded "max-score.20.biwfa" test.biwfa.$NAME $ALG-wfa 20 "--wfa-memory=ultralow"
+    utest_bounded "max-score.100.biwfa" test.biwfa.$NAME $ALG-wfa 100 "--wfa-memory=ultralow"
+    utest_bounded "prefilter.length" test.$NAME $ALG-wfa 20 "--wfa-prefilter=length"
+    utest_bounded "prefilter.basecount" test.$NAME $ALG-wfa 20 "--wfa-prefilter=basecount"
+done
+utest_feature "packed2bits" test.affine.p3 gap-affine-wfa "--wfa-packed2bits --affine-penalties=-5,1,2,1"
+utest_feature "packed2bits.biwfa" test.biwfa.affine.p3 gap-affine-wfa "--wfa-packed2bits --affine-penalties=-5,1,2,1 --wfa-memory=ultralow"
+utest_feature "hugepages.1GB" test.affine gap-affine-wfa "--wfa-hugepages 1GB"
+utest_feature "numa.node" test.affine gap-affine-wfa "--wfa-numa 0 --wfa-hugepages 2MB"
+for ALG in indel edit
+do
+    utest_feature "bpm.always" test.score.$ALG $ALG-wfa "--wfa-score-only --wfa-bpm=always"
+    utest_feature "bpm.auto" test.score.$ALG $ALG-wfa "--wfa-score-only --wfa-bpm=auto"
+done
+if [ -f "$BIN_OFFSET16" ]
+then
+    for ALG in indel edit gap-affine gap-affine2p
+    do
+        NAME=${ALG#gap-}
+        utest_offset16 "offset16" test.offset16.$NAME $ALG-wfa ""
+        utest_offset16 "offset16.pb" test.offset16.$NAME $ALG-wfa "--wfa-memory=med"
+    done
+    utest_offset16 "offset16.biwfa" test.offset16.biwfa.affine gap-affine-wfa "--wfa-memory=ultralow"
+else
+    echo ">>> Skipping 16-bit offsets tests (align_benchmark_offset16 not built)"
+fi
+utest_feature "bt-spill" test.long.pb.affine gap-affine-wfa \
+    "--wfa-memory=med --wfa-max-memory-compact=1000000 --wfa-bt-spill=$FEATURES/bt-spill" $INPUT_LONG
+utest_feature "bt-compress" test.long.pb.affine gap-affine-wfa \
+    "--wfa-memory=med --wfa-max-memory-compact=1000000 --wfa-bt-compress" $INPUT_LONG
+
 # Intra-tests
 diff $PREFIX/wfa.utest.check/test.edit.alg      $PREFIX/wfa.utest.check/test.pb.edit.alg >> $LOG.correct 2>&1
 diff $PREFIX/wfa.utest.check/test.indel.alg     $PREFIX/wfa.utest.check/test.pb.indel.alg >> $LOG.correct 2>&1
@@ -103,6 +205,25 @@ paste <(tail -n 4 $OUTPUT/wfa.utest.check/wfa.utest.log.mem) <(tail -n 4 $OUTPUT
 # Display correct
 ./tests/wfa.utest.cmp.sh $OUTPUT $OUTPUT/wfa.utest.check
 STATUS=$?
+for FEATURE in $FEATURES/*
+do
+  ./tests/wfa.utest.cmp.sh $FEATURE $OUTPUT/wfa.utest.check || STATUS=1
+done
+if [[ $STATUS_BOUNDED -ne 0 ]]
+then
+  echo "> Max-score runs differ from the reference (see $LOG.bounded)"
+  STATUS=1
+fi
+if [[ $STATUS_STATS -ne 0 ]]
+then
+  echo "> Runs with --wfa-stats did not report stats (see $LOG)"
+  STATUS=1
+fi
+if [[ $STATUS_SCORED -ne 0 ]]
+then
+  echo "> Multithreaded runs differ in score from the reference (see $LOG.scored)"
+  STATUS=1
+fi
 STATUS_EXIT=$(grep "Exit status:" $LOG | grep -v "Exit status: 0" | sort | uniq -c | tr '\n' ' ')
 STATUS_SIGNAL=$(grep "Command terminated by signal" $LOG | sort | uniq -c | tr '\n' ' ')
 STATUS_CORRECT=$(cat $OUTPUT/wfa.utest.log.correct | awk '{print $5$6}' | sort | uniq -c | tr '\n' ' ')
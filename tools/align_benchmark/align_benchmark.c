@@ -35,6 +35,7 @@
 #endif
 
 #include "align_benchmark_params.h"
+#include "align_benchmark_input.h"
 
 #include "utils/commons.h"
 #include "utils/sequence_buffer.h"
@@ -47,6 +48,8 @@
 #include "gap_affine2p/affine2p_matrix.h"
 #include "gap_affine2p/affine2p_dp.h"
 #include "wavefront/wavefront_align.h"
+#include "wavefront/wavefront_batch.h"
+#include "wavefront/wavefront_aligner_pool.h"
 
 #include "benchmark/benchmark_indel.h"
 #include "benchmark/benchmark_edit.h"
@@ -152,8 +155,8 @@ void align_pairwise_test() {
 /*
  * Configuration
  */
-wavefront_aligner_t* align_input_configure_wavefront(
-    align_input_t* const align_input) {
+bool align_input_configure_wavefront_attributes(
+    wavefront_aligner_attr_t* const wf_attributes) {
   // Set attributes
   wavefront_aligner_attr_t attributes = wavefront_aligner_attr_default;
   attributes.memory_mode = parameters.wfa_memory_mode;
@@ -216,7 +219,7 @@ wavefront_aligner_t* align_input_configure_wavefront(
       attributes.affine2p_penalties = parameters.affine2p_penalties;
       break;
     default:
-      return NULL; // No WF selected
+      return false; // No WF selected
       break;
   }
   // Select alignment form
@@ -235,13 +238,36 @@ wavefront_aligner_t* align_input_configure_wavefront(
   attributes.plot.align_level = (parameters.plot < 0) ? -1 : parameters.plot - 1;
   attributes.system.verbose = parameters.verbose;
   attributes.system.max_memory_abort = parameters.wfa_max_memory;
+  attributes.system.max_memory_compact = parameters.wfa_max_memory_compact;
+  attributes.system.memory_policy = parameters.wfa_memory_policy;
+  attributes.system.bt_spill_path = parameters.wfa_bt_spill_path;
+  attributes.system.bt_compress = parameters.wfa_bt_compress;
   attributes.system.max_alignment_steps = parameters.wfa_max_steps;
+  attributes.system.max_score = parameters.wfa_max_score;
+  attributes.system.prefilter = parameters.wfa_prefilter;
+  attributes.system.bpm_mode = parameters.wfa_bpm_mode;
   attributes.system.max_num_threads = parameters.wfa_max_threads;
+  attributes.system.kernels_isa = parameters.wfa_kernels_isa;
+  attributes.system.extend_fused = parameters.wfa_extend_fused;
+  attributes.system.stats_enabled = parameters.wfa_stats;
+  attributes.cigar_run_length = parameters.wfa_cigar_rle;
+  // Return
+  *wf_attributes = attributes;
+  return true;
+}
+wavefront_aligner_t* align_input_configure_wavefront(
+    align_input_t* const align_input) {
+  // Set attributes
+  wavefront_aligner_attr_t attributes;
+  if (!align_input_configure_wavefront_attributes(&attributes)) {
+    return NULL; // No WF selected
+  }
   // Allocate
   return wavefront_aligner_new(&attributes);
 }
 void align_input_configure_global(
-    align_input_t* const align_input) {
+    align_input_t* const align_input,
+    const bool wf_aligner_pooled) {
   // Clear
   benchmark_align_input_clear(align_input);
   // Penalties
@@ -259,7 +285,9 @@ void align_input_configure_global(
       align_input->wfa_match_funct = lambda_function;
       align_input->wfa_match_funct_arguments = &lambda_params;
     }
-    align_input->wf_aligner = align_input_configure_wavefront(align_input);
+    align_input->wfa_pinned = parameters.wfa_pinned;
+    align_input->wfa_packed2bits = parameters.wfa_packed2bits;
+    align_input->wf_aligner = (wf_aligner_pooled) ? NULL : align_input_configure_wavefront(align_input);
   } else {
     align_input->wf_aligner = NULL;
   }
@@ -305,6 +333,8 @@ void align_input_configure_local(
 void align_benchmark_free(
     align_input_t* const align_input) {
   if (align_input->wf_aligner) wavefront_aligner_delete(align_input->wf_aligner);
+  free(align_input->wfa_pattern_packed);
+  free(align_input->wfa_text_packed);
   mm_allocator_delete(align_input->mm_allocator);
 }
 /*
@@ -337,6 +367,82 @@ bool align_benchmark_read_input(
   align_input->text[align_input->text_length] = '\0';
   return true;
 }
+void align_benchmark_set_reference(
+    align_input_mmap_t* const input_mmap,
+    align_input_t* const align_input) {
+  // Pinned texts are aligned in place (slices of the read-only mapped file)
+  const bool mapped_seqs = (input_mmap->format == align_input_seq && input_mmap->size <= INT_MAX);
+  align_input->wfa_reference = (mapped_seqs) ? input_mmap->sequences : NULL;
+  align_input->wfa_reference_length = (mapped_seqs) ? (int)input_mmap->size : 0;
+}
+bool align_benchmark_read_input_mmap(
+    align_input_mmap_t* const input_mmap,
+    const int seqs_processed,
+    align_input_t* const align_input) {
+  // Read queries (zero-copy)
+  sequence_offset_t offsets;
+  if (!align_input_mmap_read_pair(input_mmap,&offsets)) return false;
+  // Configure input
+  align_input->sequence_id = seqs_processed;
+  align_input->pattern = input_mmap->sequences + offsets.pattern_offset;
+  align_input->pattern_length = offsets.pattern_length;
+  align_input->text = input_mmap->sequences + offsets.text_offset;
+  align_input->text_length = offsets.text_length;
+  align_benchmark_set_reference(input_mmap,align_input);
+  return true;
+}
+int align_benchmark_read_batch(
+    sequence_buffer_t* const sequence_buffer,
+    const int seqs_processed,
+    align_input_t* const align_input) {
+  // Read batch-input sequence-pair
+  sequence_buffer_clear(sequence_buffer);
+  int seqs_batch;
+  for (seqs_batch=0;seqs_batch<parameters.batch_size;++seqs_batch) {
+    const bool seqs_pending = align_benchmark_read_input(
+        parameters.input_file,&parameters.line1,&parameters.line2,
+        &parameters.line1_allocated,&parameters.line2_allocated,
+        seqs_processed,align_input);
+    if (!seqs_pending) break;
+    // Add pair pattern-text
+    sequence_buffer_add_pair(sequence_buffer,
+        align_input->pattern,align_input->pattern_length,
+        align_input->text,align_input->text_length);
+  }
+  return seqs_batch;
+}
+void align_benchmark_open_input(
+    align_input_mmap_t** const input_mmap,
+    const bool pipelined) {
+  if (parameters.input_mmap) {
+    *input_mmap = align_input_mmap_open(parameters.input_filename,parameters.batch_size);
+    if (parameters.input_fasta != NULL) {
+      align_input_mmap_load_fasta(*input_mmap,parameters.input_fasta);
+    }
+    if (pipelined) align_input_mmap_producer_start(*input_mmap);
+  } else {
+    *input_mmap = NULL;
+    parameters.input_file = fopen(parameters.input_filename, "r");
+    if (parameters.input_file == NULL) {
+      fprintf(stderr,"Input file '%s' couldn't be opened\n",parameters.input_filename);
+      exit(1);
+    }
+  }
+  if (parameters.output_filename != NULL) {
+    parameters.output_file = fopen(parameters.output_filename, "w");
+  }
+}
+void align_benchmark_close_input(
+    align_input_mmap_t* const input_mmap) {
+  if (input_mmap != NULL) {
+    align_input_mmap_close(input_mmap);
+  } else {
+    fclose(parameters.input_file);
+  }
+  if (parameters.output_file) fclose(parameters.output_file);
+  free(parameters.line1);
+  free(parameters.line2);
+}
 /*
  * Display
  */
@@ -364,6 +470,28 @@ void align_benchmark_print_results(
       timer_print(stderr,&align_input[i].timer,&parameters.timer_global);
     }
   }
+  // Print fused compute & extend savings
+  if (parameters.wfa_extend_fused && parameters.num_threads==1 && align_input->wf_aligner!=NULL) {
+    const profiler_counter_t* const fused_bytes = &align_input->wf_aligner->system.extend_fused_bytes;
+    const uint64_t fused_steps = counter_get_num_samples(fused_bytes);
+    fprintf(stderr,"=> Extend.Fused           %"PRIu64" steps, %.1f bytes/step saved (%"PRIu64" MB total)\n",
+        fused_steps,(fused_steps > 0) ? counter_get_mean(fused_bytes) : 0.0,
+        CONVERT_B_TO_MB(counter_get_total(fused_bytes)));
+  }
+  // Print WFA stats
+  if (parameters.wfa_stats && parameters.num_threads==1 && align_input->wf_aligner!=NULL) {
+    wavefront_stats_print(stderr,&align_input->wfa_stats);
+  }
+  // Print BT-buffer compaction pauses
+  if (parameters.num_threads==1 && align_input->wf_aligner!=NULL) {
+    const profiler_timer_t* const timer_compact = &align_input->wf_aligner->system.timer_compact;
+    const uint64_t num_compactions = timer_get_num_samples(timer_compact);
+    if (num_compactions > 0) {
+      fprintf(stderr,"=> Time.BTBuffer.Compact  %"PRIu64" pauses, %.2f ms total, %.2f ms max\n",
+          num_compactions,(double)timer_get_total_ns(timer_compact)/1e6,
+          (double)timer_get_max_ns(timer_compact)/1e6);
+    }
+  }
   // Print Stats
   const bool checks_enabled =
       parameters.check_display || parameters.check_correct ||
@@ -453,25 +581,21 @@ void align_benchmark_sequential() {
   // PROFILE
   timer_reset(&parameters.timer_global);
   // I/O files
-  parameters.input_file = fopen(parameters.input_filename, "r");
-  if (parameters.input_file == NULL) {
-    fprintf(stderr,"Input file '%s' couldn't be opened\n",parameters.input_filename);
-    exit(1);
-  }
-  if (parameters.output_filename != NULL) {
-    parameters.output_file = fopen(parameters.output_filename, "w");
-  }
+  align_input_mmap_t* input_mmap;
+  align_benchmark_open_input(&input_mmap,false);
   // Global configuration
   align_input_t align_input;
-  align_input_configure_global(&align_input);
+  align_input_configure_global(&align_input,false);
   // Read-align loop
   int seqs_processed = 0, progress = 0;
   while (true) {
     // Read input sequence-pair
-    const bool input_read = align_benchmark_read_input(
-        parameters.input_file,&parameters.line1,&parameters.line2,
-        &parameters.line1_allocated,&parameters.line2_allocated,
-        seqs_processed,&align_input);
+    const bool input_read = (input_mmap != NULL) ?
+        align_benchmark_read_input_mmap(input_mmap,seqs_processed,&align_input) :
+        align_benchmark_read_input(
+            parameters.input_file,&parameters.line1,&parameters.line2,
+            &parameters.line1_allocated,&parameters.line2_allocated,
+            seqs_processed,&align_input);
     if (!input_read) break;
     // Execute the selected algorithm
     timer_start(&parameters.timer_global); // PROFILE
@@ -496,10 +620,7 @@ void align_benchmark_sequential() {
   if (parameters.verbose >= 0) align_benchmark_print_results(&align_input,seqs_processed,true);
   // Free
   align_benchmark_free(&align_input);
-  fclose(parameters.input_file);
-  if (parameters.output_file) fclose(parameters.output_file);
-  free(parameters.line1);
-  free(parameters.line2);
+  align_benchmark_close_input(input_mmap);
 }
 void align_benchmark_parallel() {
   #ifndef WFA_PARALLEL
@@ -508,60 +629,70 @@ void align_benchmark_parallel() {
   #endif
   // PROFILE
   timer_reset(&parameters.timer_global);
-  // Open input file
-  parameters.input_file = fopen(parameters.input_filename, "r");
-  if (parameters.input_file == NULL) {
-    fprintf(stderr,"Input file '%s' couldn't be opened\n",parameters.input_filename);
-    exit(1);
-  }
-  if (parameters.output_filename != NULL) {
-    parameters.output_file = fopen(parameters.output_filename, "w");
-  }
+  // Open input file (mapped input parses the next batch while the current one is aligned)
+  align_input_mmap_t* input_mmap;
+  align_benchmark_open_input(&input_mmap,true);
   // Global configuration
   align_input_t align_input[parameters.num_threads];
   for (int tid=0;tid<parameters.num_threads;++tid) {
-    align_input_configure_global(align_input+tid);
+    align_input_configure_global(align_input+tid,true);
+  }
+  // Aligner pool (WFA aligners are acquired per batch)
+  wavefront_aligner_pool_t* wf_aligner_pool = NULL;
+  wavefront_aligner_attr_t attributes;
+  if (align_input_configure_wavefront_attributes(&attributes)) {
+    wf_aligner_pool = wavefront_aligner_pool_new(&attributes,parameters.num_threads);
   }
   // Read-align loop
-  sequence_buffer_t* const sequence_buffer = sequence_buffer_new(2*parameters.batch_size,100);
+  sequence_buffer_t* const sequence_buffer = (input_mmap == NULL) ?
+      sequence_buffer_new(2*parameters.batch_size,100) : NULL;
   int seqs_processed = 0, progress = 0, seqs_batch = 0;
   while (true) {
     // Read batch-input sequence-pair
-    sequence_buffer_clear(sequence_buffer);
-    for (seqs_batch=0;seqs_batch<parameters.batch_size;++seqs_batch) {
-      const bool seqs_pending = align_benchmark_read_input(
-          parameters.input_file,&parameters.line1,&parameters.line2,
-          &parameters.line1_allocated,&parameters.line2_allocated,
-          seqs_processed,align_input);
-      if (!seqs_pending) break;
-      // Add pair pattern-text
-      sequence_buffer_add_pair(sequence_buffer,
-          align_input->pattern,align_input->pattern_length,
-          align_input->text,align_input->text_length);
+    align_input_batch_t* input_batch = NULL;
+    if (input_mmap != NULL) {
+      input_batch = align_input_mmap_batch_acquire(input_mmap);
+      seqs_batch = input_batch->num_pairs;
+    } else {
+      seqs_batch = align_benchmark_read_batch(sequence_buffer,seqs_processed,align_input);
     }
     if (seqs_batch == 0) break;
     // Parallel processing of the sequences batch
     timer_start(&parameters.timer_global); // PROFILE
 #ifdef WFA_PARALLEL
+    char* const seqs_buffer = (input_batch != NULL) ?
+        input_mmap->sequences : sequence_buffer->buffer;
+    sequence_offset_t* const seqs_offsets = (input_batch != NULL) ?
+        input_batch->offsets : sequence_buffer->offsets;
     #pragma omp parallel num_threads(parameters.num_threads)
     {
       int tid = omp_get_thread_num();
+      if (wf_aligner_pool != NULL) {
+        align_input[tid].wf_aligner = wavefront_aligner_pool_acquire(wf_aligner_pool);
+      }
 
       #pragma omp for
       for (int seq_idx=0;seq_idx<seqs_batch;++seq_idx) {
         // Configure sequence
-        sequence_offset_t* const offset = sequence_buffer->offsets + seq_idx;
+        sequence_offset_t* const offset = seqs_offsets + seq_idx;
         align_input[tid].sequence_id = seqs_processed;
-        align_input[tid].pattern = sequence_buffer->buffer + offset->pattern_offset;
+        align_input[tid].pattern = seqs_buffer + offset->pattern_offset;
         align_input[tid].pattern_length = offset->pattern_length;
-        align_input[tid].text = sequence_buffer->buffer + offset->text_offset;
+        align_input[tid].text = seqs_buffer + offset->text_offset;
         align_input[tid].text_length = offset->text_length;
+        if (input_batch != NULL) align_benchmark_set_reference(input_mmap,align_input+tid);
         // Execute the selected algorithm
         align_benchmark_run_algorithm(align_input+tid);
       }
+
+      if (wf_aligner_pool != NULL) {
+        wavefront_aligner_pool_release(wf_aligner_pool,align_input[tid].wf_aligner);
+        align_input[tid].wf_aligner = NULL;
+      }
     }
 #endif
     timer_stop(&parameters.timer_global); // PROFILE
+    if (input_batch != NULL) align_input_mmap_batch_release(input_mmap,input_batch);
     // Update progress
     seqs_processed += seqs_batch;
     progress += seqs_batch;
@@ -578,11 +709,85 @@ void align_benchmark_parallel() {
   for (int tid=0;tid<parameters.num_threads;++tid) {
     align_benchmark_free(align_input+tid);
   }
-  sequence_buffer_delete(sequence_buffer);
-  fclose(parameters.input_file);
-  if (parameters.output_file) fclose(parameters.output_file);
-  free(parameters.line1);
-  free(parameters.line2);
+  if (wf_aligner_pool != NULL) wavefront_aligner_pool_delete(wf_aligner_pool);
+  if (sequence_buffer != NULL) sequence_buffer_delete(sequence_buffer);
+  align_benchmark_close_input(input_mmap);
+}
+void align_benchmark_batch() {
+  // PROFILE
+  timer_reset(&parameters.timer_global);
+  // Open input file (mapped input parses the next batch while the current one is aligned)
+  align_input_mmap_t* input_mmap;
+  align_benchmark_open_input(&input_mmap,true);
+  // Batch aligner
+  align_input_t align_input;
+  wavefront_aligner_attr_t attributes;
+  align_input_configure_wavefront_attributes(&attributes);
+  wavefront_aligner_batch_t* const wf_aligner_batch = wavefront_aligner_batch_new(&attributes);
+  wavefront_batch_pair_t* const pairs = malloc(parameters.batch_size*sizeof(wavefront_batch_pair_t));
+  timer_reset(&align_input.timer);
+  // Read-align loop
+  sequence_buffer_t* const sequence_buffer = (input_mmap == NULL) ?
+      sequence_buffer_new(2*parameters.batch_size,100) : NULL;
+  int seqs_processed = 0, progress = 0, seqs_batch = 0;
+  while (true) {
+    // Read batch-input sequence-pair
+    align_input_batch_t* input_batch = NULL;
+    char* seqs_buffer;
+    sequence_offset_t* seqs_offsets;
+    if (input_mmap != NULL) {
+      input_batch = align_input_mmap_batch_acquire(input_mmap);
+      seqs_batch = input_batch->num_pairs;
+      seqs_buffer = input_mmap->sequences;
+      seqs_offsets = input_batch->offsets;
+    } else {
+      seqs_batch = align_benchmark_read_batch(sequence_buffer,seqs_processed,&align_input);
+      seqs_buffer = sequence_buffer->buffer;
+      seqs_offsets = sequence_buffer->offsets;
+    }
+    if (seqs_batch == 0) break;
+    // Configure pairs (once the buffer is no longer reallocated)
+    for (int seq_idx=0;seq_idx<seqs_batch;++seq_idx) {
+      sequence_offset_t* const offset = seqs_offsets + seq_idx;
+      pairs[seq_idx].pattern = seqs_buffer + offset->pattern_offset;
+      pairs[seq_idx].pattern_length = offset->pattern_length;
+      pairs[seq_idx].text = seqs_buffer + offset->text_offset;
+      pairs[seq_idx].text_length = offset->text_length;
+    }
+    if (input_batch != NULL) align_input_mmap_batch_release(input_mmap,input_batch);
+    // Align batch
+    timer_start(&parameters.timer_global); // PROFILE
+    timer_start(&align_input.timer);
+    wavefront_align_batch(wf_aligner_batch,pairs,seqs_batch);
+    timer_stop(&align_input.timer);
+    timer_stop(&parameters.timer_global); // PROFILE
+    // Output
+    if (parameters.output_file) {
+      for (int seq_idx=0;seq_idx<seqs_batch;++seq_idx) {
+        fprintf(parameters.output_file,"%d\t-\n",pairs[seq_idx].score);
+      }
+    }
+    // Update progress
+    seqs_processed += seqs_batch;
+    progress += seqs_batch;
+    if (progress >= parameters.progress) {
+      progress -= parameters.progress;
+      if (parameters.verbose >= 0) align_benchmark_print_progress(seqs_processed);
+    }
+  }
+  // Print benchmark results
+  if (parameters.verbose >= 0) {
+    align_benchmark_print_results(&align_input,seqs_processed,false);
+    fprintf(stderr,"=> Batch.Lanes            %d/%d (%"PRIu64" aligned in lanes, %"PRIu64" using 16-bit offsets, %"PRIu64" scalar fallback)\n",
+        wf_aligner_batch->num_lanes,wf_aligner_batch->num_lanes16,
+        wf_aligner_batch->num_aligned_lanes,wf_aligner_batch->num_aligned_lanes16,
+        wf_aligner_batch->num_aligned_fallback);
+  }
+  // Free
+  wavefront_aligner_batch_delete(wf_aligner_batch);
+  free(pairs);
+  if (sequence_buffer != NULL) sequence_buffer_delete(sequence_buffer);
+  align_benchmark_close_input(input_mmap);
 }
 /*
  * Main
@@ -595,7 +800,9 @@ int main(int argc,char* argv[]) {
     align_pairwise_test();
   } else {
     // Execute benchmark
-    if (parameters.num_threads == 1) {
+    if (parameters.wfa_batch) {
+      align_benchmark_batch();
+    } else if (parameters.num_threads == 1) {
       align_benchmark_sequential();
     } else {
       align_benchmark_parallel();
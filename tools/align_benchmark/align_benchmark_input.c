@@ -0,0 +1,503 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignment Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignment Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignment Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: Zero-copy (mmap) input reader with a pipelined batch producer.
+ *   Reads either '.seq' files ('>pattern' and '<text' lines) or PAF/TSV
+ *   records that index into FASTA/FASTQ sequences loaded once into memory
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "align_benchmark_input.h"
+
+/*
+ * FASTA/FASTQ (Setup)
+ */
+int align_input_fasta_cmp(
+    const void* const a,
+    const void* const b) {
+  return strcmp(((align_input_fasta_seq_t*)a)->name,((align_input_fasta_seq_t*)b)->name);
+}
+char* align_input_fasta_read_file(
+    const char* const filename,
+    uint64_t* const file_size) {
+  FILE* const file = fopen(filename,"r");
+  if (file == NULL) {
+    fprintf(stderr,"FASTA/FASTQ file '%s' couldn't be opened\n",filename);
+    exit(1);
+  }
+  fseek(file,0,SEEK_END);
+  *file_size = ftell(file);
+  fseek(file,0,SEEK_SET);
+  char* const buffer = malloc(*file_size+1);
+  if (fread(buffer,1,*file_size,file) != *file_size) {
+    fprintf(stderr,"FASTA/FASTQ file '%s' couldn't be read\n",filename);
+    exit(1);
+  }
+  buffer[*file_size] = '\0';
+  fclose(file);
+  return buffer;
+}
+void align_input_fasta_parse(
+    align_input_fasta_t* const fasta,
+    const char* const filename,
+    const char* const buffer,
+    const uint64_t buffer_size,
+    uint64_t* const names_used,
+    uint64_t* const names_allocated,
+    int* const index_allocated) {
+  uint64_t pos = 0;
+  while (pos < buffer_size) {
+    // Skip empty lines
+    const char tag = buffer[pos];
+    if (tag == '\n' || tag == '\r') { ++pos; continue; }
+    if (tag != '>' && tag != '@') {
+      fprintf(stderr,"FASTA/FASTQ file '%s' has an invalid record (offset %"PRIu64")\n",filename,pos);
+      exit(1);
+    }
+    // Parse name (up to the first blank)
+    const uint64_t name_begin = ++pos;
+    while (pos < buffer_size && buffer[pos] != '\n' &&
+           buffer[pos] != ' ' && buffer[pos] != '\t' && buffer[pos] != '\r') ++pos;
+    const uint64_t name_length = pos - name_begin;
+    while (pos < buffer_size && buffer[pos] != '\n') ++pos; // Skip comment
+    ++pos;
+    if (*names_used+name_length+1 > *names_allocated) {
+      *names_allocated = 2*(*names_used+name_length+1);
+      fasta->names = realloc(fasta->names,*names_allocated);
+    }
+    memcpy(fasta->names+*names_used,buffer+name_begin,name_length);
+    fasta->names[*names_used+name_length] = '\0';
+    // Parse sequence (lines until the next record; one line for FASTQ)
+    char* const sequence = fasta->sequences + fasta->sequences_length;
+    uint64_t sequence_length = 0;
+    while (pos < buffer_size && buffer[pos] != '>' &&
+          (tag == '>' || buffer[pos] != '+')) {
+      while (pos < buffer_size && buffer[pos] != '\n') {
+        if (buffer[pos] != '\r') sequence[sequence_length++] = buffer[pos];
+        ++pos;
+      }
+      ++pos;
+      if (tag == '@') break;
+    }
+    // Skip FASTQ qualities (same length as the sequence)
+    if (tag == '@') {
+      while (pos < buffer_size && buffer[pos] != '\n') ++pos; // Skip '+' line
+      ++pos;
+      pos += sequence_length;
+      while (pos < buffer_size && buffer[pos] != '\n') ++pos;
+      ++pos;
+    }
+    // Add to index (names are referenced by offset until the buffer is final)
+    if (fasta->num_sequences == *index_allocated) {
+      *index_allocated = 2*(*index_allocated) + 1024;
+      fasta->index = realloc(fasta->index,*index_allocated*sizeof(align_input_fasta_seq_t));
+    }
+    align_input_fasta_seq_t* const sequence_entry = fasta->index + fasta->num_sequences;
+    sequence_entry->name = (char*)(uintptr_t)(*names_used);
+    sequence_entry->offset = fasta->sequences_length;
+    sequence_entry->length = sequence_length;
+    fasta->num_sequences++;
+    fasta->sequences_length += sequence_length;
+    *names_used += name_length + 1;
+  }
+}
+align_input_fasta_t* align_input_fasta_load(
+    char* const fasta_filenames) {
+  // Alloc
+  align_input_fasta_t* const fasta = calloc(1,sizeof(align_input_fasta_t));
+  // Read all files (comma-separated)
+  const int max_files = 64;
+  char* filenames[max_files];
+  char* buffers[max_files];
+  uint64_t buffer_sizes[max_files];
+  uint64_t total_size = 0;
+  int num_files = 0;
+  char* filename = strtok(fasta_filenames,",");
+  while (filename != NULL) {
+    if (num_files == max_files) {
+      fprintf(stderr,"Too many FASTA/FASTQ files (max. %d)\n",max_files);
+      exit(1);
+    }
+    filenames[num_files] = filename;
+    buffers[num_files] = align_input_fasta_read_file(filename,buffer_sizes+num_files);
+    total_size += buffer_sizes[num_files++];
+    filename = strtok(NULL,",");
+  }
+  // Parse all files (forward sequences never exceed the total files size)
+  fasta->sequences = malloc(2*total_size+1); // Reverse-complement is stored after
+  uint64_t names_used = 0, names_allocated = 0;
+  int index_allocated = 0;
+  for (int i=0;i<num_files;++i) {
+    align_input_fasta_parse(fasta,filenames[i],buffers[i],buffer_sizes[i],
+        &names_used,&names_allocated,&index_allocated);
+    free(buffers[i]);
+  }
+  // Sort index by name
+  for (int i=0;i<fasta->num_sequences;++i) {
+    fasta->index[i].name = fasta->names + (uintptr_t)fasta->index[i].name;
+  }
+  qsort(fasta->index,fasta->num_sequences,sizeof(align_input_fasta_seq_t),align_input_fasta_cmp);
+  fasta->reverse_complemented = false;
+  fasta->last_found = NULL;
+  return fasta;
+}
+void align_input_fasta_delete(
+    align_input_fasta_t* const fasta) {
+  free(fasta->sequences);
+  free(fasta->names);
+  free(fasta->index);
+  free(fasta);
+}
+/*
+ * FASTA/FASTQ (Accessors)
+ */
+align_input_fasta_seq_t* align_input_fasta_find(
+    align_input_fasta_t* const fasta,
+    const char* const name,
+    const int name_length) {
+  // Check last found
+  align_input_fasta_seq_t* const last = fasta->last_found;
+  if (last != NULL && strncmp(last->name,name,name_length) == 0 &&
+      last->name[name_length] == '\0') return last;
+  // Binary search
+  int lo = 0, hi = fasta->num_sequences - 1;
+  while (lo <= hi) {
+    const int mid = lo + (hi-lo)/2;
+    align_input_fasta_seq_t* const sequence = fasta->index + mid;
+    int cmp = strncmp(sequence->name,name,name_length);
+    if (cmp == 0) cmp = (sequence->name[name_length] != '\0');
+    if (cmp == 0) {
+      fasta->last_found = sequence;
+      return sequence;
+    }
+    if (cmp < 0) lo = mid + 1; else hi = mid - 1;
+  }
+  fprintf(stderr,"Sequence '%.*s' not found in FASTA/FASTQ\n",name_length,name);
+  exit(1);
+}
+void align_input_fasta_reverse_complement(
+    align_input_fasta_t* const fasta) {
+  // Reverse-complement all the (concatenated) sequences at once
+  const char* const forward = fasta->sequences;
+  char* const reverse = fasta->sequences + fasta->sequences_length;
+  const uint64_t length = fasta->sequences_length;
+  for (uint64_t i=0;i<length;++i) {
+    char complement;
+    switch (forward[length-1-i]) {
+      case 'A': complement = 'T'; break;
+      case 'C': complement = 'G'; break;
+      case 'G': complement = 'C'; break;
+      case 'T': complement = 'A'; break;
+      case 'a': complement = 't'; break;
+      case 'c': complement = 'g'; break;
+      case 'g': complement = 'c'; break;
+      case 't': complement = 'a'; break;
+      default: complement = 'N'; break;
+    }
+    reverse[i] = complement;
+  }
+  fasta->reverse_complemented = true;
+}
+
+/*
+ * Setup
+ */
+align_input_mmap_t* align_input_mmap_open(
+    const char* const filename,
+    const int batch_size) {
+  // Alloc
+  align_input_mmap_t* const input_mmap = calloc(1,sizeof(align_input_mmap_t));
+  // Open & map file
+  input_mmap->fd = open(filename,O_RDONLY);
+  if (input_mmap->fd == -1) {
+    fprintf(stderr,"Input file '%s' couldn't be opened\n",filename);
+    exit(1);
+  }
+  struct stat file_stat;
+  if (fstat(input_mmap->fd,&file_stat) == -1) {
+    fprintf(stderr,"Input file '%s' couldn't be stat\n",filename);
+    exit(1);
+  }
+  input_mmap->size = file_stat.st_size;
+  input_mmap->position = 0;
+  if (input_mmap->size > 0) {
+    input_mmap->memory = mmap(NULL,input_mmap->size,PROT_READ,MAP_PRIVATE,input_mmap->fd,0);
+    if (input_mmap->memory == MAP_FAILED) {
+      fprintf(stderr,"Input file '%s' couldn't be mapped\n",filename);
+      exit(1);
+    }
+    madvise(input_mmap->memory,input_mmap->size,MADV_SEQUENTIAL);
+  } else {
+    input_mmap->memory = NULL;
+  }
+  input_mmap->format = align_input_seq;
+  input_mmap->fasta = NULL;
+  input_mmap->sequences = input_mmap->memory;
+  // Batches
+  input_mmap->batch_size = batch_size;
+  for (int i=0;i<2;++i) {
+    input_mmap->batches[i].offsets = malloc(batch_size*sizeof(sequence_offset_t));
+    input_mmap->batches[i].num_pairs = 0;
+    input_mmap->batches[i].ready = false;
+  }
+  input_mmap->batch_consumed = 0;
+  // Producer
+  pthread_mutex_init(&input_mmap->mutex,NULL);
+  pthread_cond_init(&input_mmap->cond,NULL);
+  input_mmap->producer_running = false;
+  input_mmap->producer_quit = false;
+  // Return
+  return input_mmap;
+}
+void align_input_mmap_close(
+    align_input_mmap_t* const input_mmap) {
+  // Stop producer
+  if (input_mmap->producer_running) {
+    pthread_mutex_lock(&input_mmap->mutex);
+    input_mmap->producer_quit = true;
+    pthread_cond_broadcast(&input_mmap->cond);
+    pthread_mutex_unlock(&input_mmap->mutex);
+    pthread_join(input_mmap->producer,NULL);
+  }
+  pthread_mutex_destroy(&input_mmap->mutex);
+  pthread_cond_destroy(&input_mmap->cond);
+  // Unmap & close
+  if (input_mmap->memory != NULL) munmap(input_mmap->memory,input_mmap->size);
+  close(input_mmap->fd);
+  // Free
+  if (input_mmap->fasta != NULL) align_input_fasta_delete(input_mmap->fasta);
+  free(input_mmap->batches[0].offsets);
+  free(input_mmap->batches[1].offsets);
+  free(input_mmap);
+}
+void align_input_mmap_load_fasta(
+    align_input_mmap_t* const input_mmap,
+    char* const fasta_filenames) {
+  input_mmap->format = align_input_paf;
+  input_mmap->fasta = align_input_fasta_load(fasta_filenames);
+  input_mmap->sequences = input_mmap->fasta->sequences;
+}
+/*
+ * Serial reading
+ */
+bool align_input_mmap_read_line(
+    align_input_mmap_t* const input_mmap,
+    char** const line,
+    uint64_t* const line_length) {
+  // Check EOF
+  if (input_mmap->position >= input_mmap->size) return false;
+  // Find end of line
+  *line = input_mmap->memory + input_mmap->position;
+  const uint64_t bytes_left = input_mmap->size - input_mmap->position;
+  const char* const eol = memchr(*line,'\n',bytes_left);
+  *line_length = (eol != NULL) ? (eol - *line) : bytes_left;
+  input_mmap->position += *line_length + (eol != NULL);
+  return true;
+}
+bool align_input_mmap_read_pair_seq(
+    align_input_mmap_t* const input_mmap,
+    sequence_offset_t* const offsets) {
+  // Read pattern & text lines (skipping the leading tag '>' or '<')
+  char* line;
+  uint64_t length;
+  if (!align_input_mmap_read_line(input_mmap,&line,&length)) return false;
+  offsets->pattern_offset = (line - input_mmap->memory) + (length > 0);
+  offsets->pattern_length = (length > 0) ? length - 1 : 0;
+  if (!align_input_mmap_read_line(input_mmap,&line,&length)) return false;
+  offsets->text_offset = (line - input_mmap->memory) + (length > 0);
+  offsets->text_length = (length > 0) ? length - 1 : 0;
+  return true;
+}
+uint64_t align_input_mmap_parse_uint(
+    const char* const field,
+    const int field_length) {
+  uint64_t value = 0;
+  for (int i=0;i<field_length;++i) {
+    if (field[i] < '0' || field[i] > '9') {
+      fprintf(stderr,"PAF/TSV record has an invalid coordinate '%.*s'\n",field_length,field);
+      exit(1);
+    }
+    value = 10*value + (field[i]-'0');
+  }
+  return value;
+}
+void align_input_mmap_paf_subsequence(
+    align_input_mmap_t* const input_mmap,
+    const char* const name,
+    const int name_length,
+    const uint64_t begin,
+    const uint64_t end,
+    const bool reverse,
+    uint64_t* const offset,
+    uint64_t* const length) {
+  align_input_fasta_t* const fasta = input_mmap->fasta;
+  align_input_fasta_seq_t* const sequence = align_input_fasta_find(fasta,name,name_length);
+  if (begin > end || end > sequence->length) {
+    fprintf(stderr,"PAF/TSV record '%.*s:%"PRIu64"-%"PRIu64"' out of bounds (length %"PRIu64")\n",
+        name_length,name,begin,end,sequence->length);
+    exit(1);
+  }
+  *length = end - begin;
+  if (!reverse) {
+    *offset = sequence->offset + begin;
+  } else {
+    if (!fasta->reverse_complemented) align_input_fasta_reverse_complement(fasta);
+    *offset = fasta->sequences_length + (fasta->sequences_length - (sequence->offset + end));
+  }
+}
+bool align_input_mmap_read_pair_paf(
+    align_input_mmap_t* const input_mmap,
+    sequence_offset_t* const offsets) {
+  while (true) {
+    // Read record (skipping empty and comment lines)
+    char* line;
+    uint64_t length;
+    if (!align_input_mmap_read_line(input_mmap,&line,&length)) return false;
+    if (length > 0 && line[length-1] == '\r') --length;
+    if (length == 0 || line[0] == '#') continue;
+    // Split fields
+    const int max_fields = 12;
+    char* fields[max_fields];
+    int fields_length[max_fields];
+    int num_fields = 0;
+    uint64_t field_begin = 0;
+    for (uint64_t i=0;i<=length && num_fields<max_fields;++i) {
+      if (i == length || line[i] == '\t') {
+        fields[num_fields] = line + field_begin;
+        fields_length[num_fields++] = i - field_begin;
+        field_begin = i + 1;
+      }
+    }
+    // Fetch coordinates
+    //   PAF: qname qlen qstart qend strand tname tlen tstart tend ...
+    //   TSV: qname qstart qend tname tstart tend [strand]
+    int qname, qstart, qend, tname, tstart, tend, strand;
+    if (num_fields >= 9) {
+      qname = 0; qstart = 2; qend = 3; strand = 4; tname = 5; tstart = 7; tend = 8;
+    } else if (num_fields == 6 || num_fields == 7) {
+      qname = 0; qstart = 1; qend = 2; tname = 3; tstart = 4; tend = 5;
+      strand = (num_fields == 7) ? 6 : -1;
+    } else {
+      fprintf(stderr,"PAF/TSV record has an invalid number of fields (%d)\n",num_fields);
+      exit(1);
+    }
+    const bool reverse = (strand != -1 && fields_length[strand] == 1 && fields[strand][0] == '-');
+    // Configure pattern (query) & text (target)
+    align_input_mmap_paf_subsequence(input_mmap,fields[qname],fields_length[qname],
+        align_input_mmap_parse_uint(fields[qstart],fields_length[qstart]),
+        align_input_mmap_parse_uint(fields[qend],fields_length[qend]),
+        reverse,&offsets->pattern_offset,&offsets->pattern_length);
+    align_input_mmap_paf_subsequence(input_mmap,fields[tname],fields_length[tname],
+        align_input_mmap_parse_uint(fields[tstart],fields_length[tstart]),
+        align_input_mmap_parse_uint(fields[tend],fields_length[tend]),
+        false,&offsets->text_offset,&offsets->text_length);
+    return true;
+  }
+}
+bool align_input_mmap_read_pair(
+    align_input_mmap_t* const input_mmap,
+    sequence_offset_t* const offsets) {
+  if (input_mmap->format == align_input_paf) {
+    return align_input_mmap_read_pair_paf(input_mmap,offsets);
+  } else {
+    return align_input_mmap_read_pair_seq(input_mmap,offsets);
+  }
+}
+int align_input_mmap_read_batch(
+    align_input_mmap_t* const input_mmap,
+    sequence_offset_t* const offsets,
+    const int batch_size) {
+  int num_pairs;
+  for (num_pairs=0;num_pairs<batch_size;++num_pairs) {
+    if (!align_input_mmap_read_pair(input_mmap,offsets+num_pairs)) break;
+  }
+  return num_pairs;
+}
+/*
+ * Pipelined reading (producer thread)
+ */
+void* align_input_mmap_producer(void* const arg) {
+  align_input_mmap_t* const input_mmap = (align_input_mmap_t*)arg;
+  int batch_idx = 0;
+  while (true) {
+    // Wait for the batch to be consumed
+    align_input_batch_t* const batch = input_mmap->batches + batch_idx;
+    pthread_mutex_lock(&input_mmap->mutex);
+    while (batch->ready && !input_mmap->producer_quit) {
+      pthread_cond_wait(&input_mmap->cond,&input_mmap->mutex);
+    }
+    const bool quit = input_mmap->producer_quit;
+    pthread_mutex_unlock(&input_mmap->mutex);
+    if (quit) break;
+    // Parse batch (also faults-in the mapped pages ahead of the aligners)
+    const int num_pairs = align_input_mmap_read_batch(
+        input_mmap,batch->offsets,input_mmap->batch_size);
+    // Publish batch
+    pthread_mutex_lock(&input_mmap->mutex);
+    batch->num_pairs = num_pairs;
+    batch->ready = true;
+    pthread_cond_broadcast(&input_mmap->cond);
+    pthread_mutex_unlock(&input_mmap->mutex);
+    if (num_pairs == 0) break; // EOF
+    batch_idx = 1 - batch_idx;
+  }
+  return NULL;
+}
+void align_input_mmap_producer_start(
+    align_input_mmap_t* const input_mmap) {
+  if (pthread_create(&input_mmap->producer,NULL,align_input_mmap_producer,input_mmap) != 0) {
+    fprintf(stderr,"Input reader thread couldn't be created\n");
+    exit(1);
+  }
+  input_mmap->producer_running = true;
+}
+align_input_batch_t* align_input_mmap_batch_acquire(
+    align_input_mmap_t* const input_mmap) {
+  // Wait for the batch to be parsed
+  align_input_batch_t* const batch = input_mmap->batches + input_mmap->batch_consumed;
+  pthread_mutex_lock(&input_mmap->mutex);
+  while (!batch->ready) {
+    pthread_cond_wait(&input_mmap->cond,&input_mmap->mutex);
+  }
+  pthread_mutex_unlock(&input_mmap->mutex);
+  return batch;
+}
+void align_input_mmap_batch_release(
+    align_input_mmap_t* const input_mmap,
+    align_input_batch_t* const batch) {
+  // Hand the batch back to the producer
+  pthread_mutex_lock(&input_mmap->mutex);
+  batch->ready = false;
+  pthread_cond_broadcast(&input_mmap->cond);
+  pthread_mutex_unlock(&input_mmap->mutex);
+  input_mmap->batch_consumed = 1 - input_mmap->batch_consumed;
+}
@@ -0,0 +1,134 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignment Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignment Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignment Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: Zero-copy (mmap) input reader with a pipelined batch producer.
+ *   Reads either '.seq' files ('>pattern' and '<text' lines) or PAF/TSV
+ *   records that index into FASTA/FASTQ sequences loaded once into memory
+ */
+
+#ifndef ALIGN_BENCHMARK_INPUT_H_
+#define ALIGN_BENCHMARK_INPUT_H_
+
+#include <pthread.h>
+
+#include "utils/commons.h"
+#include "utils/sequence_buffer.h"
+
+/*
+ * Input batch (offsets point into the mapped file)
+ */
+typedef struct {
+  sequence_offset_t* offsets;   // Sequence-pair offsets (relative to the mapped file)
+  int num_pairs;                // Sequence-pairs parsed (0 if the input is exhausted)
+  bool ready;                   // Parsed and pending to be consumed
+} align_input_batch_t;
+
+/*
+ * FASTA/FASTQ sequences (loaded once; all sequences concatenated)
+ */
+typedef struct {
+  char* name;                   // Sequence name (NUL-terminated)
+  uint64_t offset;              // Sequence offset (in the sequences buffer)
+  uint64_t length;              // Sequence length
+} align_input_fasta_seq_t;
+typedef struct {
+  // Sequences
+  char* sequences;              // Forward sequences followed by their reverse-complement
+  uint64_t sequences_length;    // Total length of the forward sequences
+  bool reverse_complemented;    // Reverse-complement computed (lazily, on the first '-' record)
+  // Names index (sorted by name)
+  char* names;                  // Names buffer
+  align_input_fasta_seq_t* index;
+  int num_sequences;
+  align_input_fasta_seq_t* last_found; // Last sequence found (PAF records are usually clustered)
+} align_input_fasta_t;
+
+/*
+ * Mapped Input
+ */
+typedef enum {
+  align_input_seq,              // '>pattern' & '<text' lines
+  align_input_paf,              // PAF/TSV records (pattern=query, text=target)
+} align_input_format_t;
+typedef struct {
+  // Mapped file
+  int fd;                       // File descriptor
+  char* memory;                 // Mapped file memory (read-only)
+  uint64_t size;                // File size
+  uint64_t position;            // Current parsing position
+  // Sequences
+  align_input_format_t format;  // Input format
+  align_input_fasta_t* fasta;   // FASTA/FASTQ sequences (PAF/TSV format)
+  char* sequences;              // Base of all sequence offsets (mapped file or FASTA sequences)
+  // Double-buffered batches
+  int batch_size;               // Maximum sequence-pairs per batch
+  align_input_batch_t batches[2];
+  int batch_consumed;           // Next batch to be consumed
+  // Producer thread
+  pthread_t producer;           // Producer thread (parses batch N+1 while N is aligned)
+  pthread_mutex_t mutex;        // Protects batches' ready flags
+  pthread_cond_t cond;          // Signals batch ready/consumed
+  bool producer_running;        // Producer thread started
+  bool producer_quit;           // Producer requested to stop
+} align_input_mmap_t;
+
+/*
+ * Setup
+ */
+align_input_mmap_t* align_input_mmap_open(
+    const char* const filename,
+    const int batch_size);
+void align_input_mmap_close(
+    align_input_mmap_t* const input_mmap);
+void align_input_mmap_load_fasta(
+    align_input_mmap_t* const input_mmap,
+    char* const fasta_filenames);
+
+/*
+ * Serial reading
+ */
+bool align_input_mmap_read_pair(
+    align_input_mmap_t* const input_mmap,
+    sequence_offset_t* const offsets);
+int align_input_mmap_read_batch(
+    align_input_mmap_t* const input_mmap,
+    sequence_offset_t* const offsets,
+    const int batch_size);
+
+/*
+ * Pipelined reading (producer thread)
+ */
+void align_input_mmap_producer_start(
+    align_input_mmap_t* const input_mmap);
+align_input_batch_t* align_input_mmap_batch_acquire(
+    align_input_mmap_t* const input_mmap);
+void align_input_mmap_batch_release(
+    align_input_mmap_t* const input_mmap,
+    align_input_batch_t* const batch);
+
+#endif /* ALIGN_BENCHMARK_INPUT_H_ */
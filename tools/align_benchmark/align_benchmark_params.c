@@ -42,6 +42,8 @@ align_bench_params_t parameters = {
   .input_filename = NULL,
   .output_filename = NULL,
   .output_full = false,
+  .input_mmap = false,
+  .input_fasta = NULL,
   .output_file = NULL,
   // I/O internals
   .input_file = NULL,
@@ -85,9 +87,23 @@ align_bench_params_t parameters = {
   .wfa_heuristic_p3 = -1,
   .wfa_memory_mode = wavefront_memory_high,
   .wfa_max_memory = UINT64_MAX,
+  .wfa_max_memory_compact = UINT64_MAX,
+  .wfa_memory_policy = { .pages = mm_pages_default, .numa = mm_numa_default, .numa_node = -1 },
+  .wfa_bt_spill_path = NULL,
+  .wfa_bt_compress = false,
   .wfa_max_steps = INT_MAX,
+  .wfa_max_score = INT_MAX,
+  .wfa_prefilter = wf_prefilter_none,
+  .wfa_bpm_mode = wf_bpm_auto,
   .wfa_max_threads = 1,
+  .wfa_kernels_isa = wf_kernels_auto,
+  .wfa_extend_fused = false,
+  .wfa_stats = false,
+  .wfa_cigar_rle = false,
+  .wfa_pinned = false,
+  .wfa_packed2bits = false,
   .wfa_lambda = false,
+  .wfa_batch = false,
   // Other algorithms parameters
   .bandwidth = -1,
   // Misc
@@ -134,6 +150,8 @@ void usage() {
       "          --input|i PATH                                                \n"
       "          --output|o PATH                                               \n"
       "          --output-full PATH                                            \n"
+      "          --input-mmap (zero-copy mapped input, pipelined reader)       \n"
+      "          --input-fasta PATH[,PATH...] (FASTA/FASTQ; --input is PAF/TSV)\n"
       "        [Penalties]                                                     \n"
       "          --linear-penalties|p M,X,I                                    \n"
       "          --affine-penalties|g M,X,O,E                                  \n"
@@ -162,8 +180,23 @@ void usage() {
       "              P1 = z-drop                                               \n"
       "              P2 = steps-between-cutoffs                                \n"
       "          --wfa-max-memory BYTES                                        \n"
+      "          --wfa-max-memory-compact BYTES (BT-buffer compaction budget)  \n"
+      "          --wfa-hugepages '2MB'|'1GB'                                   \n"
+      "          --wfa-numa 'local'|NODE                                       \n"
+      "          --wfa-bt-spill DIR (spill cold BT-segments; med/low memory)   \n"
+      "          --wfa-bt-compress (compress cold BT-segments; not with spill) \n"
       "          --wfa-max-steps INT                                           \n"
+      "          --wfa-max-score INT                                           \n"
+      "          --wfa-prefilter 'none'|'length'|'basecount'                   \n"
+      "          --wfa-bpm 'auto'|'never'|'always' (score-only edit/indel)     \n"
       "          --wfa-max-threads INT (intra-parallelism; default=1)          \n"
+      "          --wfa-kernels 'auto'|'scalar'|'avx2'|'avx512'                 \n"
+      "          --wfa-extend-fused (extend diagonals as computed; end-to-end) \n"
+      "          --wfa-batch (score-only pairs aligned in lockstep, exact)     \n"
+      "          --wfa-stats (report steps/cells/memory/time per phase)        \n"
+      "          --wfa-cigar-rle (backtrace emits run-length CIGARs directly)  \n"
+      "          --wfa-pinned (pin each pattern once, align texts against it)  \n"
+      "          --wfa-packed2bits (align 2-bits packed sequences; ACGT only)  \n"
       "        [Other Parameters]                                              \n"
       "          --bandwidth INT                                               \n"
       "        [Misc]                                                          \n"
@@ -196,6 +229,8 @@ void parse_arguments(
     { "input", required_argument, 0, 'i' },
     { "output", required_argument, 0, 'o' },
     { "output-full", required_argument, 0, 800 },
+    { "input-mmap", no_argument, 0, 801 },
+    { "input-fasta", required_argument, 0, 802 },
     /* Penalties */
     { "linear-penalties", required_argument, 0, 'p' },
     { "affine-penalties", required_argument, 0, 'g' },
@@ -207,9 +242,24 @@ void parse_arguments(
     { "wfa-heuristic", required_argument, 0, 1003 },
     { "wfa-heuristic-parameters", required_argument, 0, 1004 },
     { "wfa-max-memory", required_argument, 0, 1005 },
+    { "wfa-max-memory-compact", required_argument, 0, 1022 },
+    { "wfa-hugepages", required_argument, 0, 1015 },
+    { "wfa-numa", required_argument, 0, 1016 },
+    { "wfa-bt-spill", required_argument, 0, 1017 },
+    { "wfa-bt-compress", no_argument, 0, 1018 },
     { "wfa-max-steps", required_argument, 0, 1006 },
+    { "wfa-max-score", required_argument, 0, 1011 },
+    { "wfa-prefilter", required_argument, 0, 1012 },
+    { "wfa-bpm", required_argument, 0, 1014 },
     { "wfa-max-threads", required_argument, 0, 1007 },
     { "wfa-lambda", no_argument, 0, 1008 },
+    { "wfa-kernels", required_argument, 0, 1009 },
+    { "wfa-batch", no_argument, 0, 1010 },
+    { "wfa-extend-fused", no_argument, 0, 1013 },
+    { "wfa-stats", no_argument, 0, 1019 },
+    { "wfa-cigar-rle", no_argument, 0, 1020 },
+    { "wfa-pinned", no_argument, 0, 1021 },
+    { "wfa-packed2bits", no_argument, 0, 1023 },
     /* Other alignment parameters */
     { "bandwidth", required_argument, 0, 2000 },
     /* Misc */
@@ -293,6 +343,13 @@ void parse_arguments(
       parameters.output_filename = optarg;
       parameters.output_full = true;
       break;
+    case 801: // --input-mmap
+      parameters.input_mmap = true;
+      break;
+    case 802: // --input-fasta
+      parameters.input_fasta = optarg;
+      parameters.input_mmap = true; // PAF/TSV records are read from the mapped input
+      break;
     /*
      * Penalties
      */
@@ -438,15 +495,101 @@ void parse_arguments(
     case 1005: // --wfa-max-memory
       parameters.wfa_max_memory = atol(optarg);
       break;
+    case 1022: // --wfa-max-memory-compact
+      parameters.wfa_max_memory_compact = atol(optarg);
+      break;
+    case 1015: // --wfa-hugepages
+      if (strcmp(optarg,"2MB")==0) {
+        parameters.wfa_memory_policy.pages = mm_pages_huge_2MB;
+      } else if (strcmp(optarg,"1GB")==0) {
+        parameters.wfa_memory_policy.pages = mm_pages_huge_1GB;
+      } else {
+        fprintf(stderr,"Option '--wfa-hugepages' must be in {'2MB','1GB'}\n");
+        exit(1);
+      }
+      break;
+    case 1016: // --wfa-numa
+      if (strcmp(optarg,"local")==0) {
+        parameters.wfa_memory_policy.numa = mm_numa_local;
+      } else {
+        parameters.wfa_memory_policy.numa = mm_numa_bind;
+        parameters.wfa_memory_policy.numa_node = atoi(optarg);
+      }
+      break;
+    case 1017: // --wfa-bt-spill
+      parameters.wfa_bt_spill_path = optarg;
+      break;
+    case 1018: // --wfa-bt-compress
+      parameters.wfa_bt_compress = true;
+      break;
     case 1006: // --wfa-max-steps
       parameters.wfa_max_steps = atoi(optarg);
       break;
+    case 1011: // --wfa-max-score
+      parameters.wfa_max_score = atoi(optarg);
+      break;
+    case 1012: // --wfa-prefilter
+      if (strcmp(optarg,"none")==0) {
+        parameters.wfa_prefilter = wf_prefilter_none;
+      } else if (strcmp(optarg,"length")==0) {
+        parameters.wfa_prefilter = wf_prefilter_length;
+      } else if (strcmp(optarg,"basecount")==0) {
+        parameters.wfa_prefilter = wf_prefilter_basecount;
+      } else {
+        fprintf(stderr,"Option '--wfa-prefilter' must be in {'none','length','basecount'}\n");
+        exit(1);
+      }
+      break;
+    case 1014: // --wfa-bpm
+      if (strcmp(optarg,"auto")==0) {
+        parameters.wfa_bpm_mode = wf_bpm_auto;
+      } else if (strcmp(optarg,"never")==0) {
+        parameters.wfa_bpm_mode = wf_bpm_never;
+      } else if (strcmp(optarg,"always")==0) {
+        parameters.wfa_bpm_mode = wf_bpm_always;
+      } else {
+        fprintf(stderr,"Option '--wfa-bpm' must be in {'auto','never','always'}\n");
+        exit(1);
+      }
+      break;
     case 1007: // --wfa-max-threads
       parameters.wfa_max_threads = atoi(optarg);
       break;
     case 1008: // --wfa-lambda
       parameters.wfa_lambda = true;
       break;
+    case 1009: // --wfa-kernels in {'auto','scalar','avx2','avx512'}
+      if (strcmp(optarg,"auto")==0) {
+        parameters.wfa_kernels_isa = wf_kernels_auto;
+      } else if (strcmp(optarg,"scalar")==0) {
+        parameters.wfa_kernels_isa = wf_kernels_scalar;
+      } else if (strcmp(optarg,"avx2")==0) {
+        parameters.wfa_kernels_isa = wf_kernels_avx2;
+      } else if (strcmp(optarg,"avx512")==0) {
+        parameters.wfa_kernels_isa = wf_kernels_avx512;
+      } else {
+        fprintf(stderr,"Option '--wfa-kernels' must be in {'auto','scalar','avx2','avx512'}\n");
+        exit(1);
+      }
+      break;
+    case 1010: // --wfa-batch
+      parameters.wfa_batch = true;
+      break;
+    case 1013: // --wfa-extend-fused
+      parameters.wfa_extend_fused = true;
+      break;
+    case 1019: // --wfa-stats
+      parameters.wfa_stats = true;
+      break;
+    case 1020: // --wfa-cigar-rle
+      parameters.wfa_cigar_rle = true;
+      break;
+    case 1021: // --wfa-pinned
+      parameters.wfa_pinned = true;
+      break;
+    case 1023: // --wfa-packed2bits
+      parameters.wfa_packed2bits = true;
+      break;
     /*
      * Other alignment parameters
      */
@@ -595,6 +738,36 @@ void parse_arguments(
     default:
       break;
   }
+  // Check 'wfa-bt-spill' & 'wfa-bt-compress'
+  if (parameters.wfa_bt_spill_path != NULL && parameters.wfa_bt_compress) {
+    fprintf(stderr,"Options '--wfa-bt-spill' and '--wfa-bt-compress' are mutually exclusive\n");
+    exit(1);
+  }
+  // Check 'wfa-batch'
+  if (parameters.wfa_batch) {
+    switch (parameters.algorithm) {
+      case alignment_indel_wavefront:
+      case alignment_edit_wavefront:
+      case alignment_gap_linear_wavefront:
+      case alignment_gap_affine_wavefront:
+      case alignment_gap_affine2p_wavefront:
+        break;
+      default:
+        fprintf(stderr,"Option '--wfa-batch' requires a wavefront algorithm\n");
+        exit(1);
+        break;
+    }
+    if (!parameters.wfa_score_only) {
+      fprintf(stderr,"Option '--wfa-batch' requires '--wfa-score-only'\n");
+      exit(1);
+    }
+    if (parameters.num_threads > 1 || parameters.plot != 0 ||
+        parameters.wfa_lambda || parameters.check_display || parameters.check_correct ||
+        parameters.check_score || parameters.check_alignments) {
+      fprintf(stderr,"Option '--wfa-batch' is not compatible with threads, plots, lambdas, or checks\n");
+      exit(1);
+    }
+  }
   // Checks parallel
   if (parameters.num_threads > 1) {
     if (parameters.plot > 0) {
@@ -70,6 +70,8 @@ typedef struct {
   char *input_filename;
   char *output_filename;
   bool output_full;
+  bool input_mmap;
+  char *input_fasta;
   // I/O internals
   FILE* input_file;
   char* line1;
@@ -97,9 +99,23 @@ typedef struct {
   int wfa_heuristic_p3;
   wavefront_memory_t wfa_memory_mode;
   uint64_t wfa_max_memory;
+  uint64_t wfa_max_memory_compact;
+  mm_allocator_policy_t wfa_memory_policy;
+  char* wfa_bt_spill_path;
+  bool wfa_bt_compress;
   int wfa_max_steps;
+  int wfa_max_score;
+  wavefront_prefilter_t wfa_prefilter;
+  wavefront_bpm_mode_t wfa_bpm_mode;
   int wfa_max_threads;
+  wavefront_kernels_isa_t wfa_kernels_isa;
+  bool wfa_extend_fused;
+  bool wfa_stats;
+  bool wfa_cigar_rle;
+  bool wfa_pinned;
+  bool wfa_packed2bits;
   bool wfa_lambda;
+  bool wfa_batch;
   // Other algorithms parameters
   int bandwidth;
   // Misc
@@ -74,6 +74,7 @@ void benchmark_check_alignment_using_solution(
         counter_add(&(align_input->align_correct),1);
       }
       // CIGAR Stats
+      cigar_expand(cigar_computed);
       int i;
       counter_add(&(align_input->align_bases),align_input->pattern_length);
       for (i=cigar_computed->begin_offset;i<cigar_computed->end_offset;++i) {
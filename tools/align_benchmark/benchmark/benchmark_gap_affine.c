@@ -132,16 +132,9 @@ void benchmark_gap_affine_wavefront(
   wavefront_aligner_t* const wf_aligner = align_input->wf_aligner;
   // Align
   timer_start(&align_input->timer);
-  if (align_input->wfa_match_funct == NULL) {
-    wavefront_align(wf_aligner,
-        align_input->pattern,align_input->pattern_length,
-        align_input->text,align_input->text_length);
-  } else {
-    wavefront_align_lambda(wf_aligner,
-        align_input->wfa_match_funct,align_input->wfa_match_funct_arguments,
-        align_input->pattern_length,align_input->text_length);
-  }
+  benchmark_wavefront_align(align_input);
   timer_stop(&align_input->timer);
+  benchmark_wavefront_stats_add(align_input);
   // DEBUG
   if (align_input->debug_flags) {
     benchmark_check_alignment(align_input,wf_aligner->cigar);
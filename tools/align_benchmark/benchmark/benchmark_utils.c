@@ -35,6 +35,7 @@
 #include "gap_linear/nw.h"
 #include "gap_affine/affine_matrix.h"
 #include "gap_affine/swg.h"
+#include "wavefront/wavefront_align.h"
 
 /*
  * Setup
@@ -48,6 +49,14 @@ void benchmark_align_input_clear(
   align_input->text_end_free = 0;
   align_input->wfa_match_funct = NULL;
   align_input->wfa_match_funct_arguments = NULL;
+  align_input->wfa_pinned = false;
+  align_input->wfa_reference = NULL;
+  align_input->wfa_reference_length = 0;
+  align_input->wfa_packed2bits = false;
+  align_input->wfa_pattern_packed = NULL;
+  align_input->wfa_text_packed = NULL;
+  align_input->wfa_pattern_packed_allocated = 0;
+  align_input->wfa_text_packed_allocated = 0;
   // Output
   align_input->output_file = NULL;
   align_input->output_full = false;
@@ -63,6 +72,7 @@ void benchmark_align_input_clear(
   counter_reset(&(align_input->align_mismatches));
   counter_reset(&(align_input->align_del));
   counter_reset(&(align_input->align_ins));
+  wavefront_stats_clear(&(align_input->wfa_stats));
 }
 /*
  * Display
@@ -76,8 +86,8 @@ void benchmark_print_alignment(
     cigar_t* const cigar_correct) {
   // Print Sequence
   fprintf(stream,"ALIGNMENT (#%d)\n",align_input->sequence_id);
-  fprintf(stream,"  PATTERN  %s\n",align_input->pattern);
-  fprintf(stream,"  TEXT     %s\n",align_input->text);
+  fprintf(stream,"  PATTERN  %.*s\n",align_input->pattern_length,align_input->pattern);
+  fprintf(stream,"  TEXT     %.*s\n",align_input->text_length,align_input->text);
   // Print CIGARS
   if (cigar_computed != NULL && score_computed != -1) {
     fprintf(stream,"    COMPUTED\tscore=%d\t",score_computed);
@@ -130,11 +140,13 @@ void benchmark_print_output_full(
     cigar_sprint(cigar_str,cigar,true);
   }
   // Print
-  fprintf(stream,"%d\t%d\t%d\t%s\t%s\t%s\n",
+  fprintf(stream,"%d\t%d\t%d\t%.*s\t%.*s\t%s\n",
       align_input->pattern_length,     // Pattern length
       align_input->text_length,        // Text length
       score,                           // Alignment score
+      align_input->pattern_length,
       align_input->pattern,            // Pattern sequence
+      align_input->text_length,
       align_input->text,               // Text sequence
       (cigar_null) ? "-" : cigar_str); // CIGAR
   // Free
@@ -177,9 +189,107 @@ void benchmark_print_output(
     }
   }
 }
+/*
+ * Wavefront
+ */
+void benchmark_wavefront_align_pinned(
+    align_input_t* const align_input) {
+  // Parameters
+  wavefront_aligner_t* const wf_aligner = align_input->wf_aligner;
+  wavefront_sequences_t* const pinned = (wf_aligner->bialigner == NULL) ?
+      &wf_aligner->sequences : &wf_aligner->bialigner->wf_forward->sequences;
+  // Pin pattern (only if it changed)
+  const bool already_pinned = pinned->pattern_pinned &&
+      pinned->pattern_pinned_length == align_input->pattern_length &&
+      memcmp(pinned->pattern_pinned_buffer,align_input->pattern,align_input->pattern_length) == 0;
+  if (!already_pinned) {
+    wavefront_align_pin_pattern(wf_aligner,align_input->pattern,align_input->pattern_length);
+  }
+  // Align text (slice of the read-only mapped input, if any)
+  if (align_input->wfa_reference != NULL) {
+    const int text_begin = align_input->text - align_input->wfa_reference;
+    wavefront_align_pinned_slice(wf_aligner,
+        align_input->wfa_reference,align_input->wfa_reference_length,
+        text_begin,text_begin+align_input->text_length);
+  } else {
+    wavefront_align_pinned(wf_aligner,align_input->text,align_input->text_length);
+  }
+}
+/*
+ * Benchmark 2-bits packed
+ *   Sequences are packed (A=0,C=1,G=2,T=3) outside the timed region
+ */
+uint8_t* benchmark_wavefront_pack2bits(
+    const char* const sequence,
+    const int sequence_length,
+    uint8_t* packed,
+    int* const packed_allocated) {
+  // Allocate
+  const int num_bytes = DIV_CEIL(sequence_length,4);
+  if (*packed_allocated < num_bytes) {
+    free(packed);
+    *packed_allocated = num_bytes + num_bytes/2;
+    packed = malloc(*packed_allocated);
+  }
+  // Pack
+  memset(packed,0,num_bytes);
+  int i;
+  for (i=0;i<sequence_length;++i) {
+    uint8_t base;
+    switch (sequence[i]) {
+      case 'A': base = 0; break;
+      case 'C': base = 1; break;
+      case 'G': base = 2; break;
+      default:  base = 3; break;
+    }
+    packed[i>>2] |= (uint8_t)(base << ((i&3)<<1));
+  }
+  return packed;
+}
+void benchmark_wavefront_align_packed2bits(
+    align_input_t* const align_input) {
+  // Pack sequences (not timed)
+  timer_pause(&align_input->timer);
+  align_input->wfa_pattern_packed = benchmark_wavefront_pack2bits(
+      align_input->pattern,align_input->pattern_length,
+      align_input->wfa_pattern_packed,&align_input->wfa_pattern_packed_allocated);
+  align_input->wfa_text_packed = benchmark_wavefront_pack2bits(
+      align_input->text,align_input->text_length,
+      align_input->wfa_text_packed,&align_input->wfa_text_packed_allocated);
+  timer_continue(&align_input->timer);
+  // Align
+  wavefront_align_packed2bits(align_input->wf_aligner,
+      align_input->wfa_pattern_packed,align_input->pattern_length,
+      align_input->wfa_text_packed,align_input->text_length);
+}
+void benchmark_wavefront_align(
+    align_input_t* const align_input) {
+  // Parameters
+  wavefront_aligner_t* const wf_aligner = align_input->wf_aligner;
+  // Align
+  if (align_input->wfa_match_funct != NULL) {
+    wavefront_align_lambda(wf_aligner,
+        align_input->wfa_match_funct,align_input->wfa_match_funct_arguments,
+        align_input->pattern_length,align_input->text_length);
+  } else if (align_input->wfa_pinned) {
+    benchmark_wavefront_align_pinned(align_input);
+  } else if (align_input->wfa_packed2bits) {
+    benchmark_wavefront_align_packed2bits(align_input);
+  } else {
+    wavefront_align(wf_aligner,
+        align_input->pattern,align_input->pattern_length,
+        align_input->text,align_input->text_length);
+  }
+}
 /*
  * Stats
  */
+void benchmark_wavefront_stats_add(
+    align_input_t* const align_input) {
+  wavefront_aligner_t* const wf_aligner = align_input->wf_aligner;
+  if (!wf_aligner->system.stats_enabled) return;
+  wavefront_stats_add(&align_input->wfa_stats,&wf_aligner->stats);
+}
 void benchmark_print_stats(
     FILE* const stream,
     align_input_t* const align_input,
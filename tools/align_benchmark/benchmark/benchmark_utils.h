@@ -64,6 +64,14 @@ typedef struct {
   int text_length;
   alignment_match_funct_t wfa_match_funct;
   void* wfa_match_funct_arguments;
+  bool wfa_pinned;
+  const char* wfa_reference;    // Read-only reference holding the texts (pinned slices)
+  int wfa_reference_length;
+  bool wfa_packed2bits;
+  uint8_t* wfa_pattern_packed;
+  uint8_t* wfa_text_packed;
+  int wfa_pattern_packed_allocated;
+  int wfa_text_packed_allocated;
   // Penalties
   linear_penalties_t linear_penalties;
   affine_penalties_t affine_penalties;
@@ -92,6 +100,7 @@ typedef struct {
   profiler_counter_t align_mismatches;
   profiler_counter_t align_del;
   profiler_counter_t align_ins;
+  wavefront_aligner_stats_t wfa_stats; // WFA stats (accumulated over all alignments)
   // DEBUG
   int debug_flags;
   linear_penalties_t* check_linear_penalties;
@@ -123,9 +132,17 @@ void benchmark_print_output(
     const bool score_only,
     cigar_t* const cigar);
 
+/*
+ * Wavefront
+ */
+void benchmark_wavefront_align(
+    align_input_t* const align_input);
+
 /*
  * Stats
  */
+void benchmark_wavefront_stats_add(
+    align_input_t* const align_input);
 void benchmark_print_stats(
     FILE* const stream,
     align_input_t* const align_input,
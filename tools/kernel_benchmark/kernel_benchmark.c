@@ -0,0 +1,907 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignment Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignment Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignment Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: Microbenchmark of the WFA kernels (isolated from the alignment loop)
+ *   over a grid of sequence lengths, error rates, and wavefront widths
+ */
+
+#include <getopt.h>
+
+#include "utils/commons.h"
+#include "system/mm_allocator.h"
+#include "system/profiler_timer.h"
+#include "wavefront/wavefront_aligner.h"
+#include "wavefront/wavefront_align.h"
+#include "wavefront/wavefront_dispatch.h"
+#include "wavefront/wavefront_compute_edit.h"
+#include "wavefront/wavefront_compute_linear.h"
+#include "wavefront/wavefront_extend_kernels.h"
+#include "wavefront/wavefront_backtrace.h"
+#include "wavefront/wavefront_backtrace_buffer.h"
+#include "wavefront/wavefront_components.h"
+#include "kernel_benchmark_dataset.h"
+#include "kernel_benchmark_report.h"
+
+/*
+ * Parameters
+ */
+#define KERNEL_BENCHMARK_MAX_GRID 64
+typedef struct {
+  // Kernels
+  bool kernels_compute;      // Compute kernels (synthetic wavefronts)
+  bool kernels_extend;       // Extend kernels
+  bool kernels_backtrace;    // Backtrace (wavefronts & BT-buffer)
+  bool kernels_compact;      // BT-buffer compaction
+  bool kernels_cigar;        // CIGAR generation (cigar_get_CIGAR)
+  // Grid
+  int lengths[KERNEL_BENCHMARK_MAX_GRID];   // Sequence lengths
+  int num_lengths;
+  float errors[KERNEL_BENCHMARK_MAX_GRID];  // Error rates
+  int num_errors;
+  int widths[KERNEL_BENCHMARK_MAX_GRID];    // Wavefront widths (diagonals)
+  int num_widths;
+  // Dataset & timing
+  int num_pairs;             // Sequence pairs generated per grid point
+  int sequence_length;       // Pattern/Text length bounding the synthetic offsets
+  int iterations;            // Kernel calls timed
+  double null_rate;          // Fraction of null input offsets
+  uint64_t seed;             // Random seed
+  // Output
+  char* output_filename;     // Output file (stdout if NULL)
+  kernel_benchmark_format_t output_format;
+} kernel_benchmark_params_t;
+kernel_benchmark_params_t parameters = {
+  // Kernels
+  .kernels_compute = true,
+  .kernels_extend = true,
+  .kernels_backtrace = true,
+  .kernels_compact = true,
+  .kernels_cigar = true,
+  // Grid
+  .lengths = {100,1000,10000},
+  .num_lengths = 3,
+  .errors = {0.01,0.05,0.10},
+  .num_errors = 3,
+  .widths = {100,1000,10000},
+  .num_widths = 3,
+  // Dataset & timing
+  .num_pairs = 10,
+  .sequence_length = 100000,
+  .iterations = 1000,
+  .null_rate = 0.10,
+  .seed = 42,
+  // Output
+  .output_filename = NULL,
+  .output_format = kernel_benchmark_format_table,
+};
+
+/*
+ * Compute kernels
+ */
+typedef enum {
+  kernel_compute_edit,
+  kernel_compute_edit_piggyback,
+  kernel_compute_linear,
+  kernel_compute_linear_piggyback,
+  kernel_compute_affine,
+  kernel_compute_affine_piggyback,
+  kernel_compute_affine2p,
+  kernel_compute_affine2p_piggyback,
+} kernel_benchmark_kernel_t;
+#define KERNEL_BENCHMARK_NUM_KERNELS 8
+char* kernel_benchmark_kernel_name[KERNEL_BENCHMARK_NUM_KERNELS] = {
+  "compute.edit",
+  "compute.edit.piggyback",
+  "compute.linear",
+  "compute.linear.piggyback",
+  "compute.affine",
+  "compute.affine.piggyback",
+  "compute.affine2p",
+  "compute.affine2p.piggyback",
+};
+typedef void (*kernel_compute_f)(
+    wavefront_aligner_t* const,const wavefront_set_t* const,const int,const int);
+void kernel_benchmark_compute_edit_idm(
+    wavefront_aligner_t* const wf_aligner,
+    const wavefront_set_t* const wavefront_set,
+    const int lo,
+    const int hi) {
+  wavefront_compute_edit_idm(wf_aligner,
+      wavefront_set->in_mwavefront_misms,wavefront_set->out_mwavefront,lo,hi);
+}
+void kernel_benchmark_compute_edit_idm_piggyback(
+    wavefront_aligner_t* const wf_aligner,
+    const wavefront_set_t* const wavefront_set,
+    const int lo,
+    const int hi) {
+  wavefront_compute_edit_idm_piggyback(wf_aligner,
+      wavefront_set->in_mwavefront_misms,wavefront_set->out_mwavefront,lo,hi,1);
+}
+kernel_compute_f kernel_benchmark_get_kernel(
+    wavefront_kernels_t* const kernels,
+    const kernel_benchmark_kernel_t kernel) {
+  // Edit and gap-linear kernels are only implemented in scalar (auto-vectorized)
+  const bool scalar = (kernels->isa == wf_kernels_scalar);
+  switch (kernel) {
+    case kernel_compute_edit: return (scalar) ? kernel_benchmark_compute_edit_idm : NULL;
+    case kernel_compute_edit_piggyback: return (scalar) ? kernel_benchmark_compute_edit_idm_piggyback : NULL;
+    case kernel_compute_linear: return (scalar) ? wavefront_compute_linear_idm : NULL;
+    case kernel_compute_linear_piggyback: return (scalar) ? wavefront_compute_linear_idm_piggyback : NULL;
+    case kernel_compute_affine: return kernels->compute_affine_idm;
+    case kernel_compute_affine_piggyback: return kernels->compute_affine_idm_piggyback;
+    case kernel_compute_affine2p: return kernels->compute_affine2p_idm;
+    default: return kernels->compute_affine2p_idm_piggyback;
+  }
+}
+bool kernel_benchmark_kernel_is_piggyback(
+    const kernel_benchmark_kernel_t kernel) {
+  return (kernel == kernel_compute_edit_piggyback ||
+          kernel == kernel_compute_linear_piggyback ||
+          kernel == kernel_compute_affine_piggyback ||
+          kernel == kernel_compute_affine2p_piggyback);
+}
+
+/*
+ * Synthetic wavefronts
+ */
+#define KERNEL_BENCHMARK_IN_WAVEFRONTS  7
+#define KERNEL_BENCHMARK_OUT_WAVEFRONTS 5
+typedef struct {
+  wavefront_t in[KERNEL_BENCHMARK_IN_WAVEFRONTS];
+  wavefront_t out[KERNEL_BENCHMARK_OUT_WAVEFRONTS];
+  wavefront_set_t wavefront_set;
+  int lo;
+  int hi;
+} kernel_benchmark_wavefronts_t;
+void kernel_benchmark_wavefronts_init(
+    kernel_benchmark_wavefronts_t* const wavefronts,
+    const int wavefront_length,
+    mm_allocator_t* const mm_allocator) {
+  // Parameters
+  const int lo = -wavefront_length/2;
+  const int hi = lo + wavefront_length - 1;
+  const int wf_elements = WAVEFRONT_LENGTH(lo-1,hi+1);
+  const uint64_t null_threshold = (uint64_t)(parameters.null_rate*(double)UINT32_MAX);
+  uint64_t state = parameters.seed;
+  wavefronts->lo = lo;
+  wavefronts->hi = hi;
+  // Input wavefronts (random offsets around the main diagonal)
+  int i, k;
+  for (i=0;i<KERNEL_BENCHMARK_IN_WAVEFRONTS;++i) {
+    wavefront_t* const wavefront = wavefronts->in + i;
+    wavefront_allocate(wavefront,wf_elements,true,mm_allocator);
+    wavefront_init(wavefront,lo-1,hi+1);
+    wavefront_set_limits(wavefront,lo-1,hi+1);
+    for (k=lo-1;k<=hi+1;++k) {
+      const uint64_t random = kernel_benchmark_rand(&state);
+      const int base = parameters.sequence_length/2;
+      wavefront->offsets[k] = ((random & UINT32_MAX) < null_threshold) ?
+          WAVEFRONT_OFFSET_NULL : base + (int)((random >> 32) % 64);
+      wavefront->bt_pcigar[k] = (pcigar_t)(random >> 16);
+      wavefront->bt_prev[k] = (bt_block_idx_t)(random >> 24);
+    }
+  }
+  // Output wavefronts
+  for (i=0;i<KERNEL_BENCHMARK_OUT_WAVEFRONTS;++i) {
+    wavefront_t* const wavefront = wavefronts->out + i;
+    wavefront_allocate(wavefront,wf_elements,true,mm_allocator);
+    wavefront_init(wavefront,lo-1,hi+1);
+    wavefront_set_limits(wavefront,lo,hi);
+  }
+  // Wavefront set
+  wavefront_set_t* const wavefront_set = &wavefronts->wavefront_set;
+  wavefront_set->in_mwavefront_misms = wavefronts->in + 0;
+  wavefront_set->in_mwavefront_open1 = wavefronts->in + 1;
+  wavefront_set->in_mwavefront_open2 = wavefronts->in + 2;
+  wavefront_set->in_i1wavefront_ext = wavefronts->in + 3;
+  wavefront_set->in_i2wavefront_ext = wavefronts->in + 4;
+  wavefront_set->in_d1wavefront_ext = wavefronts->in + 5;
+  wavefront_set->in_d2wavefront_ext = wavefronts->in + 6;
+  wavefront_set->out_mwavefront = wavefronts->out + 0;
+  wavefront_set->out_i1wavefront = wavefronts->out + 1;
+  wavefront_set->out_i2wavefront = wavefronts->out + 2;
+  wavefront_set->out_d1wavefront = wavefronts->out + 3;
+  wavefront_set->out_d2wavefront = wavefronts->out + 4;
+}
+void kernel_benchmark_wavefronts_free(
+    kernel_benchmark_wavefronts_t* const wavefronts,
+    mm_allocator_t* const mm_allocator) {
+  int i;
+  for (i=0;i<KERNEL_BENCHMARK_IN_WAVEFRONTS;++i) wavefront_free(wavefronts->in+i,mm_allocator);
+  for (i=0;i<KERNEL_BENCHMARK_OUT_WAVEFRONTS;++i) wavefront_free(wavefronts->out+i,mm_allocator);
+}
+uint64_t kernel_benchmark_wavefronts_checksum(
+    kernel_benchmark_wavefronts_t* const wavefronts,
+    const bool piggyback) {
+  uint64_t checksum = 0;
+  int i, k;
+  for (i=0;i<KERNEL_BENCHMARK_OUT_WAVEFRONTS;++i) {
+    wavefront_t* const wavefront = wavefronts->out + i;
+    for (k=wavefronts->lo;k<=wavefronts->hi;++k) {
+      checksum = checksum*31 + (uint32_t)wavefront->offsets[k];
+      if (piggyback) {
+        checksum = checksum*31 + (uint64_t)wavefront->bt_pcigar[k];
+        checksum = checksum*31 + (uint64_t)wavefront->bt_prev[k];
+      }
+    }
+  }
+  return checksum;
+}
+void kernel_benchmark_wavefronts_clear(
+    kernel_benchmark_wavefronts_t* const wavefronts) {
+  int i, k;
+  for (i=0;i<KERNEL_BENCHMARK_OUT_WAVEFRONTS;++i) {
+    wavefront_t* const wavefront = wavefronts->out + i;
+    for (k=wavefronts->lo;k<=wavefronts->hi;++k) {
+      wavefront->offsets[k] = 0;
+      wavefront->bt_pcigar[k] = 0;
+      wavefront->bt_prev[k] = 0;
+    }
+  }
+}
+
+/*
+ * Benchmark compute kernels (synthetic wavefronts)
+ */
+void kernel_benchmark_compute_width(
+    wavefront_aligner_t* const wf_aligner,
+    kernel_benchmark_wavefronts_t* const wavefronts,
+    const int width,
+    kernel_benchmark_report_t* const report) {
+  // Benchmark each kernel for every ISA supported
+  const wavefront_kernels_isa_t isa_supported = wavefront_dispatch_detect_isa();
+  const wavefront_kernels_isa_t isas[] = {wf_kernels_scalar,wf_kernels_avx2,wf_kernels_avx512};
+  const int num_isas = sizeof(isas)/sizeof(wavefront_kernels_isa_t);
+  const int lo = wavefronts->lo, hi = wavefronts->hi;
+  int kernel, i, it;
+  for (kernel=0;kernel<KERNEL_BENCHMARK_NUM_KERNELS;++kernel) {
+    const bool piggyback = kernel_benchmark_kernel_is_piggyback(kernel);
+    uint64_t scalar_ns = 0;
+    uint64_t scalar_checksum = 0;
+    for (i=0;i<num_isas;++i) {
+      if (isas[i] > isa_supported) continue;
+      // Select kernel
+      wavefront_kernels_t kernels;
+      wavefront_dispatch_init(&kernels,isas[i]);
+      kernel_compute_f const compute = kernel_benchmark_get_kernel(&kernels,kernel);
+      if (compute == NULL) continue;
+      // Check (against the scalar kernel)
+      kernel_benchmark_wavefronts_clear(wavefronts);
+      compute(wf_aligner,&wavefronts->wavefront_set,lo,hi);
+      const uint64_t checksum = kernel_benchmark_wavefronts_checksum(wavefronts,piggyback);
+      if (isas[i] == wf_kernels_scalar) scalar_checksum = checksum;
+      // Time
+      profiler_timer_t timer;
+      timer_reset(&timer);
+      timer_start(&timer);
+      for (it=0;it<parameters.iterations;++it) {
+        compute(wf_aligner,&wavefronts->wavefront_set,lo,hi);
+      }
+      timer_stop(&timer);
+      const uint64_t total_ns = timer_get_total_ns(&timer);
+      if (isas[i] == wf_kernels_scalar) scalar_ns = total_ns;
+      // Report
+      kernel_benchmark_record_t record = {
+          .kernel = kernel_benchmark_kernel_name[kernel],
+          .isa = wavefront_dispatch_isa_name(kernels.isa),
+          .length = -1, .error = -1.0, .width = width,
+          .elements = width, .iterations = parameters.iterations, .total_ns = total_ns,
+          .speedup = (double)scalar_ns / (double)MAX(total_ns,1),
+          .check = (checksum == scalar_checksum) ? "OK" : "MISMATCH",
+      };
+      kernel_benchmark_report_record(report,&record);
+    }
+  }
+}
+void kernel_benchmark_compute(
+    wavefront_aligner_t* const wf_aligner,
+    kernel_benchmark_report_t* const report) {
+  // Aligner (provides the sequence bounds to the compute kernels)
+  wf_aligner->sequences.pattern_length = parameters.sequence_length;
+  wf_aligner->sequences.text_length = parameters.sequence_length;
+  // Benchmark each wavefront width
+  mm_allocator_t* const mm_allocator = mm_allocator_new(BUFFER_SIZE_8M);
+  int w;
+  for (w=0;w<parameters.num_widths;++w) {
+    kernel_benchmark_wavefronts_t wavefronts;
+    kernel_benchmark_wavefronts_init(&wavefronts,parameters.widths[w],mm_allocator);
+    kernel_benchmark_compute_width(wf_aligner,&wavefronts,parameters.widths[w],report);
+    kernel_benchmark_wavefronts_free(&wavefronts,mm_allocator);
+  }
+  mm_allocator_delete(mm_allocator);
+}
+
+/*
+ * Benchmark extend kernels
+ *   Every call extends a wavefront of the given width placed on a single
+ *   anti-diagonal of the sequence pair (as the aligner finds it after a
+ *   compute step). Several anti-diagonals along the sequences are cycled.
+ */
+#define KERNEL_BENCHMARK_EXTEND_POSITIONS 16
+typedef enum {
+  kernel_extend_scalar,
+  kernel_extend_avx2,
+  kernel_extend_avx512,
+  kernel_extend_packed2bits_scalar,
+  kernel_extend_packed2bits_avx2,
+  kernel_extend_packed2bits_avx512,
+} kernel_benchmark_extend_t;
+#define KERNEL_BENCHMARK_NUM_EXTEND 6
+typedef struct {
+  profiler_timer_t timer;
+  uint64_t checksum;
+  bool enabled;
+} kernel_benchmark_extend_counters_t;
+void kernel_benchmark_extend_offsets(
+    kernel_benchmark_pair_t* const pair,
+    const int width,
+    wf_offset_t* const init_offsets) {
+  const int lo = -width/2;
+  const int antidiagonal_length = pair->pattern_length + pair->text_length;
+  int p, i;
+  for (p=0;p<KERNEL_BENCHMARK_EXTEND_POSITIONS;++p) {
+    wf_offset_t* const offsets = init_offsets + p*width;
+    const int antidiagonal = (int)(((int64_t)antidiagonal_length*(2*p+1))/(2*KERNEL_BENCHMARK_EXTEND_POSITIONS));
+    for (i=0;i<width;++i) {
+      const int k = lo + i;
+      const int h = (antidiagonal + k) / 2;
+      const int v = h - k;
+      const bool valid = (h >= 0 && v >= 0 && h <= pair->text_length && v <= pair->pattern_length);
+      offsets[i] = (valid) ? h : WAVEFRONT_OFFSET_NULL;
+    }
+  }
+}
+void kernel_benchmark_extend_time(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const wavefront,
+    const wf_offset_t* const init_offsets,
+    const int width,
+    const int iterations,
+    const kernel_benchmark_extend_t kernel,
+    kernel_benchmark_extend_counters_t* const counters) {
+  // Select kernel
+  wavefront_kernels_t kernels;
+  const int lo = -width/2, hi = lo + width - 1;
+  void (*extend)(wavefront_aligner_t* const,wavefront_t* const,const int,const int);
+  switch (kernel) {
+    case kernel_extend_avx2:
+    case kernel_extend_avx512:
+      wavefront_dispatch_init(&kernels,(kernel==kernel_extend_avx2) ? wf_kernels_avx2 : wf_kernels_avx512);
+      extend = kernels.extend_matches_end2end;
+      break;
+    case kernel_extend_packed2bits_avx2:
+    case kernel_extend_packed2bits_avx512:
+      wavefront_dispatch_init(&kernels,(kernel==kernel_extend_packed2bits_avx2) ? wf_kernels_avx2 : wf_kernels_avx512);
+      extend = kernels.extend_matches_packed2bits_end2end;
+      break;
+    case kernel_extend_packed2bits_scalar:
+      extend = wavefront_extend_matches_packed2bits_end2end;
+      break;
+    default:
+      extend = wavefront_extend_matches_packed_end2end;
+      break;
+  }
+  // Time (restoring the input wavefront before each call)
+  int it, k;
+  for (it=0;it<iterations;++it) {
+    const int position = it % KERNEL_BENCHMARK_EXTEND_POSITIONS;
+    memcpy(wavefront->offsets+lo,init_offsets+position*width,width*sizeof(wf_offset_t));
+    timer_start(&counters->timer);
+    extend(wf_aligner,wavefront,lo,hi);
+    timer_stop(&counters->timer);
+    // Checksum (one pass over the positions)
+    if (it < KERNEL_BENCHMARK_EXTEND_POSITIONS) {
+      for (k=lo;k<=hi;++k) counters->checksum = counters->checksum*31 + (uint32_t)wavefront->offsets[k];
+    }
+  }
+}
+void kernel_benchmark_extend_dataset(
+    wavefront_aligner_t* const wf_aligner,
+    kernel_benchmark_dataset_t* const dataset,
+    const int width,
+    mm_allocator_t* const mm_allocator,
+    kernel_benchmark_report_t* const report) {
+  // Parameters
+  const wavefront_kernels_isa_t isa_supported = wavefront_dispatch_detect_isa();
+  const int iterations_per_pair = DIV_CEIL(parameters.iterations,dataset->num_pairs);
+  char* const kernel_names[KERNEL_BENCHMARK_NUM_EXTEND] = {
+      "extend","extend","extend",
+      "extend.packed2bits","extend.packed2bits","extend.packed2bits"};
+  char* const isa_names[KERNEL_BENCHMARK_NUM_EXTEND] = {
+      wavefront_dispatch_isa_name(wf_kernels_scalar),
+      wavefront_dispatch_isa_name(wf_kernels_avx2),
+      wavefront_dispatch_isa_name(wf_kernels_avx512),
+      wavefront_dispatch_isa_name(wf_kernels_scalar),
+      wavefront_dispatch_isa_name(wf_kernels_avx2),
+      wavefront_dispatch_isa_name(wf_kernels_avx512)};
+  // Counters
+  kernel_benchmark_extend_counters_t counters[KERNEL_BENCHMARK_NUM_EXTEND];
+  int i, p;
+  for (i=0;i<KERNEL_BENCHMARK_NUM_EXTEND;++i) {
+    timer_reset(&counters[i].timer);
+    counters[i].checksum = 0;
+  }
+  counters[kernel_extend_scalar].enabled = true;
+  counters[kernel_extend_avx2].enabled = (wf_kernels_avx2 <= isa_supported);
+  counters[kernel_extend_avx512].enabled = (wf_kernels_avx512 <= isa_supported);
+  counters[kernel_extend_packed2bits_scalar].enabled = true;
+  counters[kernel_extend_packed2bits_avx2].enabled = (wf_kernels_avx2 <= isa_supported);
+  counters[kernel_extend_packed2bits_avx512].enabled = (wf_kernels_avx512 <= isa_supported);
+  // Wavefront
+  const int lo = -width/2, hi = lo + width - 1;
+  wavefront_t wavefront;
+  wavefront_allocate(&wavefront,width,false,mm_allocator);
+  wavefront_init(&wavefront,lo,hi);
+  wavefront_set_limits(&wavefront,lo,hi);
+  wf_offset_t* const init_offsets = malloc(KERNEL_BENCHMARK_EXTEND_POSITIONS*width*sizeof(wf_offset_t));
+  // Benchmark each pair
+  for (p=0;p<dataset->num_pairs;++p) {
+    kernel_benchmark_pair_t* const pair = dataset->pairs + p;
+    kernel_benchmark_extend_offsets(pair,width,init_offsets);
+    // ASCII kernels (padded sequences with sentinels)
+    wavefront_sequences_init_ascii(&wf_aligner->sequences,
+        pair->pattern,pair->pattern_length,pair->text,pair->text_length,false);
+    for (i=kernel_extend_scalar;i<=kernel_extend_avx512;++i) {
+      if (!counters[i].enabled) continue;
+      kernel_benchmark_extend_time(wf_aligner,&wavefront,
+          init_offsets,width,iterations_per_pair,i,counters+i);
+    }
+    // 2-bits packed kernels
+    wavefront_sequences_init_packed2bits(&wf_aligner->sequences,
+        pair->pattern_packed,pair->pattern_length,pair->text_packed,pair->text_length,false);
+    for (i=kernel_extend_packed2bits_scalar;i<=kernel_extend_packed2bits_avx512;++i) {
+      if (!counters[i].enabled) continue;
+      kernel_benchmark_extend_time(wf_aligner,&wavefront,
+          init_offsets,width,iterations_per_pair,i,counters+i);
+    }
+  }
+  // Report
+  const uint64_t scalar_ns = timer_get_total_ns(&counters[kernel_extend_scalar].timer);
+  for (i=0;i<KERNEL_BENCHMARK_NUM_EXTEND;++i) {
+    if (!counters[i].enabled) continue;
+    const uint64_t total_ns = timer_get_total_ns(&counters[i].timer);
+    kernel_benchmark_record_t record = {
+        .kernel = kernel_names[i], .isa = isa_names[i],
+        .length = dataset->length, .error = dataset->error, .width = width,
+        .elements = width, .iterations = iterations_per_pair*dataset->num_pairs, .total_ns = total_ns,
+        .speedup = (double)scalar_ns / (double)MAX(total_ns,1),
+        .check = (counters[i].checksum == counters[kernel_extend_scalar].checksum) ? "OK" : "MISMATCH",
+    };
+    kernel_benchmark_report_record(report,&record);
+  }
+  // Free
+  free(init_offsets);
+  wavefront_free(&wavefront,mm_allocator);
+}
+
+/*
+ * Benchmark backtrace, BT-buffer compaction, and CIGAR kernels
+ *   Each pair is aligned once (not timed) and the kernel is timed
+ *   over the resulting wavefronts/BT-buffer/CIGAR
+ */
+typedef struct {
+  profiler_timer_t timer;
+  uint64_t elements;
+  int calls;
+  bool correct;
+} kernel_benchmark_counters_t;
+void kernel_benchmark_counters_init(
+    kernel_benchmark_counters_t* const counters) {
+  timer_reset(&counters->timer);
+  counters->elements = 0;
+  counters->calls = 0;
+  counters->correct = true;
+}
+void kernel_benchmark_counters_report(
+    kernel_benchmark_counters_t* const counters,
+    char* const kernel,
+    kernel_benchmark_dataset_t* const dataset,
+    const bool checked,
+    kernel_benchmark_report_t* const report) {
+  kernel_benchmark_record_t record = {
+      .kernel = kernel, .isa = wavefront_dispatch_isa_name(wf_kernels_scalar),
+      .length = dataset->length, .error = dataset->error, .width = -1,
+      .elements = counters->elements / MAX(counters->calls,1),
+      .iterations = counters->calls,
+      .total_ns = timer_get_total_ns(&counters->timer),
+      .speedup = -1.0,
+      .check = (!checked) ? NULL : (counters->correct) ? "OK" : "FAIL",
+  };
+  kernel_benchmark_report_record(report,&record);
+}
+bool kernel_benchmark_check_cigar(
+    wavefront_aligner_t* const wf_aligner,
+    kernel_benchmark_pair_t* const pair) {
+  return cigar_check_alignment(stderr,
+      pair->pattern,pair->pattern_length,
+      pair->text,pair->text_length,
+      wf_aligner->cigar,false);
+}
+void kernel_benchmark_backtrace_wavefronts(
+    wavefront_aligner_t* const wf_aligner,
+    kernel_benchmark_pair_t* const pair,
+    const int iterations,
+    kernel_benchmark_counters_t* const backtrace,
+    kernel_benchmark_counters_t* const cigar) {
+  // Align (high-memory; keeps all the wavefronts)
+  wavefront_align(wf_aligner,pair->pattern,pair->pattern_length,pair->text,pair->text_length);
+  const int score = wf_aligner->align_status.score;
+  const int k = wf_aligner->alignment_end_pos.k;
+  const wf_offset_t offset = wf_aligner->alignment_end_pos.offset;
+  cigar_t* const cigar_alignment = wf_aligner->cigar;
+  int it;
+  // Backtrace
+  if (parameters.kernels_backtrace) {
+    for (it=0;it<iterations;++it) {
+      timer_start(&backtrace->timer);
+      wavefront_backtrace_affine(wf_aligner,
+          wf_aligner->component_begin,wf_aligner->component_end,score,k,offset);
+      timer_stop(&backtrace->timer);
+    }
+    backtrace->elements += (uint64_t)iterations*(cigar_alignment->end_offset-cigar_alignment->begin_offset);
+    backtrace->calls += iterations;
+    backtrace->correct &= kernel_benchmark_check_cigar(wf_aligner,pair);
+  }
+  // CIGAR (SAM-compliant)
+  if (parameters.kernels_cigar) {
+    uint32_t* cigar_buffer;
+    int cigar_length;
+    for (it=0;it<iterations;++it) {
+      cigar_alignment->cigar_length = 0; // Force recomputing
+      timer_start(&cigar->timer);
+      cigar_get_CIGAR(cigar_alignment,true,&cigar_buffer,&cigar_length);
+      timer_stop(&cigar->timer);
+    }
+    cigar->elements += (uint64_t)iterations*(cigar_alignment->end_offset-cigar_alignment->begin_offset);
+    cigar->calls += iterations;
+  }
+}
+void kernel_benchmark_backtrace_pcigar_call(
+    wavefront_aligner_t* const wf_aligner) {
+  // Fetch wavefront
+  wavefront_components_t* const wf_components = &wf_aligner->wf_components;
+  const int score = wf_aligner->align_status.score;
+  const int k = wf_aligner->alignment_end_pos.k;
+  const int score_mod = (wf_components->memory_modular) ? score % wf_components->max_score_scope : score;
+  wavefront_t* const mwavefront = wf_components->mwavefronts[score_mod];
+  // Backtrace alignment from buffer (unpacking pcigar)
+  wavefront_backtrace_pcigar(wf_aligner,k,wf_aligner->alignment_end_pos.offset,
+      mwavefront->bt_pcigar[k],mwavefront->bt_prev[k]);
+}
+void kernel_benchmark_backtrace_btbuffer(
+    wavefront_aligner_t* const wf_aligner,
+    kernel_benchmark_pair_t* const pair,
+    const int iterations,
+    kernel_benchmark_counters_t* const backtrace,
+    kernel_benchmark_counters_t* const compact) {
+  // Align (medium-memory; piggybacks the backtrace into the BT-buffer)
+  wavefront_align(wf_aligner,pair->pattern,pair->pattern_length,pair->text,pair->text_length);
+  cigar_t* const cigar_alignment = wf_aligner->cigar;
+  int it;
+  // Backtrace
+  if (parameters.kernels_backtrace) {
+    for (it=0;it<iterations;++it) {
+      timer_start(&backtrace->timer);
+      kernel_benchmark_backtrace_pcigar_call(wf_aligner);
+      timer_stop(&backtrace->timer);
+    }
+    backtrace->elements += (uint64_t)iterations*(cigar_alignment->end_offset-cigar_alignment->begin_offset);
+    backtrace->calls += iterations;
+    backtrace->correct &= kernel_benchmark_check_cigar(wf_aligner,pair);
+  }
+  // Compaction (once per alignment; then checks the compacted BT-buffer)
+  if (parameters.kernels_compact) {
+    wavefront_components_t* const wf_components = &wf_aligner->wf_components;
+    compact->elements += wf_backtrace_buffer_get_used(wf_components->bt_buffer);
+    compact->calls += 1;
+    timer_start(&compact->timer);
+    wavefront_components_compact_bt_buffer(wf_components,
+        wf_aligner->align_status.score,wf_aligner->system.max_num_threads,0);
+    timer_stop(&compact->timer);
+    kernel_benchmark_backtrace_pcigar_call(wf_aligner);
+    compact->correct &= kernel_benchmark_check_cigar(wf_aligner,pair);
+  }
+}
+void kernel_benchmark_alignment_dataset(
+    wavefront_aligner_t* const wf_aligner_high,
+    wavefront_aligner_t* const wf_aligner_med,
+    kernel_benchmark_dataset_t* const dataset,
+    kernel_benchmark_report_t* const report) {
+  // Counters
+  kernel_benchmark_counters_t backtrace_wavefronts, backtrace_btbuffer, compact, cigar;
+  kernel_benchmark_counters_init(&backtrace_wavefronts);
+  kernel_benchmark_counters_init(&backtrace_btbuffer);
+  kernel_benchmark_counters_init(&compact);
+  kernel_benchmark_counters_init(&cigar);
+  // Benchmark each pair
+  const int iterations_per_pair = DIV_CEIL(parameters.iterations,dataset->num_pairs);
+  int p;
+  for (p=0;p<dataset->num_pairs;++p) {
+    kernel_benchmark_pair_t* const pair = dataset->pairs + p;
+    if (parameters.kernels_backtrace || parameters.kernels_cigar) {
+      kernel_benchmark_backtrace_wavefronts(wf_aligner_high,
+          pair,iterations_per_pair,&backtrace_wavefronts,&cigar);
+    }
+    if (parameters.kernels_backtrace || parameters.kernels_compact) {
+      kernel_benchmark_backtrace_btbuffer(wf_aligner_med,
+          pair,iterations_per_pair,&backtrace_btbuffer,&compact);
+    }
+  }
+  // Report
+  if (parameters.kernels_backtrace) {
+    kernel_benchmark_counters_report(&backtrace_wavefronts,"backtrace.wavefronts",dataset,true,report);
+    kernel_benchmark_counters_report(&backtrace_btbuffer,"backtrace.btbuffer",dataset,true,report);
+  }
+  if (parameters.kernels_compact) {
+    kernel_benchmark_counters_report(&compact,"compact.btbuffer",dataset,true,report);
+  }
+  if (parameters.kernels_cigar) {
+    kernel_benchmark_counters_report(&cigar,"cigar.get_CIGAR",dataset,false,report);
+  }
+}
+
+/*
+ * Benchmark dataset grid (lengths x errors [x widths])
+ */
+void kernel_benchmark_grid(
+    wavefront_aligner_t* const wf_aligner,
+    kernel_benchmark_report_t* const report) {
+  // Aligners (exact gap-affine; high- and medium-memory)
+  wavefront_aligner_attr_t attributes = wavefront_aligner_attr_default;
+  attributes.distance_metric = gap_affine;
+  attributes.heuristic.strategy = wf_heuristic_none;
+  attributes.system.max_memory_resident = UINT64_MAX; // Keep wavefronts after aligning
+  attributes.memory_mode = wavefront_memory_high;
+  wavefront_aligner_t* const wf_aligner_high = wavefront_aligner_new(&attributes);
+  attributes.memory_mode = wavefront_memory_med;
+  wavefront_aligner_t* const wf_aligner_med = wavefront_aligner_new(&attributes);
+  mm_allocator_t* const mm_allocator = mm_allocator_new(BUFFER_SIZE_8M);
+  // Benchmark each grid point
+  const bool kernels_alignment =
+      parameters.kernels_backtrace || parameters.kernels_compact || parameters.kernels_cigar;
+  int l, e, w;
+  for (l=0;l<parameters.num_lengths;++l) {
+    for (e=0;e<parameters.num_errors;++e) {
+      // Generate dataset (one seed per grid point)
+      kernel_benchmark_dataset_t dataset;
+      kernel_benchmark_dataset_generate(&dataset,
+          parameters.lengths[l],parameters.errors[e],parameters.num_pairs,
+          parameters.seed + (uint64_t)(l*parameters.num_errors + e));
+      // Extend kernels
+      if (parameters.kernels_extend) {
+        for (w=0;w<parameters.num_widths;++w) {
+          kernel_benchmark_extend_dataset(wf_aligner,&dataset,parameters.widths[w],mm_allocator,report);
+        }
+      }
+      // Backtrace/Compaction/CIGAR kernels
+      if (kernels_alignment) {
+        kernel_benchmark_alignment_dataset(wf_aligner_high,wf_aligner_med,&dataset,report);
+      }
+      kernel_benchmark_dataset_free(&dataset);
+    }
+  }
+  // Free
+  mm_allocator_delete(mm_allocator);
+  wavefront_aligner_delete(wf_aligner_med);
+  wavefront_aligner_delete(wf_aligner_high);
+}
+
+/*
+ * Menu
+ */
+void usage() {
+  fprintf(stderr,
+      "USE: ./kernel_benchmark [OPTIONS]                                    \n"
+      "      Options:                                                       \n"
+      "        [Kernels]                                                    \n"
+      "          --kernels|k <kernel,...>        (default=all)              \n"
+      "            [compute|extend|backtrace|compact|cigar|all]             \n"
+      "        [Grid]                                                       \n"
+      "          --lengths|l <integer,...>       (default=100,1000,10000)   \n"
+      "          --errors|e <float,...>          (default=0.01,0.05,0.10)   \n"
+      "          --widths|w <integer,...>        (default=100,1000,10000)   \n"
+      "          --pairs|p <integer>             (default=10)               \n"
+      "          --sequence-length <integer>     (default=100000)           \n"
+      "          --null-rate <float>             (default=0.10)             \n"
+      "          --seed <integer>                (default=42)               \n"
+      "        [Timing]                                                     \n"
+      "          --iterations|n <integer>        (default=1000)             \n"
+      "        [Output]                                                     \n"
+      "          --output|o <File>               (default=stdout)           \n"
+      "          --output-format <format>        (default=table)            \n"
+      "            [table|csv|json]                                         \n"
+      "          --help|h                                                   \n");
+}
+int parse_list_int(
+    char* const list,
+    int* const values) {
+  int num_values = 0;
+  char* token = strtok(list,",");
+  while (token != NULL && num_values < KERNEL_BENCHMARK_MAX_GRID) {
+    values[num_values++] = atoi(token);
+    token = strtok(NULL,",");
+  }
+  return num_values;
+}
+int parse_list_float(
+    char* const list,
+    float* const values) {
+  int num_values = 0;
+  char* token = strtok(list,",");
+  while (token != NULL && num_values < KERNEL_BENCHMARK_MAX_GRID) {
+    values[num_values++] = atof(token);
+    token = strtok(NULL,",");
+  }
+  return num_values;
+}
+void parse_kernels(
+    char* const list) {
+  parameters.kernels_compute = false;
+  parameters.kernels_extend = false;
+  parameters.kernels_backtrace = false;
+  parameters.kernels_compact = false;
+  parameters.kernels_cigar = false;
+  char* token = strtok(list,",");
+  while (token != NULL) {
+    if (strcmp(token,"compute")==0) {
+      parameters.kernels_compute = true;
+    } else if (strcmp(token,"extend")==0) {
+      parameters.kernels_extend = true;
+    } else if (strcmp(token,"backtrace")==0) {
+      parameters.kernels_backtrace = true;
+    } else if (strcmp(token,"compact")==0) {
+      parameters.kernels_compact = true;
+    } else if (strcmp(token,"cigar")==0) {
+      parameters.kernels_cigar = true;
+    } else if (strcmp(token,"all")==0) {
+      parameters.kernels_compute = true;
+      parameters.kernels_extend = true;
+      parameters.kernels_backtrace = true;
+      parameters.kernels_compact = true;
+      parameters.kernels_cigar = true;
+    } else {
+      fprintf(stderr,"Option '--kernels' must be in {'compute','extend','backtrace','compact','cigar','all'}\n");
+      exit(1);
+    }
+    token = strtok(NULL,",");
+  }
+}
+void parse_arguments(
+    int argc,
+    char** argv) {
+  struct option long_options[] = {
+    /* Kernels */
+    { "kernels", required_argument, 0, 'k' },
+    /* Grid */
+    { "lengths", required_argument, 0, 'l' },
+    { "errors", required_argument, 0, 'e' },
+    { "widths", required_argument, 0, 'w' },
+    { "pairs", required_argument, 0, 'p' },
+    { "sequence-length", required_argument, 0, 1000 },
+    { "null-rate", required_argument, 0, 1001 },
+    { "seed", required_argument, 0, 1002 },
+    /* Timing */
+    { "iterations", required_argument, 0, 'n' },
+    /* Output */
+    { "output", required_argument, 0, 'o' },
+    { "output-format", required_argument, 0, 1003 },
+    { "help", no_argument, 0, 'h' },
+    { 0, 0, 0, 0 } };
+  int c,option_index;
+  while (1) {
+    c=getopt_long(argc,argv,"k:l:e:w:p:n:o:h",long_options,&option_index);
+    if (c==-1) break;
+    switch (c) {
+      /* Kernels */
+      case 'k': parse_kernels(optarg); break;
+      /* Grid */
+      case 'l': parameters.num_lengths = parse_list_int(optarg,parameters.lengths); break;
+      case 'e': parameters.num_errors = parse_list_float(optarg,parameters.errors); break;
+      case 'w': parameters.num_widths = parse_list_int(optarg,parameters.widths); break;
+      case 'p': parameters.num_pairs = atoi(optarg); break;
+      case 1000: parameters.sequence_length = atoi(optarg); break;
+      case 1001: parameters.null_rate = atof(optarg); break;
+      case 1002: parameters.seed = strtoull(optarg,NULL,10); break;
+      /* Timing */
+      case 'n': parameters.iterations = atoi(optarg); break;
+      /* Output */
+      case 'o': parameters.output_filename = optarg; break;
+      case 1003:
+        if (strcmp(optarg,"table")==0) {
+          parameters.output_format = kernel_benchmark_format_table;
+        } else if (strcmp(optarg,"csv")==0) {
+          parameters.output_format = kernel_benchmark_format_csv;
+        } else if (strcmp(optarg,"json")==0) {
+          parameters.output_format = kernel_benchmark_format_json;
+        } else {
+          fprintf(stderr,"Option '--output-format' must be in {'table','csv','json'}\n");
+          exit(1);
+        }
+        break;
+      case 'h': usage(); exit(1);
+      default:
+        fprintf(stderr,"Option not recognized \n");
+        exit(1);
+    }
+  }
+  // Check
+  if (parameters.iterations <= 0 || parameters.num_pairs <= 0 ||
+      parameters.sequence_length <= 0 || parameters.seed == 0) {
+    fprintf(stderr,"Option error: iterations, pairs, sequence-length and seed must be positive\n");
+    exit(1);
+  }
+  int i;
+  for (i=0;i<parameters.num_lengths;++i) {
+    if (parameters.lengths[i] <= 0) {
+      fprintf(stderr,"Option error: lengths must be positive\n");
+      exit(1);
+    }
+  }
+  for (i=0;i<parameters.num_errors;++i) {
+    if (parameters.errors[i] < 0.0) {
+      fprintf(stderr,"Option error: errors must be non-negative\n");
+      exit(1);
+    }
+  }
+  for (i=0;i<parameters.num_widths;++i) {
+    if (parameters.widths[i] <= 0) {
+      fprintf(stderr,"Option error: widths must be positive\n");
+      exit(1);
+    }
+  }
+}
+int main(int argc,char* argv[]) {
+  // Parsing command-line options
+  parse_arguments(argc,argv);
+  // Output
+  FILE* const output_file = (parameters.output_filename == NULL) ?
+      stdout : fopen(parameters.output_filename,"w");
+  if (output_file == NULL) {
+    fprintf(stderr,"Error opening output file '%s'\n",parameters.output_filename);
+    exit(1);
+  }
+  kernel_benchmark_report_t report;
+  kernel_benchmark_report_begin(&report,output_file,parameters.output_format);
+  // Aligner (provides the sequences and their bounds to the kernels)
+  wavefront_aligner_attr_t attributes = wavefront_aligner_attr_default;
+  attributes.distance_metric = gap_affine_2p;
+  wavefront_aligner_t* const wf_aligner = wavefront_aligner_new(&attributes);
+  // Benchmark
+  if (parameters.kernels_compute) {
+    kernel_benchmark_compute(wf_aligner,&report);
+  }
+  if (parameters.kernels_extend || parameters.kernels_backtrace ||
+      parameters.kernels_compact || parameters.kernels_cigar) {
+    kernel_benchmark_grid(wf_aligner,&report);
+  }
+  // Free
+  kernel_benchmark_report_end(&report);
+  if (parameters.output_filename != NULL) fclose(output_file);
+  wavefront_aligner_delete(wf_aligner);
+  return 0;
+}
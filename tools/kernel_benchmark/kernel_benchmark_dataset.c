@@ -0,0 +1,182 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignment Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignment Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignment Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: In-process dataset generation for the kernel benchmark
+ *   (same error model as tools/generate_dataset, but seeded and reproducible)
+ */
+
+#include "kernel_benchmark_dataset.h"
+
+/*
+ * DNA Alphabet
+ */
+#define KERNEL_BENCHMARK_ALPHABET_SIZE 4
+char kernel_benchmark_alphabet[] = {
+    'A','C','G','T'
+};
+
+/*
+ * Random number generator
+ */
+uint64_t kernel_benchmark_rand(
+    uint64_t* const state) {
+  // xorshift64*
+  uint64_t x = *state;
+  x ^= x >> 12; x ^= x << 25; x ^= x >> 27;
+  *state = x;
+  return x * 0x2545F4914F6CDD1Dull;
+}
+uint64_t kernel_benchmark_rand_iid(
+    uint64_t* const state,
+    const uint64_t min,
+    const uint64_t max) {
+  // Sample [min,max) (high bits have the best quality)
+  return min + ((kernel_benchmark_rand(state) >> 11) % (max - min));
+}
+/*
+ * Sequence errors generation (mismatch/deletion/insertion)
+ */
+void kernel_benchmark_dataset_mismatch(
+    char* const sequence,
+    const int sequence_length,
+    uint64_t* const state) {
+  // Generate random mismatch
+  char character;
+  int position;
+  do {
+    position = kernel_benchmark_rand_iid(state,0,sequence_length);
+    character = kernel_benchmark_alphabet[kernel_benchmark_rand_iid(state,0,KERNEL_BENCHMARK_ALPHABET_SIZE)];
+  } while (sequence[position] == character);
+  sequence[position] = character;
+}
+void kernel_benchmark_dataset_deletion(
+    char* const sequence,
+    int* const sequence_length,
+    uint64_t* const state) {
+  // Generate random deletion
+  const int position = kernel_benchmark_rand_iid(state,0,*sequence_length);
+  memmove(sequence+position,sequence+position+1,*sequence_length-position-1);
+  *sequence_length -= 1;
+}
+void kernel_benchmark_dataset_insertion(
+    char* const sequence,
+    int* const sequence_length,
+    uint64_t* const state) {
+  // Generate random insertion
+  const int position = kernel_benchmark_rand_iid(state,0,*sequence_length);
+  memmove(sequence+position+1,sequence+position,*sequence_length-position);
+  sequence[position] = kernel_benchmark_alphabet[kernel_benchmark_rand_iid(state,0,KERNEL_BENCHMARK_ALPHABET_SIZE)];
+  *sequence_length += 1;
+}
+int kernel_benchmark_dataset_errors(
+    char* const sequence,
+    const int sequence_length,
+    const int num_errors,
+    uint64_t* const state) {
+  int length = sequence_length;
+  // Generate random errors
+  int i;
+  for (i=0;i<num_errors;++i) {
+    switch (kernel_benchmark_rand_iid(state,0,3)) {
+      case 0: kernel_benchmark_dataset_mismatch(sequence,length,state); break;
+      case 1: if (length > 1) kernel_benchmark_dataset_deletion(sequence,&length,state); break;
+      default: kernel_benchmark_dataset_insertion(sequence,&length,state); break;
+    }
+  }
+  // Close sequence and return length
+  sequence[length] = '\0';
+  return length;
+}
+/*
+ * 2-bits packing (first base in the lowest bits)
+ */
+uint8_t* kernel_benchmark_dataset_pack2bits(
+    const char* const sequence,
+    const int sequence_length) {
+  uint8_t* const packed = calloc(DIV_CEIL(sequence_length,4),1);
+  int i;
+  for (i=0;i<sequence_length;++i) {
+    uint8_t base;
+    switch (sequence[i]) {
+      case 'A': base = 0; break;
+      case 'C': base = 1; break;
+      case 'G': base = 2; break;
+      default:  base = 3; break;
+    }
+    packed[i>>2] |= (uint8_t)(base << ((i&3)<<1));
+  }
+  return packed;
+}
+/*
+ * Setup
+ */
+void kernel_benchmark_dataset_generate(
+    kernel_benchmark_dataset_t* const dataset,
+    const int length,
+    const float error,
+    const int num_pairs,
+    const uint64_t seed) {
+  // Parameters
+  const int num_errors = (error >= 1.0) ? (int)error : (int)ceil((float)length * error);
+  uint64_t state = seed;
+  dataset->length = length;
+  dataset->error = error;
+  dataset->num_pairs = num_pairs;
+  dataset->pairs = malloc(num_pairs*sizeof(kernel_benchmark_pair_t));
+  // Generate pairs
+  int i, j;
+  for (i=0;i<num_pairs;++i) {
+    kernel_benchmark_pair_t* const pair = dataset->pairs + i;
+    // Generate random text
+    pair->text = malloc(length+1);
+    for (j=0;j<length;++j) {
+      pair->text[j] = kernel_benchmark_alphabet[kernel_benchmark_rand_iid(&state,0,KERNEL_BENCHMARK_ALPHABET_SIZE)];
+    }
+    pair->text[length] = '\0';
+    pair->text_length = length;
+    // Generate pattern (text with errors)
+    pair->pattern = malloc(length+num_errors+1);
+    memcpy(pair->pattern,pair->text,length);
+    pair->pattern_length = kernel_benchmark_dataset_errors(pair->pattern,length,num_errors,&state);
+    // Pack sequences
+    pair->pattern_packed = kernel_benchmark_dataset_pack2bits(pair->pattern,pair->pattern_length);
+    pair->text_packed = kernel_benchmark_dataset_pack2bits(pair->text,pair->text_length);
+  }
+}
+void kernel_benchmark_dataset_free(
+    kernel_benchmark_dataset_t* const dataset) {
+  int i;
+  for (i=0;i<dataset->num_pairs;++i) {
+    kernel_benchmark_pair_t* const pair = dataset->pairs + i;
+    free(pair->pattern);
+    free(pair->text);
+    free(pair->pattern_packed);
+    free(pair->text_packed);
+  }
+  free(dataset->pairs);
+}
@@ -0,0 +1,80 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignment Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignment Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignment Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: In-process dataset generation for the kernel benchmark
+ *   (same error model as tools/generate_dataset, but seeded and reproducible)
+ */
+
+#ifndef KERNEL_BENCHMARK_DATASET_H_
+#define KERNEL_BENCHMARK_DATASET_H_
+
+#include "utils/commons.h"
+
+/*
+ * Random number generator (xorshift64*)
+ */
+uint64_t kernel_benchmark_rand(
+    uint64_t* const state);
+uint64_t kernel_benchmark_rand_iid(
+    uint64_t* const state,
+    const uint64_t min,
+    const uint64_t max);
+
+/*
+ * Dataset (sequence pairs of a given length & error rate)
+ */
+typedef struct {
+  char* pattern;              // Pattern (text with errors)
+  int pattern_length;         // Pattern length
+  char* text;                 // Text (random sequence)
+  int text_length;            // Text length
+  uint8_t* pattern_packed;    // Pattern (2-bits packed)
+  uint8_t* text_packed;       // Text (2-bits packed)
+} kernel_benchmark_pair_t;
+typedef struct {
+  // Parameters
+  int length;                 // Text length
+  float error;                // Errors (mismatch/insertion/deletion) as a fraction of the length
+  // Pairs
+  kernel_benchmark_pair_t* pairs;
+  int num_pairs;
+} kernel_benchmark_dataset_t;
+
+/*
+ * Setup
+ */
+void kernel_benchmark_dataset_generate(
+    kernel_benchmark_dataset_t* const dataset,
+    const int length,
+    const float error,
+    const int num_pairs,
+    const uint64_t seed);
+void kernel_benchmark_dataset_free(
+    kernel_benchmark_dataset_t* const dataset);
+
+#endif /* KERNEL_BENCHMARK_DATASET_H_ */
@@ -0,0 +1,133 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignment Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignment Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignment Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: Kernel benchmark report (human-readable table, CSV, or JSON)
+ */
+
+#include "kernel_benchmark_report.h"
+
+/*
+ * Accessors
+ */
+double kernel_benchmark_record_get_ns_per_element(
+    const kernel_benchmark_record_t* const record) {
+  const double total_elements = (double)record->iterations * (double)record->elements;
+  return (total_elements > 0.0) ? (double)record->total_ns / total_elements : 0.0;
+}
+
+/*
+ * Report
+ */
+void kernel_benchmark_report_begin(
+    kernel_benchmark_report_t* const report,
+    FILE* const stream,
+    const kernel_benchmark_format_t format) {
+  report->stream = stream;
+  report->format = format;
+  report->num_records = 0;
+  switch (format) {
+    case kernel_benchmark_format_table:
+      fprintf(stream,"%-28s %-8s %8s %6s %8s %10s %8s %14s %9s %s\n",
+          "Kernel","ISA","Length","Error","Width","Elements","Calls","ns/element","Speedup","Check");
+      break;
+    case kernel_benchmark_format_csv:
+      fprintf(stream,"kernel,isa,length,error,width,elements,iterations,total_ns,ns_per_element,speedup,check\n");
+      break;
+    case kernel_benchmark_format_json:
+      fprintf(stream,"[");
+      break;
+  }
+}
+void kernel_benchmark_report_record_table(
+    kernel_benchmark_report_t* const report,
+    const kernel_benchmark_record_t* const record) {
+  FILE* const stream = report->stream;
+  fprintf(stream,"%-28s %-8s ",record->kernel,record->isa);
+  if (record->length >= 0) fprintf(stream,"%8d ",record->length); else fprintf(stream,"%8s ","-");
+  if (record->error >= 0.0) fprintf(stream,"%6.3f ",record->error); else fprintf(stream,"%6s ","-");
+  if (record->width >= 0) fprintf(stream,"%8d ",record->width); else fprintf(stream,"%8s ","-");
+  fprintf(stream,"%10" PRIu64 " %8d %14.4f ",
+      record->elements,record->iterations,
+      kernel_benchmark_record_get_ns_per_element(record));
+  if (record->speedup >= 0.0) fprintf(stream,"%8.2fx ",record->speedup); else fprintf(stream,"%9s ","-");
+  fprintf(stream,"%s\n",(record->check!=NULL) ? record->check : "-");
+}
+void kernel_benchmark_report_record_csv(
+    kernel_benchmark_report_t* const report,
+    const kernel_benchmark_record_t* const record) {
+  FILE* const stream = report->stream;
+  fprintf(stream,"%s,%s,",record->kernel,record->isa);
+  if (record->length >= 0) fprintf(stream,"%d",record->length);
+  fprintf(stream,",");
+  if (record->error >= 0.0) fprintf(stream,"%g",record->error);
+  fprintf(stream,",");
+  if (record->width >= 0) fprintf(stream,"%d",record->width);
+  fprintf(stream,",%" PRIu64 ",%d,%" PRIu64 ",%.4f,",
+      record->elements,record->iterations,record->total_ns,
+      kernel_benchmark_record_get_ns_per_element(record));
+  if (record->speedup >= 0.0) fprintf(stream,"%.4f",record->speedup);
+  fprintf(stream,",%s\n",(record->check!=NULL) ? record->check : "");
+}
+void kernel_benchmark_report_record_json(
+    kernel_benchmark_report_t* const report,
+    const kernel_benchmark_record_t* const record) {
+  FILE* const stream = report->stream;
+  fprintf(stream,"%s\n  {\"kernel\":\"%s\",\"isa\":\"%s\",",
+      (report->num_records > 0) ? "," : "",record->kernel,record->isa);
+  if (record->length >= 0) fprintf(stream,"\"length\":%d,",record->length);
+  else fprintf(stream,"\"length\":null,");
+  if (record->error >= 0.0) fprintf(stream,"\"error\":%g,",record->error);
+  else fprintf(stream,"\"error\":null,");
+  if (record->width >= 0) fprintf(stream,"\"width\":%d,",record->width);
+  else fprintf(stream,"\"width\":null,");
+  fprintf(stream,"\"elements\":%" PRIu64 ",\"iterations\":%d,\"total_ns\":%" PRIu64 ",\"ns_per_element\":%.4f,",
+      record->elements,record->iterations,record->total_ns,
+      kernel_benchmark_record_get_ns_per_element(record));
+  if (record->speedup >= 0.0) fprintf(stream,"\"speedup\":%.4f,",record->speedup);
+  else fprintf(stream,"\"speedup\":null,");
+  if (record->check != NULL) fprintf(stream,"\"check\":\"%s\"}",record->check);
+  else fprintf(stream,"\"check\":null}");
+}
+void kernel_benchmark_report_record(
+    kernel_benchmark_report_t* const report,
+    const kernel_benchmark_record_t* const record) {
+  switch (report->format) {
+    case kernel_benchmark_format_table: kernel_benchmark_report_record_table(report,record); break;
+    case kernel_benchmark_format_csv: kernel_benchmark_report_record_csv(report,record); break;
+    case kernel_benchmark_format_json: kernel_benchmark_report_record_json(report,record); break;
+  }
+  ++(report->num_records);
+  fflush(report->stream);
+}
+void kernel_benchmark_report_end(
+    kernel_benchmark_report_t* const report) {
+  if (report->format == kernel_benchmark_format_json) {
+    fprintf(report->stream,"\n]\n");
+  }
+  fflush(report->stream);
+}
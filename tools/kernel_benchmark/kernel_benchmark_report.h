@@ -0,0 +1,89 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignment Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignment Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignment Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: Kernel benchmark report (human-readable table, CSV, or JSON)
+ */
+
+#ifndef KERNEL_BENCHMARK_REPORT_H_
+#define KERNEL_BENCHMARK_REPORT_H_
+
+#include "utils/commons.h"
+
+/*
+ * Report record (one per kernel, ISA, and grid point)
+ */
+typedef struct {
+  // Kernel
+  char* kernel;               // Kernel name
+  char* isa;                  // Implementation (ISA)
+  // Grid point (negative if not applicable)
+  int length;                 // Sequence length
+  float error;                // Error rate
+  int width;                  // Wavefront width (diagonals)
+  // Measures
+  uint64_t elements;          // Elements processed per call (diagonals, operations, or blocks)
+  int iterations;             // Calls timed
+  uint64_t total_ns;          // Total time of all the calls timed
+  double speedup;             // Speedup over the scalar kernel (negative if not applicable)
+  char* check;                // Check against the reference kernel (NULL if not applicable)
+} kernel_benchmark_record_t;
+
+/*
+ * Report
+ */
+typedef enum {
+  kernel_benchmark_format_table,
+  kernel_benchmark_format_csv,
+  kernel_benchmark_format_json,
+} kernel_benchmark_format_t;
+typedef struct {
+  FILE* stream;                       // Output stream
+  kernel_benchmark_format_t format;   // Output format
+  int num_records;                    // Records reported
+} kernel_benchmark_report_t;
+
+/*
+ * Report
+ */
+void kernel_benchmark_report_begin(
+    kernel_benchmark_report_t* const report,
+    FILE* const stream,
+    const kernel_benchmark_format_t format);
+void kernel_benchmark_report_record(
+    kernel_benchmark_report_t* const report,
+    const kernel_benchmark_record_t* const record);
+void kernel_benchmark_report_end(
+    kernel_benchmark_report_t* const report);
+
+/*
+ * Accessors
+ */
+double kernel_benchmark_record_get_ns_per_element(
+    const kernel_benchmark_record_t* const record);
+
+#endif /* KERNEL_BENCHMARK_REPORT_H_ */
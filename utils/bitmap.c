@@ -33,6 +33,10 @@
 #include "utils/bitmap.h"
 #include "system/mm_allocator.h"
 
+#ifdef WFA_PARALLEL
+#include <omp.h>
+#endif
+
 /*
  * Setup
  */
@@ -111,6 +115,40 @@ void bitmap_update_counters(
     acc_count += POPCOUNT_64(bitmap_block->bitmap);
   }
 }
+#ifdef WFA_PARALLEL
+void bitmap_update_counters_parallel(
+    bitmap_t* const bitmap,
+    const int num_threads) {
+  // Parameters
+  const uint64_t num_blocks = bitmap->num_blocks;
+  uint64_t* const thread_counts = mm_allocator_calloc(bitmap->mm_allocator,num_threads,uint64_t,false);
+  // Prefix-sum (popcount per thread range, then scan over the threads' totals)
+  #pragma omp parallel num_threads(num_threads)
+  {
+    const int thread_id = omp_get_thread_num();
+    const int range_threads = omp_get_num_threads();
+    const uint64_t block_begin = (num_blocks*thread_id) / range_threads;
+    const uint64_t block_end = (num_blocks*(thread_id+1)) / range_threads;
+    // Count
+    uint64_t count = 0, i;
+    for (i=block_begin;i<block_end;++i) {
+      count += POPCOUNT_64(bitmap->bitmap_blocks[i].bitmap);
+    }
+    thread_counts[thread_id] = count;
+    #pragma omp barrier
+    // Update counters
+    uint64_t acc_count = 0;
+    int t;
+    for (t=0;t<thread_id;++t) acc_count += thread_counts[t];
+    bitmap_block_t* bitmap_block = bitmap->bitmap_blocks + block_begin;
+    for (i=block_begin;i<block_end;++i,++bitmap_block) {
+      bitmap_block->counter = acc_count;
+      acc_count += POPCOUNT_64(bitmap_block->bitmap);
+    }
+  }
+  mm_allocator_free(bitmap->mm_allocator,thread_counts);
+}
+#endif
 uint64_t bitmap_erank(
     bitmap_t* const bitmap,
     const uint64_t position) {
@@ -98,6 +98,11 @@ bool bitmap_check__set(
  */
 void bitmap_update_counters(
     bitmap_t* const bitmap);
+#ifdef WFA_PARALLEL
+void bitmap_update_counters_parallel(
+    bitmap_t* const bitmap,
+    const int num_threads);
+#endif
 uint64_t bitmap_erank(
     bitmap_t* const bitmap,
     const uint64_t pos);
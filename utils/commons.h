@@ -245,6 +245,17 @@ uint64_t nominal_prop_u64(const uint64_t base,const double factor);
 #define FORCE_INLINE __attribute__((always_inline)) inline
 #define FORCE_NO_INLINE __attribute__ ((noinline))
 
+/*
+ * Target ISA (functions compiled for a specific ISA, selected at runtime)
+ */
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+  #define TARGET_X86 1
+  #define TARGET_AVX2 __attribute__((target("avx2")))
+  #define TARGET_AVX512 __attribute__((target("avx2,avx512f,avx512cd,avx512vl,avx512bw")))
+#else
+  #define TARGET_X86 0
+#endif
+
 /*
  * Vectorize
  */
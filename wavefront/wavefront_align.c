@@ -33,6 +33,8 @@
 #include "wavefront_align.h"
 #include "wavefront_unialign.h"
 #include "wavefront_bialign.h"
+#include "wavefront_prefilter.h"
+#include "wavefront_bpm.h"
 #include "wavefront_compute.h"
 #include "wavefront_compute_edit.h"
 #include "wavefront_compute_linear.h"
@@ -79,6 +81,10 @@ void wavefront_align_presets__checks(
       exit(1);
     }
   }
+  if (wf_aligner->system.bt_spill_path != NULL && wf_aligner->system.bt_compress) {
+    fprintf(stderr,"[WFA] BT-buffer spilling and compression cannot be enabled together\n");
+    exit(1);
+  }
   const distance_metric_t distance_metric = wf_aligner->penalties.distance_metric;
   const bool is_heuristic_drop =
       (wf_aligner->heuristic.strategy & wf_heuristic_xdrop) ||
@@ -101,6 +107,17 @@ void wavefront_align_presets__checks(
     }
   }
 }
+bool wavefront_align_offsets__exceeded(
+    wavefront_aligner_t* const wf_aligner,
+    const int pattern_length,
+    const int text_length) {
+  // Check offsets range (i.e., 16-bit offsets build)
+  if (pattern_length+text_length <= WAVEFRONT_OFFSET_MAX_LENGTH) return false;
+  // Too long (no wavefront computed)
+  cigar_clear(wf_aligner->cigar);
+  wf_aligner->align_status.status = WF_STATUS_SEQUENCE_TOO_LONG;
+  return true;
+}
 /*
  * Wavefront Alignment Unidirectional
  */
@@ -134,6 +151,26 @@ void wavefront_align_unidirectional(
   if (wf_aligner->align_status.status == WF_STATUS_MAX_STEPS_REACHED) return; // Alignment paused
   wavefront_align_unidirectional_cleanup(wf_aligner);
 }
+/*
+ * Wavefront Alignment Hybrid (WFA until the break-even score, then BPM)
+ */
+void wavefront_align_hybrid(
+    wavefront_aligner_t* const wf_aligner,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length,
+    const int bpm_switch_score) {
+  // Align using WFA up to the break-even score
+  const int max_score = wf_aligner->system.max_score;
+  wf_aligner->system.max_score = bpm_switch_score;
+  wavefront_align_unidirectional(wf_aligner);
+  wf_aligner->system.max_score = max_score;
+  // High divergence (switch to BPM, knowing the distance is beyond the break-even score)
+  if (wf_aligner->align_status.status == WF_STATUS_MAX_SCORE_REACHED) {
+    wavefront_bpm_align(wf_aligner,pattern,pattern_length,text,text_length,bpm_switch_score+1);
+  }
+}
 /*
  * Wavefront Alignment Bidirectional
  */
@@ -155,7 +192,15 @@ int wavefront_align_lambda(
     const int text_length) {
   // Checks
   wavefront_align_presets__checks(wf_aligner,pattern_length,text_length);
+  if (wavefront_align_offsets__exceeded(wf_aligner,pattern_length,text_length)) {
+    return WF_STATUS_SEQUENCE_TOO_LONG;
+  }
+  // Prefilter
+  if (wavefront_prefilter_lambda(wf_aligner,pattern_length,text_length)) {
+    return WF_STATUS_FILTERED;
+  }
   wavefront_debug_begin(wf_aligner);
+  wavefront_aligner_stats_begin(wf_aligner);
   // Plot
   if (wf_aligner->plot != NULL) wavefront_plot_resize(wf_aligner->plot,pattern_length,text_length);
   // Dispatcher
@@ -173,7 +218,8 @@ int wavefront_align_lambda(
     // Align
     wavefront_align_bidirectional(wf_aligner);
   }
-  // DEBUG
+  // Stats & DEBUG
+  wavefront_aligner_stats_end(wf_aligner);
   wavefront_debug_end(wf_aligner);
   wavefront_debug_check_correct(wf_aligner);
   // Return
@@ -187,7 +233,15 @@ int wavefront_align_packed2bits(
     const int text_length) {
   // Checks
   wavefront_align_presets__checks(wf_aligner,pattern_length,text_length);
+  if (wavefront_align_offsets__exceeded(wf_aligner,pattern_length,text_length)) {
+    return WF_STATUS_SEQUENCE_TOO_LONG;
+  }
+  // Prefilter
+  if (wavefront_prefilter_packed2bits(wf_aligner,pattern,pattern_length,text,text_length)) {
+    return WF_STATUS_FILTERED;
+  }
   wavefront_debug_begin(wf_aligner);
+  wavefront_aligner_stats_begin(wf_aligner);
   // Plot
   if (wf_aligner->plot != NULL) wavefront_plot_resize(wf_aligner->plot,pattern_length,text_length);
   // Dispatcher
@@ -203,7 +257,8 @@ int wavefront_align_packed2bits(
     // Align
     wavefront_align_bidirectional(wf_aligner);
   }
-  // DEBUG
+  // Stats & DEBUG
+  wavefront_aligner_stats_end(wf_aligner);
   wavefront_debug_end(wf_aligner);
   wavefront_debug_check_correct(wf_aligner);
   // Return
@@ -217,15 +272,33 @@ int wavefront_align(
     const int text_length) {
   // Checks
   wavefront_align_presets__checks(wf_aligner,pattern_length,text_length);
+  if (wavefront_align_offsets__exceeded(wf_aligner,pattern_length,text_length)) {
+    return WF_STATUS_SEQUENCE_TOO_LONG;
+  }
+  // Prefilter
+  if (wavefront_prefilter_ascii(wf_aligner,pattern,pattern_length,text,text_length)) {
+    return WF_STATUS_FILTERED;
+  }
   wavefront_debug_begin(wf_aligner);
+  wavefront_aligner_stats_begin(wf_aligner);
   // Plot
   if (wf_aligner->plot != NULL) wavefront_plot_resize(wf_aligner->plot,pattern_length,text_length);
   // Dispatcher
-  if (wf_aligner->bialigner == NULL) {
+  const int bpm_switch_score = wavefront_bpm_switch_score(
+      wf_aligner,pattern,pattern_length,text,text_length);
+  if (bpm_switch_score == 0) {
+    // Bit-parallel (score-only edit/indel, high divergence predicted)
+    wavefront_bpm_align(wf_aligner,pattern,pattern_length,text,text_length,0);
+  } else if (wf_aligner->bialigner == NULL) {
     // Prepare Sequences
     wavefront_sequences_init_ascii(&wf_aligner->sequences,
         pattern,pattern_length,text,text_length,false);
-    wavefront_align_unidirectional(wf_aligner);
+    // Align
+    if (bpm_switch_score < wf_aligner->system.max_score) {
+      wavefront_align_hybrid(wf_aligner,pattern,pattern_length,text,text_length,bpm_switch_score);
+    } else {
+      wavefront_align_unidirectional(wf_aligner);
+    }
   } else {
     // Prepare Sequences
     wavefront_bialigner_set_sequences_ascii(wf_aligner->bialigner,
@@ -233,12 +306,244 @@ int wavefront_align(
     // Align
     wavefront_align_bidirectional(wf_aligner);
   }
-  // DEBUG
+  // Stats & DEBUG
+  wavefront_aligner_stats_end(wf_aligner);
+  wavefront_debug_end(wf_aligner);
+  wavefront_debug_check_correct(wf_aligner);
+  // Return
+  return wf_aligner->align_status.status;
+}
+/*
+ * Wavefront Alignment Pinned (one pattern against many texts)
+ */
+void wavefront_align_pin_pattern(
+    wavefront_aligner_t* const wf_aligner,
+    const char* const pattern,
+    const int pattern_length) {
+  if (wf_aligner->bialigner == NULL) {
+    wavefront_sequences_pin_pattern(&wf_aligner->sequences,pattern,pattern_length,false);
+  } else {
+    wavefront_bialigner_pin_pattern(wf_aligner->bialigner,pattern,pattern_length);
+  }
+}
+void wavefront_align_unpin_pattern(
+    wavefront_aligner_t* const wf_aligner) {
+  if (wf_aligner->bialigner == NULL) {
+    wavefront_sequences_unpin_pattern(&wf_aligner->sequences);
+  } else {
+    wavefront_bialigner_unpin_pattern(wf_aligner->bialigner);
+  }
+}
+int wavefront_align_pinned__dispatch(
+    wavefront_aligner_t* const wf_aligner,
+    const char* const reference,
+    const int reference_length,
+    const int text_begin,
+    const int text_end,
+    const bool zero_copy) {
+  // Parameters
+  wavefront_sequences_t* const pinned = (wf_aligner->bialigner == NULL) ?
+      &wf_aligner->sequences : &wf_aligner->bialigner->wf_forward->sequences;
+  if (!pinned->pattern_pinned) {
+    fprintf(stderr,"[WFA] No pattern pinned to align against\n");
+    exit(1);
+  }
+  const char* const pattern = pinned->pattern_pinned_buffer;
+  const int pattern_length = pinned->pattern_pinned_length;
+  const char* const text = reference + text_begin;
+  const int text_length = text_end - text_begin;
+  // Checks
+  wavefront_align_presets__checks(wf_aligner,pattern_length,text_length);
+  if (wavefront_align_offsets__exceeded(wf_aligner,pattern_length,text_length)) {
+    return WF_STATUS_SEQUENCE_TOO_LONG;
+  }
+  // Prefilter
+  if (wavefront_prefilter_ascii(wf_aligner,pattern,pattern_length,text,text_length)) {
+    return WF_STATUS_FILTERED;
+  }
+  wavefront_debug_begin(wf_aligner);
+  wavefront_aligner_stats_begin(wf_aligner);
+  // Plot
+  if (wf_aligner->plot != NULL) wavefront_plot_resize(wf_aligner->plot,pattern_length,text_length);
+  // Dispatcher
+  const int bpm_switch_score = wavefront_bpm_switch_score(
+      wf_aligner,pattern,pattern_length,text,text_length);
+  if (bpm_switch_score == 0) {
+    // Bit-parallel (score-only edit/indel, high divergence predicted)
+    wavefront_bpm_align(wf_aligner,pattern,pattern_length,text,text_length,0);
+  } else if (wf_aligner->bialigner == NULL) {
+    // Prepare Sequences (pinned pattern; text sliced in place or copied)
+    if (!zero_copy || !wavefront_sequences_init_text_slice(&wf_aligner->sequences,
+        reference,reference_length,text_begin,text_end)) {
+      wavefront_sequences_init_text(&wf_aligner->sequences,text,text_length);
+    }
+    // Align
+    if (bpm_switch_score < wf_aligner->system.max_score) {
+      wavefront_align_hybrid(wf_aligner,pattern,pattern_length,text,text_length,bpm_switch_score);
+    } else {
+      wavefront_align_unidirectional(wf_aligner);
+    }
+    // Release slice (unless paused)
+    if (wf_aligner->align_status.status != WF_STATUS_MAX_STEPS_REACHED) {
+      wavefront_sequences_release_text_slice(&wf_aligner->sequences);
+    }
+  } else {
+    // Prepare Sequences (pinned pattern; text always copied)
+    wavefront_bialigner_set_text(wf_aligner->bialigner,text,text_length);
+    // Align
+    wavefront_align_bidirectional(wf_aligner);
+  }
+  // Stats & DEBUG
+  wavefront_aligner_stats_end(wf_aligner);
   wavefront_debug_end(wf_aligner);
   wavefront_debug_check_correct(wf_aligner);
   // Return
   return wf_aligner->align_status.status;
 }
+int wavefront_align_pinned(
+    wavefront_aligner_t* const wf_aligner,
+    const char* const text,
+    const int text_length) {
+  return wavefront_align_pinned__dispatch(
+      wf_aligner,text,text_length,0,text_length,false);
+}
+int wavefront_align_pinned_slice(
+    wavefront_aligner_t* const wf_aligner,
+    const char* const reference,
+    const int reference_length,
+    const int text_begin,
+    const int text_end) {
+  return wavefront_align_pinned__dispatch(
+      wf_aligner,reference,reference_length,text_begin,text_end,true);
+}
+/*
+ * Wavefront Alignment Incremental (extension over sequences streamed in chunks)
+ */
+void wavefront_align_incremental__checks(
+    wavefront_aligner_t* const wf_aligner) {
+  // Parameters
+  alignment_form_t* const form = &wf_aligner->alignment_form;
+  const wf_heuristic_strategy strategy = wf_aligner->heuristic.strategy;
+  // Checks
+  if (form->span != alignment_endsfree || !form->extension) {
+    fprintf(stderr,"[WFA] Incremental alignment requires the extension alignment-span\n");
+    exit(1);
+  }
+  if (wf_aligner->bialigner != NULL) {
+    fprintf(stderr,"[WFA] Incremental alignment is not supported by BiWFA (ultralow memory mode)\n");
+    exit(1);
+  }
+  // Heuristics depending on the sequence lengths would change as the sequences grow
+  const wf_heuristic_strategy length_independent =
+      wf_heuristic_none | wf_heuristic_xdrop | wf_heuristic_zdrop | wf_heuristic_banded_static;
+  if (strategy & ~length_independent) {
+    fprintf(stderr,"[WFA] Incremental alignment only supports X-drop/Z-drop/static-band heuristics\n");
+    exit(1);
+  }
+}
+int wavefront_align_incremental__continue(
+    wavefront_aligner_t* const wf_aligner) {
+  // Parameters
+  wavefront_align_status_t* const align_status = &wf_aligner->align_status;
+  // Continue aligning (from the current wavefronts)
+  wf_aligner->alignment_end_pos.score = -1;
+  wf_aligner->alignment_end_pos.k = DPMATRIX_DIAGONAL_NULL;
+  wf_aligner->alignment_end_pos.offset = WAVEFRONT_OFFSET_NULL;
+  wavefront_unialign(wf_aligner);
+  // Finish alignment
+  if (align_status->status == WF_STATUS_SEQUENCE_EXHAUSTED ||
+      align_status->status == WF_STATUS_MAX_STEPS_REACHED) {
+    return align_status->status; // Alignment paused
+  }
+  wavefront_align_unidirectional_cleanup(wf_aligner);
+  // Stats & DEBUG
+  wavefront_aligner_stats_end(wf_aligner);
+  wavefront_debug_end(wf_aligner);
+  wavefront_debug_check_correct(wf_aligner);
+  // Return
+  return align_status->status;
+}
+int wavefront_align_incremental(
+    wavefront_aligner_t* const wf_aligner,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length) {
+  // Checks
+  wavefront_align_incremental__checks(wf_aligner);
+  wavefront_align_presets__checks(wf_aligner,pattern_length,text_length);
+  if (wavefront_align_offsets__exceeded(wf_aligner,pattern_length,text_length)) {
+    return WF_STATUS_SEQUENCE_TOO_LONG;
+  }
+  wavefront_debug_begin(wf_aligner);
+  wavefront_aligner_stats_begin(wf_aligner);
+  // Plot
+  if (wf_aligner->plot != NULL) wavefront_plot_resize(wf_aligner->plot,pattern_length,text_length);
+  // Prepare Sequences
+  wavefront_sequences_init_ascii(&wf_aligner->sequences,
+      pattern,pattern_length,text,text_length,false);
+  // Init (both sequences open)
+  wavefront_unialign_init(wf_aligner,affine2p_matrix_M,affine2p_matrix_M);
+  wf_aligner->align_status.incremental = true;
+  wf_aligner->align_status.pattern_complete = false;
+  wf_aligner->align_status.text_complete = false;
+  // Align
+  return wavefront_align_incremental__continue(wf_aligner);
+}
+void wavefront_align_incremental__check_paused(
+    wavefront_aligner_t* const wf_aligner) {
+  wavefront_align_status_t* const align_status = &wf_aligner->align_status;
+  if (!align_status->incremental || align_status->status != WF_STATUS_SEQUENCE_EXHAUSTED) {
+    fprintf(stderr,"[WFA] Incremental alignment cannot be continued (not paused)\n");
+    exit(1);
+  }
+}
+int wavefront_align_incremental_append(
+    wavefront_aligner_t* const wf_aligner,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length) {
+  // Parameters
+  wavefront_sequences_t* const sequences = &wf_aligner->sequences;
+  wavefront_align_status_t* const align_status = &wf_aligner->align_status;
+  // Checks
+  wavefront_align_incremental__check_paused(wf_aligner);
+  if ((pattern_length > 0 && align_status->pattern_complete) ||
+      (text_length > 0 && align_status->text_complete)) {
+    fprintf(stderr,"[WFA] Incremental alignment cannot append to a complete sequence\n");
+    exit(1);
+  }
+  // Append chunks
+  wavefront_sequences_append(sequences,pattern,pattern_length,text,text_length);
+  // Resize for the new lengths (keeping the wavefronts computed so far)
+  const int pattern_length_new = sequences->pattern_length;
+  const int text_length_new = sequences->text_length;
+  wavefront_align_presets__checks(wf_aligner,pattern_length_new,text_length_new);
+  if (wavefront_align_offsets__exceeded(wf_aligner,pattern_length_new,text_length_new)) {
+    return WF_STATUS_SEQUENCE_TOO_LONG;
+  }
+  wavefront_components_expand(&wf_aligner->wf_components,
+      pattern_length_new,text_length_new,&wf_aligner->penalties);
+  if (wf_aligner->alignment_scope == compute_alignment) {
+    cigar_resize(wf_aligner->cigar,2*(pattern_length_new+text_length_new));
+  }
+  // Continue
+  return wavefront_align_incremental__continue(wf_aligner);
+}
+int wavefront_align_incremental_complete(
+    wavefront_aligner_t* const wf_aligner,
+    const bool pattern_complete,
+    const bool text_complete) {
+  // Checks
+  wavefront_align_incremental__check_paused(wf_aligner);
+  // Close sequences
+  wavefront_align_status_t* const align_status = &wf_aligner->align_status;
+  align_status->pattern_complete |= pattern_complete;
+  align_status->text_complete |= text_complete;
+  // Continue
+  return wavefront_align_incremental__continue(wf_aligner);
+}
 /*
  * Wavefront Alignment Resume (Experimental)
  */
@@ -255,11 +560,14 @@ int wavefront_align_resume(
   // Resume aligning sequences
   wavefront_unialign(wf_aligner);
   // Finish alignment
-  if (align_status->status == WF_STATUS_MAX_STEPS_REACHED) {
-    return WF_STATUS_MAX_STEPS_REACHED; // Alignment paused
+  if (align_status->status == WF_STATUS_MAX_STEPS_REACHED ||
+      align_status->status == WF_STATUS_SEQUENCE_EXHAUSTED) {
+    return align_status->status; // Alignment paused
   }
   wavefront_align_unidirectional_cleanup(wf_aligner);
-  // DEBUG
+  wavefront_sequences_release_text_slice(&wf_aligner->sequences);
+  // Stats & DEBUG
+  wavefront_aligner_stats_end(wf_aligner);
   wavefront_debug_check_correct(wf_aligner);
   // Return
   return align_status->status;
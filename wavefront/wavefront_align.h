@@ -54,3 +54,57 @@ int wavefront_align_packed2bits(
     const int pattern_length,
     const uint8_t* const text,
     const int text_length);
+
+/*
+ * Wavefront Alignment Pinned (one pattern against many texts)
+ *   The pattern is prepared once (padded and oriented) and every
+ *   text is aligned against it. The slice variant aligns
+ *   reference[text_begin,text_end) in place (zero-copy) as long as
+ *   WF_SEQUENCES_PADDING bytes of reference follow the slice (read,
+ *   never written; the reference can be shared and read-only).
+ *   Otherwise, the text is copied.
+ */
+void wavefront_align_pin_pattern(
+    wavefront_aligner_t* const wf_aligner,
+    const char* const pattern,
+    const int pattern_length);
+void wavefront_align_unpin_pattern(
+    wavefront_aligner_t* const wf_aligner);
+int wavefront_align_pinned(
+    wavefront_aligner_t* const wf_aligner,
+    const char* const text,
+    const int text_length);
+int wavefront_align_pinned_slice(
+    wavefront_aligner_t* const wf_aligner,
+    const char* const reference,
+    const int reference_length,
+    const int text_begin,
+    const int text_end);
+
+/*
+ * Wavefront Alignment Incremental (extension over sequences streamed in chunks)
+ *   Starts an extension alignment with the chunks available so far. The
+ *   alignment pauses (WF_STATUS_SEQUENCE_EXHAUSTED) when it reaches the
+ *   end of a sequence that can still grow. Appending more sequence
+ *   continues from the current wavefronts (no work is repeated). Marking
+ *   the sequences as complete lets the alignment finish. Results equal
+ *   those of aligning the whole sequences at once (X-drop/Z-drop included),
+ *   except that the trailing end-free gaps of edit/indel alignments (not
+ *   max-trimmed) only span the sequence appended so far.
+ */
+int wavefront_align_incremental(
+    wavefront_aligner_t* const wf_aligner,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length);
+int wavefront_align_incremental_append(
+    wavefront_aligner_t* const wf_aligner,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length);
+int wavefront_align_incremental_complete(
+    wavefront_aligner_t* const wf_aligner,
+    const bool pattern_complete,
+    const bool text_complete);
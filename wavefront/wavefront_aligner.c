@@ -37,6 +37,7 @@
 #include "wavefront_plot.h"
 #include "wavefront_compute.h"
 #include "wavefront_sequences.h"
+#include "wavefront_multiversion.h"
 
 /*
  * Configuration
@@ -56,9 +57,17 @@
 #define WF_STATUS_MAX_STEPS_REACHED_MSG       "[WFA] Alignment failed. Maximum WFA-steps limit reached"
 #define WF_STATUS_OOM_MSG                     "[WFA] Alignment failed. Maximum memory limit reached"
 #define WF_STATUS_UNATTAINABLE_MSG            "[WFA] Alignment failed. Unattainable under configured heuristics"
+#define WF_STATUS_MAX_SCORE_REACHED_MSG       "[WFA] Alignment failed. No alignment within the maximum score"
+#define WF_STATUS_FILTERED_MSG                "[WFA] Alignment filtered. Score lower-bound exceeds the maximum score"
+#define WF_STATUS_SEQUENCE_EXHAUSTED_MSG      "[WFA] Alignment paused. Sequences exhausted (append more to continue)"
+#define WF_STATUS_SEQUENCE_TOO_LONG_MSG       "[WFA] Alignment failed. Sequences too long for the wavefront offsets (16-bit offsets build)"
 #define WF_STATUS_MAX_STEPS_REACHED_MSG_SHORT "FAILED.MaxWFASteps"
 #define WF_STATUS_OOM_MSG_SHORT               "FAILED.OOM"
 #define WF_STATUS_UNATTAINABLE_MSG_SHORT      "FAILED.Unattainable"
+#define WF_STATUS_MAX_SCORE_REACHED_MSG_SHORT "FAILED.MaxScore"
+#define WF_STATUS_FILTERED_MSG_SHORT          "FAILED.Filtered"
+#define WF_STATUS_SEQUENCE_EXHAUSTED_MSG_SHORT "PAUSED.Exhausted"
+#define WF_STATUS_SEQUENCE_TOO_LONG_MSG_SHORT  "FAILED.TooLong"
 
 // Internal
 #define WF_STATUS_END_REACHED_MSG             "[WFA] Alignment end reached"
@@ -76,6 +85,10 @@ char* wavefront_align_strerror(const int error_code) {
   if (error_code == WF_STATUS_MAX_STEPS_REACHED) return WF_STATUS_MAX_STEPS_REACHED_MSG;
   if (error_code == WF_STATUS_OOM) return WF_STATUS_OOM_MSG;
   if (error_code == WF_STATUS_UNATTAINABLE) return WF_STATUS_UNATTAINABLE_MSG;
+  if (error_code == WF_STATUS_MAX_SCORE_REACHED) return WF_STATUS_MAX_SCORE_REACHED_MSG;
+  if (error_code == WF_STATUS_FILTERED) return WF_STATUS_FILTERED_MSG;
+  if (error_code == WF_STATUS_SEQUENCE_EXHAUSTED) return WF_STATUS_SEQUENCE_EXHAUSTED_MSG;
+  if (error_code == WF_STATUS_SEQUENCE_TOO_LONG) return WF_STATUS_SEQUENCE_TOO_LONG_MSG;
   // Internal
   if (error_code == WF_STATUS_END_REACHED) return WF_STATUS_END_REACHED_MSG;
   if (error_code == WF_STATUS_END_UNREACHABLE) return WF_STATUS_END_UNREACHABLE_MSG;
@@ -90,6 +103,10 @@ char* wavefront_align_strerror_short(const int error_code) {
   if (error_code == WF_STATUS_MAX_STEPS_REACHED) return WF_STATUS_MAX_STEPS_REACHED_MSG_SHORT;
   if (error_code == WF_STATUS_OOM) return WF_STATUS_OOM_MSG_SHORT;
   if (error_code == WF_STATUS_UNATTAINABLE) return WF_STATUS_UNATTAINABLE_MSG_SHORT;
+  if (error_code == WF_STATUS_MAX_SCORE_REACHED) return WF_STATUS_MAX_SCORE_REACHED_MSG_SHORT;
+  if (error_code == WF_STATUS_FILTERED) return WF_STATUS_FILTERED_MSG_SHORT;
+  if (error_code == WF_STATUS_SEQUENCE_EXHAUSTED) return WF_STATUS_SEQUENCE_EXHAUSTED_MSG_SHORT;
+  if (error_code == WF_STATUS_SEQUENCE_TOO_LONG) return WF_STATUS_SEQUENCE_TOO_LONG_MSG_SHORT;
   // Internal
   if (error_code == WF_STATUS_END_REACHED) return WF_STATUS_END_REACHED_MSG_SHORT;
   if (error_code == WF_STATUS_END_UNREACHABLE) return WF_STATUS_END_UNREACHABLE_MSG_SHORT;
@@ -104,12 +121,21 @@ void wavefront_aligner_init_status(
   wf_aligner->align_status.status = WF_STATUS_OK;
   wf_aligner->align_status.score = 0;
   wf_aligner->align_status.dropped = false;
+  wf_aligner->align_status.extend_fused = false;
+  wf_aligner->align_status.extend_fused_score = -1;
+  wf_aligner->align_status.incremental = false;
+  wf_aligner->align_status.pattern_complete = true;
+  wf_aligner->align_status.text_complete = true;
 }
 void wavefront_aligner_init_system(
     wavefront_aligner_t* const wf_aligner) {
-  // Reset effective limits
-  wf_aligner->system.max_memory_compact = BUFFER_SIZE_256M;
-  wf_aligner->system.max_memory_resident = BUFFER_SIZE_256M + BUFFER_SIZE_256M;
+  // Set effective limits (unless set by the user)
+  if (wf_aligner->system.max_memory_compact == (uint64_t)-1) {
+    wf_aligner->system.max_memory_compact = BUFFER_SIZE_256M;
+  }
+  if (wf_aligner->system.max_memory_resident == (uint64_t)-1) {
+    wf_aligner->system.max_memory_resident = BUFFER_SIZE_256M + BUFFER_SIZE_256M;
+  }
   switch (wf_aligner->memory_mode) {
     case wavefront_memory_med:
       wf_aligner->system.max_partial_compacts = 4;
@@ -126,13 +152,14 @@ void wavefront_aligner_init_system(
  */
 wavefront_aligner_t* wavefront_aligner_init_mm(
     mm_allocator_t* mm_allocator,
+    const mm_allocator_policy_t* const mm_policy,
     const bool memory_modular,
     const bool bt_piggyback,
     const bool bi_alignment) {
   // MM
   bool mm_allocator_own;
   if (mm_allocator == NULL) {
-    mm_allocator = mm_allocator_new((bi_alignment) ? BUFFER_SIZE_4K : BUFFER_SIZE_4M);
+    mm_allocator = mm_allocator_new_policy((bi_alignment) ? BUFFER_SIZE_4K : BUFFER_SIZE_4M,mm_policy);
     mm_allocator_own = true;
   } else {
     mm_allocator_own = false;
@@ -242,6 +269,8 @@ void wavefront_aligner_init_alignment(
   wf_aligner->alignment_form = attributes->alignment_form;
   // Penalties
   wavefront_aligner_init_penalties(wf_aligner,attributes);
+  // Kernels (CPU dispatch)
+  wavefront_dispatch_init(&wf_aligner->kernels,attributes->system.kernels_isa);
   // Memory mode
   wf_aligner->memory_mode = attributes->memory_mode;
   wavefront_aligner_init_heuristic(wf_aligner,attributes);
@@ -430,9 +459,14 @@ wavefront_aligner_t* wavefront_aligner_new(
   const bool memory_modular = score_only || memory_succint;
   const bool bt_piggyback = !score_only && memory_succint;
   const bool bi_alignment = (attributes->memory_mode == wavefront_memory_ultralow);
+#ifdef WFA_MULTIVERSION
+  // Multiversioned kernels (resolved once, by the first aligner)
+  wavefront_multiversion_init();
+#endif
   // Handler
   wavefront_aligner_t* const wf_aligner = wavefront_aligner_init_mm(
-      attributes->mm_allocator,memory_modular,bt_piggyback,bi_alignment);
+      attributes->mm_allocator,&attributes->system.memory_policy,
+      memory_modular,bt_piggyback,bi_alignment);
   // Plot
   if (attributes->plot.enabled) {
     wf_aligner->plot = wavefront_plot_new(attributes->distance_metric,
@@ -457,8 +491,12 @@ wavefront_aligner_t* wavefront_aligner_new(
   // CIGAR
   const int cigar_length = (score_only) ? 10 : 2*(PATTERN_LENGTH_INIT+TEXT_LENGTH_INIT);
   wf_aligner->cigar = cigar_new(cigar_length);
+  cigar_set_run_length(wf_aligner->cigar,attributes->cigar_run_length);
   // System
   wf_aligner->system = attributes->system;
+  counter_reset(&wf_aligner->system.extend_fused_bytes);
+  timer_reset(&wf_aligner->system.timer_compact);
+  wf_aligner->pool_id = -1; // Not pooled
   // Return
   return wf_aligner;
 }
@@ -502,6 +540,32 @@ void wavefront_aligner_delete(
     mm_allocator_delete(mm_allocator);
   }
 }
+/*
+ * Restore configuration (undo any setter applied since the aligner was created)
+ */
+void wavefront_aligner_restore_configuration(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_aligner_attr_t* const attributes) {
+  // Span
+  wf_aligner->alignment_form = attributes->alignment_form;
+  // Heuristic
+  wavefront_aligner_init_heuristic(wf_aligner,attributes);
+  if (wf_aligner->bialigner != NULL) {
+    wavefront_bialigner_set_heuristic(wf_aligner->bialigner,&wf_aligner->heuristic);
+  }
+  // System
+  alignment_system_t* const system = &attributes->system;
+  wavefront_aligner_set_max_alignment_steps(wf_aligner,system->max_alignment_steps);
+  wavefront_aligner_set_max_score(wf_aligner,system->max_score);
+  wavefront_aligner_set_prefilter(wf_aligner,system->prefilter);
+  wavefront_aligner_set_max_memory(wf_aligner,system->max_memory_resident,system->max_memory_abort);
+  wavefront_aligner_set_max_num_threads(wf_aligner,system->max_num_threads);
+  wavefront_aligner_set_min_offsets_per_thread(wf_aligner,system->min_offsets_per_thread);
+  wavefront_aligner_set_extend_fused(wf_aligner,system->extend_fused);
+  wavefront_aligner_set_stats(wf_aligner,system->stats_enabled);
+  // CIGAR
+  wavefront_aligner_set_cigar_run_length(wf_aligner,attributes->cigar_run_length);
+}
 /*
  * Span configuration
  */
@@ -612,6 +676,19 @@ void wavefront_aligner_set_max_alignment_steps(
         wf_aligner->bialigner,max_alignment_steps);
   }
 }
+void wavefront_aligner_set_max_score(
+    wavefront_aligner_t* const wf_aligner,
+    const int max_score) {
+  wf_aligner->system.max_score = max_score;
+  if (wf_aligner->bialigner != NULL) {
+    wavefront_bialigner_set_max_score(wf_aligner->bialigner,max_score);
+  }
+}
+void wavefront_aligner_set_prefilter(
+    wavefront_aligner_t* const wf_aligner,
+    const wavefront_prefilter_t prefilter) {
+  wf_aligner->system.prefilter = prefilter; // Checked before aligning (subsidiary aligners never filter)
+}
 void wavefront_aligner_set_max_memory(
     wavefront_aligner_t* const wf_aligner,
     const uint64_t max_memory_resident,
@@ -641,6 +718,61 @@ void wavefront_aligner_set_min_offsets_per_thread(
         wf_aligner->bialigner,min_offsets_per_thread);
   }
 }
+void wavefront_aligner_set_extend_fused(
+    wavefront_aligner_t* const wf_aligner,
+    const bool extend_fused) {
+  wf_aligner->system.extend_fused = extend_fused;
+  if (wf_aligner->bialigner != NULL) {
+    wavefront_bialigner_set_extend_fused(
+        wf_aligner->bialigner,extend_fused);
+  }
+}
+void wavefront_aligner_set_stats(
+    wavefront_aligner_t* const wf_aligner,
+    const bool stats_enabled) {
+  wf_aligner->system.stats_enabled = stats_enabled;
+  if (wf_aligner->bialigner != NULL) {
+    wavefront_bialigner_set_stats(
+        wf_aligner->bialigner,stats_enabled);
+  }
+}
+void wavefront_aligner_set_cigar_run_length(
+    wavefront_aligner_t* const wf_aligner,
+    const bool run_length) {
+  cigar_set_run_length(wf_aligner->cigar,run_length);
+}
+/*
+ * Stats
+ */
+void wavefront_aligner_stats_begin(
+    wavefront_aligner_t* const wf_aligner) {
+  if (!wf_aligner->system.stats_enabled) return;
+  wavefront_stats_clear(&wf_aligner->stats);
+  if (wf_aligner->bialigner != NULL) {
+    wavefront_bialigner_stats_clear(wf_aligner->bialigner);
+  }
+}
+void wavefront_aligner_stats_end(
+    wavefront_aligner_t* const wf_aligner) {
+  if (!wf_aligner->system.stats_enabled) return;
+  wavefront_aligner_stats_t* const stats = &wf_aligner->stats;
+  // Gather sub-aligners (BiWFA)
+  if (wf_aligner->bialigner != NULL) {
+    wavefront_bialigner_stats_gather(wf_aligner->bialigner,stats);
+  } else {
+    stats->memory_slab = wavefront_slab_get_size(wf_aligner->wavefront_slab);
+  }
+  // Memory
+  uint64_t bytes_used_malloc, bytes_used_allocator, bytes_free_available, bytes_free_fragmented;
+  mm_allocator_get_occupation(wf_aligner->mm_allocator,&bytes_used_malloc,
+      &bytes_used_allocator,&bytes_free_available,&bytes_free_fragmented);
+  stats->memory_mm = bytes_used_malloc + bytes_used_allocator;
+  stats->memory_peak = MAX(stats->memory_peak,wf_aligner->align_status.memory_used);
+}
+wavefront_aligner_stats_t* wavefront_aligner_get_stats(
+    wavefront_aligner_t* const wf_aligner) {
+  return &wf_aligner->stats;
+}
 /*
  * Utils
  */
@@ -728,8 +860,12 @@ void wavefront_aligner_print_conf(
     case wavefront_memory_ultralow: fprintf(stream,"BiWFA"); break;
   }
   if (wf_aligner->system.max_alignment_steps == INT_MAX) {
-    fprintf(stream,",inf)");
+    fprintf(stream,",inf");
   } else {
-    fprintf(stream,",%d)",wf_aligner->system.max_alignment_steps);
+    fprintf(stream,",%d",wf_aligner->system.max_alignment_steps);
   }
+#ifdef WFA_MULTIVERSION
+  fprintf(stream,",%s",wavefront_multiversion_get()->name);
+#endif
+  fprintf(stream,",%s)",wavefront_dispatch_isa_name(wf_aligner->kernels.isa));
 }
@@ -45,6 +45,13 @@ void wavefront_aligner_init(
     wavefront_aligner_t* const wf_aligner,
     const int align_level);
 
+/*
+ * Restore configuration (as given by the attributes at creation)
+ */
+void wavefront_aligner_restore_configuration(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_aligner_attr_t* const attributes);
+
 /*
  * Utils
  */
@@ -54,6 +61,14 @@ uint64_t wavefront_aligner_get_size(
 bool wavefront_aligner_maxtrim_cigar(
     wavefront_aligner_t* const wf_aligner);
 
+/*
+ * Stats
+ */
+void wavefront_aligner_stats_begin(
+    wavefront_aligner_t* const wf_aligner);
+void wavefront_aligner_stats_end(
+    wavefront_aligner_t* const wf_aligner);
+
 /*
  * Display
  */
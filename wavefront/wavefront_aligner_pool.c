@@ -0,0 +1,167 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignment Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignment Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignment Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: WFA aligner-pool (thread-safe, lock-free acquire/release of aligners)
+ */
+
+#include "utils/commons.h"
+#include "wavefront_aligner_pool.h"
+#include "wavefront_align.h"
+
+/*
+ * Free-list head (ABA tag & index+1)
+ */
+#define WF_POOL_HEAD(tag,index)  ((((uint64_t)(tag))<<32) | (uint64_t)(index))
+#define WF_POOL_HEAD_TAG(head)   ((uint32_t)((head)>>32))
+#define WF_POOL_HEAD_INDEX(head) ((uint32_t)(head))
+
+/*
+ * Nodes
+ */
+wavefront_aligner_pool_node_t* wavefront_aligner_pool_get_node(
+    wavefront_aligner_pool_t* const wf_aligner_pool,
+    const uint32_t node_id) {
+  wavefront_aligner_pool_node_t* const segment =
+      __atomic_load_n(wf_aligner_pool->segments+(node_id/WF_POOL_SEGMENT_SIZE),__ATOMIC_ACQUIRE);
+  return segment + (node_id % WF_POOL_SEGMENT_SIZE);
+}
+wavefront_aligner_t* wavefront_aligner_pool_grow(
+    wavefront_aligner_pool_t* const wf_aligner_pool) {
+  // Reserve node
+  const uint32_t node_id = __atomic_fetch_add(&wf_aligner_pool->num_aligners,1,__ATOMIC_ACQ_REL);
+  const uint32_t segment_id = node_id / WF_POOL_SEGMENT_SIZE;
+  if (segment_id >= WF_POOL_MAX_SEGMENTS) {
+    fprintf(stderr,"[WFA::Pool] Maximum number of aligners reached (%d)\n",
+        WF_POOL_MAX_SEGMENTS*WF_POOL_SEGMENT_SIZE);
+    exit(1);
+  }
+  // Allocate segment (if needed)
+  wavefront_aligner_pool_node_t* segment =
+      __atomic_load_n(wf_aligner_pool->segments+segment_id,__ATOMIC_ACQUIRE);
+  if (segment == NULL) {
+    wavefront_aligner_pool_node_t* const segment_new =
+        calloc(WF_POOL_SEGMENT_SIZE,sizeof(wavefront_aligner_pool_node_t));
+    if (__atomic_compare_exchange_n(wf_aligner_pool->segments+segment_id,
+        &segment,segment_new,false,__ATOMIC_ACQ_REL,__ATOMIC_ACQUIRE)) {
+      segment = segment_new;
+    } else {
+      free(segment_new); // Allocated by another thread
+    }
+  }
+  // Allocate aligner
+  wavefront_aligner_t* const wf_aligner = wavefront_aligner_new(&wf_aligner_pool->attributes);
+  wf_aligner->pool_id = node_id;
+  segment[node_id % WF_POOL_SEGMENT_SIZE].wf_aligner = wf_aligner;
+  return wf_aligner;
+}
+/*
+ * Setup
+ */
+wavefront_aligner_pool_t* wavefront_aligner_pool_new(
+    wavefront_aligner_attr_t* attributes,
+    const int num_aligners) {
+  // Allocate
+  wavefront_aligner_pool_t* const wf_aligner_pool = malloc(sizeof(wavefront_aligner_pool_t));
+  // Configuration
+  if (attributes == NULL) attributes = &wavefront_aligner_attr_default;
+  wf_aligner_pool->attributes = *attributes;
+  wf_aligner_pool->attributes.mm_allocator = NULL; // Each aligner owns its MM-allocator
+  // Nodes
+  int i;
+  for (i=0;i<WF_POOL_MAX_SEGMENTS;++i) wf_aligner_pool->segments[i] = NULL;
+  wf_aligner_pool->num_aligners = 0;
+  wf_aligner_pool->free_head = WF_POOL_HEAD(0,0);
+  // Pre-allocate aligners
+  for (i=0;i<num_aligners;++i) {
+    wavefront_aligner_t* const wf_aligner = wavefront_aligner_pool_grow(wf_aligner_pool);
+    wavefront_aligner_pool_release(wf_aligner_pool,wf_aligner);
+  }
+  // Return
+  return wf_aligner_pool;
+}
+void wavefront_aligner_pool_delete(
+    wavefront_aligner_pool_t* const wf_aligner_pool) {
+  // Free aligners (all of them should have been released)
+  const uint32_t num_aligners = wf_aligner_pool->num_aligners;
+  uint32_t i;
+  for (i=0;i<num_aligners;++i) {
+    wavefront_aligner_pool_node_t* const node = wavefront_aligner_pool_get_node(wf_aligner_pool,i);
+    wavefront_aligner_delete(node->wf_aligner);
+  }
+  // Free segments
+  for (i=0;i<WF_POOL_MAX_SEGMENTS;++i) {
+    if (wf_aligner_pool->segments[i] != NULL) free(wf_aligner_pool->segments[i]);
+  }
+  free(wf_aligner_pool);
+}
+/*
+ * Acquire/Release
+ */
+wavefront_aligner_t* wavefront_aligner_pool_acquire(
+    wavefront_aligner_pool_t* const wf_aligner_pool) {
+  uint64_t head = __atomic_load_n(&wf_aligner_pool->free_head,__ATOMIC_ACQUIRE);
+  while (true) {
+    // Check empty free-list
+    const uint32_t index = WF_POOL_HEAD_INDEX(head);
+    if (index == 0) return wavefront_aligner_pool_grow(wf_aligner_pool);
+    // Pop top node (the tag prevents ABA if the node is popped/pushed meanwhile)
+    wavefront_aligner_pool_node_t* const node = wavefront_aligner_pool_get_node(wf_aligner_pool,index-1);
+    const uint32_t next = __atomic_load_n(&node->next,__ATOMIC_RELAXED);
+    const uint64_t head_new = WF_POOL_HEAD(WF_POOL_HEAD_TAG(head)+1,next);
+    if (__atomic_compare_exchange_n(&wf_aligner_pool->free_head,
+        &head,head_new,true,__ATOMIC_ACQ_REL,__ATOMIC_ACQUIRE)) {
+      return node->wf_aligner;
+    }
+  }
+}
+void wavefront_aligner_pool_release(
+    wavefront_aligner_pool_t* const wf_aligner_pool,
+    wavefront_aligner_t* const wf_aligner) {
+  // Check aligner (its pool slot must hold it; pool_id alone may come from another pool)
+  const uint32_t num_aligners = __atomic_load_n(&wf_aligner_pool->num_aligners,__ATOMIC_ACQUIRE);
+  const bool in_range = wf_aligner->pool_id >= 0 && (uint32_t)wf_aligner->pool_id < num_aligners;
+  wavefront_aligner_pool_node_t* const segment = (in_range) ?
+      __atomic_load_n(wf_aligner_pool->segments+(wf_aligner->pool_id/WF_POOL_SEGMENT_SIZE),__ATOMIC_ACQUIRE) : NULL;
+  wavefront_aligner_pool_node_t* const node = (segment != NULL) ?
+      segment + (wf_aligner->pool_id % WF_POOL_SEGMENT_SIZE) : NULL;
+  if (node == NULL || node->wf_aligner != wf_aligner) {
+    fprintf(stderr,"[WFA::Pool] Released aligner does not belong to the pool\n");
+    exit(1);
+  }
+  // Restore configuration (next acquirer gets the pool's configuration)
+  wavefront_align_unpin_pattern(wf_aligner);
+  wavefront_aligner_restore_configuration(wf_aligner,&wf_aligner_pool->attributes);
+  // Push node
+  const uint32_t index = wf_aligner->pool_id + 1;
+  uint64_t head = __atomic_load_n(&wf_aligner_pool->free_head,__ATOMIC_RELAXED);
+  do {
+    __atomic_store_n(&node->next,WF_POOL_HEAD_INDEX(head),__ATOMIC_RELAXED);
+  } while (!__atomic_compare_exchange_n(&wf_aligner_pool->free_head,
+      &head,WF_POOL_HEAD(WF_POOL_HEAD_TAG(head)+1,index),
+      true,__ATOMIC_RELEASE,__ATOMIC_RELAXED));
+}
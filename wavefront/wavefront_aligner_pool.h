@@ -0,0 +1,88 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignment Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignment Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignment Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: WFA aligner-pool (thread-safe, lock-free acquire/release of aligners)
+ */
+
+#ifndef WAVEFRONT_ALIGNER_POOL_H_
+#define WAVEFRONT_ALIGNER_POOL_H_
+
+#include "utils/commons.h"
+#include "wavefront_aligner.h"
+
+/*
+ * Configuration
+ */
+#define WF_POOL_SEGMENT_SIZE  64   // Aligners per segment
+#define WF_POOL_MAX_SEGMENTS  1024 // Maximum segments (i.e., up to 64K aligners)
+
+/*
+ * Aligner Pool
+ *   Aligners are kept in segments that never move once allocated, so
+ *   that any node can be read while the pool grows. Free aligners are
+ *   linked into a lock-free stack whose head packs an ABA tag (high
+ *   32 bits) and the index+1 of the top node (low 32 bits; 0 if empty).
+ */
+typedef struct {
+  wavefront_aligner_t* wf_aligner;                                // Pooled aligner
+  uint32_t next;                                                  // Next free node (index+1; 0 if none)
+} wavefront_aligner_pool_node_t;
+typedef struct {
+  // Configuration
+  wavefront_aligner_attr_t attributes;                            // Attributes of the pooled aligners
+  // Nodes
+  wavefront_aligner_pool_node_t* segments[WF_POOL_MAX_SEGMENTS];  // Node segments
+  uint32_t num_aligners;                                          // Total aligners allocated
+  // Free-list
+  uint64_t free_head;                                             // Free-list head (tag,index+1)
+} wavefront_aligner_pool_t;
+
+/*
+ * Setup
+ */
+wavefront_aligner_pool_t* wavefront_aligner_pool_new(
+    wavefront_aligner_attr_t* attributes,
+    const int num_aligners);
+void wavefront_aligner_pool_delete(
+    wavefront_aligner_pool_t* const wf_aligner_pool);
+
+/*
+ * Acquire/Release
+ *   Acquire returns a free aligner (allocating a new one if none is
+ *   free). Released aligners keep their memory (slab, MM-allocator),
+ *   but any configuration set while acquired (span, heuristic, limits,
+ *   CIGAR format) is restored to the pool's attributes and any pinned
+ *   pattern is unpinned. Both calls are thread-safe.
+ */
+wavefront_aligner_t* wavefront_aligner_pool_acquire(
+    wavefront_aligner_pool_t* const wf_aligner_pool);
+void wavefront_aligner_pool_release(
+    wavefront_aligner_pool_t* const wf_aligner_pool,
+    wavefront_aligner_t* const wf_aligner);
+
+#endif /* WAVEFRONT_ALIGNER_POOL_H_ */
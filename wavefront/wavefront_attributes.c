@@ -47,6 +47,7 @@ wavefront_aligner_attr_t wavefront_aligner_attr_default = {
         .text_begin_free = 0,
         .text_end_free = 0,
     },
+    .cigar_run_length = false,
     // Penalties
     .linear_penalties = {
         .match = 0,
@@ -87,14 +88,27 @@ wavefront_aligner_attr_t wavefront_aligner_attr_default = {
     // System
     .system = {
         .max_alignment_steps = INT_MAX, // Unlimited
+        .max_score = INT_MAX,           // Unlimited
+        .prefilter = wf_prefilter_none,
+        .bpm_mode = wf_bpm_auto,
         .probe_interval_global = 3000,
         .probe_interval_compact = 6000,
-        .max_memory_compact = -1,  // Automatically set based on memory-mode
-        .max_memory_resident = -1, // Automatically set based on memory-mode
+        .max_memory_compact = -1,  // Automatically set (256MB)
+        .max_memory_resident = -1, // Automatically set (512MB)
         .max_memory_abort = UINT64_MAX, // Unlimited
+        .memory_policy = {
+            .pages = mm_pages_default,  // Regular pages
+            .numa = mm_numa_default,    // OS default placement
+            .numa_node = -1,
+        },
+        .bt_spill_path = NULL,     // BT-buffer kept in RAM
+        .bt_compress = false,      // BT-buffer segments kept uncompressed
         .verbose = 0, // Quiet
         .check_alignment_correct = false,
+        .stats_enabled = false,         // No per-alignment stats
         .max_num_threads = 1,           // Single thread by default
-        .min_offsets_per_thread = 500   // Minimum WF-length to spawn a thread
+        .min_offsets_per_thread = 500,  // Minimum WF-length to spawn a thread
+        .extend_fused = false,          // Separate compute and extend passes
+        .kernels_isa = wf_kernels_auto  // Best SIMD kernels supported by the CPU
     },
 };
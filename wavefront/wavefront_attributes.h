@@ -37,6 +37,7 @@
 #include "alignment/affine_penalties.h"
 #include "alignment/affine2p_penalties.h"
 #include "alignment/linear_penalties.h"
+#include "system/profiler_counter.h"
 #include "system/profiler_timer.h"
 #include "system/mm_allocator.h"
 
@@ -68,12 +69,44 @@ typedef struct {
   int text_end_free;       // Allow free-gap at the end of the text
 } alignment_form_t;
 
+/*
+ * SIMD kernels (selected at runtime)
+ */
+typedef enum {
+  wf_kernels_auto   = -1, // Best ISA supported by the CPU (detected at runtime)
+  wf_kernels_scalar =  0, // Portable scalar kernels (64-bit blockwise)
+  wf_kernels_avx2   =  1, // AVX2 kernels
+  wf_kernels_avx512 =  2, // AVX512 kernels (F+CD+VL+BW)
+} wavefront_kernels_isa_t;
+
+/*
+ * Prefilter (score lower-bound checked against max-score before aligning)
+ */
+typedef enum {
+  wf_prefilter_none      = 0, // No prefilter
+  wf_prefilter_length    = 1, // Length-difference bound (O(1))
+  wf_prefilter_basecount = 2, // Length-difference and base-count bound (O(n))
+} wavefront_prefilter_t;
+
+/*
+ * Bit-parallel engine (score-only edit/indel)
+ */
+typedef enum {
+  wf_bpm_auto   = 0, // Use BPM when the divergence predicted makes WFA slower
+  wf_bpm_never  = 1, // Always align using WFA
+  wf_bpm_always = 2, // Always use BPM (whenever applicable)
+} wavefront_bpm_mode_t;
+
 /*
  * Alignment system configuration
  */
 typedef struct {
   // Limits
   int max_alignment_steps;       // Maximum WFA-steps allowed before quit
+  int max_score;                 // Maximum alignment score (WF-score) before giving up
+  wavefront_prefilter_t prefilter; // Discard pairs whose score lower-bound exceeds max-score
+  // Engines
+  wavefront_bpm_mode_t bpm_mode; // Bit-parallel engine for score-only edit/indel alignments
   // Probing intervals
   int probe_interval_global;     // Score-ticks interval to check any limits
   int probe_interval_compact;    // Score-ticks interval to check BT-buffer compacting
@@ -82,6 +115,9 @@ typedef struct {
   uint64_t max_memory_compact;   // Maximum BT-buffer memory allowed before trigger compact
   uint64_t max_memory_resident;  // Maximum memory allowed to be buffered before reap
   uint64_t max_memory_abort;     // Maximum memory allowed to be used before aborting alignment
+  mm_allocator_policy_t memory_policy; // Hugepages/NUMA backing of the internal MM-allocator
+  const char* bt_spill_path;     // Directory where cold BT-segments are spilled (NULL disables spilling)
+  bool bt_compress;              // Compress cold BT-segments in memory (not together with spilling)
   // Verbose
   //  0 - Quiet
   //  1 - Report each sequence aligned                      (brief)
@@ -93,9 +129,16 @@ typedef struct {
   bool check_alignment_correct;  // Verify that the alignment CIGAR output is correct
   // Profile
   profiler_timer_t timer;        // Time alignment
+  profiler_timer_t timer_compact; // Time paused compacting the BT-buffer (one sample per compaction)
+  bool stats_enabled;            // Collect per-alignment stats (see wavefront_aligner_get_stats())
   // OS
   int max_num_threads;           // Maximum number of threads to use to compute/extend WFs
   int min_offsets_per_thread;    // Minimum amount of offsets to spawn a thread
+  // Fused compute & extend
+  bool extend_fused;                    // Extend each tile of M-diagonals right after computing it (end-to-end)
+  profiler_counter_t extend_fused_bytes; // M-wavefront bytes not re-streamed by the extend pass (per fused step)
+  // SIMD
+  wavefront_kernels_isa_t kernels_isa; // Kernels ISA (auto-detected from the CPU by default)
 } alignment_system_t;
 
 /*
@@ -116,6 +159,7 @@ typedef struct {
   distance_metric_t distance_metric;       // Alignment metric/distance used
   alignment_scope_t alignment_scope;       // Alignment scope (score only or full-CIGAR)
   alignment_form_t alignment_form;         // Alignment mode (end-to-end/ends-free)
+  bool cigar_run_length;                   // Backtrace emits run-length (SAM) CIGARs directly
   // Penalties
   linear_penalties_t linear_penalties;     // Gap-linear penalties (placeholder)
   affine_penalties_t affine_penalties;     // Gap-affine penalties (placeholder)
@@ -29,6 +29,7 @@
  * DESCRIPTION: WaveFront-Alignment module for backtracing alignments
  */
 
+#include "wavefront_multiversion.h"
 #include "utils/commons.h"
 #include "wavefront_backtrace.h"
 
@@ -58,6 +59,40 @@ typedef enum {
   backtrace_I1_open = 1,
 } backtrace_type;
 
+/*
+ * Backtrace CIGAR operations (traced backwards)
+ */
+void wavefront_backtrace_cigar_init(
+    cigar_t* const cigar) {
+  if (cigar->run_length) {
+    cigar_rle_clear(cigar);
+  } else {
+    cigar_clear(cigar);
+    cigar->end_offset = cigar->max_operations - 1;
+    cigar->begin_offset = cigar->max_operations - 2;
+    cigar->operations[cigar->end_offset] = '\0';
+  }
+}
+void wavefront_backtrace_cigar_op(
+    cigar_t* const cigar,
+    const char operation,
+    int length) {
+  if (cigar->run_length) {
+    cigar_rle_append(cigar,operation,length);
+  } else {
+    while (length > 0) {cigar->operations[(cigar->begin_offset)--] = operation; --length;};
+  }
+}
+void wavefront_backtrace_cigar_close(
+    cigar_t* const cigar,
+    const int score) {
+  if (cigar->run_length) {
+    cigar_rle_close(cigar,true);
+  } else {
+    ++(cigar->begin_offset);
+  }
+  cigar->score = score;
+}
 /*
  * Backtrace Trace Patch Match/Mismsmatch
  */
@@ -81,6 +116,11 @@ void wavefront_backtrace_matches(
     wf_offset_t offset,
     int num_matches,
     cigar_t* const cigar) {
+  // Run-length operations
+  if (cigar->run_length) {
+    cigar_rle_append(cigar,'M',num_matches);
+    return;
+  }
   // Parameters
   const uint64_t matches_lut = 0x4D4D4D4D4D4D4D4Dul; // Matches LUT = "MMMMMMMM"
   char* operations = cigar->operations + cigar->begin_offset;
@@ -233,10 +273,7 @@ void wavefront_backtrace_linear(
   const distance_metric_t distance_metric = penalties->distance_metric;
   // Prepare cigar
   cigar_t* const cigar = wf_aligner->cigar;
-  cigar_clear(cigar);
-  cigar->end_offset = cigar->max_operations - 1;
-  cigar->begin_offset = cigar->max_operations - 2;
-  cigar->operations[cigar->end_offset] = '\0';
+  wavefront_backtrace_cigar_init(cigar);
   // Compute starting location
   int score = alignment_score;
   int k = alignment_k;
@@ -245,12 +282,10 @@ void wavefront_backtrace_linear(
   wf_offset_t offset = alignment_offset;
   // Account for ending insertions/deletions
   if (v < pattern_length) {
-    int i = pattern_length - v;
-    while (i > 0) {cigar->operations[(cigar->begin_offset)--] = 'D'; --i;};
+    wavefront_backtrace_cigar_op(cigar,'D',pattern_length-v);
   }
   if (h < text_length) {
-    int i = text_length - h;
-    while (i > 0) {cigar->operations[(cigar->begin_offset)--] = 'I'; --i;};
+    wavefront_backtrace_cigar_op(cigar,'I',text_length-h);
   }
   // Trace the alignment back
   while (v > 0 && h > 0 && score > 0) {
@@ -280,17 +315,17 @@ void wavefront_backtrace_linear(
     switch (backtrace_type) {
       case backtrace_M:
         score = mismatch;
-        cigar->operations[(cigar->begin_offset)--] = 'X';
+        wavefront_backtrace_cigar_op(cigar,'X',1);
         --offset;
         break;
       case backtrace_I1_open:
         score = gap_open1;
-        cigar->operations[(cigar->begin_offset)--] = 'I';
+        wavefront_backtrace_cigar_op(cigar,'I',1);
         --k; --offset;
         break;
       case backtrace_D1_open:
         score = gap_open1;
-        cigar->operations[(cigar->begin_offset)--] = 'D';
+        wavefront_backtrace_cigar_op(cigar,'D',1);
         ++k;
         break;
       default:
@@ -311,11 +346,10 @@ void wavefront_backtrace_linear(
     h -= num_matches;
   }
   // Account for beginning insertions/deletions
-  while (v > 0) {cigar->operations[(cigar->begin_offset)--] = 'D'; --v;};
-  while (h > 0) {cigar->operations[(cigar->begin_offset)--] = 'I'; --h;};
+  wavefront_backtrace_cigar_op(cigar,'D',v);
+  wavefront_backtrace_cigar_op(cigar,'I',h);
   // Set CIGAR
-  ++(cigar->begin_offset);
-  cigar->score = alignment_score;
+  wavefront_backtrace_cigar_close(cigar,alignment_score);
 }
 void wavefront_backtrace_affine(
     wavefront_aligner_t* const wf_aligner,
@@ -332,10 +366,7 @@ void wavefront_backtrace_affine(
   const distance_metric_t distance_metric = penalties->distance_metric;
   // Prepare cigar
   cigar_t* const cigar = wf_aligner->cigar;
-  cigar_clear(cigar);
-  cigar->end_offset = cigar->max_operations - 1;
-  cigar->begin_offset = cigar->max_operations - 2;
-  cigar->operations[cigar->end_offset] = '\0';
+  wavefront_backtrace_cigar_init(cigar);
   // Compute starting location
   affine2p_matrix_type matrix_type = component_end;
   int score = alignment_score;
@@ -346,12 +377,10 @@ void wavefront_backtrace_affine(
   // Account for ending insertions/deletions
   if (component_end == affine2p_matrix_M) { // ends-free
     if (v < pattern_length) {
-      int i = pattern_length - v;
-      while (i > 0) {cigar->operations[(cigar->begin_offset)--] = 'D'; --i;};
+      wavefront_backtrace_cigar_op(cigar,'D',pattern_length-v);
     }
     if (h < text_length) {
-      int i = text_length - h;
-      while (i > 0) {cigar->operations[(cigar->begin_offset)--] = 'I'; --i;};
+      wavefront_backtrace_cigar_op(cigar,'I',text_length-h);
     }
   }
   // Trace the alignment back
@@ -476,21 +505,21 @@ void wavefront_backtrace_affine(
     }
     switch (backtrace_type) {
       case backtrace_M:
-        cigar->operations[(cigar->begin_offset)--] = 'X';
+        wavefront_backtrace_cigar_op(cigar,'X',1);
         --offset;
         break;
       case backtrace_I1_open:
       case backtrace_I1_ext:
       case backtrace_I2_open:
       case backtrace_I2_ext:
-        cigar->operations[(cigar->begin_offset)--] = 'I';
+        wavefront_backtrace_cigar_op(cigar,'I',1);
         --k; --offset;
         break;
       case backtrace_D1_open:
       case backtrace_D1_ext:
       case backtrace_D2_open:
       case backtrace_D2_ext:
-        cigar->operations[(cigar->begin_offset)--] = 'D';
+        wavefront_backtrace_cigar_op(cigar,'D',1);
         ++k;
         break;
       default:
@@ -512,20 +541,21 @@ void wavefront_backtrace_affine(
       h -= num_matches;
     }
     // Account for beginning insertions/deletions
-    while (v > 0) {cigar->operations[(cigar->begin_offset)--] = 'D'; --v;};
-    while (h > 0) {cigar->operations[(cigar->begin_offset)--] = 'I'; --h;};
+    wavefront_backtrace_cigar_op(cigar,'D',v);
+    wavefront_backtrace_cigar_op(cigar,'I',h);
   } else {
     // DEBUG
     if (v != 0 || h != 0 || (score != 0 && penalties->match == 0)) {
       fprintf(stderr,"[WFA::Backtrace] I?/D?-Beginning backtrace error\n");
-      fprintf(stderr,">%.*s\n",pattern_length,sequences->pattern);
-      fprintf(stderr,"<%.*s\n",text_length,sequences->text);
+      if (sequences->mode == wf_sequences_ascii) {
+        fprintf(stderr,">%.*s\n",pattern_length,sequences->pattern);
+        fprintf(stderr,"<%.*s\n",text_length,sequences->text);
+      }
       exit(-1);
     }
   }
   // Set CIGAR
-  ++(cigar->begin_offset);
-  cigar->score = alignment_score;
+  wavefront_backtrace_cigar_close(cigar,alignment_score);
 }
 /*
  * Backtrace from BT-Buffer (pcigar)
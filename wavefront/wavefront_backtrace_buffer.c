@@ -33,6 +33,12 @@
 #include "wavefront_backtrace_buffer.h"
 #include "wavefront_sequences.h"
 
+#include <sys/mman.h>
+
+#ifdef WFA_PARALLEL
+#include <omp.h>
+#endif
+
 /*
  * Config
  */
@@ -44,6 +50,33 @@
 #define BT_BUFFER_IDX(segment_idx,segment_offset) \
   ((segment_idx)*BT_BUFFER_SEGMENT_LENGTH) + (segment_offset)
 
+#define BT_BUFFER_SEGMENT_BYTES ((uint64_t)BT_BUFFER_SEGMENT_LENGTH*sizeof(bt_block_t))
+
+#define BT_BUFFER_MARK_BATCH_SIZE    100
+#define BT_BUFFER_COMPACT_CHUNK      BUFFER_SIZE_64K // BT-blocks compacted per thread and round
+
+// Compaction chunks never cross a segment boundary
+_Static_assert(BT_BUFFER_SEGMENT_LENGTH % BT_BUFFER_COMPACT_CHUNK == 0,
+    "BT_BUFFER_SEGMENT_LENGTH must be a multiple of BT_BUFFER_COMPACT_CHUNK");
+
+/*
+ * Compressed segments
+ *   Cold segments are encoded in chunks of BT-blocks. Each BT-block is a
+ *   varint header (zig-zag delta of prev_idx wrt the previous block's
+ *   prev_idx+1, shifted 2 bits, plus a tag) followed by the pcigar only
+ *   if it cannot be inferred from the tag.
+ */
+#define BT_BUFFER_CHUNK_LENGTH     256
+#define BT_BUFFER_CHUNK_MAX_BYTES  (BT_BUFFER_CHUNK_LENGTH*(5+sizeof(pcigar_t)))
+#define BT_BUFFER_NUM_CHUNKS       (BT_BUFFER_SEGMENT_LENGTH/BT_BUFFER_CHUNK_LENGTH)
+
+#define BT_BLOCK_TAG_PCIGAR        0 // Raw pcigar follows
+#define BT_BLOCK_TAG_REPEAT        1 // Same pcigar as the previous BT-block (runs)
+#define BT_BLOCK_TAG_MISMS         2 // Full-mismatch pcigar
+#define BT_BLOCK_TAG_INIT          3 // Initial BT-block (NULL prev_idx; raw pcigar follows)
+
+#define PCIGAR_FULL_MISMATCH       ((pcigar_t)0xAAAAAAAAAAAAAAAAull)
+
 /*
  * BT-Block Segments
  */
@@ -72,6 +105,83 @@ void wf_backtrace_buffer_segment_reserve(
   bt_block_t** const segments = vector_get_mem(bt_buffer->segments,bt_block_t*);
   bt_buffer->block_next = segments[bt_buffer->segment_idx];
 }
+/*
+ * Spilled BT-Block Segments
+ */
+void wf_backtrace_buffer_spill_map(
+    wf_backtrace_buffer_t* const bt_buffer) {
+  // Map spilled segments back in (paged-in on demand, read-only)
+  bt_block_t** const segments = vector_get_mem(bt_buffer->segments,bt_block_t*);
+  int i;
+  for (i=0;i<bt_buffer->num_spilled_segments;++i) {
+    void* const memory = mmap(NULL,BT_BUFFER_SEGMENT_BYTES,
+        PROT_READ,MAP_PRIVATE,bt_buffer->spill_fd,(off_t)i*BT_BUFFER_SEGMENT_BYTES);
+    if (memory == MAP_FAILED) {
+      fprintf(stderr,"[WFA::BacktraceBuffer] Error mapping spilled segment\n"); exit(1);
+    }
+    segments[i] = memory;
+  }
+  bt_buffer->spill_mapped = true;
+}
+void wf_backtrace_buffer_spill_unmap(
+    wf_backtrace_buffer_t* const bt_buffer) {
+  if (!bt_buffer->spill_mapped) return;
+  bt_block_t** const segments = vector_get_mem(bt_buffer->segments,bt_block_t*);
+  int i;
+  for (i=0;i<bt_buffer->num_spilled_segments;++i) {
+    munmap(segments[i],BT_BUFFER_SEGMENT_BYTES);
+    segments[i] = NULL;
+  }
+  bt_buffer->spill_mapped = false;
+}
+void wf_backtrace_buffer_segments_drop_cold(
+    wf_backtrace_buffer_t* const bt_buffer,
+    const int num_cold_segments) {
+  // Remove cold segments (keep resident ones)
+  const int num_segments = vector_get_used(bt_buffer->segments);
+  bt_block_t** const segments = vector_get_mem(bt_buffer->segments,bt_block_t*);
+  int i;
+  for (i=num_cold_segments;i<num_segments;++i) {
+    segments[i-num_cold_segments] = segments[i];
+  }
+  vector_set_used(bt_buffer->segments,num_segments-num_cold_segments);
+  if (vector_get_used(bt_buffer->segments) == 0) wf_backtrace_buffer_segment_add(bt_buffer);
+}
+void wf_backtrace_buffer_spill_release(
+    wf_backtrace_buffer_t* const bt_buffer) {
+  // Check spilled
+  const int num_spilled_segments = bt_buffer->num_spilled_segments;
+  if (num_spilled_segments == 0) return;
+  wf_backtrace_buffer_spill_unmap(bt_buffer);
+  wf_backtrace_buffer_segments_drop_cold(bt_buffer,num_spilled_segments);
+  bt_buffer->num_spilled_segments = 0;
+  // Release disk space
+  if (ftruncate(bt_buffer->spill_fd,0) != 0) {
+    fprintf(stderr,"[WFA::BacktraceBuffer] Error truncating spill file\n"); exit(1);
+  }
+}
+/*
+ * Compressed BT-Block Segments
+ */
+void wf_backtrace_buffer_compress_release(
+    wf_backtrace_buffer_t* const bt_buffer) {
+  // Check compressed
+  const int num_compressed_segments = bt_buffer->num_compressed_segments;
+  if (num_compressed_segments == 0) return;
+  // Free compressed segments
+  bt_segment_compressed_t* const segments_compressed =
+      vector_get_mem(bt_buffer->segments_compressed,bt_segment_compressed_t);
+  int i;
+  for (i=0;i<num_compressed_segments;++i) {
+    free(segments_compressed[i].data);
+    free(segments_compressed[i].chunk_offsets);
+  }
+  vector_clear(bt_buffer->segments_compressed);
+  wf_backtrace_buffer_segments_drop_cold(bt_buffer,num_compressed_segments);
+  bt_buffer->num_compressed_segments = 0;
+  bt_buffer->compressed_size = 0;
+  bt_buffer->chunk_cache_idx = BT_BLOCK_IDX_NULL;
+}
 /*
  * Setup
  */
@@ -89,14 +199,23 @@ wf_backtrace_buffer_t* wf_backtrace_buffer_new(
   bt_buffer->block_next = vector_get_mem(bt_buffer->segments,bt_block_t*)[0];
   bt_buffer->num_compacted_blocks = 0;
   bt_buffer->num_compactions = 0;
+  bt_buffer->spill_fd = -1;
+  bt_buffer->num_spilled_segments = 0;
+  bt_buffer->spill_mapped = false;
+  bt_buffer->segments_compressed = vector_new(10,bt_segment_compressed_t);
+  bt_buffer->num_compressed_segments = 0;
+  bt_buffer->compressed_size = 0;
+  bt_buffer->chunk_cache = mm_allocator_calloc(mm_allocator,BT_BUFFER_CHUNK_LENGTH,bt_block_t,false);
+  bt_buffer->chunk_cache_idx = BT_BLOCK_IDX_NULL;
   bt_buffer->alignment_init_pos = vector_new(100,wf_backtrace_init_pos_t);
   bt_buffer->alignment_packed = vector_new(100,pcigar_t);
-  bt_buffer->prefetch_blocks_idxs = vector_new(500,bt_block_idx_t);
   // Return
   return bt_buffer;
 }
 void wf_backtrace_buffer_clear(
     wf_backtrace_buffer_t* const bt_buffer) {
+  wf_backtrace_buffer_spill_release(bt_buffer);
+  wf_backtrace_buffer_compress_release(bt_buffer);
   bt_buffer->segment_idx = 0;
   bt_buffer->segment_offset = 0;
   bt_buffer->block_next = vector_get_mem(bt_buffer->segments,bt_block_t*)[0];
@@ -106,6 +225,9 @@ void wf_backtrace_buffer_clear(
 }
 void wf_backtrace_buffer_reap(
     wf_backtrace_buffer_t* const bt_buffer) {
+  // Drop spilled/compressed segments
+  wf_backtrace_buffer_spill_release(bt_buffer);
+  wf_backtrace_buffer_compress_release(bt_buffer);
   // Reap segments beyond the first
   const int num_segments = vector_get_used(bt_buffer->segments);
   bt_block_t** const segments = vector_get_mem(bt_buffer->segments,bt_block_t*);
@@ -124,17 +246,21 @@ void wf_backtrace_buffer_reap(
 void wf_backtrace_buffer_delete(
     wf_backtrace_buffer_t* const bt_buffer) {
   // Free segments
+  wf_backtrace_buffer_spill_release(bt_buffer);
+  wf_backtrace_buffer_compress_release(bt_buffer);
   const int num_segments = vector_get_used(bt_buffer->segments);
   bt_block_t** const segments = vector_get_mem(bt_buffer->segments,bt_block_t*);
   int i;
   for (i=0;i<num_segments;++i) {
     mm_allocator_free(bt_buffer->mm_allocator,segments[i]);
   }
+  if (bt_buffer->spill_fd >= 0) close(bt_buffer->spill_fd);
+  vector_delete(bt_buffer->segments_compressed);
+  mm_allocator_free(bt_buffer->mm_allocator,bt_buffer->chunk_cache);
   // Free handlers
   vector_delete(bt_buffer->segments);
   vector_delete(bt_buffer->alignment_init_pos);
   vector_delete(bt_buffer->alignment_packed);
-  vector_delete(bt_buffer->prefetch_blocks_idxs);
   mm_allocator_free(bt_buffer->mm_allocator,bt_buffer);
 }
 /*
@@ -157,17 +283,24 @@ void wf_backtrace_buffer_set_num_compacted_blocks(
 void wf_backtrace_buffer_reset_compaction(
     wf_backtrace_buffer_t* const bt_buffer) {
   bt_buffer->num_compactions = 0;
-  bt_buffer->num_compacted_blocks = 0;
+  // Spilled/compressed blocks remain compacted (never rewritten)
+  const int num_cold_segments = bt_buffer->num_spilled_segments + bt_buffer->num_compressed_segments;
+  bt_buffer->num_compacted_blocks = (bt_block_idx_t)num_cold_segments*BT_BUFFER_SEGMENT_LENGTH;
 }
 uint64_t wf_backtrace_buffer_get_size_allocated(
     wf_backtrace_buffer_t* const bt_buffer) {
-  const uint64_t segments_used = vector_get_used(bt_buffer->segments);
-  return segments_used*BT_BUFFER_SEGMENT_LENGTH*sizeof(bt_block_t);
+  // Resident segments only (compressed ones at their encoded size)
+  const int num_cold_segments = bt_buffer->num_spilled_segments + bt_buffer->num_compressed_segments;
+  const uint64_t segments_used = vector_get_used(bt_buffer->segments) - num_cold_segments;
+  return segments_used*BT_BUFFER_SEGMENT_LENGTH*sizeof(bt_block_t) + bt_buffer->compressed_size;
 }
 uint64_t wf_backtrace_buffer_get_size_used(
     wf_backtrace_buffer_t* const bt_buffer) {
-  const bt_block_idx_t max_block_idx = BT_BUFFER_IDX(bt_buffer->segment_idx,bt_buffer->segment_offset);
-  return max_block_idx*sizeof(bt_block_t);
+  // Resident blocks only (compressed ones at their encoded size)
+  const int num_cold_segments = bt_buffer->num_spilled_segments + bt_buffer->num_compressed_segments;
+  const uint64_t max_block_idx = BT_BUFFER_IDX(bt_buffer->segment_idx,bt_buffer->segment_offset);
+  const uint64_t cold_blocks = (uint64_t)num_cold_segments*BT_BUFFER_SEGMENT_LENGTH;
+  return (max_block_idx-cold_blocks)*sizeof(bt_block_t) + bt_buffer->compressed_size;
 }
 void wf_backtrace_buffer_prefetch_block(
     wf_backtrace_buffer_t* const bt_buffer,
@@ -213,6 +346,59 @@ bt_block_idx_t wf_backtrace_buffer_get_mem(
   // Return current global position
   return BT_BUFFER_IDX(segment_idx,segment_offset);
 }
+bt_block_t* wf_backtrace_buffer_get_block_compressed(
+    wf_backtrace_buffer_t* const bt_buffer,
+    const bt_block_idx_t block_idx) {
+  // Check decoded chunk
+  const bt_block_idx_t chunk_block_idx = block_idx - (block_idx % BT_BUFFER_CHUNK_LENGTH);
+  if (bt_buffer->chunk_cache_idx != chunk_block_idx) {
+    // Locate chunk
+    const int segment_idx = BT_BUFFER_SEGMENT_IDX(chunk_block_idx);
+    const int chunk_idx = BT_BUFFER_SEGMENT_OFFSET(chunk_block_idx) / BT_BUFFER_CHUNK_LENGTH;
+    bt_segment_compressed_t* const segment_compressed =
+        vector_get_elm(bt_buffer->segments_compressed,segment_idx,bt_segment_compressed_t);
+    const uint8_t* data = segment_compressed->data + segment_compressed->chunk_offsets[chunk_idx];
+    // Decode chunk
+    bt_block_t* const bt_blocks = bt_buffer->chunk_cache;
+    int64_t prev_predicted = chunk_block_idx;
+    pcigar_t pcigar = PCIGAR_NULL;
+    int i;
+    for (i=0;i<BT_BUFFER_CHUNK_LENGTH;++i) {
+      // Header
+      uint64_t header = 0;
+      int shift = 0;
+      uint8_t byte;
+      do {
+        byte = *(data++);
+        header |= (uint64_t)(byte & 0x7F) << shift;
+        shift += 7;
+      } while (byte & 0x80);
+      const int tag = header & 3;
+      const uint64_t zigzag = header >> 2;
+      // PCIGAR
+      switch (tag) {
+        case BT_BLOCK_TAG_REPEAT: break;
+        case BT_BLOCK_TAG_MISMS: pcigar = PCIGAR_FULL_MISMATCH; break;
+        default:
+          memcpy(&pcigar,data,sizeof(pcigar_t));
+          data += sizeof(pcigar_t);
+          break;
+      }
+      bt_blocks[i].pcigar = pcigar;
+      // Previous index
+      if (tag == BT_BLOCK_TAG_INIT) {
+        bt_blocks[i].prev_idx = BT_BLOCK_IDX_NULL;
+      } else {
+        const int64_t delta = (int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1);
+        bt_blocks[i].prev_idx = prev_predicted + delta;
+        prev_predicted = (int64_t)bt_blocks[i].prev_idx + 1;
+      }
+    }
+    bt_buffer->chunk_cache_idx = chunk_block_idx;
+  }
+  // Return block
+  return bt_buffer->chunk_cache + (block_idx - chunk_block_idx);
+}
 /*
  * Store blocks
  */
@@ -256,11 +442,19 @@ bt_block_t* wf_backtrace_buffer_traceback_pcigar(
   // Clear temporal buffer
   vector_t* const alignment_packed = bt_buffer->alignment_packed;
   vector_clear(alignment_packed);
+  // Page-in spilled segments
+  if (bt_buffer->num_spilled_segments > 0 && !bt_buffer->spill_mapped) {
+    wf_backtrace_buffer_spill_map(bt_buffer);
+  }
   // Traverse-back the BT-blocks and store all the pcigars
+  const bt_block_idx_t num_compressed_blocks =
+      (bt_block_idx_t)bt_buffer->num_compressed_segments*BT_BUFFER_SEGMENT_LENGTH;
   while (bt_block->prev_idx != BT_BLOCK_IDX_NULL) {
     vector_insert(alignment_packed,bt_block->pcigar,pcigar_t);
     const bt_block_idx_t prev_idx = bt_block->prev_idx;
-    bt_block = wf_backtrace_buffer_get_block(bt_buffer,prev_idx);
+    bt_block = (prev_idx < num_compressed_blocks) ?
+        wf_backtrace_buffer_get_block_compressed(bt_buffer,prev_idx) :
+        wf_backtrace_buffer_get_block(bt_buffer,prev_idx);
   }
   // Return initial block (start coordinate)
   return bt_block;
@@ -277,36 +471,37 @@ void wf_backtrace_buffer_unpack_cigar_linear(
   const int pattern_length = sequences->pattern_length;
   const int text_length = sequences->text_length;
   // Add init insertions/deletions
-  cigar_clear(cigar);
-  char* cigar_buffer = cigar->operations;
+  if (cigar->run_length) {
+    cigar_rle_clear(cigar);
+  } else {
+    cigar_clear(cigar);
+  }
   int i;
   int v = begin_v;
   int h = begin_h;
-  for (i=0;i<h;++i) {*cigar_buffer = 'I'; ++cigar_buffer;};
-  for (i=0;i<v;++i) {*cigar_buffer = 'D'; ++cigar_buffer;};
+  cigar_append_operation(cigar,'I',h);
+  cigar_append_operation(cigar,'D',v);
   // Traverse-forward the pcigars and unpack the cigar
   const int num_palignment_blocks = vector_get_used(bt_buffer->alignment_packed);
   pcigar_t* const palignment_blocks = vector_get_mem(bt_buffer->alignment_packed,pcigar_t);
   for (i=num_palignment_blocks-1;i>=0;--i) {
     // Unpack block
-    int cigar_block_length = 0;
-    pcigar_unpack_linear(
-        palignment_blocks[i],sequences,&v,&h,
-        cigar_buffer,&cigar_block_length);
-    // Update CIGAR
-    cigar_buffer += cigar_block_length;
+    pcigar_unpack_linear(palignment_blocks[i],sequences,&v,&h,cigar);
   }
   // Account for last stroke of matches
   const int num_matches = MIN(end_v-v,end_h-h);
-  for (i=0;i<num_matches;++i) {*cigar_buffer = 'M'; ++cigar_buffer;};
+  cigar_append_operation(cigar,'M',num_matches);
   v += num_matches;
   h += num_matches;
   // Account for last stroke of insertion/deletion
-  while (h < text_length) {*cigar_buffer = 'I'; ++cigar_buffer; ++h;};
-  while (v < pattern_length) {*cigar_buffer = 'D'; ++cigar_buffer; ++v;};
+  cigar_append_operation(cigar,'I',text_length-h);
+  cigar_append_operation(cigar,'D',pattern_length-v);
   // Close CIGAR
-  *cigar_buffer = '\0';
-  cigar->end_offset = cigar_buffer - cigar->operations;
+  if (cigar->run_length) {
+    cigar_rle_close(cigar,false);
+  } else {
+    cigar->operations[cigar->end_offset] = '\0';
+  }
 }
 void wf_backtrace_buffer_unpack_cigar_affine(
     wf_backtrace_buffer_t* const bt_buffer,
@@ -320,37 +515,40 @@ void wf_backtrace_buffer_unpack_cigar_affine(
   const int pattern_length = sequences->pattern_length;
   const int text_length = sequences->text_length;
   // Add init insertions/deletions
-  cigar_clear(cigar);
-  char* cigar_buffer = cigar->operations;
+  if (cigar->run_length) {
+    cigar_rle_clear(cigar);
+  } else {
+    cigar_clear(cigar);
+  }
   int i;
   int v = begin_v;
   int h = begin_h;
-  for (i=0;i<h;++i) {*cigar_buffer = 'I'; ++cigar_buffer;};
-  for (i=0;i<v;++i) {*cigar_buffer = 'D'; ++cigar_buffer;};
+  cigar_append_operation(cigar,'I',h);
+  cigar_append_operation(cigar,'D',v);
   // Traverse-forward the pcigars and unpack the cigar
   const int num_palignment_blocks = vector_get_used(bt_buffer->alignment_packed);
   pcigar_t* const palignment_blocks = vector_get_mem(bt_buffer->alignment_packed,pcigar_t);
   affine_matrix_type current_matrix_type = affine_matrix_M;
   for (i=num_palignment_blocks-1;i>=0;--i) {
     // Unpack block
-    int cigar_block_length = 0;
     pcigar_unpack_affine(
         palignment_blocks[i],sequences,&v,&h,
-        cigar_buffer,&cigar_block_length,&current_matrix_type);
-    // Update CIGAR
-    cigar_buffer += cigar_block_length;
+        cigar,&current_matrix_type);
   }
   // Account for last stroke of matches
   const int num_matches = MIN(end_v-v,end_h-h);
-  for (i=0;i<num_matches;++i) {*cigar_buffer = 'M'; ++cigar_buffer;};
+  cigar_append_operation(cigar,'M',num_matches);
   v += num_matches;
   h += num_matches;
   // Account for last stroke of insertion/deletion
-  while (h < text_length) {*cigar_buffer = 'I'; ++cigar_buffer; ++h;};
-  while (v < pattern_length) {*cigar_buffer = 'D'; ++cigar_buffer; ++v;};
+  cigar_append_operation(cigar,'I',text_length-h);
+  cigar_append_operation(cigar,'D',pattern_length-v);
   // Close CIGAR
-  *cigar_buffer = '\0';
-  cigar->end_offset = cigar_buffer - cigar->operations;
+  if (cigar->run_length) {
+    cigar_rle_close(cigar,false);
+  } else {
+    cigar->operations[cigar->end_offset] = '\0';
+  }
 }
 /*
  * Compact
@@ -378,13 +576,13 @@ void wf_backtrace_buffer_mark_backtrace_batch(
     wf_offset_t* const offsets,
     bt_block_idx_t* const bt_block_idxs,
     const int num_block_idxs,
-    bitmap_t* const bitmap) {
+    bitmap_t* const bitmap,
+    const bool atomic_marks) {
   // Parameters
   const bt_block_idx_t num_compacted_blocks = bt_buffer->num_compacted_blocks;
-  // Reserve prefetch-buffer
-  const int max_batch_size = 100;
-  vector_reserve(bt_buffer->prefetch_blocks_idxs,max_batch_size,false);
-  bt_block_idx_t* const pf_block_idx = vector_get_mem(bt_buffer->prefetch_blocks_idxs,bt_block_idx_t);
+  // Prefetch-buffer (private to each marking thread)
+  const int max_batch_size = BT_BUFFER_MARK_BATCH_SIZE;
+  bt_block_idx_t pf_block_idx[BT_BUFFER_MARK_BATCH_SIZE];
   // Fill-in loop (+ initial prefetch)
   int active_blocks = 0, next_idx = 0;
   while (active_blocks < max_batch_size && next_idx < num_block_idxs) {
@@ -407,9 +605,16 @@ void wf_backtrace_buffer_mark_backtrace_batch(
     // Fetch BT-block & BM-block
     const bt_block_idx_t block_idx = pf_block_idx[i];
     BITMAP_GET_BLOCK(bitmap,block_idx,block_bm_ptr);
-    // Check marked
-    if (!BM_BLOCK_IS_SET(*block_bm_ptr,block_idx)) {
-      BM_BLOCK_SET(*block_bm_ptr,block_idx);
+    // Check marked (atomically if other threads mark concurrently)
+    bool marked;
+    if (atomic_marks) {
+      const uint64_t mask = BITMAP_BLOCK_MASK << (block_idx % BITMAP_BLOCK_ELEMENTS);
+      marked = (__atomic_fetch_or(block_bm_ptr,mask,__ATOMIC_RELAXED) & mask) != 0;
+    } else {
+      marked = BM_BLOCK_IS_SET(*block_bm_ptr,block_idx);
+      if (!marked) BM_BLOCK_SET(*block_bm_ptr,block_idx);
+    }
+    if (!marked) {
       // Fetch next block
       bt_block_t* const bt_block = wf_backtrace_buffer_get_block(bt_buffer,block_idx);
       const bt_block_idx_t prev_block_idx = bt_block->prev_idx;
@@ -518,3 +723,267 @@ bt_block_idx_t wf_backtrace_buffer_compact_marked(
   // Return last index
   return write_global_pos - 1;
 }
+#ifdef WFA_PARALLEL
+bt_block_idx_t wf_backtrace_buffer_compact_chunk(
+    wf_backtrace_buffer_t* const bt_buffer,
+    bitmap_t* const bitmap,
+    const bt_block_idx_t chunk_begin,
+    const bt_block_idx_t chunk_end,
+    bt_block_t* const chunk_buffer) {
+  // Parameters
+  bt_block_t** const segments = vector_get_mem(bt_buffer->segments,bt_block_t*);
+  const bt_block_idx_t num_compacted_blocks = bt_buffer->num_compacted_blocks;
+  // Gather marked BT-blocks (chunks never cross segments)
+  bt_block_t* read_block = segments[BT_BUFFER_SEGMENT_IDX(chunk_begin)] + BT_BUFFER_SEGMENT_OFFSET(chunk_begin);
+  bt_block_idx_t read_global_pos, num_marked = 0;
+  for (read_global_pos=chunk_begin;read_global_pos<chunk_end;++read_global_pos,++read_block) {
+    BITMAP_GET_BLOCK(bitmap,read_global_pos,block_bitmap_ptr);
+    if (!BM_BLOCK_IS_SET(*block_bitmap_ptr,read_global_pos)) continue;
+    // Store pcigar and translated index
+    bt_block_t* const write_block = chunk_buffer + num_marked;
+    write_block->pcigar = read_block->pcigar;
+    if (read_block->prev_idx == BT_BLOCK_IDX_NULL ||
+        read_block->prev_idx < num_compacted_blocks) {
+      write_block->prev_idx = read_block->prev_idx;
+    } else {
+      write_block->prev_idx = num_compacted_blocks + bitmap_erank(bitmap,read_block->prev_idx);
+    }
+    ++num_marked;
+  }
+  // Return
+  return num_marked;
+}
+void wf_backtrace_buffer_compact_chunk_store(
+    wf_backtrace_buffer_t* const bt_buffer,
+    bt_block_idx_t write_global_pos,
+    bt_block_t* const chunk_buffer,
+    const bt_block_idx_t num_blocks) {
+  // Parameters
+  bt_block_t** const segments = vector_get_mem(bt_buffer->segments,bt_block_t*);
+  // Copy (possibly across two segments)
+  bt_block_idx_t num_stored = 0;
+  while (num_stored < num_blocks) {
+    const bt_block_idx_t write_offset = BT_BUFFER_SEGMENT_OFFSET(write_global_pos);
+    const bt_block_idx_t num_copy = MIN(num_blocks-num_stored,BT_BUFFER_SEGMENT_LENGTH-write_offset);
+    memcpy(segments[BT_BUFFER_SEGMENT_IDX(write_global_pos)]+write_offset,
+        chunk_buffer+num_stored,num_copy*sizeof(bt_block_t));
+    num_stored += num_copy;
+    write_global_pos += num_copy;
+  }
+}
+bt_block_idx_t wf_backtrace_buffer_compact_marked_parallel(
+    wf_backtrace_buffer_t* const bt_buffer,
+    bitmap_t* const bitmap,
+    const int num_threads,
+    const int verbose) {
+  // Parameters
+  bt_block_t** const segments = vector_get_mem(bt_buffer->segments,bt_block_t*);
+  const bt_block_idx_t num_compacted_blocks = bt_buffer->num_compacted_blocks;
+  const bt_block_idx_t max_block_idx = BT_BUFFER_IDX(bt_buffer->segment_idx,bt_buffer->segment_offset);
+  const bt_block_idx_t first_chunk = num_compacted_blocks / BT_BUFFER_COMPACT_CHUNK;
+  const bt_block_idx_t num_chunks = (max_block_idx > num_compacted_blocks) ?
+      (max_block_idx-1) / BT_BUFFER_COMPACT_CHUNK - first_chunk + 1 : 0;
+  // Allocate per-thread chunk buffers
+  bt_block_t* const chunk_buffers = mm_allocator_calloc(
+      bt_buffer->mm_allocator,(uint64_t)num_threads*BT_BUFFER_COMPACT_CHUNK,bt_block_t,false);
+  // Compact in rounds of one chunk per thread. Marked blocks of a round are
+  // gathered (read-only) before any is stored; stores never go beyond the
+  // round (compacted positions never exceed original ones)
+  bt_block_idx_t write_global_pos = num_compacted_blocks;
+  #pragma omp parallel num_threads(num_threads)
+  {
+    const int thread_id = omp_get_thread_num();
+    const int round_threads = omp_get_num_threads();
+    bt_block_t* const chunk_buffer = chunk_buffers + (uint64_t)thread_id*BT_BUFFER_COMPACT_CHUNK;
+    bt_block_idx_t round_chunk;
+    for (round_chunk=0;round_chunk<num_chunks;round_chunk+=round_threads) {
+      // Gather
+      const bt_block_idx_t chunk = round_chunk + thread_id;
+      bt_block_idx_t chunk_begin = 0, num_marked = 0;
+      if (chunk < num_chunks) {
+        const bt_block_idx_t chunk_pos = (first_chunk+chunk) * BT_BUFFER_COMPACT_CHUNK;
+        chunk_begin = MAX(chunk_pos,num_compacted_blocks);
+        const bt_block_idx_t chunk_end = MIN(chunk_pos+BT_BUFFER_COMPACT_CHUNK,max_block_idx);
+        num_marked = wf_backtrace_buffer_compact_chunk(bt_buffer,bitmap,chunk_begin,chunk_end,chunk_buffer);
+      }
+      #pragma omp barrier
+      // Store (prefix-sum of marked blocks given by the bitmap counters)
+      if (num_marked > 0) {
+        const bt_block_idx_t write_pos = num_compacted_blocks + bitmap_erank(bitmap,chunk_begin);
+        wf_backtrace_buffer_compact_chunk_store(bt_buffer,write_pos,chunk_buffer,num_marked);
+      }
+      if (chunk+1 == num_chunks) {
+        write_global_pos = num_compacted_blocks + bitmap_erank(bitmap,chunk_begin) + num_marked;
+      }
+      #pragma omp barrier
+    }
+  }
+  mm_allocator_free(bt_buffer->mm_allocator,chunk_buffers);
+  // Update next BT-buffer index
+  bt_buffer->segment_idx = BT_BUFFER_SEGMENT_IDX(write_global_pos);
+  bt_buffer->segment_offset = BT_BUFFER_SEGMENT_OFFSET(write_global_pos);
+  bt_buffer->block_next = segments[bt_buffer->segment_idx] + bt_buffer->segment_offset;
+  bt_buffer->num_compactions++;
+  // DEBUG
+  if (verbose >= 3) {
+    fprintf(stderr,"[WFA::BacktraceBuffer] Compacted from %lu MB to %lu MB (%2.2f%%) using %d threads",
+        CONVERT_B_TO_MB(max_block_idx*sizeof(bt_block_t)),
+        CONVERT_B_TO_MB(write_global_pos*sizeof(bt_block_t)),
+        100.0f*(float)write_global_pos/(float)max_block_idx,num_threads);
+  }
+  // Return last index
+  return write_global_pos - 1;
+}
+#endif
+/*
+ * Spill
+ */
+void wf_backtrace_buffer_spill_create(
+    wf_backtrace_buffer_t* const bt_buffer,
+    const char* const spill_path) {
+  // Create anonymous file (removed as soon as it is closed)
+  char* const file_name = malloc(strlen(spill_path)+32);
+  sprintf(file_name,"%s/wfa_bt_spill.XXXXXX",spill_path);
+  bt_buffer->spill_fd = mkstemp(file_name);
+  if (bt_buffer->spill_fd < 0) {
+    fprintf(stderr,"[WFA::BacktraceBuffer] Error creating spill file '%s'\n",file_name); exit(1);
+  }
+  unlink(file_name);
+  free(file_name);
+}
+void wf_backtrace_buffer_spill_write(
+    wf_backtrace_buffer_t* const bt_buffer,
+    const int segment_idx) {
+  bt_block_t** const segments = vector_get_mem(bt_buffer->segments,bt_block_t*);
+  const char* const memory = (const char*)segments[segment_idx];
+  const off_t file_offset = (off_t)segment_idx*BT_BUFFER_SEGMENT_BYTES;
+  uint64_t written = 0;
+  while (written < BT_BUFFER_SEGMENT_BYTES) {
+    const ssize_t bytes = pwrite(bt_buffer->spill_fd,
+        memory+written,BT_BUFFER_SEGMENT_BYTES-written,file_offset+written);
+    if (bytes <= 0) {
+      if (bytes < 0 && errno == EINTR) continue;
+      fprintf(stderr,"[WFA::BacktraceBuffer] Error writing spill file\n"); exit(1);
+    }
+    written += bytes;
+  }
+}
+void wf_backtrace_buffer_spill_cold(
+    wf_backtrace_buffer_t* const bt_buffer,
+    const char* const spill_path,
+    const int verbose) {
+  // Cold segments (entirely below the compaction horizon; never rewritten)
+  const int cold_segments = BT_BUFFER_SEGMENT_IDX(bt_buffer->num_compacted_blocks);
+  if (bt_buffer->num_compressed_segments > 0) return; // Compression took over
+  if (cold_segments <= bt_buffer->num_spilled_segments) return;
+  if (bt_buffer->spill_fd < 0) wf_backtrace_buffer_spill_create(bt_buffer,spill_path);
+  // Write & free segments
+  bt_block_t** const segments = vector_get_mem(bt_buffer->segments,bt_block_t*);
+  int i;
+  for (i=bt_buffer->num_spilled_segments;i<cold_segments;++i) {
+    wf_backtrace_buffer_spill_write(bt_buffer,i);
+    mm_allocator_free(bt_buffer->mm_allocator,segments[i]);
+    segments[i] = NULL;
+  }
+  // DEBUG
+  if (verbose >= 3) {
+    fprintf(stderr,"[WFA::BacktraceBuffer] Spilled %d segments (%lu MB on disk)\n",
+        cold_segments-bt_buffer->num_spilled_segments,
+        CONVERT_B_TO_MB((uint64_t)cold_segments*BT_BUFFER_SEGMENT_BYTES));
+  }
+  bt_buffer->num_spilled_segments = cold_segments;
+}
+/*
+ * Compress
+ */
+uint8_t* wf_backtrace_buffer_compress_chunk(
+    const bt_block_t* const bt_blocks,
+    const bt_block_idx_t chunk_block_idx,
+    uint8_t* data) {
+  int64_t prev_predicted = chunk_block_idx;
+  int i;
+  for (i=0;i<BT_BUFFER_CHUNK_LENGTH;++i) {
+    const pcigar_t pcigar = bt_blocks[i].pcigar;
+    const bt_block_idx_t prev_idx = bt_blocks[i].prev_idx;
+    // Compose header
+    uint64_t header;
+    int tag;
+    if (prev_idx == BT_BLOCK_IDX_NULL) {
+      tag = BT_BLOCK_TAG_INIT;
+      header = tag;
+    } else {
+      if (i > 0 && pcigar == bt_blocks[i-1].pcigar) {
+        tag = BT_BLOCK_TAG_REPEAT;
+      } else if (pcigar == PCIGAR_FULL_MISMATCH) {
+        tag = BT_BLOCK_TAG_MISMS;
+      } else {
+        tag = BT_BLOCK_TAG_PCIGAR;
+      }
+      const int64_t delta = (int64_t)prev_idx - prev_predicted;
+      const uint64_t zigzag = ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63);
+      header = (zigzag << 2) | tag;
+      prev_predicted = (int64_t)prev_idx + 1;
+    }
+    // Store header (varint)
+    while (header >= 0x80) {
+      *(data++) = (uint8_t)(header | 0x80);
+      header >>= 7;
+    }
+    *(data++) = (uint8_t)header;
+    // Store pcigar
+    if (tag == BT_BLOCK_TAG_PCIGAR || tag == BT_BLOCK_TAG_INIT) {
+      memcpy(data,&pcigar,sizeof(pcigar_t));
+      data += sizeof(pcigar_t);
+    }
+  }
+  return data;
+}
+void wf_backtrace_buffer_compress_segment(
+    wf_backtrace_buffer_t* const bt_buffer,
+    const int segment_idx) {
+  // Allocate (worst-case, then shrink)
+  bt_segment_compressed_t segment_compressed;
+  segment_compressed.chunk_offsets = malloc(BT_BUFFER_NUM_CHUNKS*sizeof(uint32_t));
+  uint8_t* const data = malloc((uint64_t)BT_BUFFER_NUM_CHUNKS*BT_BUFFER_CHUNK_MAX_BYTES);
+  // Encode chunks
+  bt_block_t** const segments = vector_get_mem(bt_buffer->segments,bt_block_t*);
+  const bt_block_t* const bt_blocks = segments[segment_idx];
+  const bt_block_idx_t segment_block_idx = BT_BUFFER_IDX(segment_idx,0);
+  uint8_t* data_end = data;
+  int i;
+  for (i=0;i<BT_BUFFER_NUM_CHUNKS;++i) {
+    segment_compressed.chunk_offsets[i] = data_end - data;
+    data_end = wf_backtrace_buffer_compress_chunk(
+        bt_blocks+i*BT_BUFFER_CHUNK_LENGTH,
+        segment_block_idx+i*BT_BUFFER_CHUNK_LENGTH,data_end);
+  }
+  segment_compressed.size = data_end - data;
+  segment_compressed.data = realloc(data,segment_compressed.size);
+  // Replace segment
+  vector_insert(bt_buffer->segments_compressed,segment_compressed,bt_segment_compressed_t);
+  bt_buffer->compressed_size += segment_compressed.size +
+      BT_BUFFER_NUM_CHUNKS*sizeof(uint32_t);
+  mm_allocator_free(bt_buffer->mm_allocator,segments[segment_idx]);
+  segments[segment_idx] = NULL;
+}
+void wf_backtrace_buffer_compress_cold(
+    wf_backtrace_buffer_t* const bt_buffer,
+    const int verbose) {
+  // Cold segments (entirely below the compaction horizon; never rewritten)
+  const int cold_segments = BT_BUFFER_SEGMENT_IDX(bt_buffer->num_compacted_blocks);
+  if (bt_buffer->num_spilled_segments > 0) return; // Spilling takes over
+  if (cold_segments <= bt_buffer->num_compressed_segments) return;
+  // Compress segments
+  int i;
+  for (i=bt_buffer->num_compressed_segments;i<cold_segments;++i) {
+    wf_backtrace_buffer_compress_segment(bt_buffer,i);
+  }
+  // DEBUG
+  if (verbose >= 3) {
+    fprintf(stderr,"[WFA::BacktraceBuffer] Compressed %d segments (overall %lu MB into %lu MB)\n",
+        cold_segments-bt_buffer->num_compressed_segments,
+        CONVERT_B_TO_MB((uint64_t)cold_segments*BT_BUFFER_SEGMENT_BYTES),
+        CONVERT_B_TO_MB(bt_buffer->compressed_size));
+  }
+  bt_buffer->num_compressed_segments = cold_segments;
+}
@@ -52,6 +52,15 @@ typedef struct {
   bt_block_idx_t prev_idx;    // Index of the previous BT-block
 } __attribute__((packed)) bt_block_t;
 
+/*
+ * Compressed BT-Block Segment (cold segments; decoded on the fly at traceback)
+ */
+typedef struct {
+  uint8_t* data;              // Encoded BT-blocks (varint headers + pcigars)
+  uint32_t* chunk_offsets;    // Offset of each chunk of BT-blocks within data
+  uint64_t size;              // Total encoded size (bytes)
+} bt_segment_compressed_t;
+
 /*
  * Backtrace initial positions
  */
@@ -73,9 +82,18 @@ typedef struct {
   vector_t* alignment_init_pos;        // Buffer to store alignment's initial coordinates (h,v) (wf_backtrace_init_pos_t)
   bt_block_idx_t num_compacted_blocks; // Total compacted blocks in BT-buffer compacted (dense from 0..num_compacted_blocks-1)
   int num_compactions;                 // Total compactions performed
+  // Spill (cold BT-segments written to a file)
+  int spill_fd;                        // Spill file descriptor (-1 if not created)
+  int num_spilled_segments;            // Segments spilled (dense from 0..num_spilled_segments-1)
+  bool spill_mapped;                   // Spilled segments mapped back in (read-only)
+  // Compression (cold BT-segments encoded in memory)
+  vector_t* segments_compressed;       // Compressed segments (bt_segment_compressed_t)
+  int num_compressed_segments;         // Segments compressed (dense from 0..num_compressed_segments-1)
+  uint64_t compressed_size;            // Total size of the compressed segments (bytes)
+  bt_block_t* chunk_cache;             // Decoded chunk of BT-blocks (traceback)
+  bt_block_idx_t chunk_cache_idx;      // Index of the first BT-block decoded (BT_BLOCK_IDX_NULL if none)
   // Internal buffers
   vector_t* alignment_packed;          // Temporal buffer to store final alignment (pcigar_t)
-  vector_t* prefetch_blocks_idxs;      // Temporal buffer to store blocks_idxs (bt_block_idx_t)
   // MM
   mm_allocator_t* mm_allocator;
 } wf_backtrace_buffer_t;
@@ -146,12 +164,35 @@ void wf_backtrace_buffer_mark_backtrace_batch(
     wf_offset_t* const offsets,
     bt_block_idx_t* const bt_block_idxs,
     const int num_block_idxs,
-    bitmap_t* const bitmap);
+    bitmap_t* const bitmap,
+    const bool atomic_marks);
 
 bt_block_idx_t wf_backtrace_buffer_compact_marked(
     wf_backtrace_buffer_t* const bt_buffer,
     bitmap_t* const bitmap,
     const int verbose);
+#ifdef WFA_PARALLEL
+bt_block_idx_t wf_backtrace_buffer_compact_marked_parallel(
+    wf_backtrace_buffer_t* const bt_buffer,
+    bitmap_t* const bitmap,
+    const int num_threads,
+    const int verbose);
+#endif
+
+/*
+ * Spill
+ */
+void wf_backtrace_buffer_spill_cold(
+    wf_backtrace_buffer_t* const bt_buffer,
+    const char* const spill_path,
+    const int verbose);
+
+/*
+ * Compress
+ */
+void wf_backtrace_buffer_compress_cold(
+    wf_backtrace_buffer_t* const bt_buffer,
+    const int verbose);
 
 /*
  * Utils
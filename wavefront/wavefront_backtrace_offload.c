@@ -29,6 +29,7 @@
  * DESCRIPTION: WaveFront alignment module for offloading partial backtraces
  */
 
+#include "wavefront_multiversion.h"
 #include "utils/commons.h"
 #include "wfa.h"
 #include "wavefront_backtrace_offload.h"
@@ -0,0 +1,808 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignment Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignment Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignment Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: WFA batch aligner (many short pairs aligned in lockstep across SIMD lanes)
+ */
+
+// Use cross-platform header
+#include <sys/types.h>
+
+#include "utils/commons.h"
+#include "wavefront_batch.h"
+#include "wavefront_align.h"
+#include "wavefront_compute.h"
+
+/*
+ * Setup
+ */
+wavefront_aligner_batch_t* wavefront_aligner_batch_new(
+    wavefront_aligner_attr_t* attributes) {
+  // Allocate
+  wavefront_aligner_batch_t* const wf_aligner_batch = malloc(sizeof(wavefront_aligner_batch_t));
+  // Scalar aligner (lanes compute exact alignments; disable heuristics so that
+  // the default wf-adaptive does not send every pair to the scalar aligner)
+  wavefront_aligner_attr_t batch_attributes = *attributes;
+  batch_attributes.heuristic.strategy = wf_heuristic_none;
+  wavefront_aligner_t* const wf_aligner = wavefront_aligner_new(&batch_attributes);
+  wf_aligner_batch->wf_aligner = wf_aligner;
+  wf_aligner_batch->num_lanes = (wf_aligner->kernels.isa == wf_kernels_avx512) ? 16 : 8;
+  wf_aligner_batch->num_lanes16 = 2*wf_aligner_batch->num_lanes;
+  wf_aligner_batch->offsets16 = false;
+  wf_aligner_batch->num_group_lanes = 0;
+  // Lanes
+  int l;
+  for (l=0;l<WF_BATCH_MAX_LANES;++l) {
+    wavefront_sequences_allocate(wf_aligner_batch->sequences+l);
+    wf_aligner_batch->null_offsets[l] = WAVEFRONT_OFFSET_NULL;
+    wf_aligner_batch->null_offsets16[l] = WAVEFRONT_OFFSET16_NULL;
+  }
+  // Wavefronts (modular)
+  wavefront_penalties_t* const penalties = &wf_aligner->penalties;
+  const int max_score_misms = penalties->mismatch;
+  const int max_score_indel = penalties->gap_opening1 + penalties->gap_extension1;
+  const int max_score_scope = (penalties->distance_metric == gap_affine) ?
+      MAX(max_score_misms,max_score_indel) + 1 : 2;
+  const int wf_length = 2*WF_BATCH_MAX_BAND + 3; // Including one null diagonal per side
+  const int wf_size = wf_length * WF_BATCH_MAX_LANES;
+  wf_aligner_batch->max_score_scope = max_score_scope;
+  wf_aligner_batch->wavefronts = malloc(max_score_scope*sizeof(wavefront_batch_wf_t));
+  wf_aligner_batch->offsets_buffer = malloc(3*max_score_scope*wf_size*sizeof(wf_offset_t));
+  int s, i, c;
+  for (s=0;s<max_score_scope;++s) {
+    wavefront_batch_wf_t* const wavefront = wf_aligner_batch->wavefronts + s;
+    for (c=0;c<3;++c) {
+      wf_offset_t* const offsets = wf_aligner_batch->offsets_buffer + (3*s+c)*wf_size;
+      for (i=0;i<wf_size;++i) offsets[i] = WAVEFRONT_OFFSET_NULL;
+      wavefront->offsets[c] = offsets + (WF_BATCH_MAX_BAND+1)*WF_BATCH_MAX_LANES;
+      wavefront->offsets16[c] = (wf_offset16_t*)offsets + (WF_BATCH_MAX_BAND+1)*WF_BATCH_MAX_LANES;
+    }
+    wavefront->null = true;
+  }
+  // Stats
+  wf_aligner_batch->num_aligned_lanes = 0;
+  wf_aligner_batch->num_aligned_lanes16 = 0;
+  wf_aligner_batch->num_aligned_fallback = 0;
+  // Return
+  return wf_aligner_batch;
+}
+void wavefront_aligner_batch_delete(
+    wavefront_aligner_batch_t* const wf_aligner_batch) {
+  int l;
+  for (l=0;l<WF_BATCH_MAX_LANES;++l) {
+    wavefront_sequences_free(wf_aligner_batch->sequences+l);
+  }
+  free(wf_aligner_batch->wavefronts);
+  free(wf_aligner_batch->offsets_buffer);
+  wavefront_aligner_delete(wf_aligner_batch->wf_aligner);
+  free(wf_aligner_batch);
+}
+/*
+ * Accessors
+ */
+#define WF_BATCH_M 0
+#define WF_BATCH_I 1
+#define WF_BATCH_D 2
+FORCE_INLINE wavefront_batch_wf_t* wavefront_batch_get_wavefront(
+    wavefront_aligner_batch_t* const wf_aligner_batch,
+    const int score) {
+  if (score < 0) return NULL;
+  wavefront_batch_wf_t* const wavefront =
+      wf_aligner_batch->wavefronts + (score % wf_aligner_batch->max_score_scope);
+  return (wavefront->null) ? NULL : wavefront;
+}
+FORCE_INLINE const wf_offset_t* wavefront_batch_get_offsets(
+    wavefront_aligner_batch_t* const wf_aligner_batch,
+    wavefront_batch_wf_t* const wavefront,
+    const int component,
+    const int k) {
+  if (wavefront == NULL || k < wavefront->lo || k > wavefront->hi) {
+    return wf_aligner_batch->null_offsets;
+  }
+  return wavefront->offsets[component] + k*WF_BATCH_MAX_LANES;
+}
+FORCE_INLINE const wf_offset16_t* wavefront_batch_get_offsets16(
+    wavefront_aligner_batch_t* const wf_aligner_batch,
+    wavefront_batch_wf_t* const wavefront,
+    const int component,
+    const int k) {
+  if (wavefront == NULL || k < wavefront->lo || k > wavefront->hi) {
+    return wf_aligner_batch->null_offsets16;
+  }
+  return wavefront->offsets16[component] + k*WF_BATCH_MAX_LANES;
+}
+FORCE_INLINE wf_offset_t wavefront_batch_get_offset(
+    wavefront_aligner_batch_t* const wf_aligner_batch,
+    wavefront_batch_wf_t* const wavefront,
+    const int component,
+    const int k,
+    const int lane) {
+  return (wf_aligner_batch->offsets16) ?
+      (wf_offset_t)wavefront->offsets16[component][k*WF_BATCH_MAX_LANES+lane] :
+      wavefront->offsets[component][k*WF_BATCH_MAX_LANES+lane];
+}
+FORCE_INLINE void wavefront_batch_set_offset(
+    wavefront_aligner_batch_t* const wf_aligner_batch,
+    wavefront_batch_wf_t* const wavefront,
+    const int component,
+    const int k,
+    const int lane,
+    const wf_offset_t offset) {
+  if (wf_aligner_batch->offsets16) {
+    wavefront->offsets16[component][k*WF_BATCH_MAX_LANES+lane] = (wf_offset16_t)offset;
+  } else {
+    wavefront->offsets[component][k*WF_BATCH_MAX_LANES+lane] = offset;
+  }
+}
+bool wavefront_batch_lanes_supported(
+    wavefront_aligner_t* const wf_aligner) {
+  const distance_metric_t distance_metric = wf_aligner->penalties.distance_metric;
+  return (distance_metric == indel ||
+          distance_metric == edit ||
+          distance_metric == gap_affine) &&
+         wf_aligner->alignment_scope == compute_score &&
+         wf_aligner->alignment_form.span == alignment_end2end &&
+         wf_aligner->heuristic.strategy == wf_heuristic_none;
+}
+/*
+ * Compute Kernels (all lanes in lockstep)
+ */
+FORCE_INLINE void wavefront_batch_compute_edit_kernel(
+    wavefront_aligner_batch_t* const wf_aligner_batch,
+    wavefront_batch_wf_t* const wf_prev,
+    wavefront_batch_wf_t* const wf_curr,
+    const int num_lanes) {
+  // Parameters
+  const int* const pattern_lengths = wf_aligner_batch->pattern_lengths;
+  const int* const text_lengths = wf_aligner_batch->text_lengths;
+  const bool is_indel = (wf_aligner_batch->wf_aligner->penalties.distance_metric == indel);
+  // Compute-Next kernel loop
+  int k, l;
+  for (k=wf_curr->lo;k<=wf_curr->hi;++k) {
+    // Fetch offsets (all lanes)
+    const wf_offset_t* const prev_ins = wavefront_batch_get_offsets(wf_aligner_batch,wf_prev,WF_BATCH_M,k-1);
+    const wf_offset_t* const prev_del = wavefront_batch_get_offsets(wf_aligner_batch,wf_prev,WF_BATCH_M,k+1);
+    const wf_offset_t* const prev_misms = wavefront_batch_get_offsets(wf_aligner_batch,wf_prev,WF_BATCH_M,k);
+    wf_offset_t* const curr_offsets = wf_curr->offsets[WF_BATCH_M] + k*WF_BATCH_MAX_LANES;
+    if (is_indel) {
+      PRAGMA_LOOP_VECTORIZE
+      for (l=0;l<num_lanes;++l) {
+        wf_offset_t max = MAX(prev_del[l],prev_ins[l]+1);
+        const wf_unsigned_offset_t h = WAVEFRONT_H(k,max);
+        const wf_unsigned_offset_t v = WAVEFRONT_V(k,max);
+        if (h > text_lengths[l]) max = WAVEFRONT_OFFSET_NULL;
+        if (v > pattern_lengths[l]) max = WAVEFRONT_OFFSET_NULL;
+        curr_offsets[l] = max;
+      }
+    } else {
+      PRAGMA_LOOP_VECTORIZE
+      for (l=0;l<num_lanes;++l) {
+        wf_offset_t max = MAX(prev_del[l],MAX(prev_ins[l],prev_misms[l])+1);
+        const wf_unsigned_offset_t h = WAVEFRONT_H(k,max);
+        const wf_unsigned_offset_t v = WAVEFRONT_V(k,max);
+        if (h > text_lengths[l]) max = WAVEFRONT_OFFSET_NULL;
+        if (v > pattern_lengths[l]) max = WAVEFRONT_OFFSET_NULL;
+        curr_offsets[l] = max;
+      }
+    }
+  }
+}
+FORCE_INLINE void wavefront_batch_compute_affine_kernel(
+    wavefront_aligner_batch_t* const wf_aligner_batch,
+    wavefront_batch_wf_t* const wf_misms,
+    wavefront_batch_wf_t* const wf_open,
+    wavefront_batch_wf_t* const wf_ext,
+    wavefront_batch_wf_t* const wf_curr,
+    const int num_lanes) {
+  // Parameters
+  const int* const pattern_lengths = wf_aligner_batch->pattern_lengths;
+  const int* const text_lengths = wf_aligner_batch->text_lengths;
+  // Compute-Next kernel loop
+  int k, l;
+  for (k=wf_curr->lo;k<=wf_curr->hi;++k) {
+    // In Offsets (all lanes)
+    const wf_offset_t* const m_misms = wavefront_batch_get_offsets(wf_aligner_batch,wf_misms,WF_BATCH_M,k);
+    const wf_offset_t* const m_open_ins = wavefront_batch_get_offsets(wf_aligner_batch,wf_open,WF_BATCH_M,k-1);
+    const wf_offset_t* const m_open_del = wavefront_batch_get_offsets(wf_aligner_batch,wf_open,WF_BATCH_M,k+1);
+    const wf_offset_t* const i_ext = wavefront_batch_get_offsets(wf_aligner_batch,wf_ext,WF_BATCH_I,k-1);
+    const wf_offset_t* const d_ext = wavefront_batch_get_offsets(wf_aligner_batch,wf_ext,WF_BATCH_D,k+1);
+    // Out Offsets (all lanes)
+    wf_offset_t* const out_m = wf_curr->offsets[WF_BATCH_M] + k*WF_BATCH_MAX_LANES;
+    wf_offset_t* const out_i = wf_curr->offsets[WF_BATCH_I] + k*WF_BATCH_MAX_LANES;
+    wf_offset_t* const out_d = wf_curr->offsets[WF_BATCH_D] + k*WF_BATCH_MAX_LANES;
+    PRAGMA_LOOP_VECTORIZE
+    for (l=0;l<num_lanes;++l) {
+      // Update I
+      const wf_offset_t ins = MAX(m_open_ins[l],i_ext[l]) + 1;
+      out_i[l] = ins;
+      // Update D
+      const wf_offset_t del = MAX(m_open_del[l],d_ext[l]);
+      out_d[l] = del;
+      // Update M
+      wf_offset_t max = MAX(del,MAX(m_misms[l]+1,ins));
+      // Adjust offset out of boundaries !(h>tlen,v>plen)
+      const wf_unsigned_offset_t h = WAVEFRONT_H(k,max);
+      const wf_unsigned_offset_t v = WAVEFRONT_V(k,max);
+      if (h > text_lengths[l]) max = WAVEFRONT_OFFSET_NULL;
+      if (v > pattern_lengths[l]) max = WAVEFRONT_OFFSET_NULL;
+      out_m[l] = max;
+    }
+  }
+}
+/*
+ * Compute Kernels (16-bit offsets, all lanes in lockstep)
+ *   Negative I/D offsets are reset to null so they cannot drift
+ *   towards valid values (narrow range of the 16-bit null offset)
+ */
+FORCE_INLINE void wavefront_batch_compute_edit16_kernel(
+    wavefront_aligner_batch_t* const wf_aligner_batch,
+    wavefront_batch_wf_t* const wf_prev,
+    wavefront_batch_wf_t* const wf_curr,
+    const int num_lanes) {
+  // Parameters
+  const wf_offset16_t* const pattern_lengths = wf_aligner_batch->pattern_lengths16;
+  const wf_offset16_t* const text_lengths = wf_aligner_batch->text_lengths16;
+  const bool is_indel = (wf_aligner_batch->wf_aligner->penalties.distance_metric == indel);
+  // Compute-Next kernel loop
+  int k, l;
+  for (k=wf_curr->lo;k<=wf_curr->hi;++k) {
+    // Fetch offsets (all lanes)
+    const wf_offset16_t* const prev_ins = wavefront_batch_get_offsets16(wf_aligner_batch,wf_prev,WF_BATCH_M,k-1);
+    const wf_offset16_t* const prev_del = wavefront_batch_get_offsets16(wf_aligner_batch,wf_prev,WF_BATCH_M,k+1);
+    const wf_offset16_t* const prev_misms = wavefront_batch_get_offsets16(wf_aligner_batch,wf_prev,WF_BATCH_M,k);
+    wf_offset16_t* const curr_offsets = wf_curr->offsets16[WF_BATCH_M] + k*WF_BATCH_MAX_LANES;
+    if (is_indel) {
+      PRAGMA_LOOP_VECTORIZE
+      for (l=0;l<num_lanes;++l) {
+        wf_offset16_t max = MAX(prev_del[l],prev_ins[l]+1);
+        const wf_unsigned_offset16_t h = WAVEFRONT_H(k,max);
+        const wf_unsigned_offset16_t v = WAVEFRONT_V(k,max);
+        if (h > (wf_unsigned_offset16_t)text_lengths[l]) max = WAVEFRONT_OFFSET16_NULL;
+        if (v > (wf_unsigned_offset16_t)pattern_lengths[l]) max = WAVEFRONT_OFFSET16_NULL;
+        curr_offsets[l] = max;
+      }
+    } else {
+      PRAGMA_LOOP_VECTORIZE
+      for (l=0;l<num_lanes;++l) {
+        wf_offset16_t max = MAX(prev_del[l],MAX(prev_ins[l],prev_misms[l])+1);
+        const wf_unsigned_offset16_t h = WAVEFRONT_H(k,max);
+        const wf_unsigned_offset16_t v = WAVEFRONT_V(k,max);
+        if (h > (wf_unsigned_offset16_t)text_lengths[l]) max = WAVEFRONT_OFFSET16_NULL;
+        if (v > (wf_unsigned_offset16_t)pattern_lengths[l]) max = WAVEFRONT_OFFSET16_NULL;
+        curr_offsets[l] = max;
+      }
+    }
+  }
+}
+FORCE_INLINE void wavefront_batch_compute_affine16_kernel(
+    wavefront_aligner_batch_t* const wf_aligner_batch,
+    wavefront_batch_wf_t* const wf_misms,
+    wavefront_batch_wf_t* const wf_open,
+    wavefront_batch_wf_t* const wf_ext,
+    wavefront_batch_wf_t* const wf_curr,
+    const int num_lanes) {
+  // Parameters
+  const wf_offset16_t* const pattern_lengths = wf_aligner_batch->pattern_lengths16;
+  const wf_offset16_t* const text_lengths = wf_aligner_batch->text_lengths16;
+  // Compute-Next kernel loop
+  int k, l;
+  for (k=wf_curr->lo;k<=wf_curr->hi;++k) {
+    // In Offsets (all lanes)
+    const wf_offset16_t* const m_misms = wavefront_batch_get_offsets16(wf_aligner_batch,wf_misms,WF_BATCH_M,k);
+    const wf_offset16_t* const m_open_ins = wavefront_batch_get_offsets16(wf_aligner_batch,wf_open,WF_BATCH_M,k-1);
+    const wf_offset16_t* const m_open_del = wavefront_batch_get_offsets16(wf_aligner_batch,wf_open,WF_BATCH_M,k+1);
+    const wf_offset16_t* const i_ext = wavefront_batch_get_offsets16(wf_aligner_batch,wf_ext,WF_BATCH_I,k-1);
+    const wf_offset16_t* const d_ext = wavefront_batch_get_offsets16(wf_aligner_batch,wf_ext,WF_BATCH_D,k+1);
+    // Out Offsets (all lanes)
+    wf_offset16_t* const out_m = wf_curr->offsets16[WF_BATCH_M] + k*WF_BATCH_MAX_LANES;
+    wf_offset16_t* const out_i = wf_curr->offsets16[WF_BATCH_I] + k*WF_BATCH_MAX_LANES;
+    wf_offset16_t* const out_d = wf_curr->offsets16[WF_BATCH_D] + k*WF_BATCH_MAX_LANES;
+    PRAGMA_LOOP_VECTORIZE
+    for (l=0;l<num_lanes;++l) {
+      // Update I
+      wf_offset16_t ins = MAX(m_open_ins[l],i_ext[l]) + 1;
+      if (ins < 0) ins = WAVEFRONT_OFFSET16_NULL;
+      out_i[l] = ins;
+      // Update D
+      wf_offset16_t del = MAX(m_open_del[l],d_ext[l]);
+      if (del < 0) del = WAVEFRONT_OFFSET16_NULL;
+      out_d[l] = del;
+      // Update M
+      wf_offset16_t max = MAX(del,MAX(m_misms[l]+1,ins));
+      // Adjust offset out of boundaries !(h>tlen,v>plen)
+      const wf_unsigned_offset16_t h = WAVEFRONT_H(k,max);
+      const wf_unsigned_offset16_t v = WAVEFRONT_V(k,max);
+      if (h > (wf_unsigned_offset16_t)text_lengths[l]) max = WAVEFRONT_OFFSET16_NULL;
+      if (v > (wf_unsigned_offset16_t)pattern_lengths[l]) max = WAVEFRONT_OFFSET16_NULL;
+      out_m[l] = max;
+    }
+  }
+}
+/*
+ * Compute Kernels (ISA variants)
+ */
+FORCE_NO_INLINE void wavefront_batch_compute_edit(
+    wavefront_aligner_batch_t* const wf_aligner_batch,
+    wavefront_batch_wf_t* const wf_prev,
+    wavefront_batch_wf_t* const wf_curr) {
+  wavefront_batch_compute_edit_kernel(
+      wf_aligner_batch,wf_prev,wf_curr,wf_aligner_batch->num_lanes);
+}
+FORCE_NO_INLINE void wavefront_batch_compute_affine(
+    wavefront_aligner_batch_t* const wf_aligner_batch,
+    wavefront_batch_wf_t* const wf_misms,
+    wavefront_batch_wf_t* const wf_open,
+    wavefront_batch_wf_t* const wf_ext,
+    wavefront_batch_wf_t* const wf_curr) {
+  wavefront_batch_compute_affine_kernel(
+      wf_aligner_batch,wf_misms,wf_open,wf_ext,wf_curr,wf_aligner_batch->num_lanes);
+}
+FORCE_NO_INLINE void wavefront_batch_compute_edit16(
+    wavefront_aligner_batch_t* const wf_aligner_batch,
+    wavefront_batch_wf_t* const wf_prev,
+    wavefront_batch_wf_t* const wf_curr) {
+  wavefront_batch_compute_edit16_kernel(
+      wf_aligner_batch,wf_prev,wf_curr,wf_aligner_batch->num_lanes16);
+}
+FORCE_NO_INLINE void wavefront_batch_compute_affine16(
+    wavefront_aligner_batch_t* const wf_aligner_batch,
+    wavefront_batch_wf_t* const wf_misms,
+    wavefront_batch_wf_t* const wf_open,
+    wavefront_batch_wf_t* const wf_ext,
+    wavefront_batch_wf_t* const wf_curr) {
+  wavefront_batch_compute_affine16_kernel(
+      wf_aligner_batch,wf_misms,wf_open,wf_ext,wf_curr,wf_aligner_batch->num_lanes16);
+}
+#if TARGET_X86
+FORCE_NO_INLINE TARGET_AVX2 void wavefront_batch_compute_edit_avx2(
+    wavefront_aligner_batch_t* const wf_aligner_batch,
+    wavefront_batch_wf_t* const wf_prev,
+    wavefront_batch_wf_t* const wf_curr) {
+  wavefront_batch_compute_edit_kernel(wf_aligner_batch,wf_prev,wf_curr,8);
+}
+FORCE_NO_INLINE TARGET_AVX2 void wavefront_batch_compute_affine_avx2(
+    wavefront_aligner_batch_t* const wf_aligner_batch,
+    wavefront_batch_wf_t* const wf_misms,
+    wavefront_batch_wf_t* const wf_open,
+    wavefront_batch_wf_t* const wf_ext,
+    wavefront_batch_wf_t* const wf_curr) {
+  wavefront_batch_compute_affine_kernel(wf_aligner_batch,wf_misms,wf_open,wf_ext,wf_curr,8);
+}
+FORCE_NO_INLINE TARGET_AVX2 void wavefront_batch_compute_edit16_avx2(
+    wavefront_aligner_batch_t* const wf_aligner_batch,
+    wavefront_batch_wf_t* const wf_prev,
+    wavefront_batch_wf_t* const wf_curr) {
+  wavefront_batch_compute_edit16_kernel(wf_aligner_batch,wf_prev,wf_curr,16);
+}
+FORCE_NO_INLINE TARGET_AVX2 void wavefront_batch_compute_affine16_avx2(
+    wavefront_aligner_batch_t* const wf_aligner_batch,
+    wavefront_batch_wf_t* const wf_misms,
+    wavefront_batch_wf_t* const wf_open,
+    wavefront_batch_wf_t* const wf_ext,
+    wavefront_batch_wf_t* const wf_curr) {
+  wavefront_batch_compute_affine16_kernel(wf_aligner_batch,wf_misms,wf_open,wf_ext,wf_curr,16);
+}
+FORCE_NO_INLINE TARGET_AVX512 void wavefront_batch_compute_edit_avx512(
+    wavefront_aligner_batch_t* const wf_aligner_batch,
+    wavefront_batch_wf_t* const wf_prev,
+    wavefront_batch_wf_t* const wf_curr) {
+  wavefront_batch_compute_edit_kernel(wf_aligner_batch,wf_prev,wf_curr,16);
+}
+FORCE_NO_INLINE TARGET_AVX512 void wavefront_batch_compute_affine_avx512(
+    wavefront_aligner_batch_t* const wf_aligner_batch,
+    wavefront_batch_wf_t* const wf_misms,
+    wavefront_batch_wf_t* const wf_open,
+    wavefront_batch_wf_t* const wf_ext,
+    wavefront_batch_wf_t* const wf_curr) {
+  wavefront_batch_compute_affine_kernel(wf_aligner_batch,wf_misms,wf_open,wf_ext,wf_curr,16);
+}
+FORCE_NO_INLINE TARGET_AVX512 void wavefront_batch_compute_edit16_avx512(
+    wavefront_aligner_batch_t* const wf_aligner_batch,
+    wavefront_batch_wf_t* const wf_prev,
+    wavefront_batch_wf_t* const wf_curr) {
+  wavefront_batch_compute_edit16_kernel(wf_aligner_batch,wf_prev,wf_curr,32);
+}
+FORCE_NO_INLINE TARGET_AVX512 void wavefront_batch_compute_affine16_avx512(
+    wavefront_aligner_batch_t* const wf_aligner_batch,
+    wavefront_batch_wf_t* const wf_misms,
+    wavefront_batch_wf_t* const wf_open,
+    wavefront_batch_wf_t* const wf_ext,
+    wavefront_batch_wf_t* const wf_curr) {
+  wavefront_batch_compute_affine16_kernel(wf_aligner_batch,wf_misms,wf_open,wf_ext,wf_curr,32);
+}
+#endif
+/*
+ * Compute
+ */
+void wavefront_batch_compute(
+    wavefront_aligner_batch_t* const wf_aligner_batch,
+    const int score) {
+  // Parameters
+  wavefront_penalties_t* const penalties = &wf_aligner_batch->wf_aligner->penalties;
+  const wavefront_kernels_isa_t isa = wf_aligner_batch->wf_aligner->kernels.isa;
+  wavefront_batch_wf_t* const wf_curr =
+      wf_aligner_batch->wavefronts + (score % wf_aligner_batch->max_score_scope);
+  // Fetch source wavefronts
+  wavefront_batch_wf_t *wf_misms, *wf_open, *wf_ext;
+  if (penalties->distance_metric == gap_affine) {
+    wf_misms = wavefront_batch_get_wavefront(wf_aligner_batch,score-penalties->mismatch);
+    wf_open = wavefront_batch_get_wavefront(wf_aligner_batch,score-penalties->gap_opening1-penalties->gap_extension1);
+    wf_ext = wavefront_batch_get_wavefront(wf_aligner_batch,score-penalties->gap_extension1);
+  } else {
+    wf_misms = wavefront_batch_get_wavefront(wf_aligner_batch,score-1);
+    wf_open = NULL;
+    wf_ext = NULL;
+  }
+  // Compute limits (common to all lanes)
+  int lo = INT32_MAX, hi = INT32_MIN;
+  if (wf_misms != NULL) { lo = MIN(lo,wf_misms->lo); hi = MAX(hi,wf_misms->hi); }
+  if (wf_open != NULL) { lo = MIN(lo,wf_open->lo); hi = MAX(hi,wf_open->hi); }
+  if (wf_ext != NULL) { lo = MIN(lo,wf_ext->lo); hi = MAX(hi,wf_ext->hi); }
+  if (lo > hi) { // All sources null
+    wf_curr->null = true;
+    return;
+  }
+  wf_curr->null = false;
+  wf_curr->lo = MAX(lo-1,-WF_BATCH_MAX_BAND);
+  wf_curr->hi = MIN(hi+1,WF_BATCH_MAX_BAND);
+  // Compute next wavefront (16-bit offsets)
+  if (wf_aligner_batch->offsets16) {
+    if (penalties->distance_metric == gap_affine) {
+      switch (isa) {
+#if TARGET_X86
+        case wf_kernels_avx512:
+          wavefront_batch_compute_affine16_avx512(wf_aligner_batch,wf_misms,wf_open,wf_ext,wf_curr);
+          break;
+        case wf_kernels_avx2:
+          wavefront_batch_compute_affine16_avx2(wf_aligner_batch,wf_misms,wf_open,wf_ext,wf_curr);
+          break;
+#endif
+        default:
+          wavefront_batch_compute_affine16(wf_aligner_batch,wf_misms,wf_open,wf_ext,wf_curr);
+          break;
+      }
+    } else {
+      switch (isa) {
+#if TARGET_X86
+        case wf_kernels_avx512:
+          wavefront_batch_compute_edit16_avx512(wf_aligner_batch,wf_misms,wf_curr);
+          break;
+        case wf_kernels_avx2:
+          wavefront_batch_compute_edit16_avx2(wf_aligner_batch,wf_misms,wf_curr);
+          break;
+#endif
+        default:
+          wavefront_batch_compute_edit16(wf_aligner_batch,wf_misms,wf_curr);
+          break;
+      }
+    }
+    return;
+  }
+  // Compute next wavefront (32-bit offsets)
+  if (penalties->distance_metric == gap_affine) {
+    switch (isa) {
+#if TARGET_X86
+      case wf_kernels_avx512:
+        wavefront_batch_compute_affine_avx512(wf_aligner_batch,wf_misms,wf_open,wf_ext,wf_curr);
+        break;
+      case wf_kernels_avx2:
+        wavefront_batch_compute_affine_avx2(wf_aligner_batch,wf_misms,wf_open,wf_ext,wf_curr);
+        break;
+#endif
+      default:
+        wavefront_batch_compute_affine(wf_aligner_batch,wf_misms,wf_open,wf_ext,wf_curr);
+        break;
+    }
+  } else {
+    switch (isa) {
+#if TARGET_X86
+      case wf_kernels_avx512:
+        wavefront_batch_compute_edit_avx512(wf_aligner_batch,wf_misms,wf_curr);
+        break;
+      case wf_kernels_avx2:
+        wavefront_batch_compute_edit_avx2(wf_aligner_batch,wf_misms,wf_curr);
+        break;
+#endif
+      default:
+        wavefront_batch_compute_edit(wf_aligner_batch,wf_misms,wf_curr);
+        break;
+    }
+  }
+}
+/*
+ * Extend (per lane)
+ */
+FORCE_INLINE wf_offset_t wavefront_batch_extend_kernel(
+    const char* const pattern,
+    const char* const text,
+    const int k,
+    wf_offset_t offset) {
+#if __BYTE_ORDER == __LITTLE_ENDIAN
+  // Fetch pattern/text blocks
+  uint64_t* pattern_blocks = (uint64_t*)(pattern+WAVEFRONT_V(k,offset));
+  uint64_t* text_blocks = (uint64_t*)(text+WAVEFRONT_H(k,offset));
+  // Compare 64-bits blocks
+  uint64_t cmp = *pattern_blocks ^ *text_blocks;
+  while (__builtin_expect(cmp==0,0)) {
+    offset += 8;
+    ++pattern_blocks;
+    ++text_blocks;
+    cmp = *pattern_blocks ^ *text_blocks;
+  }
+  // Count equal characters
+  return offset + DIV_FLOOR(__builtin_ctzl(cmp),8);
+#else
+  // Compare characters
+  while (pattern[WAVEFRONT_V(k,offset)] == text[WAVEFRONT_H(k,offset)]) ++offset;
+  return offset;
+#endif
+}
+void wavefront_batch_extend(
+    wavefront_aligner_batch_t* const wf_aligner_batch,
+    wavefront_batch_wf_t* const wavefront) {
+  // Parameters
+  const int num_lanes = wf_aligner_batch->num_group_lanes;
+  const bool* const active = wf_aligner_batch->active;
+  // Extend all lanes (sentinels bound every lane to its own sequences)
+  int k, l;
+  for (k=wavefront->lo;k<=wavefront->hi;++k) {
+    for (l=0;l<num_lanes;++l) {
+      const wf_offset_t offset = wavefront_batch_get_offset(wf_aligner_batch,wavefront,WF_BATCH_M,k,l);
+      if (!active[l] || offset < 0) continue;
+      wavefront_batch_set_offset(wf_aligner_batch,wavefront,WF_BATCH_M,k,l,
+          wavefront_batch_extend_kernel(
+              wf_aligner_batch->sequences[l].pattern,
+              wf_aligner_batch->sequences[l].text,k,offset));
+    }
+  }
+}
+/*
+ * Termination
+ */
+int wavefront_batch_terminate(
+    wavefront_aligner_batch_t* const wf_aligner_batch,
+    wavefront_batch_wf_t* const wavefront,
+    const int score) {
+  // Parameters
+  wavefront_aligner_t* const wf_aligner = wf_aligner_batch->wf_aligner;
+  const int num_lanes = wf_aligner_batch->num_group_lanes;
+  // Check each lane end
+  int l, num_active = 0;
+  for (l=0;l<num_lanes;++l) {
+    if (!wf_aligner_batch->active[l]) continue;
+    const int pattern_length = wf_aligner_batch->pattern_lengths[l];
+    const int text_length = wf_aligner_batch->text_lengths[l];
+    const int alignment_k = DPMATRIX_DIAGONAL(text_length,pattern_length);
+    if (wavefront != NULL && wavefront->lo <= alignment_k && alignment_k <= wavefront->hi) {
+      const wf_offset_t offset =
+          wavefront_batch_get_offset(wf_aligner_batch,wavefront,WF_BATCH_M,alignment_k,l);
+      if (offset >= text_length) {
+        wavefront_batch_pair_t* const pair = wf_aligner_batch->pairs[l];
+        pair->status = WF_STATUS_ALG_COMPLETED;
+        pair->score = wavefront_compute_classic_score(wf_aligner,pattern_length,text_length,score);
+        wf_aligner_batch->active[l] = false;
+        ++(wf_aligner_batch->num_aligned_lanes);
+        if (wf_aligner_batch->offsets16) ++(wf_aligner_batch->num_aligned_lanes16);
+        continue;
+      }
+    }
+    ++num_active;
+  }
+  return num_active;
+}
+void wavefront_batch_abort(
+    wavefront_aligner_batch_t* const wf_aligner_batch,
+    const int score) {
+  // Active lanes have no alignment within the maximum score
+  const int num_lanes = wf_aligner_batch->num_group_lanes;
+  int l;
+  for (l=0;l<num_lanes;++l) {
+    if (!wf_aligner_batch->active[l]) continue;
+    wavefront_batch_pair_t* const pair = wf_aligner_batch->pairs[l];
+    pair->status = WF_STATUS_MAX_SCORE_REACHED;
+    pair->score = -score;
+    wf_aligner_batch->active[l] = false;
+    ++(wf_aligner_batch->num_aligned_lanes);
+    if (wf_aligner_batch->offsets16) ++(wf_aligner_batch->num_aligned_lanes16);
+  }
+}
+int wavefront_batch_check_band(
+    wavefront_aligner_batch_t* const wf_aligner_batch,
+    wavefront_batch_wf_t* const wavefront) {
+  // Parameters
+  const int num_lanes = wf_aligner_batch->num_group_lanes;
+  // Lanes reaching the band limits are handed to the scalar aligner
+  int l, c, num_active = 0;
+  for (l=0;l<num_lanes;++l) {
+    if (!wf_aligner_batch->active[l]) continue;
+    if (wavefront != NULL) {
+      bool overflow = false;
+      for (c=0;c<3;++c) {
+        if (wavefront->lo == -WF_BATCH_MAX_BAND &&
+            wavefront_batch_get_offset(wf_aligner_batch,wavefront,c,-WF_BATCH_MAX_BAND,l) >= 0) overflow = true;
+        if (wavefront->hi == WF_BATCH_MAX_BAND &&
+            wavefront_batch_get_offset(wf_aligner_batch,wavefront,c,WF_BATCH_MAX_BAND,l) >= 0) overflow = true;
+      }
+      if (overflow) {
+        wf_aligner_batch->active[l] = false;
+        wf_aligner_batch->fallback[l] = true;
+        continue;
+      }
+    }
+    ++num_active;
+  }
+  return num_active;
+}
+/*
+ * Batch Align (lanes)
+ */
+void wavefront_batch_init(
+    wavefront_aligner_batch_t* const wf_aligner_batch,
+    wavefront_batch_pair_t* const pairs,
+    const int num_pairs,
+    const bool offsets16) {
+  // Offsets width
+  wf_aligner_batch->offsets16 = offsets16;
+  wf_aligner_batch->num_group_lanes = (offsets16) ?
+      wf_aligner_batch->num_lanes16 : wf_aligner_batch->num_lanes;
+  // Load lanes
+  const int num_lanes = wf_aligner_batch->num_group_lanes;
+  int l;
+  for (l=0;l<num_lanes;++l) {
+    if (l < num_pairs) {
+      wavefront_batch_pair_t* const pair = pairs + l;
+      const int alignment_k = DPMATRIX_DIAGONAL(pair->text_length,pair->pattern_length);
+      const bool fits_lanes = (ABS(alignment_k) < WF_BATCH_MAX_BAND) &&
+          (pair->pattern_length+pair->text_length <= WAVEFRONT_OFFSET_MAX_LENGTH);
+      wf_aligner_batch->pairs[l] = pair;
+      wf_aligner_batch->active[l] = fits_lanes;
+      wf_aligner_batch->fallback[l] = !fits_lanes;
+      if (fits_lanes) {
+        wavefront_sequences_init_ascii(wf_aligner_batch->sequences+l,
+            pair->pattern,pair->pattern_length,pair->text,pair->text_length,false);
+        wf_aligner_batch->pattern_lengths[l] = pair->pattern_length;
+        wf_aligner_batch->text_lengths[l] = pair->text_length;
+        wf_aligner_batch->pattern_lengths16[l] = (offsets16) ? pair->pattern_length : 0;
+        wf_aligner_batch->text_lengths16[l] = (offsets16) ? pair->text_length : 0;
+        continue;
+      }
+    } else {
+      wf_aligner_batch->pairs[l] = NULL;
+      wf_aligner_batch->active[l] = false;
+      wf_aligner_batch->fallback[l] = false;
+    }
+    wf_aligner_batch->pattern_lengths[l] = 0;
+    wf_aligner_batch->text_lengths[l] = 0;
+    wf_aligner_batch->pattern_lengths16[l] = 0;
+    wf_aligner_batch->text_lengths16[l] = 0;
+  }
+  // Initialize wavefronts
+  int s;
+  for (s=0;s<wf_aligner_batch->max_score_scope;++s) {
+    wf_aligner_batch->wavefronts[s].null = true;
+  }
+  wavefront_batch_wf_t* const wavefront = wf_aligner_batch->wavefronts;
+  wavefront->null = false;
+  wavefront->lo = 0;
+  wavefront->hi = 0;
+  for (l=0;l<WF_BATCH_MAX_LANES;++l) {
+    wavefront_batch_set_offset(wf_aligner_batch,wavefront,WF_BATCH_M,0,l,0);
+    wavefront_batch_set_offset(wf_aligner_batch,wavefront,WF_BATCH_I,0,l,
+        (offsets16) ? WAVEFRONT_OFFSET16_NULL : WAVEFRONT_OFFSET_NULL);
+    wavefront_batch_set_offset(wf_aligner_batch,wavefront,WF_BATCH_D,0,l,
+        (offsets16) ? WAVEFRONT_OFFSET16_NULL : WAVEFRONT_OFFSET_NULL);
+  }
+}
+void wavefront_batch_align_lanes(
+    wavefront_aligner_batch_t* const wf_aligner_batch,
+    wavefront_batch_pair_t* const pairs,
+    const int num_pairs,
+    const bool offsets16) {
+  // Init
+  wavefront_batch_init(wf_aligner_batch,pairs,num_pairs,offsets16);
+  // Parameters
+  const int max_alignment_steps = wf_aligner_batch->wf_aligner->system.max_alignment_steps;
+  const int max_score = wf_aligner_batch->wf_aligner->system.max_score;
+  const int num_lanes = wf_aligner_batch->num_group_lanes;
+  // Compute wavefronts of increasing score (all lanes in lockstep)
+  int score = 0;
+  while (true) {
+    // Extend & check termination (per lane)
+    wavefront_batch_wf_t* const wavefront = wavefront_batch_get_wavefront(wf_aligner_batch,score);
+    if (wavefront != NULL) wavefront_batch_extend(wf_aligner_batch,wavefront);
+    if (wavefront_batch_terminate(wf_aligner_batch,wavefront,score) == 0) break;
+    // Compute next wavefront
+    if (++score >= max_alignment_steps) break;
+    if (score > max_score) {
+      wavefront_batch_abort(wf_aligner_batch,score);
+      break;
+    }
+    wavefront_batch_compute(wf_aligner_batch,score);
+    if (wavefront_batch_check_band(wf_aligner_batch,
+        wavefront_batch_get_wavefront(wf_aligner_batch,score)) == 0) break;
+  }
+  // Unfinished lanes fall back to the scalar aligner
+  int l;
+  for (l=0;l<num_lanes;++l) {
+    if (wf_aligner_batch->active[l]) {
+      wf_aligner_batch->active[l] = false;
+      wf_aligner_batch->fallback[l] = true;
+    }
+  }
+}
+/*
+ * Batch Align
+ */
+void wavefront_batch_align_scalar(
+    wavefront_aligner_batch_t* const wf_aligner_batch,
+    wavefront_batch_pair_t* const pair) {
+  wavefront_aligner_t* const wf_aligner = wf_aligner_batch->wf_aligner;
+  pair->status = wavefront_align(wf_aligner,
+      pair->pattern,pair->pattern_length,pair->text,pair->text_length);
+  pair->score = wf_aligner->cigar->score;
+  ++(wf_aligner_batch->num_aligned_fallback);
+}
+bool wavefront_batch_group_offsets16(
+    wavefront_batch_pair_t* const pairs,
+    const int num_pairs) {
+  int i;
+  for (i=0;i<num_pairs;++i) {
+    if (pairs[i].pattern_length+pairs[i].text_length > WAVEFRONT_OFFSET16_MAX_LENGTH) return false;
+  }
+  return true;
+}
+void wavefront_align_batch(
+    wavefront_aligner_batch_t* const wf_aligner_batch,
+    wavefront_batch_pair_t* const pairs,
+    const int num_pairs) {
+  // Check configuration supported by the lanes
+  if (!wavefront_batch_lanes_supported(wf_aligner_batch->wf_aligner)) {
+    int i;
+    for (i=0;i<num_pairs;++i) {
+      wavefront_batch_align_scalar(wf_aligner_batch,pairs+i);
+    }
+    return;
+  }
+  // Align groups of pairs in lockstep
+  int i, l;
+  for (i=0;i<num_pairs;) {
+    // Use 16-bit offsets (twice the lanes) if all pairs in the group are short
+    const bool offsets16 = wavefront_batch_group_offsets16(
+        pairs+i,MIN(wf_aligner_batch->num_lanes16,num_pairs-i));
+    const int num_lanes = (offsets16) ?
+        wf_aligner_batch->num_lanes16 : wf_aligner_batch->num_lanes;
+    const int num_group = MIN(num_lanes,num_pairs-i);
+    wavefront_batch_align_lanes(wf_aligner_batch,pairs+i,num_group,offsets16);
+    // Scalar fallback
+    for (l=0;l<num_group;++l) {
+      if (wf_aligner_batch->fallback[l]) {
+        wavefront_batch_align_scalar(wf_aligner_batch,pairs+i+l);
+      }
+    }
+    i += num_group;
+  }
+}
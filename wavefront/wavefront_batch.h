@@ -0,0 +1,124 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignment Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignment Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignment Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: WFA batch aligner (many short pairs aligned in lockstep across SIMD lanes)
+ */
+
+#ifndef WAVEFRONT_BATCH_H_
+#define WAVEFRONT_BATCH_H_
+
+#include "utils/commons.h"
+#include "wavefront_aligner.h"
+
+/*
+ * Configuration
+ */
+#define WF_BATCH_MAX_LANES 32 // Pairs aligned in lockstep (AVX512: 16/32, AVX2/Scalar: 8/16 using 32/16-bit offsets)
+#define WF_BATCH_MAX_BAND  32 // Max |k| per lane (wider wavefronts fall back to the scalar aligner)
+
+/*
+ * Batch pair (input sequences & output score)
+ */
+typedef struct {
+  // Input
+  const char* pattern;          // Pattern sequence
+  int pattern_length;           // Pattern length
+  const char* text;             // Text sequence
+  int text_length;              // Text length
+  // Output
+  int status;                   // Alignment status (WF_STATUS_*)
+  int score;                    // Alignment score
+} wavefront_batch_pair_t;
+
+/*
+ * Batch wavefront (all lanes interleaved per diagonal)
+ */
+typedef struct {
+  bool null;                    // Null wavefront (no source wavefronts)
+  int lo;                       // Lowest diagonal (common to all lanes)
+  int hi;                       // Highest diagonal (common to all lanes)
+  wf_offset_t* offsets[3];      // M/I/D offsets ([k][lane], positioned at k=0)
+  wf_offset16_t* offsets16[3];  // M/I/D 16-bit offsets (same memory, used if all lanes are short)
+} wavefront_batch_wf_t;
+
+/*
+ * Batch Aligner
+ */
+typedef struct {
+  // Scalar aligner (configuration & fallback)
+  wavefront_aligner_t* wf_aligner;                       // Scalar aligner
+  int num_lanes;                                         // Lanes used (depends on the kernels ISA)
+  int num_lanes16;                                       // Lanes used with 16-bit offsets
+  // Current group
+  bool offsets16;                                        // Group aligned using 16-bit offsets
+  int num_group_lanes;                                   // Lanes used by the group
+  // Lanes
+  wavefront_sequences_t sequences[WF_BATCH_MAX_LANES];   // Lane sequences (padded)
+  wavefront_batch_pair_t* pairs[WF_BATCH_MAX_LANES];     // Lane pairs
+  int pattern_lengths[WF_BATCH_MAX_LANES];               // Lane pattern lengths
+  int text_lengths[WF_BATCH_MAX_LANES];                  // Lane text lengths
+  wf_offset16_t pattern_lengths16[WF_BATCH_MAX_LANES];   // Lane pattern lengths (16-bit)
+  wf_offset16_t text_lengths16[WF_BATCH_MAX_LANES];      // Lane text lengths (16-bit)
+  bool active[WF_BATCH_MAX_LANES];                       // Lane still aligning
+  bool fallback[WF_BATCH_MAX_LANES];                     // Lane requires the scalar aligner
+  // Wavefronts
+  int max_score_scope;                                   // Wavefronts kept (modular)
+  wavefront_batch_wf_t* wavefronts;                      // Wavefronts (max_score_scope)
+  wf_offset_t* offsets_buffer;                           // Offsets memory
+  wf_offset_t null_offsets[WF_BATCH_MAX_LANES];          // Null row (all lanes)
+  wf_offset16_t null_offsets16[WF_BATCH_MAX_LANES];      // Null row (all lanes, 16-bit)
+  // Stats
+  uint64_t num_aligned_lanes;                            // Pairs aligned using the lanes
+  uint64_t num_aligned_lanes16;                          // Pairs aligned using the lanes (16-bit offsets)
+  uint64_t num_aligned_fallback;                         // Pairs aligned using the scalar aligner
+} wavefront_aligner_batch_t;
+
+/*
+ * Setup
+ */
+wavefront_aligner_batch_t* wavefront_aligner_batch_new(
+    wavefront_aligner_attr_t* attributes);
+void wavefront_aligner_batch_delete(
+    wavefront_aligner_batch_t* const wf_aligner_batch);
+
+/*
+ * Batch Align
+ *   Score-only end-to-end alignments (indel, edit, gap-affine) are
+ *   computed in lockstep across the SIMD lanes. Any other configuration,
+ *   and any pair whose wavefront outgrows WF_BATCH_MAX_BAND, is aligned
+ *   using the scalar aligner. Groups of pairs whose pattern_length+text_length
+ *   fit WAVEFRONT_OFFSET16_MAX_LENGTH use 16-bit offsets (twice the lanes);
+ *   otherwise, 32-bit offsets are used. Batch aligners are exact: the
+ *   heuristic set in the attributes is ignored (wf_heuristic_none).
+ */
+void wavefront_align_batch(
+    wavefront_aligner_batch_t* const wf_aligner_batch,
+    wavefront_batch_pair_t* const pairs,
+    const int num_pairs);
+
+#endif /* WAVEFRONT_BATCH_H_ */
@@ -28,6 +28,7 @@
  * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
  */
 
+#include "wavefront_multiversion.h"
 #include "utils/commons.h"
 #include "wavefront_bialign.h"
 #include "wavefront_unialign.h"
@@ -42,8 +43,17 @@
 #include "wavefront_plot.h"
 #include "wavefront_debug.h"
 
-#if __AVX2__
+// SIMD breakpoint detection (32-bit offset lanes)
+#if __AVX2__ && !defined(WFA_OFFSET16)
+#define WF_BIALIGN_BREAKPOINT_SIMD 1
 #include <immintrin.h>
+#else
+#define WF_BIALIGN_BREAKPOINT_SIMD 0
+#endif
+
+#ifdef WFA_PARALLEL
+#include <omp.h>
+#include <sched.h>
 #endif
 
 /*
@@ -52,6 +62,7 @@
 #define WF_BIALIGN_FALLBACK_MIN_SCORE  250
 #define WF_BIALIGN_FALLBACK_MIN_LENGTH 100
 #define WF_BIALIGN_RECOVERY_MIN_SCORE  500
+#define WF_BIALIGN_PARALLEL_MIN_LENGTH 10000
 
 /*
  * Debug
@@ -165,8 +176,10 @@ int wavefront_bialign_base(
   // Parameters
   wavefront_aligner_t* const wf_base = wf_aligner->bialigner->wf_base;
   const int verbose = wf_base->system.verbose;
-  // Configure
+  // Configure (max-score only bounds the whole alignment, not its sub-alignments)
   wf_base->alignment_form = *form;
+  wf_base->system.max_score = (align_level == 0) ?
+      wf_aligner->bialigner->wf_forward->system.max_score : INT_MAX;
   wavefront_unialign_init(wf_base,component_begin,component_end);
   // DEBUG
   if (verbose >= 2) wavefront_debug_begin(wf_base);
@@ -179,10 +192,17 @@ int wavefront_bialign_base(
   }
   // Append CIGAR
   cigar_append_forward(wf_aligner->cigar,wf_base->cigar);
+  if (align_level == 0) { // Whole alignment solved by the base case
+    wf_aligner->cigar->score = wf_base->cigar->score;
+    wf_aligner->cigar->end_v = wf_base->cigar->end_v;
+    wf_aligner->cigar->end_h = wf_base->cigar->end_h;
+  }
   // Set status and return
   const int align_status = wf_base->align_status.status;
   if (align_status == WF_STATUS_ALG_COMPLETED) {
     return WF_STATUS_OK;
+  } else if (align_status == WF_STATUS_MAX_SCORE_REACHED) {
+    return WF_STATUS_MAX_SCORE_REACHED;
   } else {
     return WF_STATUS_UNATTAINABLE;
   }
@@ -190,7 +210,7 @@ int wavefront_bialign_base(
 /*
  * Bidirectional check breakpoints
  */
-#if __AVX2__ 
+#if WF_BIALIGN_BREAKPOINT_SIMD
 #if __AVX512CD__ && __AVX512VL__
 void wavefront_bialign_breakpoint_indel2indel_avx512(
     wavefront_aligner_t* const wf_aligner,
@@ -482,7 +502,7 @@ void wavefront_bialign_breakpoint_indel2indel(
     wavefront_t* const dwf_1,
     const affine2p_matrix_type component,
     wf_bialign_breakpoint_t* const breakpoint) {
-#if __AVX2__
+#if WF_BIALIGN_BREAKPOINT_SIMD
 #if __AVX512CD__ && __AVX512VL__
   wavefront_bialign_breakpoint_indel2indel_avx512(
       wf_aligner,
@@ -570,7 +590,7 @@ void wavefront_bialign_breakpoint_indel2indel(
   }
 #endif // AVX2
 }
-#if __AVX2__
+#if WF_BIALIGN_BREAKPOINT_SIMD
 #if __AVX512CD__ && __AVX512VL__
 void wavefront_bialign_breakpoint_m2m_avx512(
     wavefront_aligner_t* const wf_aligner,
@@ -804,7 +824,7 @@ void wavefront_bialign_breakpoint_m2m(
     wf_bialign_breakpoint_t* const breakpoint) {
   // Parameters
   if (score_0 + score_1 >= breakpoint->score) return;
-#if __AVX2__
+#if WF_BIALIGN_BREAKPOINT_SIMD
 #if __AVX512CD__ && __AVX512VL__
   wavefront_bialign_breakpoint_m2m_avx512(
       wf_aligner,
@@ -971,6 +991,151 @@ int wavefront_bialign_overlap_gopen_adjust(
       return 0;
   }
 }
+int wavefront_bialign_max_score_bound(
+    wavefront_aligner_t* const wf_aligner,
+    const distance_metric_t distance_metric,
+    const int align_level) {
+  /*
+   * Any alignment of score S splits into a forward part of score a<=sf
+   * and a reverse part b, where b < S-sf+P (P being the largest single
+   * operation penalty) plus a gap-opening if the split falls into a gap.
+   * Thus, if no overlap is found once sf+sr > S+P+gap_opening, there is
+   * no alignment within S. Only applies to the whole alignment (level-0)
+   */
+  const int max_score = wf_aligner->system.max_score;
+  if (align_level > 0 || max_score == INT_MAX) return INT_MAX;
+  wavefront_penalties_t* const penalties = &wf_aligner->penalties;
+  int max_op_penalty;
+  switch (distance_metric) {
+    case gap_linear:
+      max_op_penalty = MAX(penalties->mismatch,penalties->gap_opening1);
+      break;
+    case gap_affine:
+      max_op_penalty = MAX(penalties->mismatch,penalties->gap_opening1+penalties->gap_extension1);
+      break;
+    case gap_affine_2p:
+      max_op_penalty = MAX(penalties->mismatch,MAX(
+          penalties->gap_opening1+penalties->gap_extension1,
+          penalties->gap_opening2+penalties->gap_extension2));
+      break;
+    case indel:
+    case edit:
+    default:
+      max_op_penalty = 1;
+      break;
+  }
+  const int64_t bound = (int64_t)max_score + max_op_penalty +
+      wavefront_bialign_overlap_gopen_adjust(wf_aligner,distance_metric);
+  return (bound > INT_MAX) ? INT_MAX : (int)bound;
+}
+#ifdef WFA_PARALLEL
+/*
+ * Bidirectional breakpoint detection (two threads)
+ *   Each direction advances on its own thread. After every score step,
+ *   each thread publishes its max-antidiagonal (per score parity) and
+ *   then its score watermark. Before moving on, a thread waits until the
+ *   other direction has reached the same score, so that both threads
+ *   take the same decision on the same snapshot (fwd(s),rev(s)).
+ */
+typedef struct {
+  int score[2];      // Last score step completed (forward/reverse)
+  int max_ak[2][2];  // Max antidiagonal reached (forward/reverse; score parity)
+  bool quit[2][2];   // End reached (forward/reverse; score parity)
+} wf_bialign_watermarks_t;
+bool wavefront_bialign_parallel_enabled(
+    wavefront_bialigner_t* const bialigner,
+    const int pattern_length,
+    const int text_length) {
+  wavefront_aligner_t* const wf_forward = bialigner->wf_forward;
+  if (wf_forward->system.max_num_threads < 2) return false;
+  if (wf_forward->plot != NULL) return false;
+  if (pattern_length + text_length < WF_BIALIGN_PARALLEL_MIN_LENGTH) return false;
+  return omp_get_active_level() < omp_get_max_active_levels(); // Nested team available
+}
+int wavefront_bialign_parallel_wait(
+    wf_bialign_watermarks_t* const watermarks,
+    const int direction,
+    const int score) {
+  int spins = 0, score_direction;
+  while (true) {
+    #pragma omp atomic read seq_cst
+    score_direction = watermarks->score[direction];
+    if (score_direction >= score) return score_direction;
+    if (++spins > 1000) sched_yield();
+  }
+}
+bool wavefront_bialign_find_collision_parallel(
+    wavefront_bialigner_t* const bialigner,
+    const int forward_max_ak,
+    const int reverse_max_ak,
+    const int max_antidiagonal,
+    const int max_score_bound,
+    int* const collision_score,
+    int* const align_status) {
+  // Parameters
+  const int max_alignment_steps = bialigner->wf_forward->system.max_alignment_steps;
+  void (*wf_align_compute)(wavefront_aligner_t* const,const int) = bialigner->wf_align_compute;
+  // Watermarks (score-0 already computed)
+  wf_bialign_watermarks_t watermarks = {
+      .score = {0,0},
+      .max_ak = {{forward_max_ak,0},{reverse_max_ak,0}},
+      .quit = {{false,false},{false,false}},
+  };
+  bool performed = true;
+  #pragma omp parallel num_threads(2)
+  {
+    const int direction = omp_get_thread_num();
+    if (omp_get_num_threads() < 2) {
+      performed = false; // No second thread available
+    } else {
+      wavefront_aligner_t* const wf_aligner = (direction==0) ? bialigner->wf_forward : bialigner->wf_reverse;
+      const int other = 1 - direction;
+      int score = 0, max_ak = watermarks.max_ak[direction][0];
+      while (true) {
+        // Wait for the other direction to complete the same score
+        wavefront_bialign_parallel_wait(&watermarks,other,score);
+        // Check stable snapshot (fwd(score),rev(score))
+        const int parity = score % 2;
+        if (watermarks.quit[0][parity]) { // End reached (forward first)
+          if (direction==0) *align_status = bialigner->wf_forward->align_status.status;
+          break;
+        }
+        if (watermarks.quit[1][parity]) { // End reached (reverse)
+          if (direction==0) *align_status = bialigner->wf_reverse->align_status.status;
+          break;
+        }
+        if (score > 0 && 2*score >= max_alignment_steps) {
+          if (direction==0) *align_status = WF_STATUS_MAX_STEPS_REACHED;
+          break;
+        }
+        if (2*score > max_score_bound) {
+          if (direction==0) *align_status = WF_STATUS_MAX_SCORE_REACHED;
+          break;
+        }
+        if (watermarks.max_ak[0][parity] + watermarks.max_ak[1][parity] >= max_antidiagonal) {
+          if (direction==0) {
+            *collision_score = score;
+            *align_status = WF_STATUS_OK;
+          }
+          break;
+        }
+        // Compute & extend next wavefront
+        ++score;
+        (*wf_align_compute)(wf_aligner,score);
+        int ak = 0;
+        const bool reachability_quit = wavefront_extend_end2end_max(wf_aligner,score,&ak);
+        if (max_ak < ak) max_ak = ak;
+        // Publish (max_ak & quit, then score watermark)
+        watermarks.max_ak[direction][score%2] = max_ak;
+        watermarks.quit[direction][score%2] = reachability_quit;
+        #pragma omp atomic write seq_cst
+        watermarks.score[direction] = score;
+      }
+    }
+  }
+  return performed;
+}
+#endif
 int wavefront_bialign_find_breakpoint(
     wavefront_bialigner_t* const bialigner,
     const distance_metric_t distance_metric,
@@ -995,6 +1160,7 @@ int wavefront_bialign_find_breakpoint(
   void (*wf_align_compute)(wavefront_aligner_t* const,const int) = bialigner->wf_align_compute;
   // Parameters
   const int max_alignment_steps = wf_forward->system.max_alignment_steps;
+  const int max_score_bound = wavefront_bialign_max_score_bound(wf_forward,distance_metric,align_level);
   const int max_antidiagonal = DPMATRIX_ANTIDIAGONAL(pattern_length,text_length) - 1; // Note: Even removing -1
   int score_forward = 0, score_reverse = 0, forward_max_ak = 0, reverse_max_ak = 0;
   bool reachability_quit;
@@ -1007,7 +1173,23 @@ int wavefront_bialign_find_breakpoint(
   // Compute wavefronts of increasing score until both wavefronts overlap
   int max_ak = 0;
   bool last_wf_forward = false;
-  while (true) {
+  bool collision_found = false;
+#ifdef WFA_PARALLEL
+  if (wavefront_bialign_parallel_enabled(bialigner,pattern_length,text_length)) {
+    int collision_score = 0, align_status = WF_STATUS_OK;
+    collision_found = wavefront_bialign_find_collision_parallel(bialigner,
+        forward_max_ak,reverse_max_ak,max_antidiagonal,max_score_bound,
+        &collision_score,&align_status);
+    if (collision_found) {
+      if (align_status != WF_STATUS_OK) return align_status;
+      // Both directions stopped at the same score (check forward against reverse)
+      score_forward = collision_score;
+      score_reverse = collision_score;
+      wavefront_bialign_overlap(wf_forward,wf_reverse,score_forward,score_reverse,true,breakpoint);
+    }
+  }
+#endif
+  while (!collision_found) {
     // Check close-to-collision
     if (forward_max_ak + reverse_max_ak >= max_antidiagonal) break;
     /*
@@ -1036,6 +1218,7 @@ int wavefront_bialign_find_breakpoint(
     // Check end-reached and max-steps-reached
     if (reachability_quit) return wf_reverse->align_status.status;
     if (score_reverse + score_forward >= max_alignment_steps) return WF_STATUS_MAX_STEPS_REACHED;
+    if (score_reverse + score_forward > max_score_bound) return WF_STATUS_MAX_SCORE_REACHED;
     // DEBUG
     if (verbose >= 3 && score_forward % system->probe_interval_global == 0) {
       wavefront_unialign_print_status(stderr,wf_forward,score_forward);
@@ -1074,9 +1257,14 @@ int wavefront_bialign_find_breakpoint(
     reachability_quit = wavefront_extend_end2end(wf_forward,score_forward);
     if (reachability_quit) return wf_forward->align_status.status;
     if (score_reverse + score_forward >= max_alignment_steps) return WF_STATUS_MAX_STEPS_REACHED;
+    if (score_reverse + score_forward > max_score_bound) return WF_STATUS_MAX_SCORE_REACHED;
     // Enable always
     last_wf_forward = true;
   }
+  // Check max-score (breakpoint score is the whole alignment score at level-0)
+  if (align_level == 0 && breakpoint->score > system->max_score) {
+    return WF_STATUS_MAX_SCORE_REACHED;
+  }
   // Return OK
   return WF_STATUS_OK;
 }
@@ -1098,7 +1286,10 @@ int wavefront_bialign_find_breakpoint_exception(
     } else {
       score_reached = wf_reverse->align_status.score;
     }
-    // Fallback if possible
+    // Check max-score & fallback if possible
+    if (align_level == 0 && score_reached > wf_forward->system.max_score) {
+      return WF_STATUS_MAX_SCORE_REACHED;
+    }
     if (score_reached <= WF_BIALIGN_RECOVERY_MIN_SCORE) {
       return wavefront_bialign_base(wf_aligner,form,component_begin,component_end,align_level);
     } else {
@@ -1141,6 +1332,33 @@ void wavefront_bialign_init_half_1(
   half_form->text_begin_free = 0;
   half_form->text_end_free = global_form->text_end_free;
 }
+wavefront_aligner_t* wavefront_bialign_get_worker(
+    wavefront_aligner_t* const wf_aligner,
+    const int pattern_begin,
+    const int pattern_end,
+    const int text_begin,
+    const int text_end,
+    const int align_level) {
+#ifdef WFA_PARALLEL
+  // Check parallel context (tasks are spawned within the team)
+  wavefront_bialigner_t* const bialigner = wf_aligner->bialigner;
+  const int half_length = (pattern_end-pattern_begin) + (text_end-text_begin);
+  if (bialigner->num_workers == 0 || wf_aligner->plot != NULL) return NULL;
+  if (half_length < WF_BIALIGN_PARALLEL_MIN_LENGTH || align_level >= 30) return NULL;
+  if (!omp_in_parallel()) return NULL;
+  // Each node at level L hands its second half to worker (id + 2^L)
+  const int worker_id = bialigner->worker_id + (1 << align_level);
+  if (worker_id > bialigner->num_workers) return NULL;
+  wavefront_aligner_t* const wf_worker = wavefront_bialigner_get_worker(bialigner,worker_id);
+  // Prepare the worker's half (only once it is handed work)
+  cigar_resize(wf_worker->cigar,2*half_length);
+  wavefront_bialigner_set_sequences_worker(wf_worker->bialigner,bialigner,
+      pattern_begin,pattern_end,text_begin,text_end);
+  return wf_worker;
+#else
+  return NULL;
+#endif
+}
 int wavefront_bialign_alignment(
     wavefront_aligner_t* const wf_aligner,
     alignment_form_t* const form,
@@ -1186,30 +1404,64 @@ int wavefront_bialign_alignment(
         wf_aligner,form,component_begin,component_end,align_level,align_status);
   }
   // Breakpoint found
+  if (wf_aligner->system.stats_enabled) {
+    wf_aligner->stats.bialign_breakpoints++;
+    wf_aligner->stats.bialign_max_depth = MAX(wf_aligner->stats.bialign_max_depth,align_level+1);
+  }
   const int breakpoint_h = WAVEFRONT_H(breakpoint.k_forward,breakpoint.offset_forward);
   const int breakpoint_v = WAVEFRONT_V(breakpoint.k_forward,breakpoint.offset_forward);
   // DEBUG
   if (wf_aligner->system.verbose >= 3) wavefront_bialign_debug(&breakpoint,align_level);
-  // Align half_0
-  alignment_form_t form_0;
-  wavefront_bialigner_set_sequences_bounds(wf_aligner->bialigner,
-      pattern_begin,pattern_begin+breakpoint_v,
-      text_begin,text_begin+breakpoint_h);
-  wavefront_bialign_init_half_0(form,&form_0);
-  align_status = wavefront_bialign_alignment(wf_aligner,
-      &form_0,component_begin,breakpoint.component,
-      breakpoint.score_forward,align_level+1);
-  if (align_status != WF_STATUS_OK) return align_status;
-  // Align half_1
-  alignment_form_t form_1;
-  wavefront_bialigner_set_sequences_bounds(wf_aligner->bialigner,
-      pattern_begin+breakpoint_v,pattern_end,
-      text_begin+breakpoint_h,text_end);
-  wavefront_bialign_init_half_1(form,&form_1);
-  align_status = wavefront_bialign_alignment(wf_aligner,
-      &form_1,breakpoint.component,component_end,
-      breakpoint.score_reverse,align_level+1);
-  if (align_status != WF_STATUS_OK) return align_status;
+  // Select worker for half_1 (if any)
+  wavefront_aligner_t* const wf_worker = wavefront_bialign_get_worker(wf_aligner,
+      pattern_begin+breakpoint_v,pattern_end,text_begin+breakpoint_h,text_end,align_level);
+  if (wf_worker != NULL) {
+#ifdef WFA_PARALLEL
+    // Align half_1 (worker task)
+    int align_status_1;
+    alignment_form_t form_1;
+    wavefront_bialign_init_half_1(form,&form_1);
+    #pragma omp task shared(align_status_1)
+    align_status_1 = wavefront_bialign_alignment(wf_worker,
+        &form_1,breakpoint.component,component_end,
+        breakpoint.score_reverse,align_level+1);
+    // Align half_0
+    alignment_form_t form_0;
+    wavefront_bialigner_set_sequences_bounds(wf_aligner->bialigner,
+        pattern_begin,pattern_begin+breakpoint_v,
+        text_begin,text_begin+breakpoint_h);
+    wavefront_bialign_init_half_0(form,&form_0);
+    align_status = wavefront_bialign_alignment(wf_aligner,
+        &form_0,component_begin,breakpoint.component,
+        breakpoint.score_forward,align_level+1);
+    #pragma omp taskwait
+    if (align_status != WF_STATUS_OK) return align_status;
+    if (align_status_1 != WF_STATUS_OK) return align_status_1;
+    // Stitch half_1 after half_0
+    cigar_append_forward(wf_aligner->cigar,wf_worker->cigar);
+#endif
+  } else {
+    // Align half_0
+    alignment_form_t form_0;
+    wavefront_bialigner_set_sequences_bounds(wf_aligner->bialigner,
+        pattern_begin,pattern_begin+breakpoint_v,
+        text_begin,text_begin+breakpoint_h);
+    wavefront_bialign_init_half_0(form,&form_0);
+    align_status = wavefront_bialign_alignment(wf_aligner,
+        &form_0,component_begin,breakpoint.component,
+        breakpoint.score_forward,align_level+1);
+    if (align_status != WF_STATUS_OK) return align_status;
+    // Align half_1
+    alignment_form_t form_1;
+    wavefront_bialigner_set_sequences_bounds(wf_aligner->bialigner,
+        pattern_begin+breakpoint_v,pattern_end,
+        text_begin+breakpoint_h,text_end);
+    wavefront_bialign_init_half_1(form,&form_1);
+    align_status = wavefront_bialign_alignment(wf_aligner,
+        &form_1,breakpoint.component,component_end,
+        breakpoint.score_reverse,align_level+1);
+    if (align_status != WF_STATUS_OK) return align_status;
+  }
   // Set score (Strictly speaking, only needed at level-0)
   if (align_level == 0) {
     cigar_t* const cigar = wf_aligner->cigar;
@@ -1244,10 +1496,15 @@ int wavefront_bialign_compute_score(
   }
   // Check status
   cigar_t* const cigar = wf_aligner->cigar;
+  if (align_status == WF_STATUS_OK && wf_aligner->system.stats_enabled) {
+    wf_aligner->stats.bialign_breakpoints++;
+    wf_aligner->stats.bialign_max_depth = 1;
+  }
   if (align_status == WF_STATUS_OK || align_status == WF_STATUS_END_REACHED) {
     if (align_status == WF_STATUS_END_REACHED) {
       breakpoint.score = (wf_forward->align_status.status == WF_STATUS_END_REACHED) ?
           wf_forward->align_status.score : wf_reverse->align_status.score;
+      if (breakpoint.score > wf_forward->system.max_score) return WF_STATUS_MAX_SCORE_REACHED;
     }
     // Set status & score
     cigar->score = wavefront_compute_classic_score(wf_aligner,pattern_length,text_length,breakpoint.score);
@@ -1277,16 +1534,42 @@ void wavefront_bialign(
     cigar_resize(wf_aligner->cigar,2*(pattern_length+text_length)); // Resize & clear
     // Bidirectional alignment
     const bool min_length = MAX(pattern_length,text_length) <= WF_BIALIGN_FALLBACK_MIN_LENGTH;
-    align_status = wavefront_bialign_alignment(wf_aligner,
-        &wf_aligner->alignment_form,
-        affine_matrix_M,affine_matrix_M,
-        min_length ? 0 : INT_MAX,0);
+#ifdef WFA_PARALLEL
+    // Parallel halves (tasks handed to the workers)
+    const int num_workers = wf_aligner->bialigner->num_workers;
+    const bool parallel_halves =
+        num_workers > 0 && wf_aligner->plot == NULL && !omp_in_parallel() &&
+        pattern_length + text_length >= WF_BIALIGN_PARALLEL_MIN_LENGTH;
+    if (parallel_halves) {
+      // Allow the two-thread breakpoint search to open a team within the halves' team
+      const int max_active_levels = omp_get_max_active_levels();
+      if (max_active_levels < 2) omp_set_max_active_levels(2);
+      #pragma omp parallel num_threads(num_workers+1)
+      {
+        #pragma omp single
+        align_status = wavefront_bialign_alignment(wf_aligner,
+            &wf_aligner->alignment_form,
+            affine_matrix_M,affine_matrix_M,
+            min_length ? 0 : INT_MAX,0);
+      }
+      if (max_active_levels < 2) omp_set_max_active_levels(max_active_levels);
+    } else
+#endif
+    {
+      align_status = wavefront_bialign_alignment(wf_aligner,
+          &wf_aligner->alignment_form,
+          affine_matrix_M,affine_matrix_M,
+          min_length ? 0 : INT_MAX,0);
+    }
   }
   // Check status
   if (align_status == WF_STATUS_OK) {
     wf_aligner->align_status.status = WF_STATUS_ALG_COMPLETED;
   } else if (align_status == WF_STATUS_MAX_STEPS_REACHED || align_status == WF_STATUS_OOM) {
     wf_aligner->align_status.status = align_status;
+  } else if (align_status == WF_STATUS_MAX_SCORE_REACHED) {
+    wf_aligner->cigar->score = -(wf_aligner->system.max_score+1);
+    wf_aligner->align_status.status = align_status;
   } else { // Other cases
     wf_aligner->align_status.status = WF_STATUS_UNATTAINABLE;
   }
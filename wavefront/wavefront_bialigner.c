@@ -34,6 +34,56 @@
 #include "wavefront_attributes.h"
 #include "wavefront_heuristic.h"
 
+/*
+ * Workers
+ */
+void wavefront_bialigner_workers_allocate(
+    wavefront_bialigner_t* const wf_bialigner,
+    const int num_workers) {
+  // Init
+  wf_bialigner->workers = NULL;
+  wf_bialigner->num_workers = 0;
+#ifdef WFA_PARALLEL
+  if (num_workers <= 0) return;
+  // Allocate worker aligners (own forward/reverse/base aligners, own CIGAR)
+  wf_bialigner->workers = malloc(num_workers*sizeof(wavefront_aligner_t*));
+  wf_bialigner->num_workers = num_workers;
+  int i;
+  for (i=0;i<num_workers;++i) {
+    wavefront_aligner_t* const worker = wavefront_aligner_new(&wf_bialigner->workers_attr);
+    wavefront_bialigner_t* const worker_bialigner = worker->bialigner;
+    worker_bialigner->workers = wf_bialigner->workers;
+    worker_bialigner->num_workers = num_workers;
+    worker_bialigner->worker_id = i+1;
+    // Inherit the current configuration
+    alignment_system_t* const system = &wf_bialigner->wf_base->system;
+    wavefront_bialigner_set_heuristic(worker_bialigner,&wf_bialigner->wf_forward->heuristic);
+    wavefront_bialigner_set_max_alignment_steps(worker_bialigner,system->max_alignment_steps);
+    wavefront_bialigner_set_max_score(worker_bialigner,system->max_score);
+    wavefront_bialigner_set_max_memory(worker_bialigner,
+        system->max_memory_resident,system->max_memory_abort);
+    // Inherit the thread budget (two-thread breakpoint search within the halves)
+    wavefront_bialigner_set_max_num_threads(worker_bialigner,system->max_num_threads);
+    wf_bialigner->workers[i] = worker;
+  }
+#endif
+}
+void wavefront_bialigner_workers_free(
+    wavefront_bialigner_t* const wf_bialigner) {
+  if (wf_bialigner->worker_id != 0) return; // Owned by the master aligner
+  int i;
+  for (i=0;i<wf_bialigner->num_workers;++i) {
+    wavefront_aligner_delete(wf_bialigner->workers[i]);
+  }
+  if (wf_bialigner->workers != NULL) free(wf_bialigner->workers);
+  wf_bialigner->workers = NULL;
+  wf_bialigner->num_workers = 0;
+}
+wavefront_aligner_t* wavefront_bialigner_get_worker(
+    wavefront_bialigner_t* const wf_bialigner,
+    const int worker_id) {
+  return wf_bialigner->workers[worker_id-1];
+}
 /*
  * Setup
  */
@@ -69,6 +119,13 @@ wavefront_bialigner_t* wavefront_bialigner_new(
   wf_bialigner->wf_base = wavefront_aligner_new(&subsidiary_attr);
   wf_bialigner->wf_base->align_mode = wf_align_biwfa_subsidiary;
   wf_bialigner->wf_base->plot = plot;
+  // Allocate workers
+  wf_bialigner->workers_attr = *attributes;
+  wf_bialigner->workers_attr.mm_allocator = NULL;        // Own allocator (thread-safe)
+  wf_bialigner->workers_attr.plot.enabled = false;       // Plots are not supported
+  wf_bialigner->workers_attr.system.max_num_threads = 1; // Workers have no workers (budget set once allocated)
+  wf_bialigner->worker_id = 0;
+  wavefront_bialigner_workers_allocate(wf_bialigner,attributes->system.max_num_threads-1);
   // Return
   return wf_bialigner;
 }
@@ -77,12 +134,19 @@ void wavefront_bialigner_reap(
   wavefront_aligner_reap(wf_bialigner->wf_forward);
   wavefront_aligner_reap(wf_bialigner->wf_reverse);
   wavefront_aligner_reap(wf_bialigner->wf_base);
+  if (wf_bialigner->worker_id == 0) {
+    int i;
+    for (i=0;i<wf_bialigner->num_workers;++i) {
+      wavefront_aligner_reap(wf_bialigner->workers[i]);
+    }
+  }
 }
 void wavefront_bialigner_delete(
     wavefront_bialigner_t* const wf_bialigner) {
   wavefront_aligner_delete(wf_bialigner->wf_forward);
   wavefront_aligner_delete(wf_bialigner->wf_reverse);
   wavefront_aligner_delete(wf_bialigner->wf_base);
+  wavefront_bialigner_workers_free(wf_bialigner);
   free(wf_bialigner);
 }
 /*
@@ -133,6 +197,55 @@ void wavefront_bialigner_set_sequences_packed2bits(
       &wf_bialigner->wf_base->sequences,
       pattern,pattern_length,text,text_length,false);
 }
+void wavefront_bialigner_pin_pattern(
+    wavefront_bialigner_t* const wf_bialigner,
+    const char* const pattern,
+    const int pattern_length) {
+  wavefront_sequences_pin_pattern(
+      &wf_bialigner->wf_forward->sequences,pattern,pattern_length,false);
+  wavefront_sequences_pin_pattern(
+      &wf_bialigner->wf_reverse->sequences,pattern,pattern_length,true);
+  wavefront_sequences_pin_pattern(
+      &wf_bialigner->wf_base->sequences,pattern,pattern_length,false);
+}
+void wavefront_bialigner_unpin_pattern(
+    wavefront_bialigner_t* const wf_bialigner) {
+  wavefront_sequences_unpin_pattern(&wf_bialigner->wf_forward->sequences);
+  wavefront_sequences_unpin_pattern(&wf_bialigner->wf_reverse->sequences);
+  wavefront_sequences_unpin_pattern(&wf_bialigner->wf_base->sequences);
+}
+void wavefront_bialigner_set_text(
+    wavefront_bialigner_t* const wf_bialigner,
+    const char* const text,
+    const int text_length) {
+  wavefront_sequences_init_text(&wf_bialigner->wf_forward->sequences,text,text_length);
+  wavefront_sequences_init_text(&wf_bialigner->wf_reverse->sequences,text,text_length);
+  wavefront_sequences_init_text(&wf_bialigner->wf_base->sequences,text,text_length);
+}
+void wavefront_bialigner_set_sequences_worker(
+    wavefront_bialigner_t* const wf_bialigner,
+    wavefront_bialigner_t* const wf_bialigner_parent,
+    const int pattern_begin,
+    const int pattern_end,
+    const int text_begin,
+    const int text_end) {
+  // Parameters
+  wavefront_sequences_t* const forward = &wf_bialigner_parent->wf_forward->sequences;
+  wavefront_sequences_t* const reverse = &wf_bialigner_parent->wf_reverse->sequences;
+  if (forward->mode == wf_sequences_ascii) {
+    // Copy the half only (ASCII buffers are truncated using EOS chars, so they cannot be shared)
+    wavefront_bialigner_set_sequences_ascii(wf_bialigner,
+        forward->pattern_buffer+pattern_begin,pattern_end-pattern_begin,
+        forward->text_buffer+text_begin,text_end-text_begin);
+  } else {
+    // Share the parent's sequences (read-only)
+    wavefront_sequences_init_shared(&wf_bialigner->wf_forward->sequences,forward);
+    wavefront_sequences_init_shared(&wf_bialigner->wf_reverse->sequences,reverse);
+    wavefront_sequences_init_shared(&wf_bialigner->wf_base->sequences,forward);
+    wavefront_bialigner_set_sequences_bounds(wf_bialigner,
+        pattern_begin,pattern_end,text_begin,text_end);
+  }
+}
 void wavefront_bialigner_set_sequences_bounds(
     wavefront_bialigner_t* const wf_bialigner,
     const int pattern_begin,
@@ -154,9 +267,17 @@ void wavefront_bialigner_set_sequences_bounds(
  */
 uint64_t wavefront_bialigner_get_size(
     wavefront_bialigner_t* const wf_bialigner) {
-  return wavefront_aligner_get_size(wf_bialigner->wf_forward) +
+  uint64_t size =
+      wavefront_aligner_get_size(wf_bialigner->wf_forward) +
       wavefront_aligner_get_size(wf_bialigner->wf_reverse) +
       wavefront_aligner_get_size(wf_bialigner->wf_base);
+  if (wf_bialigner->worker_id == 0) {
+    int i;
+    for (i=0;i<wf_bialigner->num_workers;++i) {
+      size += wavefront_aligner_get_size(wf_bialigner->workers[i]);
+    }
+  }
+  return size;
 }
 void wavefront_bialigner_set_heuristic(
     wavefront_bialigner_t* const wf_bialigner,
@@ -164,6 +285,13 @@ void wavefront_bialigner_set_heuristic(
   wf_bialigner->wf_forward->heuristic = *heuristic;
   wf_bialigner->wf_reverse->heuristic = *heuristic;
   // Heuristics are not inherited to wf_base
+  // Workers
+  if (wf_bialigner->worker_id == 0) {
+    int i;
+    for (i=0;i<wf_bialigner->num_workers;++i) {
+      wavefront_bialigner_set_heuristic(wf_bialigner->workers[i]->bialigner,heuristic);
+    }
+  }
 }
 void wavefront_bialigner_set_max_alignment_steps(
     wavefront_bialigner_t* const wf_bialigner,
@@ -171,6 +299,29 @@ void wavefront_bialigner_set_max_alignment_steps(
   wf_bialigner->wf_forward->system.max_alignment_steps = max_alignment_steps;
   wf_bialigner->wf_reverse->system.max_alignment_steps = max_alignment_steps;
   wf_bialigner->wf_base->system.max_alignment_steps = max_alignment_steps;
+  // Workers
+  if (wf_bialigner->worker_id == 0) {
+    int i;
+    for (i=0;i<wf_bialigner->num_workers;++i) {
+      wavefront_bialigner_set_max_alignment_steps(
+          wf_bialigner->workers[i]->bialigner,max_alignment_steps);
+    }
+  }
+}
+void wavefront_bialigner_set_max_score(
+    wavefront_bialigner_t* const wf_bialigner,
+    const int max_score) {
+  wf_bialigner->wf_forward->system.max_score = max_score;
+  wf_bialigner->wf_reverse->system.max_score = max_score;
+  wf_bialigner->wf_base->system.max_score = max_score;
+  // Workers
+  if (wf_bialigner->worker_id == 0) {
+    int i;
+    for (i=0;i<wf_bialigner->num_workers;++i) {
+      wavefront_bialigner_set_max_score(
+          wf_bialigner->workers[i]->bialigner,max_score);
+    }
+  }
 }
 void wavefront_bialigner_set_max_memory(
     wavefront_bialigner_t* const wf_bialigner,
@@ -182,6 +333,14 @@ void wavefront_bialigner_set_max_memory(
   wf_bialigner->wf_reverse->system.max_memory_abort = max_memory_abort;
   wf_bialigner->wf_base->system.max_memory_resident = max_memory_resident;
   wf_bialigner->wf_base->system.max_memory_abort = max_memory_abort;
+  // Workers
+  if (wf_bialigner->worker_id == 0) {
+    int i;
+    for (i=0;i<wf_bialigner->num_workers;++i) {
+      wavefront_bialigner_set_max_memory(
+          wf_bialigner->workers[i]->bialigner,max_memory_resident,max_memory_abort);
+    }
+  }
 }
 void wavefront_bialigner_set_max_num_threads(
     wavefront_bialigner_t* const wf_bialigner,
@@ -189,6 +348,11 @@ void wavefront_bialigner_set_max_num_threads(
   wf_bialigner->wf_forward->system.max_num_threads = max_num_threads;
   wf_bialigner->wf_reverse->system.max_num_threads = max_num_threads;
   wf_bialigner->wf_base->system.max_num_threads = max_num_threads;
+  // Workers
+  if (wf_bialigner->worker_id == 0 && wf_bialigner->num_workers != max_num_threads-1) {
+    wavefront_bialigner_workers_free(wf_bialigner);
+    wavefront_bialigner_workers_allocate(wf_bialigner,max_num_threads-1);
+  }
 }
 void wavefront_bialigner_set_min_offsets_per_thread(
     wavefront_bialigner_t* const wf_bialigner,
@@ -196,4 +360,80 @@ void wavefront_bialigner_set_min_offsets_per_thread(
   wf_bialigner->wf_forward->system.min_offsets_per_thread = min_offsets_per_thread;
   wf_bialigner->wf_reverse->system.min_offsets_per_thread = min_offsets_per_thread;
   wf_bialigner->wf_base->system.min_offsets_per_thread = min_offsets_per_thread;
+  // Workers
+  if (wf_bialigner->worker_id == 0) {
+    int i;
+    for (i=0;i<wf_bialigner->num_workers;++i) {
+      wavefront_bialigner_set_min_offsets_per_thread(
+          wf_bialigner->workers[i]->bialigner,min_offsets_per_thread);
+    }
+  }
+}
+void wavefront_bialigner_set_extend_fused(
+    wavefront_bialigner_t* const wf_bialigner,
+    const bool extend_fused) {
+  // Only the subsidiary (unidirectional) aligner fuses compute & extend
+  wf_bialigner->wf_base->system.extend_fused = extend_fused;
+  // Workers
+  if (wf_bialigner->worker_id == 0) {
+    int i;
+    for (i=0;i<wf_bialigner->num_workers;++i) {
+      wavefront_bialigner_set_extend_fused(
+          wf_bialigner->workers[i]->bialigner,extend_fused);
+    }
+  }
+}
+void wavefront_bialigner_set_stats(
+    wavefront_bialigner_t* const wf_bialigner,
+    const bool stats_enabled) {
+  wf_bialigner->wf_forward->system.stats_enabled = stats_enabled;
+  wf_bialigner->wf_reverse->system.stats_enabled = stats_enabled;
+  wf_bialigner->wf_base->system.stats_enabled = stats_enabled;
+  // Workers
+  if (wf_bialigner->worker_id == 0) {
+    int i;
+    for (i=0;i<wf_bialigner->num_workers;++i) {
+      wf_bialigner->workers[i]->system.stats_enabled = stats_enabled;
+      wavefront_bialigner_set_stats(
+          wf_bialigner->workers[i]->bialigner,stats_enabled);
+    }
+  }
+}
+/*
+ * Stats
+ */
+void wavefront_bialigner_stats_clear(
+    wavefront_bialigner_t* const wf_bialigner) {
+  wavefront_stats_clear(&wf_bialigner->wf_forward->stats);
+  wavefront_stats_clear(&wf_bialigner->wf_reverse->stats);
+  wavefront_stats_clear(&wf_bialigner->wf_base->stats);
+  // Workers
+  if (wf_bialigner->worker_id == 0) {
+    int i;
+    for (i=0;i<wf_bialigner->num_workers;++i) {
+      wavefront_stats_clear(&wf_bialigner->workers[i]->stats);
+      wavefront_bialigner_stats_clear(wf_bialigner->workers[i]->bialigner);
+    }
+  }
+}
+void wavefront_bialigner_stats_gather_aligner(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_aligner_stats_t* const stats) {
+  wavefront_stats_add(stats,&wf_aligner->stats);
+  stats->memory_slab += wavefront_slab_get_size(wf_aligner->wavefront_slab);
+}
+void wavefront_bialigner_stats_gather(
+    wavefront_bialigner_t* const wf_bialigner,
+    wavefront_aligner_stats_t* const stats) {
+  wavefront_bialigner_stats_gather_aligner(wf_bialigner->wf_forward,stats);
+  wavefront_bialigner_stats_gather_aligner(wf_bialigner->wf_reverse,stats);
+  wavefront_bialigner_stats_gather_aligner(wf_bialigner->wf_base,stats);
+  // Workers
+  if (wf_bialigner->worker_id == 0) {
+    int i;
+    for (i=0;i<wf_bialigner->num_workers;++i) {
+      wavefront_stats_add(stats,&wf_bialigner->workers[i]->stats);
+      wavefront_bialigner_stats_gather(wf_bialigner->workers[i]->bialigner,stats);
+    }
+  }
 }
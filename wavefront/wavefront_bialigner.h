@@ -36,6 +36,7 @@
 #include "wavefront_heuristic.h"
 #include "wavefront_offset.h"
 #include "wavefront_sequences.h"
+#include "wavefront_stats.h"
 
 // Wavefront ahead definition
 typedef struct _wavefront_aligner_t wavefront_aligner_t;
@@ -60,6 +61,11 @@ typedef struct {
   wavefront_aligner_t* wf_base;     // Base/Subsidiary aligner
   // Operators
   void (*wf_align_compute)(wavefront_aligner_t* const,const int);
+  // Workers (parallel alignment of the BiWFA halves)
+  wavefront_aligner_attr_t workers_attr; // Attributes to allocate the workers
+  wavefront_aligner_t** workers;         // Worker aligners (shared with the workers)
+  int num_workers;                       // Total worker aligners
+  int worker_id;                         // Worker identifier (0 for the master aligner)
 } wavefront_bialigner_t;
 
 /*
@@ -94,6 +100,23 @@ void wavefront_bialigner_set_sequences_packed2bits(
     const int pattern_length,
     const uint8_t* const text,
     const int text_length);
+void wavefront_bialigner_pin_pattern(
+    wavefront_bialigner_t* const wf_bialigner,
+    const char* const pattern,
+    const int pattern_length);
+void wavefront_bialigner_unpin_pattern(
+    wavefront_bialigner_t* const wf_bialigner);
+void wavefront_bialigner_set_text(
+    wavefront_bialigner_t* const wf_bialigner,
+    const char* const text,
+    const int text_length);
+void wavefront_bialigner_set_sequences_worker(
+    wavefront_bialigner_t* const wf_bialigner,
+    wavefront_bialigner_t* const wf_bialigner_parent,
+    const int pattern_begin,
+    const int pattern_end,
+    const int text_begin,
+    const int text_end);
 void wavefront_bialigner_set_sequences_bounds(
     wavefront_bialigner_t* const wf_bialigner,
     const int pattern_begin,
@@ -112,6 +135,9 @@ void wavefront_bialigner_set_heuristic(
 void wavefront_bialigner_set_max_alignment_steps(
     wavefront_bialigner_t* const wf_bialigner,
     const int max_alignment_steps);
+void wavefront_bialigner_set_max_score(
+    wavefront_bialigner_t* const wf_bialigner,
+    const int max_score);
 void wavefront_bialigner_set_max_memory(
     wavefront_bialigner_t* const wf_bialigner,
     const uint64_t max_memory_resident,
@@ -122,4 +148,27 @@ void wavefront_bialigner_set_max_num_threads(
 void wavefront_bialigner_set_min_offsets_per_thread(
     wavefront_bialigner_t* const wf_bialigner,
     const int min_offsets_per_thread);
+void wavefront_bialigner_set_extend_fused(
+    wavefront_bialigner_t* const wf_bialigner,
+    const bool extend_fused);
+void wavefront_bialigner_set_stats(
+    wavefront_bialigner_t* const wf_bialigner,
+    const bool stats_enabled);
+
+/*
+ * Stats
+ */
+void wavefront_bialigner_stats_clear(
+    wavefront_bialigner_t* const wf_bialigner);
+void wavefront_bialigner_stats_gather(
+    wavefront_bialigner_t* const wf_bialigner,
+    wavefront_aligner_stats_t* const stats);
+
+/*
+ * Workers
+ */
+wavefront_aligner_t* wavefront_bialigner_get_worker(
+    wavefront_bialigner_t* const wf_bialigner,
+    const int worker_id);
+
 #endif /* WAVEFRONT_BIALIGNER_H_ */
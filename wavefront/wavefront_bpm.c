@@ -0,0 +1,391 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignment Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignment Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignment Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: Bit-parallel (BPM) engine for score-only edit/indel alignments
+ */
+
+#include "utils/commons.h"
+#include "system/mm_allocator.h"
+#include "wavefront_bpm.h"
+#include "wavefront_prefilter.h"
+
+/*
+ * Constants
+ */
+#define BPM_W64_LENGTH UINT64_LENGTH
+#define BPM_W64_ONES   UINT64_MAX
+#define BPM_W64_MASK   (1ull<<63)
+
+/*
+ * Engine cost model (WFA-steps vs BPM block-steps)
+ *   WFA computes ~s^2 cells up to score s, whereas banded BPM computes
+ *   ~(s/64+1) blocks per text character. The constants are the relative
+ *   cost of a BPM block-step wrt a WFA cell (measured on x86-64)
+ */
+#define BPM_COST_BLOCK_STEP  12
+#define BPM_SWITCH_SCORE_MIN 16
+
+/*
+ * Advance block (Myers' BPM, Hyyrö's formulation)
+ *   const @vector Eq,mask;
+ *   return (Pv,Mv,PHout,MHout);
+ */
+#define BPM_ADVANCE_BLOCK(Eq,mask,Pv,Mv,PHin,MHin,PHout,MHout) \
+  /* Computes modulator vector {Xv,Xh} ( cases A&C ) */ \
+  const uint64_t Xv = Eq | Mv; \
+  const uint64_t _Eq = Eq | MHin; \
+  const uint64_t Xh = (((_Eq & Pv) + Pv) ^ Pv) | _Eq; \
+  /* Calculate Hout */ \
+  uint64_t Ph = Mv | ~(Xh | Pv); \
+  uint64_t Mh = Pv & Xh; \
+  /* Account Hout that propagates for the next block */ \
+  PHout = (Ph & mask)!=0; \
+  MHout = (Mh & mask)!=0; \
+  /* Hout become the Hin of the next cell */ \
+  Ph <<= 1; \
+  Mh <<= 1; \
+  /* Account Hin coming from the previous block */ \
+  Ph |= PHin; \
+  Mh |= MHin; \
+  /* Finally, generate the Vout */ \
+  Pv = Mh | ~(Xv | Ph); \
+  Mv = Ph & Xv
+
+/*
+ * Setup
+ */
+void wavefront_bpm_pattern_compile(
+    wavefront_bpm_pattern_t* const bpm_pattern,
+    const char* const pattern,
+    const int pattern_length,
+    mm_allocator_t* const mm_allocator) {
+  // Reduce alphabet to the pattern characters
+  uint16_t* const symbols = bpm_pattern->symbols;
+  memset(symbols,0,256*sizeof(uint16_t));
+  int alphabet_length = 1, i;
+  for (i=0;i<pattern_length;++i) {
+    const uint8_t enc_char = pattern[i];
+    if (symbols[enc_char] == 0) symbols[enc_char] = alphabet_length++;
+  }
+  // Init fields
+  const int num_words = DIV_CEIL(pattern_length,BPM_W64_LENGTH);
+  bpm_pattern->pattern_length = pattern_length;
+  bpm_pattern->num_words = num_words;
+  bpm_pattern->alphabet_length = alphabet_length;
+  // Compile Peq
+  const uint64_t peq_size = (uint64_t)num_words*alphabet_length*UINT64_SIZE;
+  bpm_pattern->peq = mm_allocator_malloc(mm_allocator,MAX(peq_size,UINT64_SIZE));
+  memset(bpm_pattern->peq,0,peq_size);
+  for (i=0;i<pattern_length;++i) {
+    const int block = i/BPM_W64_LENGTH;
+    const uint64_t mask = 1ull<<(i%BPM_W64_LENGTH);
+    bpm_pattern->peq[symbols[(uint8_t)pattern[i]]*num_words+block] |= mask;
+  }
+}
+void wavefront_bpm_pattern_free(
+    wavefront_bpm_pattern_t* const bpm_pattern,
+    mm_allocator_t* const mm_allocator) {
+  mm_allocator_free(mm_allocator,bpm_pattern->peq);
+}
+/*
+ * Edit distance (single 64-bit block, i.e., pattern_length <= 64)
+ */
+int wavefront_bpm_edit_word(
+    wavefront_bpm_pattern_t* const bpm_pattern,
+    const char* const text,
+    const int text_length) {
+  // Parameters
+  const uint64_t* const peq = bpm_pattern->peq;
+  const uint16_t* const symbols = bpm_pattern->symbols;
+  const uint64_t mask = 1ull<<(bpm_pattern->pattern_length-1);
+  // Advance (registers only)
+  uint64_t Pv = BPM_W64_ONES, Mv = 0, PHout, MHout;
+  int64_t score = bpm_pattern->pattern_length;
+  int text_position;
+  for (text_position=0;text_position<text_length;++text_position) {
+    const uint64_t Eq = peq[symbols[(uint8_t)text[text_position]]];
+    BPM_ADVANCE_BLOCK(Eq,mask,Pv,Mv,1,0,PHout,MHout);
+    score += (int64_t)PHout - (int64_t)MHout;
+  }
+  return (int)score;
+}
+/*
+ * Edit distance (banded on 64-bit blocks)
+ *   Bottom blocks are activated/deactivated using Ukkonen's cut-off, whereas
+ *   top blocks are dropped once their rows fall off the diagonal band any
+ *   alignment within @max_distance must stay in (the first active block
+ *   then takes +1 as horizontal input, which can only overestimate cells
+ *   outside the band).
+ *   Returns the distance or -1 if larger than @max_distance
+ */
+int wavefront_bpm_edit_banded(
+    wavefront_bpm_pattern_t* const bpm_pattern,
+    const char* const text,
+    const int text_length,
+    const int max_distance,
+    uint64_t* const Pv,
+    uint64_t* const Mv,
+    int64_t* const score) {
+  // Parameters
+  const uint64_t* const peq = bpm_pattern->peq;
+  const uint16_t* const symbols = bpm_pattern->symbols;
+  const int num_words = bpm_pattern->num_words;
+  const int top = num_words-1;
+  const int top_rows = bpm_pattern->pattern_length - top*BPM_W64_LENGTH;
+  const uint64_t top_mask = 1ull<<(top_rows-1);
+  const int64_t max_score = max_distance;
+  const int64_t band_offset = ((int64_t)bpm_pattern->pattern_length - text_length - max_score) >> 1;
+  int first_block = 0;
+  // Reset active blocks (only those that can hold scores within max-distance)
+  int top_level = DIV_CEIL(max_distance,BPM_W64_LENGTH);
+  top_level = MIN(MAX(top_level,1),num_words);
+  int i;
+  for (i=0;i<top_level;++i) {
+    Pv[i] = BPM_W64_ONES;
+    Mv[i] = 0;
+    score[i] = (int64_t)(i+1)*BPM_W64_LENGTH;
+  }
+  if (top_level == num_words) score[top] = bpm_pattern->pattern_length;
+  // Advance in the DP-bit-encoded matrix
+  int text_position;
+  for (text_position=0;text_position<text_length;++text_position) {
+    // Fetch next character
+    const uint64_t* const peq_char = peq + symbols[(uint8_t)text[text_position]]*num_words;
+    // Drop top blocks out of the band (i.e., diagonals that cannot reach the end within max-distance)
+    const int64_t row_min = text_position + 1 + band_offset;
+    while (first_block < top_level-1 && (int64_t)(first_block+1)*BPM_W64_LENGTH < row_min) ++first_block;
+    // Advance all active blocks
+    uint64_t PHin=1, MHin=0, PHout, MHout;
+    for (i=first_block;i<top_level;++i) {
+      const uint64_t Eq = peq_char[i];
+      const uint64_t mask = (i==top) ? top_mask : BPM_W64_MASK;
+      uint64_t Pv_in = Pv[i];
+      uint64_t Mv_in = Mv[i];
+      BPM_ADVANCE_BLOCK(Eq,mask,Pv_in,Mv_in,PHin,MHin,PHout,MHout);
+      Pv[i] = Pv_in;
+      Mv[i] = Mv_in;
+      score[i] += (int64_t)PHout - (int64_t)MHout;
+      PHin = PHout;
+      MHin = MHout;
+    }
+    // Cut-off (activate the next block)
+    const int last = top_level-1;
+    if (last < top && score[last] <= max_score+1) {
+      const int64_t last_score = score[last] + ((int64_t)MHin - (int64_t)PHin);
+      const uint64_t Eq = peq_char[top_level];
+      if (last_score <= max_score && (MHin || (Eq & 1))) {
+        const int rows = (top_level==top) ? top_rows : BPM_W64_LENGTH;
+        const uint64_t mask = (top_level==top) ? top_mask : BPM_W64_MASK;
+        uint64_t Pv_in = BPM_W64_ONES;
+        uint64_t Mv_in = 0;
+        BPM_ADVANCE_BLOCK(Eq,mask,Pv_in,Mv_in,PHin,MHin,PHout,MHout);
+        Pv[top_level] = Pv_in;
+        Mv[top_level] = Mv_in;
+        score[top_level] = last_score + rows + ((int64_t)PHout - (int64_t)MHout);
+        ++top_level;
+        continue;
+      }
+    }
+    // Cut-off (deactivate blocks beyond max-distance)
+    while (top_level > first_block) {
+      const int rows = (top_level-1==top) ? top_rows : BPM_W64_LENGTH;
+      if (score[top_level-1] <= max_score+rows) break;
+      --top_level;
+    }
+    if (top_level == first_block) return -1; // All cells beyond max-distance
+  }
+  // Return distance
+  if (top_level < num_words || score[top] > max_score) return -1;
+  return (int)score[top];
+}
+/*
+ * LCS (bit-parallel, Hyyrö's formulation)
+ *   Returns the length of the longest common subsequence
+ */
+int wavefront_bpm_lcs(
+    wavefront_bpm_pattern_t* const bpm_pattern,
+    const char* const text,
+    const int text_length,
+    uint64_t* const V) {
+  // Parameters
+  const uint64_t* const peq = bpm_pattern->peq;
+  const uint16_t* const symbols = bpm_pattern->symbols;
+  const int num_words = bpm_pattern->num_words;
+  const int top = num_words-1;
+  const int top_rows = bpm_pattern->pattern_length - top*BPM_W64_LENGTH;
+  // Reset
+  int i;
+  for (i=0;i<num_words;++i) V[i] = BPM_W64_ONES;
+  // Advance (V = (V + (V & Eq)) | (V & ~Eq), carrying along the words)
+  int text_position;
+  for (text_position=0;text_position<text_length;++text_position) {
+    const uint64_t* const peq_char = peq + symbols[(uint8_t)text[text_position]]*num_words;
+    uint64_t carry = 0;
+    for (i=0;i<num_words;++i) {
+      const uint64_t V_in = V[i];
+      const uint64_t U = V_in & peq_char[i];
+      const uint64_t sum_partial = V_in + U;
+      const uint64_t sum = sum_partial + carry;
+      carry = (sum_partial < V_in) | (sum < sum_partial);
+      V[i] = sum | (V_in & ~U);
+    }
+  }
+  // Count zeros (matches)
+  int lcs = 0;
+  for (i=0;i<top;++i) lcs += __builtin_popcountll(~V[i]);
+  const uint64_t top_valid = (top_rows==BPM_W64_LENGTH) ? BPM_W64_ONES : (1ull<<top_rows)-1;
+  lcs += __builtin_popcountll(~V[top] & top_valid);
+  return lcs;
+}
+/*
+ * Engine selection
+ */
+bool wavefront_bpm_applicable(
+    wavefront_aligner_t* const wf_aligner) {
+  const distance_metric_t distance_metric = wf_aligner->penalties.distance_metric;
+  return wf_aligner->system.bpm_mode != wf_bpm_never &&
+         (distance_metric == edit || distance_metric == indel) &&
+         wf_aligner->alignment_scope == compute_score &&
+         wf_aligner->alignment_form.span == alignment_end2end &&
+         !wf_aligner->alignment_form.extension &&
+         wf_aligner->heuristic.strategy == wf_heuristic_none &&
+         wf_aligner->plot == NULL;
+}
+int wavefront_bpm_switch_score(
+    wavefront_aligner_t* const wf_aligner,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length) {
+  // Check engine
+  if (!wavefront_bpm_applicable(wf_aligner)) return INT_MAX; // WFA only
+  if (wf_aligner->system.bpm_mode == wf_bpm_always) return 0; // BPM only
+  /*
+   * Break-even score (WFA-cells ~ s^2 vs BPM-block-steps ~ n*(s/64+1))
+   *   s^2 = C*n*(s/64+1)  =>  s = (C*n/64 + sqrt((C*n/64)^2 + 4*C*n))/2
+   */
+  const double cost_n = (double)BPM_COST_BLOCK_STEP*(double)text_length;
+  const double cost_64 = cost_n/(double)BPM_W64_LENGTH;
+  const int switch_score = MAX((int)((cost_64+sqrt(cost_64*cost_64+4.0*cost_n))/2.0),BPM_SWITCH_SCORE_MIN);
+  // Predict divergence (score lower-bound from the length-difference and base-counts)
+  int pattern_counts[5], text_counts[5];
+  wavefront_prefilter_count_ascii(pattern,pattern_length,pattern_counts);
+  wavefront_prefilter_count_ascii(text,text_length,text_counts);
+  const int excess_pairs = wavefront_prefilter_excess_pairs(pattern_counts,text_counts);
+  const int score_bound = wavefront_prefilter_bound(
+      &wf_aligner->penalties,pattern_length,text_length,excess_pairs);
+  // BPM right away if WFA is predicted to reach the break-even score
+  return (score_bound >= switch_score) ? 0 : switch_score;
+}
+/*
+ * BPM Align (score-only)
+ */
+int wavefront_bpm_edit(
+    wavefront_bpm_pattern_t* const bpm_pattern,
+    const char* const text,
+    const int text_length,
+    const int min_distance,
+    const int max_distance,
+    mm_allocator_t* const mm_allocator) {
+  // Single-word pattern (no banding needed)
+  const int num_words = bpm_pattern->num_words;
+  if (num_words == 1) {
+    const int distance = wavefront_bpm_edit_word(bpm_pattern,text,text_length);
+    return (distance <= max_distance) ? distance : -1;
+  }
+  // Allocate
+  uint64_t* const Pv = mm_allocator_calloc(mm_allocator,num_words,uint64_t,false);
+  uint64_t* const Mv = mm_allocator_calloc(mm_allocator,num_words,uint64_t,false);
+  int64_t* const score = mm_allocator_calloc(mm_allocator,num_words,int64_t,false);
+  // Banded BPM (doubling the band until the distance falls within)
+  int band = MIN(MAX(2*min_distance,BPM_W64_LENGTH),max_distance);
+  int distance;
+  while (true) {
+    distance = wavefront_bpm_edit_banded(bpm_pattern,text,text_length,band,Pv,Mv,score);
+    if (distance >= 0 || band >= max_distance) break;
+    band = (band > max_distance/2) ? max_distance : 2*band;
+  }
+  // Free
+  mm_allocator_free(mm_allocator,score);
+  mm_allocator_free(mm_allocator,Mv);
+  mm_allocator_free(mm_allocator,Pv);
+  return distance;
+}
+int wavefront_bpm_indel(
+    wavefront_bpm_pattern_t* const bpm_pattern,
+    const char* const text,
+    const int text_length,
+    mm_allocator_t* const mm_allocator) {
+  uint64_t* const V = mm_allocator_calloc(mm_allocator,bpm_pattern->num_words,uint64_t,false);
+  const int lcs = wavefront_bpm_lcs(bpm_pattern,text,text_length,V);
+  mm_allocator_free(mm_allocator,V);
+  return bpm_pattern->pattern_length + text_length - 2*lcs;
+}
+void wavefront_bpm_align(
+    wavefront_aligner_t* const wf_aligner,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length,
+    const int min_distance) {
+  // Parameters
+  mm_allocator_t* const mm_allocator = wf_aligner->mm_allocator;
+  const int max_score = wf_aligner->system.max_score;
+  cigar_t* const cigar = wf_aligner->cigar;
+  cigar_clear(cigar);
+  // Compute distance
+  int distance;
+  if (pattern_length == 0 || text_length == 0) {
+    distance = pattern_length + text_length;
+  } else {
+    wavefront_bpm_pattern_t bpm_pattern;
+    wavefront_bpm_pattern_compile(&bpm_pattern,pattern,pattern_length,mm_allocator);
+    if (wf_aligner->penalties.distance_metric == edit) {
+      const int max_distance = MIN(max_score,MAX(pattern_length,text_length));
+      distance = wavefront_bpm_edit(&bpm_pattern,text,text_length,min_distance,max_distance,mm_allocator);
+    } else {
+      distance = wavefront_bpm_indel(&bpm_pattern,text,text_length,mm_allocator);
+    }
+    wavefront_bpm_pattern_free(&bpm_pattern,mm_allocator);
+  }
+  // Set status
+  wavefront_align_status_t* const align_status = &wf_aligner->align_status;
+  align_status->dropped = false;
+  if (distance < 0 || distance > max_score) {
+    cigar->score = -(max_score+1);
+    align_status->status = WF_STATUS_MAX_SCORE_REACHED;
+    align_status->score = max_score+1;
+  } else {
+    cigar->end_v = pattern_length;
+    cigar->end_h = text_length;
+    cigar->score = distance; // Classic score (edit/indel)
+    align_status->status = WF_STATUS_ALG_COMPLETED;
+    align_status->score = distance;
+  }
+  align_status->memory_used = wavefront_aligner_get_size(wf_aligner);
+}
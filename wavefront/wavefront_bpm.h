@@ -0,0 +1,102 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignment Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignment Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignment Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: Bit-parallel (BPM) engine for score-only edit/indel alignments
+ */
+
+#ifndef WAVEFRONT_BPM_H_
+#define WAVEFRONT_BPM_H_
+
+#include "wavefront_aligner.h"
+
+/*
+ * Pattern profile (Peq bit-vectors over the pattern's own alphabet)
+ */
+typedef struct {
+  int pattern_length;        // Pattern length
+  int num_words;             // Number of 64-bit words per column
+  int alphabet_length;       // Pattern characters + 1 (symbol 0 matches nothing)
+  uint16_t symbols[256];     // Character to symbol
+  uint64_t* peq;             // Match bit-vectors (alphabet_length x num_words)
+} wavefront_bpm_pattern_t;
+
+/*
+ * Setup
+ */
+void wavefront_bpm_pattern_compile(
+    wavefront_bpm_pattern_t* const bpm_pattern,
+    const char* const pattern,
+    const int pattern_length,
+    mm_allocator_t* const mm_allocator);
+void wavefront_bpm_pattern_free(
+    wavefront_bpm_pattern_t* const bpm_pattern,
+    mm_allocator_t* const mm_allocator);
+
+/*
+ * Bit-parallel distances
+ */
+int wavefront_bpm_edit_word(
+    wavefront_bpm_pattern_t* const bpm_pattern,
+    const char* const text,
+    const int text_length);
+int wavefront_bpm_edit_banded(
+    wavefront_bpm_pattern_t* const bpm_pattern,
+    const char* const text,
+    const int text_length,
+    const int max_distance,
+    uint64_t* const Pv,
+    uint64_t* const Mv,
+    int64_t* const score);
+int wavefront_bpm_lcs(
+    wavefront_bpm_pattern_t* const bpm_pattern,
+    const char* const text,
+    const int text_length,
+    uint64_t* const V);
+
+/*
+ * Engine selection
+ */
+int wavefront_bpm_switch_score(
+    wavefront_aligner_t* const wf_aligner,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length);
+
+/*
+ * BPM Align (score-only)
+ */
+void wavefront_bpm_align(
+    wavefront_aligner_t* const wf_aligner,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length,
+    const int min_distance);
+
+#endif /* WAVEFRONT_BPM_H_ */
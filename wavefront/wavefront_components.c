@@ -33,6 +33,11 @@
 #include "wavefront_components.h"
 #include "utils/bitmap.h"
 #include "system/profiler_timer.h"
+#include "wavefront_compute.h"
+
+#ifdef WFA_PARALLEL
+#include <omp.h>
+#endif
 
 /*
  * Configuration
@@ -41,6 +46,8 @@
 #define WF_NULL_INIT_HI     ( 1024)
 #define WF_NULL_INIT_LENGTH WAVEFRONT_LENGTH(WF_NULL_INIT_LO,WF_NULL_INIT_HI)
 
+#define WF_COMPONENTS_COMPACT_MIN_BLOCKS_THREAD BUFFER_SIZE_64K // Min. BT-blocks per compacting thread
+
 /*
  * Compute dimensions
  */
@@ -299,6 +306,49 @@ void wavefront_components_resize(
     wavefront_components_clear(wf_components);
   }
 }
+void wavefront_components_expand(
+    wavefront_components_t* const wf_components,
+    const int max_pattern_length,
+    const int max_text_length,
+    wavefront_penalties_t* const penalties) {
+  // Compute dimensions
+  int num_wavefronts = 0;
+  wavefront_components_dimensions(
+      wf_components,penalties,
+      max_pattern_length,max_text_length,
+      &wf_components->max_score_scope,&num_wavefronts);
+  if (num_wavefronts <= wf_components->num_wavefronts) return;
+  // Keep the wavefronts computed so far (alignment in progress)
+  const int wf_size = wf_components->num_wavefronts*sizeof(wavefront_t*);
+  wavefront_t** const mwavefronts = wf_components->mwavefronts;
+  wavefront_t** const i1wavefronts = wf_components->i1wavefronts;
+  wavefront_t** const d1wavefronts = wf_components->d1wavefronts;
+  wavefront_t** const i2wavefronts = wf_components->i2wavefronts;
+  wavefront_t** const d2wavefronts = wf_components->d2wavefronts;
+  // Allocate larger components & copy
+  wf_components->num_wavefronts = num_wavefronts;
+  wavefront_components_allocate_wf(wf_components,
+      max_pattern_length,max_text_length,penalties->distance_metric);
+  mm_allocator_t* const mm_allocator = wf_components->mm_allocator;
+  memcpy(wf_components->mwavefronts,mwavefronts,wf_size);
+  mm_allocator_free(mm_allocator,mwavefronts);
+  if (i1wavefronts) {
+    memcpy(wf_components->i1wavefronts,i1wavefronts,wf_size);
+    mm_allocator_free(mm_allocator,i1wavefronts);
+  }
+  if (d1wavefronts) {
+    memcpy(wf_components->d1wavefronts,d1wavefronts,wf_size);
+    mm_allocator_free(mm_allocator,d1wavefronts);
+  }
+  if (i2wavefronts) {
+    memcpy(wf_components->i2wavefronts,i2wavefronts,wf_size);
+    mm_allocator_free(mm_allocator,i2wavefronts);
+  }
+  if (d2wavefronts) {
+    memcpy(wf_components->d2wavefronts,d2wavefronts,wf_size);
+    mm_allocator_free(mm_allocator,d2wavefronts);
+  }
+}
 void wavefront_components_resize_null__victim(
     wavefront_components_t* const wf_components,
     const int lo,
@@ -327,52 +377,82 @@ void wavefront_components_resize_null__victim(
 void wavefront_components_mark_backtrace(
     wf_backtrace_buffer_t* const bt_buffer,
     bitmap_t* const bitmap,
-    wavefront_t* const wavefront) {
+    wavefront_t* const wavefront,
+    const int thread_id,
+    const int num_threads) {
   // Parameters
   wf_offset_t* const offsets = wavefront->offsets;
   bt_block_idx_t* const bt_prev = wavefront->bt_prev;
-  const int lo = wavefront->lo;
-  const int hi = wavefront->hi;
+  int lo = wavefront->lo;
+  int hi = wavefront->hi;
+#ifdef WFA_PARALLEL
+  if (num_threads > 1) wavefront_compute_thread_limits(thread_id,num_threads,lo,hi,&lo,&hi);
+#endif
+  if (lo > hi) return;
   // Mark all wavefront backtraces (batch mode)
   wf_backtrace_buffer_mark_backtrace_batch(
-      bt_buffer,offsets+lo,bt_prev+lo,hi-lo+1,bitmap);
+      bt_buffer,offsets+lo,bt_prev+lo,hi-lo+1,bitmap,num_threads>1);
   //  int i;
   //  for (i=lo;i<=hi;++i) {
   //    if (offsets[i]>=0) wf_backtrace_buffer_mark_backtrace(bt_buffer,bt_prev[i],bitmap);
   //  }
 }
-void wavefront_components_mark_wavefronts(
+void wavefront_components_mark_aws(
     wavefront_components_t* const wf_components,
     bitmap_t* const bitmap,
-    const int score) {
+    const int score,
+    const int thread_id,
+    const int num_threads) {
   // Parameters
   wf_backtrace_buffer_t* const bt_buffer = wf_components->bt_buffer;
   const int max_score_scope = wf_components->max_score_scope;
-  // Mark Active Working Set (AWS)
+  // Mark Active Working Set (AWS) (scores below zero don't exist)
+  const int num_scores = MIN(max_score_scope,score+1);
   int i;
-  for (i=0;i<max_score_scope;++i) {
+  for (i=0;i<num_scores;++i) {
     // Compute score
     const int score_mod = (score-i) % wf_components->max_score_scope;
     // Mark M-wavefront
     wavefront_t* const mwavefront = wf_components->mwavefronts[score_mod];
-    if (mwavefront!=NULL) wavefront_components_mark_backtrace(bt_buffer,bitmap,mwavefront);
+    if (mwavefront!=NULL) wavefront_components_mark_backtrace(bt_buffer,bitmap,mwavefront,thread_id,num_threads);
     // Mark (I1/D1)-wavefronts
     if (wf_components->i1wavefronts != NULL) {
       wavefront_t* const i1wavefront = wf_components->i1wavefronts[score_mod];
-      if (i1wavefront!=NULL) wavefront_components_mark_backtrace(bt_buffer,bitmap,i1wavefront);
+      if (i1wavefront!=NULL) wavefront_components_mark_backtrace(bt_buffer,bitmap,i1wavefront,thread_id,num_threads);
       wavefront_t* const d1wavefront = wf_components->d1wavefronts[score_mod];
-      if (d1wavefront!=NULL) wavefront_components_mark_backtrace(bt_buffer,bitmap,d1wavefront);
+      if (d1wavefront!=NULL) wavefront_components_mark_backtrace(bt_buffer,bitmap,d1wavefront,thread_id,num_threads);
       // Mark (I2/D2)-wavefronts
       if (wf_components->i2wavefronts != NULL) {
         wavefront_t* const i2wavefront = wf_components->i2wavefronts[score_mod];
-        if (i2wavefront!=NULL) wavefront_components_mark_backtrace(bt_buffer,bitmap,i2wavefront);
+        if (i2wavefront!=NULL) wavefront_components_mark_backtrace(bt_buffer,bitmap,i2wavefront,thread_id,num_threads);
         wavefront_t* const d2wavefront = wf_components->d2wavefronts[score_mod];
-        if (d2wavefront!=NULL) wavefront_components_mark_backtrace(bt_buffer,bitmap,d2wavefront);
+        if (d2wavefront!=NULL) wavefront_components_mark_backtrace(bt_buffer,bitmap,d2wavefront,thread_id,num_threads);
       }
     }
   }
-  // Update counters in marked bitmap
-  bitmap_update_counters(bitmap);
+}
+void wavefront_components_mark_wavefronts(
+    wavefront_components_t* const wf_components,
+    bitmap_t* const bitmap,
+    const int score,
+    const int num_threads) {
+  if (num_threads == 1) {
+    // Mark Active Working Set (AWS)
+    wavefront_components_mark_aws(wf_components,bitmap,score,0,1);
+    // Update counters in marked bitmap
+    bitmap_update_counters(bitmap);
+  } else {
+#ifdef WFA_PARALLEL
+    // Mark Active Working Set (AWS) splitting diagonals across threads (atomic marks)
+    #pragma omp parallel num_threads(num_threads)
+    {
+      wavefront_components_mark_aws(wf_components,bitmap,score,
+          omp_get_thread_num(),omp_get_num_threads());
+    }
+    // Update counters in marked bitmap (parallel prefix-sum)
+    bitmap_update_counters_parallel(bitmap,num_threads);
+#endif
+  }
 }
 /*
  * Translate block-idxs
@@ -380,13 +460,18 @@ void wavefront_components_mark_wavefronts(
 void wavefront_components_translate_idx(
     wavefront_components_t* const wf_components,
     bitmap_t* const bitmap,
-    wavefront_t* const wavefront) {
+    wavefront_t* const wavefront,
+    const int thread_id,
+    const int num_threads) {
   // Parameters
   wf_offset_t* const offsets = wavefront->offsets;
   bt_block_idx_t* const bt_prev = wavefront->bt_prev;
-  const int lo = wavefront->lo;
-  const int hi = wavefront->hi;
+  int lo = wavefront->lo;
+  int hi = wavefront->hi;
   const bt_block_idx_t num_compacted_blocks = wf_components->bt_buffer->num_compacted_blocks;
+#ifdef WFA_PARALLEL
+  if (num_threads > 1) wavefront_compute_thread_limits(thread_id,num_threads,lo,hi,&lo,&hi);
+#endif
   // Translate all wavefront block-idxs
   int k;
   for (k=lo;k<=hi;++k) {
@@ -397,41 +482,73 @@ void wavefront_components_translate_idx(
     }
   }
 }
-void wavefront_components_translate_wavefronts(
+void wavefront_components_translate_aws(
     wavefront_components_t* const wf_components,
     bitmap_t* const bitmap,
-    const int score) {
-  // Mark Active Working Set (AWS)
+    const int score,
+    const int thread_id,
+    const int num_threads) {
+  // Translate Active Working Set (AWS)
   const int max_score_scope = wf_components->max_score_scope;
+  const int num_scores = MIN(max_score_scope,score+1);
   int i;
-  for (i=0;i<max_score_scope;++i) {
+  for (i=0;i<num_scores;++i) {
     // Compute score
     const int score_mod = (score-i) % wf_components->max_score_scope;
-    // Mark M-wavefront
+    // Translate M-wavefront
     wavefront_t* const mwavefront = wf_components->mwavefronts[score_mod];
-    if (mwavefront!=NULL) wavefront_components_translate_idx(wf_components,bitmap,mwavefront);
-    // Mark (I1/D1)-wavefronts
+    if (mwavefront!=NULL) wavefront_components_translate_idx(wf_components,bitmap,mwavefront,thread_id,num_threads);
+    // Translate (I1/D1)-wavefronts
     if (wf_components->i1wavefronts != NULL) {
       wavefront_t* const i1wavefront = wf_components->i1wavefronts[score_mod];
-      if (i1wavefront!=NULL) wavefront_components_translate_idx(wf_components,bitmap,i1wavefront);
+      if (i1wavefront!=NULL) wavefront_components_translate_idx(wf_components,bitmap,i1wavefront,thread_id,num_threads);
       wavefront_t* const d1wavefront = wf_components->d1wavefronts[score_mod];
-      if (d1wavefront!=NULL) wavefront_components_translate_idx(wf_components,bitmap,d1wavefront);
-      // Mark (I2/D2)-wavefronts
+      if (d1wavefront!=NULL) wavefront_components_translate_idx(wf_components,bitmap,d1wavefront,thread_id,num_threads);
+      // Translate (I2/D2)-wavefronts
       if (wf_components->i2wavefronts != NULL) {
         wavefront_t* const i2wavefront = wf_components->i2wavefronts[score_mod];
-        if (i2wavefront!=NULL) wavefront_components_translate_idx(wf_components,bitmap,i2wavefront);
+        if (i2wavefront!=NULL) wavefront_components_translate_idx(wf_components,bitmap,i2wavefront,thread_id,num_threads);
         wavefront_t* const d2wavefront = wf_components->d2wavefronts[score_mod];
-        if (d2wavefront!=NULL) wavefront_components_translate_idx(wf_components,bitmap,d2wavefront);
+        if (d2wavefront!=NULL) wavefront_components_translate_idx(wf_components,bitmap,d2wavefront,thread_id,num_threads);
       }
     }
   }
 }
+void wavefront_components_translate_wavefronts(
+    wavefront_components_t* const wf_components,
+    bitmap_t* const bitmap,
+    const int score,
+    const int num_threads) {
+  if (num_threads == 1) {
+    wavefront_components_translate_aws(wf_components,bitmap,score,0,1);
+  } else {
+#ifdef WFA_PARALLEL
+    #pragma omp parallel num_threads(num_threads)
+    {
+      wavefront_components_translate_aws(wf_components,bitmap,score,
+          omp_get_thread_num(),omp_get_num_threads());
+    }
+#endif
+  }
+}
 /*
  * Compact
  */
+int wavefront_components_compact_num_threads(
+    const uint64_t bt_buffer_used,
+    const int max_num_threads) {
+#ifdef WFA_PARALLEL
+  // Spawn threads only if each one gets enough BT-blocks to compact
+  const int max_workers = bt_buffer_used / WF_COMPONENTS_COMPACT_MIN_BLOCKS_THREAD;
+  return MAX(MIN(max_workers,max_num_threads),1);
+#else
+  return 1;
+#endif
+}
 void wavefront_components_compact_bt_buffer(
     wavefront_components_t* const wf_components,
     const int score,
+    const int max_num_threads,
     const int verbose) {
   // PROFILE
   profiler_timer_t timer;
@@ -439,15 +556,24 @@ void wavefront_components_compact_bt_buffer(
   // Parameters
   wf_backtrace_buffer_t* const bt_buffer = wf_components->bt_buffer;
   const uint64_t bt_buffer_used = wf_backtrace_buffer_get_used(bt_buffer);
+  const int num_threads = wavefront_components_compact_num_threads(bt_buffer_used,max_num_threads);
   // Allocate bitmap
   bitmap_t* const bitmap = bitmap_new(bt_buffer_used,wf_components->mm_allocator);
   // Mark Active Working Set (AWS)
-  wavefront_components_mark_wavefronts(wf_components,bitmap,score);
+  wavefront_components_mark_wavefronts(wf_components,bitmap,score,num_threads);
   // Compact marked blocks (also translates idxs to compacted positions)
-  const bt_block_idx_t total_compacted_blocks =
-      wf_backtrace_buffer_compact_marked(bt_buffer,bitmap,verbose);
+  bt_block_idx_t total_compacted_blocks;
+#ifdef WFA_PARALLEL
+  if (num_threads > 1) {
+    total_compacted_blocks = wf_backtrace_buffer_compact_marked_parallel(bt_buffer,bitmap,num_threads,verbose);
+  } else {
+    total_compacted_blocks = wf_backtrace_buffer_compact_marked(bt_buffer,bitmap,verbose);
+  }
+#else
+  total_compacted_blocks = wf_backtrace_buffer_compact_marked(bt_buffer,bitmap,verbose);
+#endif
   // Translate Active Working Set (AWS)
-  wavefront_components_translate_wavefronts(wf_components,bitmap,score);
+  wavefront_components_translate_wavefronts(wf_components,bitmap,score,num_threads);
   // Set new compacted blocks
   wf_backtrace_buffer_set_num_compacted_blocks(bt_buffer,total_compacted_blocks);
   // Free
@@ -88,6 +88,11 @@ void wavefront_components_resize(
     const int max_pattern_length,
     const int max_text_length,
     wavefront_penalties_t* const penalties);
+void wavefront_components_expand(
+    wavefront_components_t* const wf_components,
+    const int max_pattern_length,
+    const int max_text_length,
+    wavefront_penalties_t* const penalties);
 void wavefront_components_resize_null__victim(
     wavefront_components_t* const wf_components,
     const int lo,
@@ -99,6 +104,7 @@ void wavefront_components_resize_null__victim(
 void wavefront_components_compact_bt_buffer(
     wavefront_components_t* const wf_components,
     const int score,
+    const int max_num_threads,
     const int verbose);
 
 #endif /* WAVEFRONT_WAVEFRONT_COMPONENTS_H_ */
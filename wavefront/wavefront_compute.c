@@ -29,6 +29,7 @@
  * DESCRIPTION: WaveFront alignment module for computing wavefronts
  */
 
+#include "wavefront_multiversion.h"
 #include "utils/commons.h"
 #include "system/mm_allocator.h"
 #include "alignment/affine2p_penalties.h"
@@ -630,6 +631,21 @@ void wavefront_compute_process_ends(
   if (wavefront_set->out_i2wavefront) wavefront_compute_trim_ends(wf_aligner,wavefront_set->out_i2wavefront);
   if (wavefront_set->out_d2wavefront) wavefront_compute_trim_ends(wf_aligner,wavefront_set->out_d2wavefront);
 }
+/*
+ * Fused compute & extend
+ */
+void wavefront_compute_extend_fused_completed(
+    wavefront_aligner_t* const wf_aligner,
+    const int score,
+    const int lo,
+    const int hi) {
+  // Skip the extend pass over the s-wavefront
+  wf_aligner->align_status.extend_fused_score = score;
+  // Account the M-offsets not re-streamed (one read and one write per diagonal)
+  const uint64_t bytes_saved = 2*sizeof(wf_offset_t)*(uint64_t)WAVEFRONT_LENGTH(lo,hi);
+  counter_add(&wf_aligner->system.extend_fused_bytes,bytes_saved);
+  if (wf_aligner->system.stats_enabled) wf_aligner->stats.extend_fused_bytes += bytes_saved;
+}
 /*
  * Multithread dispatcher
  */
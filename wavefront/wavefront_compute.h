@@ -99,6 +99,17 @@ void wavefront_compute_process_ends(
     wavefront_set_t* const wavefront_set,
     const int score);
 
+/*
+ * Fused compute & extend
+ */
+#define WF_COMPUTE_FUSED_TILE_LENGTH 256 // Diagonals per tile (keeps in/out offsets L1-resident)
+
+void wavefront_compute_extend_fused_completed(
+    wavefront_aligner_t* const wf_aligner,
+    const int score,
+    const int lo,
+    const int hi);
+
 /*
  * Multithread dispatcher
  */
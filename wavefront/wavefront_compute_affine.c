@@ -29,9 +29,11 @@
  * DESCRIPTION: WaveFront alignment module for computing wavefronts (gap-affine)
  */
 
+#include "wavefront_multiversion.h"
 #include "utils/commons.h"
 #include "system/mm_allocator.h"
 #include "wavefront_compute.h"
+#include "wavefront_extend.h"
 #include "wavefront_backtrace_offload.h"
 
 #ifdef WFA_PARALLEL
@@ -192,22 +194,49 @@ void wavefront_compute_affine_idm_piggyback(
 /*
  * Compute Wavefronts (gap-affine)
  */
+void wavefront_compute_affine_kernel(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_set_t* const wavefront_set,
+    const int lo,
+    const int hi) {
+  if (wf_aligner->wf_components.bt_piggyback) {
+    wf_aligner->kernels.compute_affine_idm_piggyback(wf_aligner,wavefront_set,lo,hi);
+  } else {
+    wf_aligner->kernels.compute_affine_idm(wf_aligner,wavefront_set,lo,hi);
+  }
+}
+void wavefront_compute_affine_tiles(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_set_t* const wavefront_set,
+    const int score,
+    const int lo,
+    const int hi) {
+  // Compute only
+  if (!wf_aligner->align_status.extend_fused) {
+    wavefront_compute_affine_kernel(wf_aligner,wavefront_set,lo,hi);
+    return;
+  }
+  // Compute & extend each tile of diagonals while still in cache
+  wavefront_t* const mwavefront = wavefront_set->out_mwavefront;
+  int t_lo;
+  for (t_lo=lo;t_lo<=hi;t_lo+=WF_COMPUTE_FUSED_TILE_LENGTH) {
+    const int t_hi = MIN(t_lo+WF_COMPUTE_FUSED_TILE_LENGTH-1,hi);
+    wavefront_compute_affine_kernel(wf_aligner,wavefront_set,t_lo,t_hi);
+    wavefront_extend_end2end_dispatcher_seq(wf_aligner,mwavefront,score,t_lo,t_hi);
+  }
+}
 void wavefront_compute_affine_dispatcher(
     wavefront_aligner_t* const wf_aligner,
     wavefront_set_t* const wavefront_set,
+    const int score,
     const int lo,
     const int hi) {
   // Parameters
-  const bool bt_piggyback = wf_aligner->wf_components.bt_piggyback;
   const int num_threads = wavefront_compute_num_threads(wf_aligner,lo,hi);
   // Multithreading dispatcher
   if (num_threads == 1) {
     // Compute next wavefront
-    if (bt_piggyback) {
-      wavefront_compute_affine_idm_piggyback(wf_aligner,wavefront_set,lo,hi);
-    } else {
-      wavefront_compute_affine_idm(wf_aligner,wavefront_set,lo,hi);
-    }
+    wavefront_compute_affine_tiles(wf_aligner,wavefront_set,score,lo,hi);
   } else {
 #ifdef WFA_PARALLEL
     // Compute next wavefront in parallel
@@ -217,14 +246,14 @@ void wavefront_compute_affine_dispatcher(
       const int thread_id = omp_get_thread_num();
       const int thread_num = omp_get_num_threads();
       wavefront_compute_thread_limits(thread_id,thread_num,lo,hi,&t_lo,&t_hi);
-      if (bt_piggyback) {
-        wavefront_compute_affine_idm_piggyback(wf_aligner,wavefront_set,t_lo,t_hi);
-      } else {
-        wavefront_compute_affine_idm(wf_aligner,wavefront_set,t_lo,t_hi);
-      }
+      wavefront_compute_affine_tiles(wf_aligner,wavefront_set,score,t_lo,t_hi);
     }
 #endif
   }
+  // Fused extension
+  if (wf_aligner->align_status.extend_fused) {
+    wavefront_compute_extend_fused_completed(wf_aligner,score,lo,hi);
+  }
 }
 void wavefront_compute_affine(
     wavefront_aligner_t* const wf_aligner,
@@ -242,6 +271,9 @@ void wavefront_compute_affine(
     return;
   }
   wf_aligner->align_status.num_null_steps = 0;
+  // Stats
+  const bool stats_enabled = wf_aligner->system.stats_enabled;
+  const uint64_t stats_begin_ns = (stats_enabled) ? wavefront_stats_get_time_ns() : 0;
   // Set limits
   int hi, lo;
   wavefront_compute_limits_input(wf_aligner,&wavefront_set,&lo,&hi);
@@ -250,13 +282,15 @@ void wavefront_compute_affine(
   // Init wavefront ends
   wavefront_compute_init_ends(wf_aligner,&wavefront_set,lo,hi);
   // Compute wavefronts
-  wavefront_compute_affine_dispatcher(wf_aligner,&wavefront_set,lo,hi);
+  wavefront_compute_affine_dispatcher(wf_aligner,&wavefront_set,score,lo,hi);
   // Offload backtrace (if necessary)
   if (wf_aligner->wf_components.bt_piggyback) {
     wavefront_backtrace_offload_affine(wf_aligner,&wavefront_set,lo,hi);
   }
   // Process wavefront ends
   wavefront_compute_process_ends(wf_aligner,&wavefront_set,score);
+  // Stats
+  if (stats_enabled) wavefront_stats_add_compute(&wf_aligner->stats,stats_begin_ns,lo,hi);
 }
 
 
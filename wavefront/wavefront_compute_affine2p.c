@@ -29,10 +29,12 @@
  * DESCRIPTION: WaveFront alignment module for computing wavefronts (gap-affine-2p)
  */
 
+#include "wavefront_multiversion.h"
 #include "utils/commons.h"
 #include "system/mm_allocator.h"
 #include "wavefront_compute.h"
 #include "wavefront_compute_affine.h"
+#include "wavefront_extend.h"
 #include "wavefront_backtrace_offload.h"
 
 #ifdef WFA_PARALLEL
@@ -293,22 +295,43 @@ void wavefront_compute_affine2p_dispatcher(
       wavefront_set->in_d2wavefront_ext->null) {
     // Delegate to regular gap-affine
     if (wf_aligner->wf_components.bt_piggyback) {
-      wavefront_compute_affine_idm_piggyback(wf_aligner,wavefront_set,lo,hi);
+      wf_aligner->kernels.compute_affine_idm_piggyback(wf_aligner,wavefront_set,lo,hi);
     } else {
-      wavefront_compute_affine_idm(wf_aligner,wavefront_set,lo,hi);
+      wf_aligner->kernels.compute_affine_idm(wf_aligner,wavefront_set,lo,hi);
     }
   } else {
     // Full gap-affine-2p
     if (wf_aligner->wf_components.bt_piggyback) {
-      wavefront_compute_affine2p_idm_piggyback(wf_aligner,wavefront_set,lo,hi);
+      wf_aligner->kernels.compute_affine2p_idm_piggyback(wf_aligner,wavefront_set,lo,hi);
     } else {
-      wavefront_compute_affine2p_idm(wf_aligner,wavefront_set,lo,hi);
+      wf_aligner->kernels.compute_affine2p_idm(wf_aligner,wavefront_set,lo,hi);
     }
   }
 }
+void wavefront_compute_affine2p_tiles(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_set_t* const wavefront_set,
+    const int score,
+    const int lo,
+    const int hi) {
+  // Compute only
+  if (!wf_aligner->align_status.extend_fused) {
+    wavefront_compute_affine2p_dispatcher(wf_aligner,wavefront_set,lo,hi);
+    return;
+  }
+  // Compute & extend each tile of diagonals while still in cache
+  wavefront_t* const mwavefront = wavefront_set->out_mwavefront;
+  int t_lo;
+  for (t_lo=lo;t_lo<=hi;t_lo+=WF_COMPUTE_FUSED_TILE_LENGTH) {
+    const int t_hi = MIN(t_lo+WF_COMPUTE_FUSED_TILE_LENGTH-1,hi);
+    wavefront_compute_affine2p_dispatcher(wf_aligner,wavefront_set,t_lo,t_hi);
+    wavefront_extend_end2end_dispatcher_seq(wf_aligner,mwavefront,score,t_lo,t_hi);
+  }
+}
 void wavefront_compute_affine2p_dispatcher_omp(
     wavefront_aligner_t* const wf_aligner,
     wavefront_set_t* const wavefront_set,
+    const int score,
     const int lo,
     const int hi) {
   // Parameters
@@ -316,7 +339,7 @@ void wavefront_compute_affine2p_dispatcher_omp(
   // Multithreading dispatcher
   if (num_threads == 1) {
     // Compute next wavefront
-    wavefront_compute_affine2p_dispatcher(wf_aligner,wavefront_set,lo,hi);
+    wavefront_compute_affine2p_tiles(wf_aligner,wavefront_set,score,lo,hi);
   } else {
 #ifdef WFA_PARALLEL
     // Compute next wavefront in parallel
@@ -326,10 +349,14 @@ void wavefront_compute_affine2p_dispatcher_omp(
       const int thread_id = omp_get_thread_num();
       const int thread_num = omp_get_num_threads();
       wavefront_compute_thread_limits(thread_id,thread_num,lo,hi,&t_lo,&t_hi);
-      wavefront_compute_affine2p_dispatcher(wf_aligner,wavefront_set,t_lo,t_hi);
+      wavefront_compute_affine2p_tiles(wf_aligner,wavefront_set,score,t_lo,t_hi);
     }
 #endif
   }
+  // Fused extension
+  if (wf_aligner->align_status.extend_fused) {
+    wavefront_compute_extend_fused_completed(wf_aligner,score,lo,hi);
+  }
 }
 void wavefront_compute_affine2p(
     wavefront_aligner_t* const wf_aligner,
@@ -350,6 +377,9 @@ void wavefront_compute_affine2p(
     return;
   }
   wf_aligner->align_status.num_null_steps = 0;
+  // Stats
+  const bool stats_enabled = wf_aligner->system.stats_enabled;
+  const uint64_t stats_begin_ns = (stats_enabled) ? wavefront_stats_get_time_ns() : 0;
   // Set limits
   int hi, lo;
   wavefront_compute_limits_input(wf_aligner,&wavefront_set,&lo,&hi);
@@ -358,12 +388,14 @@ void wavefront_compute_affine2p(
   // Init wavefront ends
   wavefront_compute_init_ends(wf_aligner,&wavefront_set,lo,hi);
   // Compute wavefronts
-  wavefront_compute_affine2p_dispatcher_omp(wf_aligner,&wavefront_set,lo,hi);
+  wavefront_compute_affine2p_dispatcher_omp(wf_aligner,&wavefront_set,score,lo,hi);
   // Offload backtrace (if necessary)
   if (wf_aligner->wf_components.bt_piggyback) {
     wavefront_backtrace_offload_affine(wf_aligner,&wavefront_set,lo,hi);
   }
   // Process wavefront ends
   wavefront_compute_process_ends(wf_aligner,&wavefront_set,score);
+  // Stats
+  if (stats_enabled) wavefront_stats_add_compute(&wf_aligner->stats,stats_begin_ns,lo,hi);
 }
 
@@ -29,9 +29,11 @@
  * DESCRIPTION: WaveFront alignment module for computing wavefronts (edit/indel)
  */
 
+#include "wavefront_multiversion.h"
 #include "utils/commons.h"
 #include "system/mm_allocator.h"
 #include "wavefront_compute.h"
+#include "wavefront_extend.h"
 #include "wavefront_backtrace_offload.h"
 
 #ifdef WFA_PARALLEL
@@ -297,6 +299,26 @@ void wavefront_compute_edit_dispatcher(
     }
   }
 }
+void wavefront_compute_edit_tiles(
+    wavefront_aligner_t* const wf_aligner,
+    const int score,
+    wavefront_t* const wf_prev,
+    wavefront_t* const wf_curr,
+    const int lo,
+    const int hi) {
+  // Compute only
+  if (!wf_aligner->align_status.extend_fused) {
+    wavefront_compute_edit_dispatcher(wf_aligner,score,wf_prev,wf_curr,lo,hi);
+    return;
+  }
+  // Compute & extend each tile of diagonals while still in cache
+  int t_lo;
+  for (t_lo=lo;t_lo<=hi;t_lo+=WF_COMPUTE_FUSED_TILE_LENGTH) {
+    const int t_hi = MIN(t_lo+WF_COMPUTE_FUSED_TILE_LENGTH-1,hi);
+    wavefront_compute_edit_dispatcher(wf_aligner,score,wf_prev,wf_curr,t_lo,t_hi);
+    wavefront_extend_end2end_dispatcher_seq(wf_aligner,wf_curr,score,t_lo,t_hi);
+  }
+}
 void wavefront_compute_edit_dispatcher_omp(
     wavefront_aligner_t* const wf_aligner,
     wavefront_t* const wf_prev,
@@ -309,7 +331,7 @@ void wavefront_compute_edit_dispatcher_omp(
   // Multithreading dispatcher
   if (num_threads == 1) {
     // Compute next wavefront
-    wavefront_compute_edit_dispatcher(
+    wavefront_compute_edit_tiles(
         wf_aligner,score,wf_prev,wf_curr,lo,hi);
   } else {
 #ifdef WFA_PARALLEL
@@ -320,17 +342,23 @@ void wavefront_compute_edit_dispatcher_omp(
       const int thread_id = omp_get_thread_num();
       const int thread_num = omp_get_num_threads();
       wavefront_compute_thread_limits(thread_id,thread_num,lo,hi,&t_lo,&t_hi);
-      wavefront_compute_edit_dispatcher(
+      wavefront_compute_edit_tiles(
           wf_aligner,score,wf_prev,wf_curr,t_lo,t_hi);
     }
 #endif
   }
+  // Fused extension
+  if (wf_aligner->align_status.extend_fused) {
+    wavefront_compute_extend_fused_completed(wf_aligner,score,lo,hi);
+  }
 }
 void wavefront_compute_edit(
     wavefront_aligner_t* const wf_aligner,
     const int score) {
   // Parameters
   wavefront_components_t* const wf_components = &wf_aligner->wf_components;
+  const bool stats_enabled = wf_aligner->system.stats_enabled;
+  const uint64_t stats_begin_ns = (stats_enabled) ? wavefront_stats_get_time_ns() : 0;
   // Compute scores
   int score_prev = score - 1;
   int score_curr = score;
@@ -371,4 +399,6 @@ void wavefront_compute_edit(
       wf_aligner->penalties.distance_metric == edit) {
     wavefront_compute_edit_exact_prune(wf_aligner,wf_curr);
   }
+  // Stats
+  if (stats_enabled) wavefront_stats_add_compute(&wf_aligner->stats,stats_begin_ns,lo,hi);
 }
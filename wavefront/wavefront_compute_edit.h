@@ -34,6 +34,23 @@
 
 #include "wavefront_aligner.h"
 
+/*
+ * Compute Kernels
+ */
+void wavefront_compute_edit_idm(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const wf_prev,
+    wavefront_t* const wf_curr,
+    const int lo,
+    const int hi);
+void wavefront_compute_edit_idm_piggyback(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const wf_prev,
+    wavefront_t* const wf_curr,
+    const int lo,
+    const int hi,
+    const int score);
+
 /*
  * Compute wavefront (edit)
  */
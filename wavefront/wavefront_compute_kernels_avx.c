@@ -0,0 +1,777 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignment Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignment Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignment Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: WaveFront-Alignment SIMD kernels for the gap-affine and gap-affine-2p compute step
+ */
+
+#include "wavefront_multiversion.h"
+#include "utils/commons.h"
+#include "wavefront_compute.h"
+#include "wavefront_compute_affine.h"
+#include "wavefront_compute_affine2p.h"
+#include "wavefront_compute_kernels_avx.h"
+
+#if TARGET_X86
+#include <immintrin.h>
+
+/*
+ * Common (AVX2)
+ */
+FORCE_INLINE TARGET_AVX2 __m256i avx2_loadu_epi32(const void* const mem) {
+  return _mm256_loadu_si256((const __m256i*)mem);
+}
+FORCE_INLINE TARGET_AVX2 void avx2_storeu_epi32(void* const mem,const __m256i v) {
+  _mm256_storeu_si256((__m256i*)mem,v);
+}
+FORCE_INLINE TARGET_AVX2 __m256i avx2_compute_trim(
+    const __m256i max,
+    const __m256i ks,
+    const __m256i pattern_length,
+    const __m256i text_length,
+    const __m256i offsets_null) {
+  // Adjust offset out of boundaries !(h>tlen,v>plen) (unsigned to discard negatives)
+  const __m256i h = max;
+  const __m256i v = _mm256_sub_epi32(max,ks);
+  const __m256i h_valid = _mm256_cmpeq_epi32(_mm256_max_epu32(h,text_length),text_length);
+  const __m256i v_valid = _mm256_cmpeq_epi32(_mm256_max_epu32(v,pattern_length),pattern_length);
+  return _mm256_blendv_epi8(offsets_null,max,_mm256_and_si256(h_valid,v_valid));
+}
+#ifdef PCIGAR_32BITS
+FORCE_INLINE TARGET_AVX2 void avx2_compute_gap_piggyback(
+    const wf_offset_t* const open,
+    const wf_offset_t* const ext,
+    const pcigar_t* const open_bt_pcigar,
+    const pcigar_t* const ext_bt_pcigar,
+    const bt_block_idx_t* const open_bt_prev,
+    const bt_block_idx_t* const ext_bt_prev,
+    const int k,
+    __m256i* const offset,
+    __m256i* const pcigar,
+    __m256i* const bt_prev) {
+  // Select gap-open if strictly better than gap-extend
+  const __m256i open_offset = avx2_loadu_epi32(open+k);
+  const __m256i ext_offset = avx2_loadu_epi32(ext+k);
+  const __m256i open_mask = _mm256_cmpgt_epi32(open_offset,ext_offset);
+  *offset = _mm256_max_epi32(open_offset,ext_offset);
+  *pcigar = _mm256_blendv_epi8(
+      avx2_loadu_epi32(ext_bt_pcigar+k),avx2_loadu_epi32(open_bt_pcigar+k),open_mask);
+  *bt_prev = _mm256_blendv_epi8(
+      avx2_loadu_epi32(ext_bt_prev+k),avx2_loadu_epi32(open_bt_prev+k),open_mask);
+}
+#endif
+/*
+ * Common (AVX512)
+ */
+FORCE_INLINE TARGET_AVX512 __m512i avx512_compute_trim(
+    const __m512i max,
+    const __m512i ks,
+    const __m512i pattern_length,
+    const __m512i text_length,
+    const __m512i offsets_null) {
+  // Adjust offset out of boundaries !(h>tlen,v>plen) (unsigned to discard negatives)
+  const __m512i v = _mm512_sub_epi32(max,ks);
+  const __mmask16 valid =
+      _mm512_cmple_epu32_mask(max,text_length) &
+      _mm512_cmple_epu32_mask(v,pattern_length);
+  return _mm512_mask_blend_epi32(valid,offsets_null,max);
+}
+#ifdef PCIGAR_32BITS
+FORCE_INLINE TARGET_AVX512 void avx512_compute_gap_piggyback(
+    const wf_offset_t* const open,
+    const wf_offset_t* const ext,
+    const pcigar_t* const open_bt_pcigar,
+    const pcigar_t* const ext_bt_pcigar,
+    const bt_block_idx_t* const open_bt_prev,
+    const bt_block_idx_t* const ext_bt_prev,
+    const int k,
+    const __mmask16 lanes,
+    __m512i* const offset,
+    __m512i* const pcigar,
+    __m512i* const bt_prev) {
+  // Select gap-open if strictly better than gap-extend
+  const __m512i open_offset = _mm512_maskz_loadu_epi32(lanes,open+k);
+  const __m512i ext_offset = _mm512_maskz_loadu_epi32(lanes,ext+k);
+  const __mmask16 open_mask = _mm512_cmpgt_epi32_mask(open_offset,ext_offset);
+  *offset = _mm512_max_epi32(open_offset,ext_offset);
+  *pcigar = _mm512_mask_blend_epi32(open_mask,
+      _mm512_maskz_loadu_epi32(lanes,ext_bt_pcigar+k),
+      _mm512_maskz_loadu_epi32(lanes,open_bt_pcigar+k));
+  *bt_prev = _mm512_mask_blend_epi32(open_mask,
+      _mm512_maskz_loadu_epi32(lanes,ext_bt_prev+k),
+      _mm512_maskz_loadu_epi32(lanes,open_bt_prev+k));
+}
+#endif
+FORCE_INLINE TARGET_AVX512 __mmask16 avx512_compute_lanes(
+    const int k,
+    const int hi) {
+  const int num_lanes = hi-k+1;
+  return (num_lanes >= 16) ? (__mmask16)0xFFFF : (__mmask16)((1u<<num_lanes)-1);
+}
+/*
+ * Compute Kernels gap-affine (SIMD AVX2)
+ */
+FORCE_NO_INLINE TARGET_AVX2 void wavefront_compute_affine_idm_avx2(
+    wavefront_aligner_t* const wf_aligner,
+    const wavefront_set_t* const wavefront_set,
+    const int lo,
+    const int hi) {
+  // Parameters
+  wavefront_sequences_t* const sequences = &wf_aligner->sequences;
+  const __m256i pattern_length = _mm256_set1_epi32(sequences->pattern_length);
+  const __m256i text_length = _mm256_set1_epi32(sequences->text_length);
+  const __m256i offsets_null = _mm256_set1_epi32(WAVEFRONT_OFFSET_NULL);
+  const __m256i ones = _mm256_set1_epi32(1);
+  const __m256i eights = _mm256_set1_epi32(8);
+  // In Offsets
+  const wf_offset_t* const m_misms = wavefront_set->in_mwavefront_misms->offsets;
+  const wf_offset_t* const m_open1 = wavefront_set->in_mwavefront_open1->offsets;
+  const wf_offset_t* const i1_ext = wavefront_set->in_i1wavefront_ext->offsets;
+  const wf_offset_t* const d1_ext = wavefront_set->in_d1wavefront_ext->offsets;
+  // Out Offsets
+  wf_offset_t* const out_m = wavefront_set->out_mwavefront->offsets;
+  wf_offset_t* const out_i1 = wavefront_set->out_i1wavefront->offsets;
+  wf_offset_t* const out_d1 = wavefront_set->out_d1wavefront->offsets;
+  // Compute-Next kernel loop (8 diagonals per iteration)
+  __m256i ks = _mm256_add_epi32(_mm256_set1_epi32(lo),_mm256_setr_epi32(0,1,2,3,4,5,6,7));
+  int k;
+  for (k=lo;k+7<=hi;k+=8) {
+    // Update I1
+    const __m256i ins1 = _mm256_add_epi32(_mm256_max_epi32(
+        avx2_loadu_epi32(m_open1+k-1),avx2_loadu_epi32(i1_ext+k-1)),ones);
+    avx2_storeu_epi32(out_i1+k,ins1);
+    // Update D1
+    const __m256i del1 = _mm256_max_epi32(
+        avx2_loadu_epi32(m_open1+k+1),avx2_loadu_epi32(d1_ext+k+1));
+    avx2_storeu_epi32(out_d1+k,del1);
+    // Update M
+    const __m256i misms = _mm256_add_epi32(avx2_loadu_epi32(m_misms+k),ones);
+    const __m256i max = _mm256_max_epi32(del1,_mm256_max_epi32(misms,ins1));
+    avx2_storeu_epi32(out_m+k,avx2_compute_trim(max,ks,pattern_length,text_length,offsets_null));
+    ks = _mm256_add_epi32(ks,eights);
+  }
+  // Remaining diagonals
+  if (k <= hi) wavefront_compute_affine_idm(wf_aligner,wavefront_set,k,hi);
+}
+FORCE_NO_INLINE TARGET_AVX2 void wavefront_compute_affine_idm_piggyback_avx2(
+    wavefront_aligner_t* const wf_aligner,
+    const wavefront_set_t* const wavefront_set,
+    const int lo,
+    const int hi) {
+#ifdef PCIGAR_32BITS
+  // Parameters
+  wavefront_sequences_t* const sequences = &wf_aligner->sequences;
+  const __m256i pattern_length = _mm256_set1_epi32(sequences->pattern_length);
+  const __m256i text_length = _mm256_set1_epi32(sequences->text_length);
+  const __m256i offsets_null = _mm256_set1_epi32(WAVEFRONT_OFFSET_NULL);
+  const __m256i ones = _mm256_set1_epi32(1);
+  const __m256i eights = _mm256_set1_epi32(8);
+  const __m256i pcigar_ins = _mm256_set1_epi32(PCIGAR_INSERTION);
+  const __m256i pcigar_del = _mm256_set1_epi32(PCIGAR_DELETION);
+  const __m256i pcigar_misms = _mm256_set1_epi32(PCIGAR_MISMATCH);
+  // In Offsets
+  const wf_offset_t* const m_misms = wavefront_set->in_mwavefront_misms->offsets;
+  const wf_offset_t* const m_open1 = wavefront_set->in_mwavefront_open1->offsets;
+  const wf_offset_t* const i1_ext  = wavefront_set->in_i1wavefront_ext->offsets;
+  const wf_offset_t* const d1_ext  = wavefront_set->in_d1wavefront_ext->offsets;
+  // Out Offsets
+  wf_offset_t* const out_m  = wavefront_set->out_mwavefront->offsets;
+  wf_offset_t* const out_i1 = wavefront_set->out_i1wavefront->offsets;
+  wf_offset_t* const out_d1 = wavefront_set->out_d1wavefront->offsets;
+  // In BT-pcigar
+  const pcigar_t* const m_misms_bt_pcigar = wavefront_set->in_mwavefront_misms->bt_pcigar;
+  const pcigar_t* const m_open1_bt_pcigar = wavefront_set->in_mwavefront_open1->bt_pcigar;
+  const pcigar_t* const i1_ext_bt_pcigar  = wavefront_set->in_i1wavefront_ext->bt_pcigar;
+  const pcigar_t* const d1_ext_bt_pcigar  = wavefront_set->in_d1wavefront_ext->bt_pcigar;
+  // In BT-prev
+  const bt_block_idx_t* const m_misms_bt_prev = wavefront_set->in_mwavefront_misms->bt_prev;
+  const bt_block_idx_t* const m_open1_bt_prev = wavefront_set->in_mwavefront_open1->bt_prev;
+  const bt_block_idx_t* const i1_ext_bt_prev  = wavefront_set->in_i1wavefront_ext->bt_prev;
+  const bt_block_idx_t* const d1_ext_bt_prev  = wavefront_set->in_d1wavefront_ext->bt_prev;
+  // Out BT-pcigar
+  pcigar_t* const out_m_bt_pcigar   = wavefront_set->out_mwavefront->bt_pcigar;
+  pcigar_t* const out_i1_bt_pcigar  = wavefront_set->out_i1wavefront->bt_pcigar;
+  pcigar_t* const out_d1_bt_pcigar  = wavefront_set->out_d1wavefront->bt_pcigar;
+  // Out BT-prev
+  bt_block_idx_t* const out_m_bt_prev  = wavefront_set->out_mwavefront->bt_prev;
+  bt_block_idx_t* const out_i1_bt_prev = wavefront_set->out_i1wavefront->bt_prev;
+  bt_block_idx_t* const out_d1_bt_prev = wavefront_set->out_d1wavefront->bt_prev;
+  // Compute-Next kernel loop (8 diagonals per iteration)
+  __m256i ks = _mm256_add_epi32(_mm256_set1_epi32(lo),_mm256_setr_epi32(0,1,2,3,4,5,6,7));
+  int k;
+  for (k=lo;k+7<=hi;k+=8) {
+    // Update I1
+    __m256i ins1, ins1_pcigar, ins1_bt_prev;
+    avx2_compute_gap_piggyback(m_open1,i1_ext,m_open1_bt_pcigar,i1_ext_bt_pcigar,
+        m_open1_bt_prev,i1_ext_bt_prev,k-1,&ins1,&ins1_pcigar,&ins1_bt_prev);
+    ins1_pcigar = _mm256_or_si256(_mm256_slli_epi32(ins1_pcigar,2),pcigar_ins);
+    ins1 = _mm256_add_epi32(ins1,ones);
+    avx2_storeu_epi32(out_i1_bt_pcigar+k,ins1_pcigar);
+    avx2_storeu_epi32(out_i1_bt_prev+k,ins1_bt_prev);
+    avx2_storeu_epi32(out_i1+k,ins1);
+    // Update D1
+    __m256i del1, del1_pcigar, del1_bt_prev;
+    avx2_compute_gap_piggyback(m_open1,d1_ext,m_open1_bt_pcigar,d1_ext_bt_pcigar,
+        m_open1_bt_prev,d1_ext_bt_prev,k+1,&del1,&del1_pcigar,&del1_bt_prev);
+    del1_pcigar = _mm256_or_si256(_mm256_slli_epi32(del1_pcigar,2),pcigar_del);
+    avx2_storeu_epi32(out_d1_bt_pcigar+k,del1_pcigar);
+    avx2_storeu_epi32(out_d1_bt_prev+k,del1_bt_prev);
+    avx2_storeu_epi32(out_d1+k,del1);
+    // Update M (source priority: misms > del1 > ins1)
+    const __m256i misms = _mm256_add_epi32(avx2_loadu_epi32(m_misms+k),ones);
+    const __m256i max = _mm256_max_epi32(del1,_mm256_max_epi32(misms,ins1));
+    const __m256i is_del1 = _mm256_cmpeq_epi32(max,del1);
+    const __m256i is_misms = _mm256_cmpeq_epi32(max,misms);
+    __m256i m_pcigar = _mm256_blendv_epi8(ins1_pcigar,del1_pcigar,is_del1);
+    __m256i m_bt_prev = _mm256_blendv_epi8(ins1_bt_prev,del1_bt_prev,is_del1);
+    m_pcigar = _mm256_blendv_epi8(m_pcigar,avx2_loadu_epi32(m_misms_bt_pcigar+k),is_misms);
+    m_bt_prev = _mm256_blendv_epi8(m_bt_prev,avx2_loadu_epi32(m_misms_bt_prev+k),is_misms);
+    // Coming from I/D -> X is fake to represent gap-close
+    // Coming from M -> X is real to represent mismatch
+    avx2_storeu_epi32(out_m_bt_pcigar+k,_mm256_or_si256(_mm256_slli_epi32(m_pcigar,2),pcigar_misms));
+    avx2_storeu_epi32(out_m_bt_prev+k,m_bt_prev);
+    avx2_storeu_epi32(out_m+k,avx2_compute_trim(max,ks,pattern_length,text_length,offsets_null));
+    ks = _mm256_add_epi32(ks,eights);
+  }
+  // Remaining diagonals
+  if (k <= hi) wavefront_compute_affine_idm_piggyback(wf_aligner,wavefront_set,k,hi);
+#else
+  wavefront_compute_affine_idm_piggyback(wf_aligner,wavefront_set,lo,hi);
+#endif
+}
+/*
+ * Compute Kernels gap-affine-2p (SIMD AVX2)
+ */
+FORCE_NO_INLINE TARGET_AVX2 void wavefront_compute_affine2p_idm_avx2(
+    wavefront_aligner_t* const wf_aligner,
+    const wavefront_set_t* const wavefront_set,
+    const int lo,
+    const int hi) {
+  // Parameters
+  wavefront_sequences_t* const sequences = &wf_aligner->sequences;
+  const __m256i pattern_length = _mm256_set1_epi32(sequences->pattern_length);
+  const __m256i text_length = _mm256_set1_epi32(sequences->text_length);
+  const __m256i offsets_null = _mm256_set1_epi32(WAVEFRONT_OFFSET_NULL);
+  const __m256i ones = _mm256_set1_epi32(1);
+  const __m256i eights = _mm256_set1_epi32(8);
+  // In Offsets
+  const wf_offset_t* const m_misms = wavefront_set->in_mwavefront_misms->offsets;
+  const wf_offset_t* const m_open1 = wavefront_set->in_mwavefront_open1->offsets;
+  const wf_offset_t* const m_open2 = wavefront_set->in_mwavefront_open2->offsets;
+  const wf_offset_t* const i1_ext = wavefront_set->in_i1wavefront_ext->offsets;
+  const wf_offset_t* const i2_ext = wavefront_set->in_i2wavefront_ext->offsets;
+  const wf_offset_t* const d1_ext = wavefront_set->in_d1wavefront_ext->offsets;
+  const wf_offset_t* const d2_ext = wavefront_set->in_d2wavefront_ext->offsets;
+  // Out Offsets
+  wf_offset_t* const out_m = wavefront_set->out_mwavefront->offsets;
+  wf_offset_t* const out_i1 = wavefront_set->out_i1wavefront->offsets;
+  wf_offset_t* const out_i2 = wavefront_set->out_i2wavefront->offsets;
+  wf_offset_t* const out_d1 = wavefront_set->out_d1wavefront->offsets;
+  wf_offset_t* const out_d2 = wavefront_set->out_d2wavefront->offsets;
+  // Compute-Next kernel loop (8 diagonals per iteration)
+  __m256i ks = _mm256_add_epi32(_mm256_set1_epi32(lo),_mm256_setr_epi32(0,1,2,3,4,5,6,7));
+  int k;
+  for (k=lo;k+7<=hi;k+=8) {
+    // Update I1/I2
+    const __m256i ins1 = _mm256_add_epi32(_mm256_max_epi32(
+        avx2_loadu_epi32(m_open1+k-1),avx2_loadu_epi32(i1_ext+k-1)),ones);
+    avx2_storeu_epi32(out_i1+k,ins1);
+    const __m256i ins2 = _mm256_add_epi32(_mm256_max_epi32(
+        avx2_loadu_epi32(m_open2+k-1),avx2_loadu_epi32(i2_ext+k-1)),ones);
+    avx2_storeu_epi32(out_i2+k,ins2);
+    const __m256i ins = _mm256_max_epi32(ins1,ins2);
+    // Update D1/D2
+    const __m256i del1 = _mm256_max_epi32(
+        avx2_loadu_epi32(m_open1+k+1),avx2_loadu_epi32(d1_ext+k+1));
+    avx2_storeu_epi32(out_d1+k,del1);
+    const __m256i del2 = _mm256_max_epi32(
+        avx2_loadu_epi32(m_open2+k+1),avx2_loadu_epi32(d2_ext+k+1));
+    avx2_storeu_epi32(out_d2+k,del2);
+    const __m256i del = _mm256_max_epi32(del1,del2);
+    // Update M
+    const __m256i misms = _mm256_add_epi32(avx2_loadu_epi32(m_misms+k),ones);
+    const __m256i max = _mm256_max_epi32(del,_mm256_max_epi32(misms,ins));
+    avx2_storeu_epi32(out_m+k,avx2_compute_trim(max,ks,pattern_length,text_length,offsets_null));
+    ks = _mm256_add_epi32(ks,eights);
+  }
+  // Remaining diagonals
+  if (k <= hi) wavefront_compute_affine2p_idm(wf_aligner,wavefront_set,k,hi);
+}
+FORCE_NO_INLINE TARGET_AVX2 void wavefront_compute_affine2p_idm_piggyback_avx2(
+    wavefront_aligner_t* const wf_aligner,
+    const wavefront_set_t* const wavefront_set,
+    const int lo,
+    const int hi) {
+#ifdef PCIGAR_32BITS
+  // Parameters
+  wavefront_sequences_t* const sequences = &wf_aligner->sequences;
+  const __m256i pattern_length = _mm256_set1_epi32(sequences->pattern_length);
+  const __m256i text_length = _mm256_set1_epi32(sequences->text_length);
+  const __m256i offsets_null = _mm256_set1_epi32(WAVEFRONT_OFFSET_NULL);
+  const __m256i ones = _mm256_set1_epi32(1);
+  const __m256i eights = _mm256_set1_epi32(8);
+  const __m256i pcigar_ins = _mm256_set1_epi32(PCIGAR_INSERTION);
+  const __m256i pcigar_del = _mm256_set1_epi32(PCIGAR_DELETION);
+  const __m256i pcigar_misms = _mm256_set1_epi32(PCIGAR_MISMATCH);
+  // In Offsets
+  const wf_offset_t* const m_misms = wavefront_set->in_mwavefront_misms->offsets;
+  const wf_offset_t* const m_open1 = wavefront_set->in_mwavefront_open1->offsets;
+  const wf_offset_t* const m_open2 = wavefront_set->in_mwavefront_open2->offsets;
+  const wf_offset_t* const i1_ext  = wavefront_set->in_i1wavefront_ext->offsets;
+  const wf_offset_t* const i2_ext  = wavefront_set->in_i2wavefront_ext->offsets;
+  const wf_offset_t* const d1_ext  = wavefront_set->in_d1wavefront_ext->offsets;
+  const wf_offset_t* const d2_ext  = wavefront_set->in_d2wavefront_ext->offsets;
+  // Out Offsets
+  wf_offset_t* const out_m  = wavefront_set->out_mwavefront->offsets;
+  wf_offset_t* const out_i1 = wavefront_set->out_i1wavefront->offsets;
+  wf_offset_t* const out_i2 = wavefront_set->out_i2wavefront->offsets;
+  wf_offset_t* const out_d1 = wavefront_set->out_d1wavefront->offsets;
+  wf_offset_t* const out_d2 = wavefront_set->out_d2wavefront->offsets;
+  // In BT-pcigar
+  const pcigar_t* const m_misms_bt_pcigar = wavefront_set->in_mwavefront_misms->bt_pcigar;
+  const pcigar_t* const m_open1_bt_pcigar = wavefront_set->in_mwavefront_open1->bt_pcigar;
+  const pcigar_t* const m_open2_bt_pcigar = wavefront_set->in_mwavefront_open2->bt_pcigar;
+  const pcigar_t* const i1_ext_bt_pcigar  = wavefront_set->in_i1wavefront_ext->bt_pcigar;
+  const pcigar_t* const i2_ext_bt_pcigar  = wavefront_set->in_i2wavefront_ext->bt_pcigar;
+  const pcigar_t* const d1_ext_bt_pcigar  = wavefront_set->in_d1wavefront_ext->bt_pcigar;
+  const pcigar_t* const d2_ext_bt_pcigar  = wavefront_set->in_d2wavefront_ext->bt_pcigar;
+  // In BT-prev
+  const bt_block_idx_t* const m_misms_bt_prev = wavefront_set->in_mwavefront_misms->bt_prev;
+  const bt_block_idx_t* const m_open1_bt_prev = wavefront_set->in_mwavefront_open1->bt_prev;
+  const bt_block_idx_t* const m_open2_bt_prev = wavefront_set->in_mwavefront_open2->bt_prev;
+  const bt_block_idx_t* const i1_ext_bt_prev  = wavefront_set->in_i1wavefront_ext->bt_prev;
+  const bt_block_idx_t* const i2_ext_bt_prev  = wavefront_set->in_i2wavefront_ext->bt_prev;
+  const bt_block_idx_t* const d1_ext_bt_prev  = wavefront_set->in_d1wavefront_ext->bt_prev;
+  const bt_block_idx_t* const d2_ext_bt_prev  = wavefront_set->in_d2wavefront_ext->bt_prev;
+  // Out BT-pcigar
+  pcigar_t* const out_m_bt_pcigar   = wavefront_set->out_mwavefront->bt_pcigar;
+  pcigar_t* const out_i1_bt_pcigar  = wavefront_set->out_i1wavefront->bt_pcigar;
+  pcigar_t* const out_i2_bt_pcigar  = wavefront_set->out_i2wavefront->bt_pcigar;
+  pcigar_t* const out_d1_bt_pcigar  = wavefront_set->out_d1wavefront->bt_pcigar;
+  pcigar_t* const out_d2_bt_pcigar  = wavefront_set->out_d2wavefront->bt_pcigar;
+  // Out BT-prev
+  bt_block_idx_t* const out_m_bt_prev  = wavefront_set->out_mwavefront->bt_prev;
+  bt_block_idx_t* const out_i1_bt_prev = wavefront_set->out_i1wavefront->bt_prev;
+  bt_block_idx_t* const out_i2_bt_prev = wavefront_set->out_i2wavefront->bt_prev;
+  bt_block_idx_t* const out_d1_bt_prev = wavefront_set->out_d1wavefront->bt_prev;
+  bt_block_idx_t* const out_d2_bt_prev = wavefront_set->out_d2wavefront->bt_prev;
+  // Compute-Next kernel loop (8 diagonals per iteration)
+  __m256i ks = _mm256_add_epi32(_mm256_set1_epi32(lo),_mm256_setr_epi32(0,1,2,3,4,5,6,7));
+  int k;
+  for (k=lo;k+7<=hi;k+=8) {
+    // Update I1
+    __m256i ins1, ins1_pcigar, ins1_bt_prev;
+    avx2_compute_gap_piggyback(m_open1,i1_ext,m_open1_bt_pcigar,i1_ext_bt_pcigar,
+        m_open1_bt_prev,i1_ext_bt_prev,k-1,&ins1,&ins1_pcigar,&ins1_bt_prev);
+    ins1_pcigar = _mm256_or_si256(_mm256_slli_epi32(ins1_pcigar,2),pcigar_ins);
+    ins1 = _mm256_add_epi32(ins1,ones);
+    avx2_storeu_epi32(out_i1_bt_pcigar+k,ins1_pcigar);
+    avx2_storeu_epi32(out_i1_bt_prev+k,ins1_bt_prev);
+    avx2_storeu_epi32(out_i1+k,ins1);
+    // Update I2
+    __m256i ins2, ins2_pcigar, ins2_bt_prev;
+    avx2_compute_gap_piggyback(m_open2,i2_ext,m_open2_bt_pcigar,i2_ext_bt_pcigar,
+        m_open2_bt_prev,i2_ext_bt_prev,k-1,&ins2,&ins2_pcigar,&ins2_bt_prev);
+    ins2_pcigar = _mm256_or_si256(_mm256_slli_epi32(ins2_pcigar,2),pcigar_ins);
+    ins2 = _mm256_add_epi32(ins2,ones);
+    avx2_storeu_epi32(out_i2_bt_pcigar+k,ins2_pcigar);
+    avx2_storeu_epi32(out_i2_bt_prev+k,ins2_bt_prev);
+    avx2_storeu_epi32(out_i2+k,ins2);
+    // Update D1
+    __m256i del1, del1_pcigar, del1_bt_prev;
+    avx2_compute_gap_piggyback(m_open1,d1_ext,m_open1_bt_pcigar,d1_ext_bt_pcigar,
+        m_open1_bt_prev,d1_ext_bt_prev,k+1,&del1,&del1_pcigar,&del1_bt_prev);
+    del1_pcigar = _mm256_or_si256(_mm256_slli_epi32(del1_pcigar,2),pcigar_del);
+    avx2_storeu_epi32(out_d1_bt_pcigar+k,del1_pcigar);
+    avx2_storeu_epi32(out_d1_bt_prev+k,del1_bt_prev);
+    avx2_storeu_epi32(out_d1+k,del1);
+    // Update D2
+    __m256i del2, del2_pcigar, del2_bt_prev;
+    avx2_compute_gap_piggyback(m_open2,d2_ext,m_open2_bt_pcigar,d2_ext_bt_pcigar,
+        m_open2_bt_prev,d2_ext_bt_prev,k+1,&del2,&del2_pcigar,&del2_bt_prev);
+    del2_pcigar = _mm256_or_si256(_mm256_slli_epi32(del2_pcigar,2),pcigar_del);
+    avx2_storeu_epi32(out_d2_bt_pcigar+k,del2_pcigar);
+    avx2_storeu_epi32(out_d2_bt_prev+k,del2_bt_prev);
+    avx2_storeu_epi32(out_d2+k,del2);
+    // Update M (source priority: misms > del2 > del1 > ins2 > ins1)
+    const __m256i ins = _mm256_max_epi32(ins1,ins2);
+    const __m256i del = _mm256_max_epi32(del1,del2);
+    const __m256i misms = _mm256_add_epi32(avx2_loadu_epi32(m_misms+k),ones);
+    const __m256i max = _mm256_max_epi32(del,_mm256_max_epi32(misms,ins));
+    const __m256i is_ins2 = _mm256_cmpeq_epi32(max,ins2);
+    const __m256i is_del1 = _mm256_cmpeq_epi32(max,del1);
+    const __m256i is_del2 = _mm256_cmpeq_epi32(max,del2);
+    const __m256i is_misms = _mm256_cmpeq_epi32(max,misms);
+    __m256i m_pcigar = _mm256_blendv_epi8(ins1_pcigar,ins2_pcigar,is_ins2);
+    __m256i m_bt_prev = _mm256_blendv_epi8(ins1_bt_prev,ins2_bt_prev,is_ins2);
+    m_pcigar = _mm256_blendv_epi8(m_pcigar,del1_pcigar,is_del1);
+    m_bt_prev = _mm256_blendv_epi8(m_bt_prev,del1_bt_prev,is_del1);
+    m_pcigar = _mm256_blendv_epi8(m_pcigar,del2_pcigar,is_del2);
+    m_bt_prev = _mm256_blendv_epi8(m_bt_prev,del2_bt_prev,is_del2);
+    m_pcigar = _mm256_blendv_epi8(m_pcigar,avx2_loadu_epi32(m_misms_bt_pcigar+k),is_misms);
+    m_bt_prev = _mm256_blendv_epi8(m_bt_prev,avx2_loadu_epi32(m_misms_bt_prev+k),is_misms);
+    // Coming from I/D -> X is fake to represent gap-close
+    // Coming from M -> X is real to represent mismatch
+    avx2_storeu_epi32(out_m_bt_pcigar+k,_mm256_or_si256(_mm256_slli_epi32(m_pcigar,2),pcigar_misms));
+    avx2_storeu_epi32(out_m_bt_prev+k,m_bt_prev);
+    avx2_storeu_epi32(out_m+k,avx2_compute_trim(max,ks,pattern_length,text_length,offsets_null));
+    ks = _mm256_add_epi32(ks,eights);
+  }
+  // Remaining diagonals
+  if (k <= hi) wavefront_compute_affine2p_idm_piggyback(wf_aligner,wavefront_set,k,hi);
+#else
+  wavefront_compute_affine2p_idm_piggyback(wf_aligner,wavefront_set,lo,hi);
+#endif
+}
+/*
+ * Compute Kernels gap-affine (SIMD AVX512)
+ */
+FORCE_NO_INLINE TARGET_AVX512 void wavefront_compute_affine_idm_avx512(
+    wavefront_aligner_t* const wf_aligner,
+    const wavefront_set_t* const wavefront_set,
+    const int lo,
+    const int hi) {
+  // Parameters
+  wavefront_sequences_t* const sequences = &wf_aligner->sequences;
+  const __m512i pattern_length = _mm512_set1_epi32(sequences->pattern_length);
+  const __m512i text_length = _mm512_set1_epi32(sequences->text_length);
+  const __m512i offsets_null = _mm512_set1_epi32(WAVEFRONT_OFFSET_NULL);
+  const __m512i ones = _mm512_set1_epi32(1);
+  const __m512i sixteens = _mm512_set1_epi32(16);
+  // In Offsets
+  const wf_offset_t* const m_misms = wavefront_set->in_mwavefront_misms->offsets;
+  const wf_offset_t* const m_open1 = wavefront_set->in_mwavefront_open1->offsets;
+  const wf_offset_t* const i1_ext = wavefront_set->in_i1wavefront_ext->offsets;
+  const wf_offset_t* const d1_ext = wavefront_set->in_d1wavefront_ext->offsets;
+  // Out Offsets
+  wf_offset_t* const out_m = wavefront_set->out_mwavefront->offsets;
+  wf_offset_t* const out_i1 = wavefront_set->out_i1wavefront->offsets;
+  wf_offset_t* const out_d1 = wavefront_set->out_d1wavefront->offsets;
+  // Compute-Next kernel loop (16 diagonals per iteration, masked tail)
+  __m512i ks = _mm512_add_epi32(_mm512_set1_epi32(lo),
+      _mm512_setr_epi32(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15));
+  int k;
+  for (k=lo;k<=hi;k+=16) {
+    const __mmask16 lanes = avx512_compute_lanes(k,hi);
+    // Update I1
+    const __m512i ins1 = _mm512_add_epi32(_mm512_max_epi32(
+        _mm512_maskz_loadu_epi32(lanes,m_open1+k-1),
+        _mm512_maskz_loadu_epi32(lanes,i1_ext+k-1)),ones);
+    _mm512_mask_storeu_epi32(out_i1+k,lanes,ins1);
+    // Update D1
+    const __m512i del1 = _mm512_max_epi32(
+        _mm512_maskz_loadu_epi32(lanes,m_open1+k+1),
+        _mm512_maskz_loadu_epi32(lanes,d1_ext+k+1));
+    _mm512_mask_storeu_epi32(out_d1+k,lanes,del1);
+    // Update M
+    const __m512i misms = _mm512_add_epi32(_mm512_maskz_loadu_epi32(lanes,m_misms+k),ones);
+    const __m512i max = _mm512_max_epi32(del1,_mm512_max_epi32(misms,ins1));
+    _mm512_mask_storeu_epi32(out_m+k,lanes,
+        avx512_compute_trim(max,ks,pattern_length,text_length,offsets_null));
+    ks = _mm512_add_epi32(ks,sixteens);
+  }
+}
+FORCE_NO_INLINE TARGET_AVX512 void wavefront_compute_affine_idm_piggyback_avx512(
+    wavefront_aligner_t* const wf_aligner,
+    const wavefront_set_t* const wavefront_set,
+    const int lo,
+    const int hi) {
+#ifdef PCIGAR_32BITS
+  // Parameters
+  wavefront_sequences_t* const sequences = &wf_aligner->sequences;
+  const __m512i pattern_length = _mm512_set1_epi32(sequences->pattern_length);
+  const __m512i text_length = _mm512_set1_epi32(sequences->text_length);
+  const __m512i offsets_null = _mm512_set1_epi32(WAVEFRONT_OFFSET_NULL);
+  const __m512i ones = _mm512_set1_epi32(1);
+  const __m512i sixteens = _mm512_set1_epi32(16);
+  const __m512i pcigar_ins = _mm512_set1_epi32(PCIGAR_INSERTION);
+  const __m512i pcigar_del = _mm512_set1_epi32(PCIGAR_DELETION);
+  const __m512i pcigar_misms = _mm512_set1_epi32(PCIGAR_MISMATCH);
+  // In Offsets
+  const wf_offset_t* const m_misms = wavefront_set->in_mwavefront_misms->offsets;
+  const wf_offset_t* const m_open1 = wavefront_set->in_mwavefront_open1->offsets;
+  const wf_offset_t* const i1_ext  = wavefront_set->in_i1wavefront_ext->offsets;
+  const wf_offset_t* const d1_ext  = wavefront_set->in_d1wavefront_ext->offsets;
+  // Out Offsets
+  wf_offset_t* const out_m  = wavefront_set->out_mwavefront->offsets;
+  wf_offset_t* const out_i1 = wavefront_set->out_i1wavefront->offsets;
+  wf_offset_t* const out_d1 = wavefront_set->out_d1wavefront->offsets;
+  // In BT-pcigar
+  const pcigar_t* const m_misms_bt_pcigar = wavefront_set->in_mwavefront_misms->bt_pcigar;
+  const pcigar_t* const m_open1_bt_pcigar = wavefront_set->in_mwavefront_open1->bt_pcigar;
+  const pcigar_t* const i1_ext_bt_pcigar  = wavefront_set->in_i1wavefront_ext->bt_pcigar;
+  const pcigar_t* const d1_ext_bt_pcigar  = wavefront_set->in_d1wavefront_ext->bt_pcigar;
+  // In BT-prev
+  const bt_block_idx_t* const m_misms_bt_prev = wavefront_set->in_mwavefront_misms->bt_prev;
+  const bt_block_idx_t* const m_open1_bt_prev = wavefront_set->in_mwavefront_open1->bt_prev;
+  const bt_block_idx_t* const i1_ext_bt_prev  = wavefront_set->in_i1wavefront_ext->bt_prev;
+  const bt_block_idx_t* const d1_ext_bt_prev  = wavefront_set->in_d1wavefront_ext->bt_prev;
+  // Out BT-pcigar
+  pcigar_t* const out_m_bt_pcigar   = wavefront_set->out_mwavefront->bt_pcigar;
+  pcigar_t* const out_i1_bt_pcigar  = wavefront_set->out_i1wavefront->bt_pcigar;
+  pcigar_t* const out_d1_bt_pcigar  = wavefront_set->out_d1wavefront->bt_pcigar;
+  // Out BT-prev
+  bt_block_idx_t* const out_m_bt_prev  = wavefront_set->out_mwavefront->bt_prev;
+  bt_block_idx_t* const out_i1_bt_prev = wavefront_set->out_i1wavefront->bt_prev;
+  bt_block_idx_t* const out_d1_bt_prev = wavefront_set->out_d1wavefront->bt_prev;
+  // Compute-Next kernel loop (16 diagonals per iteration, masked tail)
+  __m512i ks = _mm512_add_epi32(_mm512_set1_epi32(lo),
+      _mm512_setr_epi32(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15));
+  int k;
+  for (k=lo;k<=hi;k+=16) {
+    const __mmask16 lanes = avx512_compute_lanes(k,hi);
+    // Update I1
+    __m512i ins1, ins1_pcigar, ins1_bt_prev;
+    avx512_compute_gap_piggyback(m_open1,i1_ext,m_open1_bt_pcigar,i1_ext_bt_pcigar,
+        m_open1_bt_prev,i1_ext_bt_prev,k-1,lanes,&ins1,&ins1_pcigar,&ins1_bt_prev);
+    ins1_pcigar = _mm512_or_si512(_mm512_slli_epi32(ins1_pcigar,2),pcigar_ins);
+    ins1 = _mm512_add_epi32(ins1,ones);
+    _mm512_mask_storeu_epi32(out_i1_bt_pcigar+k,lanes,ins1_pcigar);
+    _mm512_mask_storeu_epi32(out_i1_bt_prev+k,lanes,ins1_bt_prev);
+    _mm512_mask_storeu_epi32(out_i1+k,lanes,ins1);
+    // Update D1
+    __m512i del1, del1_pcigar, del1_bt_prev;
+    avx512_compute_gap_piggyback(m_open1,d1_ext,m_open1_bt_pcigar,d1_ext_bt_pcigar,
+        m_open1_bt_prev,d1_ext_bt_prev,k+1,lanes,&del1,&del1_pcigar,&del1_bt_prev);
+    del1_pcigar = _mm512_or_si512(_mm512_slli_epi32(del1_pcigar,2),pcigar_del);
+    _mm512_mask_storeu_epi32(out_d1_bt_pcigar+k,lanes,del1_pcigar);
+    _mm512_mask_storeu_epi32(out_d1_bt_prev+k,lanes,del1_bt_prev);
+    _mm512_mask_storeu_epi32(out_d1+k,lanes,del1);
+    // Update M (source priority: misms > del1 > ins1)
+    const __m512i misms = _mm512_add_epi32(_mm512_maskz_loadu_epi32(lanes,m_misms+k),ones);
+    const __m512i max = _mm512_max_epi32(del1,_mm512_max_epi32(misms,ins1));
+    const __mmask16 is_del1 = _mm512_cmpeq_epi32_mask(max,del1);
+    const __mmask16 is_misms = _mm512_cmpeq_epi32_mask(max,misms);
+    __m512i m_pcigar = _mm512_mask_blend_epi32(is_del1,ins1_pcigar,del1_pcigar);
+    __m512i m_bt_prev = _mm512_mask_blend_epi32(is_del1,ins1_bt_prev,del1_bt_prev);
+    m_pcigar = _mm512_mask_loadu_epi32(m_pcigar,is_misms&lanes,m_misms_bt_pcigar+k);
+    m_bt_prev = _mm512_mask_loadu_epi32(m_bt_prev,is_misms&lanes,m_misms_bt_prev+k);
+    // Coming from I/D -> X is fake to represent gap-close
+    // Coming from M -> X is real to represent mismatch
+    _mm512_mask_storeu_epi32(out_m_bt_pcigar+k,lanes,
+        _mm512_or_si512(_mm512_slli_epi32(m_pcigar,2),pcigar_misms));
+    _mm512_mask_storeu_epi32(out_m_bt_prev+k,lanes,m_bt_prev);
+    _mm512_mask_storeu_epi32(out_m+k,lanes,
+        avx512_compute_trim(max,ks,pattern_length,text_length,offsets_null));
+    ks = _mm512_add_epi32(ks,sixteens);
+  }
+#else
+  wavefront_compute_affine_idm_piggyback(wf_aligner,wavefront_set,lo,hi);
+#endif
+}
+/*
+ * Compute Kernels gap-affine-2p (SIMD AVX512)
+ */
+FORCE_NO_INLINE TARGET_AVX512 void wavefront_compute_affine2p_idm_avx512(
+    wavefront_aligner_t* const wf_aligner,
+    const wavefront_set_t* const wavefront_set,
+    const int lo,
+    const int hi) {
+  // Parameters
+  wavefront_sequences_t* const sequences = &wf_aligner->sequences;
+  const __m512i pattern_length = _mm512_set1_epi32(sequences->pattern_length);
+  const __m512i text_length = _mm512_set1_epi32(sequences->text_length);
+  const __m512i offsets_null = _mm512_set1_epi32(WAVEFRONT_OFFSET_NULL);
+  const __m512i ones = _mm512_set1_epi32(1);
+  const __m512i sixteens = _mm512_set1_epi32(16);
+  // In Offsets
+  const wf_offset_t* const m_misms = wavefront_set->in_mwavefront_misms->offsets;
+  const wf_offset_t* const m_open1 = wavefront_set->in_mwavefront_open1->offsets;
+  const wf_offset_t* const m_open2 = wavefront_set->in_mwavefront_open2->offsets;
+  const wf_offset_t* const i1_ext = wavefront_set->in_i1wavefront_ext->offsets;
+  const wf_offset_t* const i2_ext = wavefront_set->in_i2wavefront_ext->offsets;
+  const wf_offset_t* const d1_ext = wavefront_set->in_d1wavefront_ext->offsets;
+  const wf_offset_t* const d2_ext = wavefront_set->in_d2wavefront_ext->offsets;
+  // Out Offsets
+  wf_offset_t* const out_m = wavefront_set->out_mwavefront->offsets;
+  wf_offset_t* const out_i1 = wavefront_set->out_i1wavefront->offsets;
+  wf_offset_t* const out_i2 = wavefront_set->out_i2wavefront->offsets;
+  wf_offset_t* const out_d1 = wavefront_set->out_d1wavefront->offsets;
+  wf_offset_t* const out_d2 = wavefront_set->out_d2wavefront->offsets;
+  // Compute-Next kernel loop (16 diagonals per iteration, masked tail)
+  __m512i ks = _mm512_add_epi32(_mm512_set1_epi32(lo),
+      _mm512_setr_epi32(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15));
+  int k;
+  for (k=lo;k<=hi;k+=16) {
+    const __mmask16 lanes = avx512_compute_lanes(k,hi);
+    // Update I1/I2
+    const __m512i ins1 = _mm512_add_epi32(_mm512_max_epi32(
+        _mm512_maskz_loadu_epi32(lanes,m_open1+k-1),
+        _mm512_maskz_loadu_epi32(lanes,i1_ext+k-1)),ones);
+    _mm512_mask_storeu_epi32(out_i1+k,lanes,ins1);
+    const __m512i ins2 = _mm512_add_epi32(_mm512_max_epi32(
+        _mm512_maskz_loadu_epi32(lanes,m_open2+k-1),
+        _mm512_maskz_loadu_epi32(lanes,i2_ext+k-1)),ones);
+    _mm512_mask_storeu_epi32(out_i2+k,lanes,ins2);
+    const __m512i ins = _mm512_max_epi32(ins1,ins2);
+    // Update D1/D2
+    const __m512i del1 = _mm512_max_epi32(
+        _mm512_maskz_loadu_epi32(lanes,m_open1+k+1),
+        _mm512_maskz_loadu_epi32(lanes,d1_ext+k+1));
+    _mm512_mask_storeu_epi32(out_d1+k,lanes,del1);
+    const __m512i del2 = _mm512_max_epi32(
+        _mm512_maskz_loadu_epi32(lanes,m_open2+k+1),
+        _mm512_maskz_loadu_epi32(lanes,d2_ext+k+1));
+    _mm512_mask_storeu_epi32(out_d2+k,lanes,del2);
+    const __m512i del = _mm512_max_epi32(del1,del2);
+    // Update M
+    const __m512i misms = _mm512_add_epi32(_mm512_maskz_loadu_epi32(lanes,m_misms+k),ones);
+    const __m512i max = _mm512_max_epi32(del,_mm512_max_epi32(misms,ins));
+    _mm512_mask_storeu_epi32(out_m+k,lanes,
+        avx512_compute_trim(max,ks,pattern_length,text_length,offsets_null));
+    ks = _mm512_add_epi32(ks,sixteens);
+  }
+}
+FORCE_NO_INLINE TARGET_AVX512 void wavefront_compute_affine2p_idm_piggyback_avx512(
+    wavefront_aligner_t* const wf_aligner,
+    const wavefront_set_t* const wavefront_set,
+    const int lo,
+    const int hi) {
+#ifdef PCIGAR_32BITS
+  // Parameters
+  wavefront_sequences_t* const sequences = &wf_aligner->sequences;
+  const __m512i pattern_length = _mm512_set1_epi32(sequences->pattern_length);
+  const __m512i text_length = _mm512_set1_epi32(sequences->text_length);
+  const __m512i offsets_null = _mm512_set1_epi32(WAVEFRONT_OFFSET_NULL);
+  const __m512i ones = _mm512_set1_epi32(1);
+  const __m512i sixteens = _mm512_set1_epi32(16);
+  const __m512i pcigar_ins = _mm512_set1_epi32(PCIGAR_INSERTION);
+  const __m512i pcigar_del = _mm512_set1_epi32(PCIGAR_DELETION);
+  const __m512i pcigar_misms = _mm512_set1_epi32(PCIGAR_MISMATCH);
+  // In Offsets
+  const wf_offset_t* const m_misms = wavefront_set->in_mwavefront_misms->offsets;
+  const wf_offset_t* const m_open1 = wavefront_set->in_mwavefront_open1->offsets;
+  const wf_offset_t* const m_open2 = wavefront_set->in_mwavefront_open2->offsets;
+  const wf_offset_t* const i1_ext  = wavefront_set->in_i1wavefront_ext->offsets;
+  const wf_offset_t* const i2_ext  = wavefront_set->in_i2wavefront_ext->offsets;
+  const wf_offset_t* const d1_ext  = wavefront_set->in_d1wavefront_ext->offsets;
+  const wf_offset_t* const d2_ext  = wavefront_set->in_d2wavefront_ext->offsets;
+  // Out Offsets
+  wf_offset_t* const out_m  = wavefront_set->out_mwavefront->offsets;
+  wf_offset_t* const out_i1 = wavefront_set->out_i1wavefront->offsets;
+  wf_offset_t* const out_i2 = wavefront_set->out_i2wavefront->offsets;
+  wf_offset_t* const out_d1 = wavefront_set->out_d1wavefront->offsets;
+  wf_offset_t* const out_d2 = wavefront_set->out_d2wavefront->offsets;
+  // In BT-pcigar
+  const pcigar_t* const m_misms_bt_pcigar = wavefront_set->in_mwavefront_misms->bt_pcigar;
+  const pcigar_t* const m_open1_bt_pcigar = wavefront_set->in_mwavefront_open1->bt_pcigar;
+  const pcigar_t* const m_open2_bt_pcigar = wavefront_set->in_mwavefront_open2->bt_pcigar;
+  const pcigar_t* const i1_ext_bt_pcigar  = wavefront_set->in_i1wavefront_ext->bt_pcigar;
+  const pcigar_t* const i2_ext_bt_pcigar  = wavefront_set->in_i2wavefront_ext->bt_pcigar;
+  const pcigar_t* const d1_ext_bt_pcigar  = wavefront_set->in_d1wavefront_ext->bt_pcigar;
+  const pcigar_t* const d2_ext_bt_pcigar  = wavefront_set->in_d2wavefront_ext->bt_pcigar;
+  // In BT-prev
+  const bt_block_idx_t* const m_misms_bt_prev = wavefront_set->in_mwavefront_misms->bt_prev;
+  const bt_block_idx_t* const m_open1_bt_prev = wavefront_set->in_mwavefront_open1->bt_prev;
+  const bt_block_idx_t* const m_open2_bt_prev = wavefront_set->in_mwavefront_open2->bt_prev;
+  const bt_block_idx_t* const i1_ext_bt_prev  = wavefront_set->in_i1wavefront_ext->bt_prev;
+  const bt_block_idx_t* const i2_ext_bt_prev  = wavefront_set->in_i2wavefront_ext->bt_prev;
+  const bt_block_idx_t* const d1_ext_bt_prev  = wavefront_set->in_d1wavefront_ext->bt_prev;
+  const bt_block_idx_t* const d2_ext_bt_prev  = wavefront_set->in_d2wavefront_ext->bt_prev;
+  // Out BT-pcigar
+  pcigar_t* const out_m_bt_pcigar   = wavefront_set->out_mwavefront->bt_pcigar;
+  pcigar_t* const out_i1_bt_pcigar  = wavefront_set->out_i1wavefront->bt_pcigar;
+  pcigar_t* const out_i2_bt_pcigar  = wavefront_set->out_i2wavefront->bt_pcigar;
+  pcigar_t* const out_d1_bt_pcigar  = wavefront_set->out_d1wavefront->bt_pcigar;
+  pcigar_t* const out_d2_bt_pcigar  = wavefront_set->out_d2wavefront->bt_pcigar;
+  // Out BT-prev
+  bt_block_idx_t* const out_m_bt_prev  = wavefront_set->out_mwavefront->bt_prev;
+  bt_block_idx_t* const out_i1_bt_prev = wavefront_set->out_i1wavefront->bt_prev;
+  bt_block_idx_t* const out_i2_bt_prev = wavefront_set->out_i2wavefront->bt_prev;
+  bt_block_idx_t* const out_d1_bt_prev = wavefront_set->out_d1wavefront->bt_prev;
+  bt_block_idx_t* const out_d2_bt_prev = wavefront_set->out_d2wavefront->bt_prev;
+  // Compute-Next kernel loop (16 diagonals per iteration, masked tail)
+  __m512i ks = _mm512_add_epi32(_mm512_set1_epi32(lo),
+      _mm512_setr_epi32(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15));
+  int k;
+  for (k=lo;k<=hi;k+=16) {
+    const __mmask16 lanes = avx512_compute_lanes(k,hi);
+    // Update I1
+    __m512i ins1, ins1_pcigar, ins1_bt_prev;
+    avx512_compute_gap_piggyback(m_open1,i1_ext,m_open1_bt_pcigar,i1_ext_bt_pcigar,
+        m_open1_bt_prev,i1_ext_bt_prev,k-1,lanes,&ins1,&ins1_pcigar,&ins1_bt_prev);
+    ins1_pcigar = _mm512_or_si512(_mm512_slli_epi32(ins1_pcigar,2),pcigar_ins);
+    ins1 = _mm512_add_epi32(ins1,ones);
+    _mm512_mask_storeu_epi32(out_i1_bt_pcigar+k,lanes,ins1_pcigar);
+    _mm512_mask_storeu_epi32(out_i1_bt_prev+k,lanes,ins1_bt_prev);
+    _mm512_mask_storeu_epi32(out_i1+k,lanes,ins1);
+    // Update I2
+    __m512i ins2, ins2_pcigar, ins2_bt_prev;
+    avx512_compute_gap_piggyback(m_open2,i2_ext,m_open2_bt_pcigar,i2_ext_bt_pcigar,
+        m_open2_bt_prev,i2_ext_bt_prev,k-1,lanes,&ins2,&ins2_pcigar,&ins2_bt_prev);
+    ins2_pcigar = _mm512_or_si512(_mm512_slli_epi32(ins2_pcigar,2),pcigar_ins);
+    ins2 = _mm512_add_epi32(ins2,ones);
+    _mm512_mask_storeu_epi32(out_i2_bt_pcigar+k,lanes,ins2_pcigar);
+    _mm512_mask_storeu_epi32(out_i2_bt_prev+k,lanes,ins2_bt_prev);
+    _mm512_mask_storeu_epi32(out_i2+k,lanes,ins2);
+    // Update D1
+    __m512i del1, del1_pcigar, del1_bt_prev;
+    avx512_compute_gap_piggyback(m_open1,d1_ext,m_open1_bt_pcigar,d1_ext_bt_pcigar,
+        m_open1_bt_prev,d1_ext_bt_prev,k+1,lanes,&del1,&del1_pcigar,&del1_bt_prev);
+    del1_pcigar = _mm512_or_si512(_mm512_slli_epi32(del1_pcigar,2),pcigar_del);
+    _mm512_mask_storeu_epi32(out_d1_bt_pcigar+k,lanes,del1_pcigar);
+    _mm512_mask_storeu_epi32(out_d1_bt_prev+k,lanes,del1_bt_prev);
+    _mm512_mask_storeu_epi32(out_d1+k,lanes,del1);
+    // Update D2
+    __m512i del2, del2_pcigar, del2_bt_prev;
+    avx512_compute_gap_piggyback(m_open2,d2_ext,m_open2_bt_pcigar,d2_ext_bt_pcigar,
+        m_open2_bt_prev,d2_ext_bt_prev,k+1,lanes,&del2,&del2_pcigar,&del2_bt_prev);
+    del2_pcigar = _mm512_or_si512(_mm512_slli_epi32(del2_pcigar,2),pcigar_del);
+    _mm512_mask_storeu_epi32(out_d2_bt_pcigar+k,lanes,del2_pcigar);
+    _mm512_mask_storeu_epi32(out_d2_bt_prev+k,lanes,del2_bt_prev);
+    _mm512_mask_storeu_epi32(out_d2+k,lanes,del2);
+    // Update M (source priority: misms > del2 > del1 > ins2 > ins1)
+    const __m512i ins = _mm512_max_epi32(ins1,ins2);
+    const __m512i del = _mm512_max_epi32(del1,del2);
+    const __m512i misms = _mm512_add_epi32(_mm512_maskz_loadu_epi32(lanes,m_misms+k),ones);
+    const __m512i max = _mm512_max_epi32(del,_mm512_max_epi32(misms,ins));
+    const __mmask16 is_ins2 = _mm512_cmpeq_epi32_mask(max,ins2);
+    const __mmask16 is_del1 = _mm512_cmpeq_epi32_mask(max,del1);
+    const __mmask16 is_del2 = _mm512_cmpeq_epi32_mask(max,del2);
+    const __mmask16 is_misms = _mm512_cmpeq_epi32_mask(max,misms);
+    __m512i m_pcigar = _mm512_mask_blend_epi32(is_ins2,ins1_pcigar,ins2_pcigar);
+    __m512i m_bt_prev = _mm512_mask_blend_epi32(is_ins2,ins1_bt_prev,ins2_bt_prev);
+    m_pcigar = _mm512_mask_blend_epi32(is_del1,m_pcigar,del1_pcigar);
+    m_bt_prev = _mm512_mask_blend_epi32(is_del1,m_bt_prev,del1_bt_prev);
+    m_pcigar = _mm512_mask_blend_epi32(is_del2,m_pcigar,del2_pcigar);
+    m_bt_prev = _mm512_mask_blend_epi32(is_del2,m_bt_prev,del2_bt_prev);
+    m_pcigar = _mm512_mask_loadu_epi32(m_pcigar,is_misms&lanes,m_misms_bt_pcigar+k);
+    m_bt_prev = _mm512_mask_loadu_epi32(m_bt_prev,is_misms&lanes,m_misms_bt_prev+k);
+    // Coming from I/D -> X is fake to represent gap-close
+    // Coming from M -> X is real to represent mismatch
+    _mm512_mask_storeu_epi32(out_m_bt_pcigar+k,lanes,
+        _mm512_or_si512(_mm512_slli_epi32(m_pcigar,2),pcigar_misms));
+    _mm512_mask_storeu_epi32(out_m_bt_prev+k,lanes,m_bt_prev);
+    _mm512_mask_storeu_epi32(out_m+k,lanes,
+        avx512_compute_trim(max,ks,pattern_length,text_length,offsets_null));
+    ks = _mm512_add_epi32(ks,sixteens);
+  }
+#else
+  wavefront_compute_affine2p_idm_piggyback(wf_aligner,wavefront_set,lo,hi);
+#endif
+}
+#endif // TARGET_X86
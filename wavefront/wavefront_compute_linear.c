@@ -29,6 +29,7 @@
  * DESCRIPTION: WaveFront alignment module for computing wavefronts (gap-linear)
  */
 
+#include "wavefront_multiversion.h"
 #include "utils/commons.h"
 #include "system/mm_allocator.h"
 #include "wavefront_compute.h"
@@ -177,6 +178,9 @@ void wavefront_compute_linear(
     return;
   }
   wf_aligner->align_status.num_null_steps = 0;
+  // Stats
+  const bool stats_enabled = wf_aligner->system.stats_enabled;
+  const uint64_t stats_begin_ns = (stats_enabled) ? wavefront_stats_get_time_ns() : 0;
   // Set limits
   int hi, lo;
   wavefront_compute_limits_input(wf_aligner,&wavefront_set,&lo,&hi);
@@ -192,6 +196,8 @@ void wavefront_compute_linear(
   }
   // Process wavefront ends
   wavefront_compute_process_ends(wf_aligner,&wavefront_set,score);
+  // Stats
+  if (stats_enabled) wavefront_stats_add_compute(&wf_aligner->stats,stats_begin_ns,lo,hi);
 }
 
 
@@ -37,6 +37,17 @@
 /*
  * Checks
  */
+char wavefront_check_get_char(
+    wavefront_sequences_t* const sequences,
+    const char* const sequence_ascii,
+    const uint8_t* const sequence_packed,
+    const int position) {
+  if (sequences->mode == wf_sequences_packed2bits) {
+    return "ACGT"[WF_PACKED2BITS_GET(sequence_packed,position)];
+  } else {
+    return sequence_ascii[position];
+  }
+}
 bool wavefront_check_alignment(
     FILE* const stream,
     wavefront_aligner_t* const wf_aligner) {
@@ -47,8 +58,11 @@ bool wavefront_check_alignment(
   const int pattern_length = sequences->pattern_buffer_length;
   const char* const text = sequences->text_buffer;
   const int text_length = sequences->text_buffer_length;
+  const uint8_t* const pattern_packed = sequences->pattern_packed;
+  const uint8_t* const text_packed = sequences->text_packed;
   // CIGAR
   cigar_t* const cigar = wf_aligner->cigar;
+  cigar_expand(cigar); // Lazy expansion
   char* const operations = cigar->operations;
   const int begin_offset = cigar->begin_offset;
   const int end_offset = cigar->end_offset;
@@ -60,11 +74,12 @@ bool wavefront_check_alignment(
       case 'M': {
         // Check match
         if (sequences->mode != wf_sequences_lambda) {
-          const bool is_match = (pattern[pattern_pos]==text[text_pos]);
+          const char pattern_char = wavefront_check_get_char(sequences,pattern,pattern_packed,pattern_pos);
+          const char text_char = wavefront_check_get_char(sequences,text,text_packed,text_pos);
+          const bool is_match = (pattern_char==text_char);
           if (!is_match) {
             fprintf(stream,"[WFA::Check] Alignment not matching (pattern[%d]=%c != text[%d]=%c)\n",
-                pattern_pos,pattern[pattern_pos],
-                text_pos,text[text_pos]);
+                pattern_pos,pattern_char,text_pos,text_char);
             alignment_correct = false;
             break;
           }
@@ -76,11 +91,12 @@ bool wavefront_check_alignment(
       case 'X': {
         // Check mismatch
         if (sequences->mode != wf_sequences_lambda) {
-          const bool is_match = (pattern[pattern_pos]==text[text_pos]);
+          const char pattern_char = wavefront_check_get_char(sequences,pattern,pattern_packed,pattern_pos);
+          const char text_char = wavefront_check_get_char(sequences,text,text_packed,text_pos);
+          const bool is_match = (pattern_char==text_char);
           if (is_match) {
             fprintf(stream,"[WFA::Check] Alignment not mismatching (pattern[%d]=%c == text[%d]=%c)\n",
-                pattern_pos,pattern[pattern_pos],
-                text_pos,text[text_pos]);
+                pattern_pos,pattern_char,text_pos,text_char);
             alignment_correct = false;
             break;
           }
@@ -197,6 +213,12 @@ void wavefront_report_lite(
   // SEQUENCES (#9 #10)
   if (sequences->mode == wf_sequences_lambda) {
     fprintf(stream,"\t-\t-");
+  } else if (sequences->mode == wf_sequences_packed2bits) {
+    int i;
+    fprintf(stream,"\t");
+    for (i=0;i<pattern_length;++i) fputc(wavefront_sequences_get_pattern(sequences,i),stream);
+    fprintf(stream,"\t");
+    for (i=0;i<text_length;++i) fputc(wavefront_sequences_get_text(sequences,i),stream);
   } else {
     fprintf(stream,"\t%.*s\t%.*s",pattern_length,pattern,text_length,text);
   }
@@ -0,0 +1,176 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignment Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignment Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignment Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: WFA module to select the SIMD kernels at runtime (CPU dispatch)
+ */
+
+#include "wavefront_multiversion.h"
+#include "wavefront_dispatch.h"
+#include "wavefront_extend_kernels.h"
+#include "wavefront_extend_kernels_avx.h"
+#include "wavefront_compute_affine.h"
+#include "wavefront_compute_affine2p.h"
+#include "wavefront_compute_kernels_avx.h"
+
+#ifdef WFA_MULTIVERSION_SUFFIX
+#include "wavefront_compute.h"
+#include "wavefront_compute_edit.h"
+#include "wavefront_compute_linear.h"
+#include "wavefront_extend.h"
+#include "wavefront_bialign.h"
+#include "wavefront_backtrace.h"
+#endif
+
+/*
+ * Compute kernels selected by 'auto'
+ *   Builds targeting AVX2 or above (e.g., -march=native) auto-vectorize the
+ *   scalar compute loops, which outperforms the intrinsic kernels. Hence, the
+ *   intrinsic compute kernels are only auto-selected in portable and
+ *   multiversion builds (and always if the ISA is set explicitly).
+ */
+#if defined(WFA_MULTIVERSION_LEVEL) || !defined(__AVX2__)
+#define WF_DISPATCH_COMPUTE_SIMD_AUTO true
+#else
+#define WF_DISPATCH_COMPUTE_SIMD_AUTO false
+#endif
+
+/*
+ * Setup
+ */
+wavefront_kernels_isa_t wavefront_dispatch_detect_isa(void) {
+#if TARGET_X86 && !defined(WFA_OFFSET16) // Intrinsic kernels use 32-bit offset lanes
+  __builtin_cpu_init();
+  const bool avx512_supported =
+      __builtin_cpu_supports("avx512f") &&
+      __builtin_cpu_supports("avx512cd") &&
+      __builtin_cpu_supports("avx512vl") &&
+      __builtin_cpu_supports("avx512bw");
+  if (avx512_supported) return wf_kernels_avx512;
+  if (__builtin_cpu_supports("avx2")) return wf_kernels_avx2;
+#endif
+  return wf_kernels_scalar;
+}
+void wavefront_dispatch_init(
+    wavefront_kernels_t* const kernels,
+    const wavefront_kernels_isa_t isa) {
+  // Select ISA (never above the one supported by the CPU)
+  const wavefront_kernels_isa_t isa_supported = wavefront_dispatch_detect_isa();
+  kernels->isa = (isa == wf_kernels_auto || isa > isa_supported) ? isa_supported : isa;
+  const bool compute_simd = (isa != wf_kernels_auto) || WF_DISPATCH_COMPUTE_SIMD_AUTO;
+  // Configure kernels (scalar compute kernels unless replaced below)
+  kernels->compute_affine_idm = wavefront_compute_affine_idm;
+  kernels->compute_affine_idm_piggyback = wavefront_compute_affine_idm_piggyback;
+  kernels->compute_affine2p_idm = wavefront_compute_affine2p_idm;
+  kernels->compute_affine2p_idm_piggyback = wavefront_compute_affine2p_idm_piggyback;
+  switch (kernels->isa) {
+#if TARGET_X86
+    case wf_kernels_avx512:
+      kernels->extend_matches_end2end = wavefront_extend_matches_packed_end2end_avx512;
+      kernels->extend_matches_end2end_max = wavefront_extend_matches_packed_end2end_max_avx512;
+      kernels->extend_matches_endsfree = wavefront_extend_matches_packed_endsfree_avx512;
+      kernels->extend_matches_packed2bits_end2end = wavefront_extend_matches_packed2bits_end2end_avx512;
+      kernels->extend_matches_packed2bits_end2end_max = wavefront_extend_matches_packed2bits_end2end_max_avx512;
+      kernels->extend_matches_packed2bits_endsfree = wavefront_extend_matches_packed2bits_endsfree_avx512;
+      if (compute_simd) {
+        kernels->compute_affine_idm = wavefront_compute_affine_idm_avx512;
+        kernels->compute_affine_idm_piggyback = wavefront_compute_affine_idm_piggyback_avx512;
+        kernels->compute_affine2p_idm = wavefront_compute_affine2p_idm_avx512;
+        kernels->compute_affine2p_idm_piggyback = wavefront_compute_affine2p_idm_piggyback_avx512;
+      }
+      break;
+    case wf_kernels_avx2:
+      kernels->extend_matches_end2end = wavefront_extend_matches_packed_end2end_avx2;
+      kernels->extend_matches_end2end_max = wavefront_extend_matches_packed_end2end_max_avx2;
+      kernels->extend_matches_endsfree = wavefront_extend_matches_packed_endsfree_avx2;
+      kernels->extend_matches_packed2bits_end2end = wavefront_extend_matches_packed2bits_end2end_avx2;
+      kernels->extend_matches_packed2bits_end2end_max = wavefront_extend_matches_packed2bits_end2end_max_avx2;
+      kernels->extend_matches_packed2bits_endsfree = wavefront_extend_matches_packed2bits_endsfree_avx2;
+      if (compute_simd) {
+        kernels->compute_affine_idm = wavefront_compute_affine_idm_avx2;
+        kernels->compute_affine_idm_piggyback = wavefront_compute_affine_idm_piggyback_avx2;
+        kernels->compute_affine2p_idm = wavefront_compute_affine2p_idm_avx2;
+        kernels->compute_affine2p_idm_piggyback = wavefront_compute_affine2p_idm_piggyback_avx2;
+      }
+      break;
+#endif
+    default:
+      kernels->isa = wf_kernels_scalar;
+      kernels->extend_matches_end2end = wavefront_extend_matches_packed_end2end;
+      kernels->extend_matches_end2end_max = wavefront_extend_matches_packed_end2end_max;
+      kernels->extend_matches_endsfree = wavefront_extend_matches_packed_endsfree;
+      kernels->extend_matches_packed2bits_end2end = wavefront_extend_matches_packed2bits_end2end;
+      kernels->extend_matches_packed2bits_end2end_max = wavefront_extend_matches_packed2bits_end2end_max;
+      kernels->extend_matches_packed2bits_endsfree = wavefront_extend_matches_packed2bits_endsfree;
+      break;
+  }
+}
+/*
+ * Display
+ */
+char* wavefront_dispatch_isa_name(
+    const wavefront_kernels_isa_t isa) {
+  switch (isa) {
+    case wf_kernels_auto: return "Auto";
+    case wf_kernels_avx2: return "AVX2";
+    case wf_kernels_avx512: return "AVX512";
+    default: return "Scalar";
+  }
+}
+/*
+ * Multiversioned kernels (dispatch table of this ISA level)
+ */
+#ifdef WFA_MULTIVERSION_SUFFIX
+const wavefront_multiversion_t WFA_MV(wavefront_multiversion) = {
+  .level = WFA_MULTIVERSION_LEVEL,
+  .name = WFA_MULTIVERSION_NAME,
+  .dispatch_detect_isa = wavefront_dispatch_detect_isa,
+  .dispatch_init = wavefront_dispatch_init,
+  .dispatch_isa_name = wavefront_dispatch_isa_name,
+  .compute_affine = wavefront_compute_affine,
+  .compute_affine2p = wavefront_compute_affine2p,
+  .compute_edit = wavefront_compute_edit,
+  .compute_linear = wavefront_compute_linear,
+  .compute_edit_idm = wavefront_compute_edit_idm,
+  .compute_edit_idm_piggyback = wavefront_compute_edit_idm_piggyback,
+  .compute_linear_idm = wavefront_compute_linear_idm,
+  .compute_linear_idm_piggyback = wavefront_compute_linear_idm_piggyback,
+  .compute_classic_score = wavefront_compute_classic_score,
+  .compute_limits_output = wavefront_compute_limits_output,
+#ifdef WFA_PARALLEL
+  .compute_thread_limits = wavefront_compute_thread_limits,
+#endif
+  .extend_end2end = wavefront_extend_end2end,
+  .extend_endsfree = wavefront_extend_endsfree,
+  .extend_matches_packed_end2end = wavefront_extend_matches_packed_end2end,
+  .extend_matches_packed2bits_end2end = wavefront_extend_matches_packed2bits_end2end,
+  .bialign = wavefront_bialign,
+  .backtrace_linear = wavefront_backtrace_linear,
+  .backtrace_affine = wavefront_backtrace_affine,
+  .backtrace_pcigar = wavefront_backtrace_pcigar,
+};
+#endif
@@ -0,0 +1,85 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignment Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignment Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignment Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: WFA module to select the SIMD kernels at runtime (CPU dispatch)
+ */
+
+#ifndef WAVEFRONT_DISPATCH_H_
+#define WAVEFRONT_DISPATCH_H_
+
+#include "utils/commons.h"
+#include "wavefront.h"
+#include "wavefront_attributes.h"
+
+/*
+ * Kernels (function table)
+ */
+typedef struct _wavefront_aligner_t wavefront_aligner_t;
+typedef struct {
+  // ISA selected
+  wavefront_kernels_isa_t isa;
+  // Extend kernels
+  void (*extend_matches_end2end)(
+      wavefront_aligner_t* const,wavefront_t* const,const int,const int);
+  wf_offset_t (*extend_matches_end2end_max)(
+      wavefront_aligner_t* const,wavefront_t* const,const int,const int);
+  bool (*extend_matches_endsfree)(
+      wavefront_aligner_t* const,wavefront_t* const,const int,const int,const int);
+  // Extend kernels (2-bits packed)
+  void (*extend_matches_packed2bits_end2end)(
+      wavefront_aligner_t* const,wavefront_t* const,const int,const int);
+  wf_offset_t (*extend_matches_packed2bits_end2end_max)(
+      wavefront_aligner_t* const,wavefront_t* const,const int,const int);
+  bool (*extend_matches_packed2bits_endsfree)(
+      wavefront_aligner_t* const,wavefront_t* const,const int,const int,const int);
+  // Compute kernels (gap-affine & gap-affine-2p)
+  void (*compute_affine_idm)(
+      wavefront_aligner_t* const,const wavefront_set_t* const,const int,const int);
+  void (*compute_affine_idm_piggyback)(
+      wavefront_aligner_t* const,const wavefront_set_t* const,const int,const int);
+  void (*compute_affine2p_idm)(
+      wavefront_aligner_t* const,const wavefront_set_t* const,const int,const int);
+  void (*compute_affine2p_idm_piggyback)(
+      wavefront_aligner_t* const,const wavefront_set_t* const,const int,const int);
+} wavefront_kernels_t;
+
+/*
+ * Setup
+ */
+wavefront_kernels_isa_t wavefront_dispatch_detect_isa(void);
+void wavefront_dispatch_init(
+    wavefront_kernels_t* const kernels,
+    const wavefront_kernels_isa_t isa);
+
+/*
+ * Display
+ */
+char* wavefront_dispatch_isa_name(
+    const wavefront_kernels_isa_t isa);
+
+#endif /* WAVEFRONT_DISPATCH_H_ */
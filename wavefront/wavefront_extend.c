@@ -29,11 +29,11 @@
  * DESCRIPTION: WFA module for the "extension" of exact matches
  */
 
+#include "wavefront_multiversion.h"
 #include "utils/commons.h"
 #include "system/mm_allocator.h"
 #include "wavefront_extend.h"
 #include "wavefront_extend_kernels.h"
-#include "wavefront_extend_kernels_avx.h"
 #include "wavefront_compute.h"
 #include "wavefront_termination.h"
 
@@ -52,13 +52,23 @@ void wavefront_extend_end2end_dispatcher_seq(
     const int hi) {
   // Parameters
   wavefront_sequences_t* const seqs = &wf_aligner->sequences;
+  const bool stats_enabled = wf_aligner->system.stats_enabled;
+  const uint64_t stats_offsets_sum = (stats_enabled) ? wavefront_stats_extend_sum(mwavefront->offsets,lo,hi) : 0;
   // Check the sequence mode
-  if (seqs->mode == wf_sequences_ascii) {
-    wavefront_extend_matches_packed_end2end(wf_aligner,mwavefront,lo,hi);
+  if (seqs->text_slice) {
+    wavefront_extend_matches_slice_end2end(wf_aligner,mwavefront,lo,hi);
+  } else if (seqs->mode == wf_sequences_ascii) {
+    wf_aligner->kernels.extend_matches_end2end(wf_aligner,mwavefront,lo,hi);
+  } else if (seqs->mode == wf_sequences_packed2bits) {
+    wf_aligner->kernels.extend_matches_packed2bits_end2end(wf_aligner,mwavefront,lo,hi);
   } else {
     wf_offset_t dummy;
     wavefront_extend_matches_custom(wf_aligner,mwavefront,score,lo,hi,false,&dummy);
   }
+  // Stats
+  if (stats_enabled) {
+    wavefront_stats_add_extend_chars(&wf_aligner->stats,mwavefront->offsets,lo,hi,stats_offsets_sum);
+  }
 }
 void wavefront_extend_end2end_dispatcher_threads(
     wavefront_aligner_t* const wf_aligner,
@@ -67,6 +77,8 @@ void wavefront_extend_end2end_dispatcher_threads(
   // Parameters
   const int lo = mwavefront->lo;
   const int hi = mwavefront->hi;
+  const bool stats_enabled = wf_aligner->system.stats_enabled;
+  const uint64_t stats_begin_ns = (stats_enabled) ? wavefront_stats_get_time_ns() : 0;
   const int num_threads = wavefront_compute_num_threads(wf_aligner,lo,hi);
   if (num_threads == 1) {
     // Extend wavefront single-thread
@@ -82,6 +94,8 @@ void wavefront_extend_end2end_dispatcher_threads(
     }
 #endif
   }
+  // Stats
+  if (stats_enabled) wavefront_stats_add_extend(&wf_aligner->stats,stats_begin_ns);
 }
 int wavefront_extend_end2end(
     wavefront_aligner_t* const wf_aligner,
@@ -101,8 +115,10 @@ int wavefront_extend_end2end(
     }
     return 0; // Not done
   }
-  // Extend (dispatcher)
-  wavefront_extend_end2end_dispatcher_threads(wf_aligner,mwavefront,score);
+  // Extend (dispatcher), unless already extended while computed
+  if (wf_aligner->align_status.extend_fused_score != score) {
+    wavefront_extend_end2end_dispatcher_threads(wf_aligner,mwavefront,score);
+  }
   const bool end_reached = wavefront_termination_end2end(wf_aligner,mwavefront,score,score_mod);
   if (end_reached) {
     wf_aligner->align_status.status = WF_STATUS_END_REACHED;
@@ -130,14 +146,24 @@ wf_offset_t wavefront_extend_end2end_max_dispatcher_seq(
     const int hi) {
   // Parameters
   wavefront_sequences_t* const seqs = &wf_aligner->sequences;
+  const bool stats_enabled = wf_aligner->system.stats_enabled;
+  const uint64_t stats_offsets_sum = (stats_enabled) ? wavefront_stats_extend_sum(mwavefront->offsets,lo,hi) : 0;
   // Check the sequence mode
-  if (seqs->mode == wf_sequences_ascii) {
-    return wavefront_extend_matches_packed_end2end_max(wf_aligner,mwavefront,lo,hi);
+  wf_offset_t max_antidiag;
+  if (seqs->text_slice) {
+    max_antidiag = wavefront_extend_matches_slice_end2end_max(wf_aligner,mwavefront,lo,hi);
+  } else if (seqs->mode == wf_sequences_ascii) {
+    max_antidiag = wf_aligner->kernels.extend_matches_end2end_max(wf_aligner,mwavefront,lo,hi);
+  } else if (seqs->mode == wf_sequences_packed2bits) {
+    max_antidiag = wf_aligner->kernels.extend_matches_packed2bits_end2end_max(wf_aligner,mwavefront,lo,hi);
   } else {
-    wf_offset_t max_antidiag;
     wavefront_extend_matches_custom(wf_aligner,mwavefront,score,lo,hi,false,&max_antidiag);
-    return max_antidiag;
   }
+  // Stats
+  if (stats_enabled) {
+    wavefront_stats_add_extend_chars(&wf_aligner->stats,mwavefront->offsets,lo,hi,stats_offsets_sum);
+  }
+  return max_antidiag;
 }
 wf_offset_t wavefront_extend_end2end_max_dispatcher_threads(
     wavefront_aligner_t* const wf_aligner,
@@ -147,6 +173,8 @@ wf_offset_t wavefront_extend_end2end_max_dispatcher_threads(
   const int lo = mwavefront->lo;
   const int hi = mwavefront->hi;
   wf_offset_t max_antidiag = 0;
+  const bool stats_enabled = wf_aligner->system.stats_enabled;
+  const uint64_t stats_begin_ns = (stats_enabled) ? wavefront_stats_get_time_ns() : 0;
   // Select number of threads
   const int num_threads = wavefront_compute_num_threads(wf_aligner,lo,hi);
   if (num_threads == 1) {
@@ -167,6 +195,8 @@ wf_offset_t wavefront_extend_end2end_max_dispatcher_threads(
     }
 #endif
   }
+  // Stats
+  if (stats_enabled) wavefront_stats_add_extend(&wf_aligner->stats,stats_begin_ns);
   // Return maximum antidiagonal
   return max_antidiag;
 }
@@ -220,13 +250,25 @@ bool wavefront_extend_endsfree_dispatcher_seq(
     const int hi) {
   // Parameters
   wavefront_sequences_t* const seqs = &wf_aligner->sequences;
+  const bool stats_enabled = wf_aligner->system.stats_enabled;
+  const uint64_t stats_offsets_sum = (stats_enabled) ? wavefront_stats_extend_sum(mwavefront->offsets,lo,hi) : 0;
   // Check the sequence mode
-  if (seqs->mode == wf_sequences_ascii) {
-    return wavefront_extend_matches_packed_endsfree(wf_aligner,mwavefront,score,lo,hi);
+  bool end_reached;
+  if (seqs->text_slice) {
+    end_reached = wavefront_extend_matches_slice_endsfree(wf_aligner,mwavefront,score,lo,hi);
+  } else if (seqs->mode == wf_sequences_ascii) {
+    end_reached = wf_aligner->kernels.extend_matches_endsfree(wf_aligner,mwavefront,score,lo,hi);
+  } else if (seqs->mode == wf_sequences_packed2bits) {
+    end_reached = wf_aligner->kernels.extend_matches_packed2bits_endsfree(wf_aligner,mwavefront,score,lo,hi);
   } else {
     wf_offset_t dummy;
-    return wavefront_extend_matches_custom(wf_aligner,mwavefront,score,lo,hi,true,&dummy);
+    end_reached = wavefront_extend_matches_custom(wf_aligner,mwavefront,score,lo,hi,true,&dummy);
+  }
+  // Stats
+  if (stats_enabled) {
+    wavefront_stats_add_extend_chars(&wf_aligner->stats,mwavefront->offsets,lo,hi,stats_offsets_sum);
   }
+  return end_reached;
 }
 bool wavefront_extend_endsfree_dispatcher_threads(
     wavefront_aligner_t* const wf_aligner,
@@ -236,6 +278,8 @@ bool wavefront_extend_endsfree_dispatcher_threads(
   const int lo = mwavefront->lo;
   const int hi = mwavefront->hi;
   bool end_reached = false;
+  const bool stats_enabled = wf_aligner->system.stats_enabled;
+  const uint64_t stats_begin_ns = (stats_enabled) ? wavefront_stats_get_time_ns() : 0;
   const int num_threads = wavefront_compute_num_threads(wf_aligner,lo,hi);
   if (num_threads == 1) {
     // Extend wavefront single-thread
@@ -253,6 +297,8 @@ bool wavefront_extend_endsfree_dispatcher_threads(
     }
 #endif
   }
+  // Stats
+  if (stats_enabled) wavefront_stats_add_extend(&wf_aligner->stats,stats_begin_ns);
   // Return end-reached
   return end_reached;
 }
@@ -49,4 +49,14 @@ int wavefront_extend_endsfree(
     wavefront_aligner_t* const wf_aligner,
     const int score);
 
+/*
+ * Wavefront extension (diagonal range)
+ */
+void wavefront_extend_end2end_dispatcher_seq(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int score,
+    const int lo,
+    const int hi);
+
 #endif /* WAVEFRONT_EXTEND_H_ */
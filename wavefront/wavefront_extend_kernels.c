@@ -30,19 +30,42 @@
  */
 
 
+#include "wavefront_multiversion.h"
+
 // Use cross-platform header
 #include <sys/types.h>
 
 #include "wavefront_extend_kernels.h"
 #include "wavefront_termination.h"
-#include "wavefront_extend_kernels_avx.h"
 
 #if __BYTE_ORDER == __LITTLE_ENDIAN
 #define wavefront_extend_matches_kernel wavefront_extend_matches_kernel_blockwise
+#define wavefront_extend_matches_kernel_slice wavefront_extend_matches_kernel_slice_blockwise
+#define wavefront_extend_matches_kernel_packed2bits wavefront_extend_matches_kernel_packed2bits_blockwise
 #else
 #define wavefront_extend_matches_kernel wavefront_extend_matches_kernel_charwise
+#define wavefront_extend_matches_kernel_slice wavefront_extend_matches_kernel_slice_charwise
+#define wavefront_extend_matches_kernel_packed2bits wavefront_extend_matches_kernel_packed2bits_charwise
 #endif
 
+/*
+ * 2-bits packed blocks (32 bases starting at any base position)
+ *   Loads the two aligned 64-bits words holding the block and
+ *   combines them with a single (double-word) shift
+ */
+#define WF_PACKED2BITS_BLOCK_LENGTH 32
+FORCE_INLINE uint64_t wavefront_extend_packed2bits_block(
+    const uint64_t* const sequence,
+    const int position) {
+  const uint64_t* const words = sequence + (position >> 5);
+  const int shift = (position & 31) << 1;
+#ifdef __SIZEOF_INT128__
+  return (uint64_t)((((unsigned __int128)words[1] << 64) | words[0]) >> shift);
+#else
+  return (words[0] >> shift) | ((words[1] << 1) << (63 - shift));
+#endif
+}
+
 /*
  * Inner-most extend kernel
  */
@@ -90,9 +113,115 @@ FORCE_INLINE wf_offset_t wavefront_extend_matches_kernel_blockwise(
   // Return extended offset
   return offset;
 }
+/*
+ * Inner-most extend kernel (text slice)
+ *   Text slices point into an external reference that is never written.
+ *   Thus, the text has no EOS sentinel and the extension is bounded by
+ *   the text length (checked only once a full block matches). The reads
+ *   past the slice stay within the reference padding.
+ */
+FORCE_INLINE wf_offset_t wavefront_extend_matches_kernel_slice_charwise(
+    wavefront_aligner_t* const wf_aligner,
+    const int k,
+    wf_offset_t offset) {
+  // Fetch pattern/text
+  const wf_offset_t offset_max = wf_aligner->sequences.text_length;
+  char* pattern_ptr = wf_aligner->sequences.pattern + WAVEFRONT_V(k,offset);
+  char* text_ptr = wf_aligner->sequences.text + WAVEFRONT_H(k,offset);
+  // Compare chars
+  while (offset < offset_max && *pattern_ptr == *text_ptr) {
+    // Increment offset
+    offset++;
+    // Next chars
+    ++pattern_ptr;
+    ++text_ptr;
+  }
+  // Return extended offset
+  return offset;
+}
+FORCE_INLINE wf_offset_t wavefront_extend_matches_kernel_slice_blockwise(
+    wavefront_aligner_t* const wf_aligner,
+    const int k,
+    wf_offset_t offset) {
+  // Fetch pattern/text blocks
+  const wf_offset_t offset_max = wf_aligner->sequences.text_length;
+  uint64_t* pattern_blocks = (uint64_t*)(wf_aligner->sequences.pattern+WAVEFRONT_V(k,offset));
+  uint64_t* text_blocks = (uint64_t*)(wf_aligner->sequences.text+WAVEFRONT_H(k,offset));
+  // Compare 64-bits blocks
+  uint64_t cmp = *pattern_blocks ^ *text_blocks;
+  while (__builtin_expect(cmp==0,0)) {
+    // Increment offset (full block)
+    offset += 8;
+    if (offset >= offset_max) return offset_max; // Last block of the text
+    // Next blocks
+    ++pattern_blocks;
+    ++text_blocks;
+    // Compare
+    cmp = *pattern_blocks ^ *text_blocks;
+  }
+  // Count equal characters
+  const int equal_right_bits = __builtin_ctzl(cmp);
+  const int equal_chars = DIV_FLOOR(equal_right_bits,8);
+  offset += equal_chars;
+  // Return extended offset (bounded to the text's end)
+  return (offset < offset_max) ? offset : offset_max;
+}
+/*
+ * Inner-most extend kernel (2-bits packed)
+ *   No sentinels can be encoded using 2-bits, so the extension is bounded
+ *   by the end of the diagonal (offset_max). This bound is only checked
+ *   once the extension runs through a full block (last block of the sequence)
+ *   and when returning the offset.
+ */
+FORCE_INLINE wf_offset_t wavefront_extend_matches_kernel_packed2bits_charwise(
+    const uint8_t* const pattern,
+    const uint8_t* const text,
+    int pattern_pos,
+    int text_pos,
+    wf_offset_t offset,
+    const wf_offset_t offset_max) {
+  // Compare bases
+  while (offset < offset_max &&
+         WF_PACKED2BITS_GET(pattern,pattern_pos) == WF_PACKED2BITS_GET(text,text_pos)) {
+    ++offset;
+    ++pattern_pos;
+    ++text_pos;
+  }
+  // Return extended offset
+  return offset;
+}
+FORCE_INLINE wf_offset_t wavefront_extend_matches_kernel_packed2bits_blockwise(
+    const uint8_t* const pattern,
+    const uint8_t* const text,
+    int pattern_pos,
+    int text_pos,
+    wf_offset_t offset,
+    const wf_offset_t offset_max) {
+  // Compare 64-bits blocks (32 bases)
+  const uint64_t* const pattern_words = (const uint64_t*)pattern;
+  const uint64_t* const text_words = (const uint64_t*)text;
+  uint64_t cmp =
+      wavefront_extend_packed2bits_block(pattern_words,pattern_pos) ^
+      wavefront_extend_packed2bits_block(text_words,text_pos);
+  while (__builtin_expect(cmp==0,0)) {
+    // Increment offset (full block)
+    offset += WF_PACKED2BITS_BLOCK_LENGTH;
+    if (offset >= offset_max) return offset_max; // Last block of the sequence
+    // Next blocks
+    pattern_pos += WF_PACKED2BITS_BLOCK_LENGTH;
+    text_pos += WF_PACKED2BITS_BLOCK_LENGTH;
+    // Compare
+    cmp = wavefront_extend_packed2bits_block(pattern_words,pattern_pos) ^
+          wavefront_extend_packed2bits_block(text_words,text_pos);
+  }
+  // Count equal bases
+  offset += __builtin_ctzll(cmp) >> 1;
+  // Bound to the diagonal's end (padding is not a sentinel)
+  return (offset < offset_max) ? offset : offset_max;
+}
 
 /*
- * Wavefront-Extend Inner Kernels
+ * Wavefront-Extend Inner Kernels (Scalar)
  *   Wavefront offset extension comparing characters
  *   Remember:
  *   - No offset is out of boundaries !(h>tlen,v>plen)
@@ -103,23 +232,15 @@ FORCE_NO_INLINE void wavefront_extend_matches_packed_end2end(
     wavefront_t* const mwavefront,
     const int lo,
     const int hi) {
-  #if __AVX2__ &&  __BYTE_ORDER == __LITTLE_ENDIAN
-    #if __AVX512CD__ && __AVX512VL__
-      wavefront_extend_matches_packed_end2end_avx512(wf_aligner, mwavefront, lo, hi);
-    #else
-      wavefront_extend_matches_packed_end2end_avx2(wf_aligner, mwavefront, lo, hi);
-    #endif
-  #else
-    wf_offset_t* const offsets = mwavefront->offsets;
-    int k;
-    for (k=lo;k<=hi;++k) {
-      // Fetch offset
-      const wf_offset_t offset = offsets[k];
-      if (offset == WAVEFRONT_OFFSET_NULL) continue;
-      // Extend offset
-      offsets[k] = wavefront_extend_matches_kernel(wf_aligner,k,offset);
-    }
-  #endif
+  wf_offset_t* const offsets = mwavefront->offsets;
+  int k;
+  for (k=lo;k<=hi;++k) {
+    // Fetch offset
+    const wf_offset_t offset = offsets[k];
+    if (offset == WAVEFRONT_OFFSET_NULL) continue;
+    // Extend offset
+    offsets[k] = wavefront_extend_matches_kernel(wf_aligner,k,offset);
+  }
 }
 
 FORCE_NO_INLINE wf_offset_t wavefront_extend_matches_packed_end2end_max(
@@ -127,28 +248,20 @@ FORCE_NO_INLINE wf_offset_t wavefront_extend_matches_packed_end2end_max(
     wavefront_t* const mwavefront,
     const int lo,
     const int hi) {
-  #if __AVX2__ &&  __BYTE_ORDER == __LITTLE_ENDIAN
-    #if __AVX512CD__ && __AVX512VL__
-      return wavefront_extend_matches_packed_end2end_max_avx512(wf_aligner, mwavefront, lo, hi);
-    #else
-      return wavefront_extend_matches_packed_end2end_max_avx2(wf_aligner, mwavefront, lo, hi);
-    #endif
-  #else
-    wf_offset_t* const offsets = mwavefront->offsets;
-    wf_offset_t max_antidiag = 0;
-    int k;
-    for (k=lo;k<=hi;++k) {
-      // Fetch offset
-      const wf_offset_t offset = offsets[k];
-      if (offset == WAVEFRONT_OFFSET_NULL) continue;
-      // Extend offset
-      offsets[k] = wavefront_extend_matches_kernel(wf_aligner,k,offset);
-      // Compute max
-      const wf_offset_t antidiag = WAVEFRONT_ANTIDIAGONAL(k,offsets[k]);
-      if (max_antidiag < antidiag) max_antidiag = antidiag;
-    }
-    return max_antidiag;
-  #endif 
+  wf_offset_t* const offsets = mwavefront->offsets;
+  wf_offset_t max_antidiag = 0;
+  int k;
+  for (k=lo;k<=hi;++k) {
+    // Fetch offset
+    const wf_offset_t offset = offsets[k];
+    if (offset == WAVEFRONT_OFFSET_NULL) continue;
+    // Extend offset
+    offsets[k] = wavefront_extend_matches_kernel(wf_aligner,k,offset);
+    // Compute max
+    const wf_offset_t antidiag = WAVEFRONT_ANTIDIAGONAL(k,offsets[k]);
+    if (max_antidiag < antidiag) max_antidiag = antidiag;
+  }
+  return max_antidiag;
 }
 
 FORCE_NO_INLINE bool wavefront_extend_matches_packed_endsfree(
@@ -157,13 +270,6 @@ FORCE_NO_INLINE bool wavefront_extend_matches_packed_endsfree(
     const int score,
     const int lo,
     const int hi) {
-  #if __AVX2__ &&  __BYTE_ORDER == __LITTLE_ENDIAN
-    #if __AVX512CD__ && __AVX512VL__
-      return wavefront_extend_matches_packed_endsfree_avx512(wf_aligner, mwavefront, score, lo, hi);
-    #else
-      return wavefront_extend_matches_packed_endsfree_avx2(wf_aligner, mwavefront, score, lo, hi);
-    #endif
-  #else
   // Parameters
   wf_offset_t* const offsets = mwavefront->offsets;
   int k;
@@ -190,7 +296,153 @@ FORCE_NO_INLINE bool wavefront_extend_matches_packed_endsfree(
   }
   // Alignment not finished
   return false;
-  #endif
+}
+/*
+ * Wavefront-Extend Inner Kernels (Text slice)
+ */
+FORCE_INLINE bool wavefront_extend_matches_slice(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int score,
+    const int lo,
+    const int hi,
+    const bool endsfree,
+    wf_offset_t* const max_antidiag) {
+  wf_offset_t* const offsets = mwavefront->offsets;
+  int k;
+  for (k=lo;k<=hi;++k) {
+    // Fetch offset
+    const wf_offset_t offset = offsets[k];
+    if (offset == WAVEFRONT_OFFSET_NULL) continue;
+    // Extend offset
+    const wf_offset_t offset_ext = wavefront_extend_matches_kernel_slice(wf_aligner,k,offset);
+    offsets[k] = offset_ext;
+    // Compute max
+    if (max_antidiag != NULL) {
+      const wf_offset_t antidiag = WAVEFRONT_ANTIDIAGONAL(k,offset_ext);
+      if (*max_antidiag < antidiag) *max_antidiag = antidiag;
+    }
+    // Check ends-free reaching boundaries
+    if (endsfree && wavefront_termination_endsfree(wf_aligner,mwavefront,score,k,offset_ext)) {
+      return true; // Quit (we are done)
+    }
+  }
+  // Alignment not finished
+  return false;
+}
+FORCE_NO_INLINE void wavefront_extend_matches_slice_end2end(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int lo,
+    const int hi) {
+  wavefront_extend_matches_slice(wf_aligner,mwavefront,0,lo,hi,false,NULL);
+}
+FORCE_NO_INLINE wf_offset_t wavefront_extend_matches_slice_end2end_max(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int lo,
+    const int hi) {
+  wf_offset_t max_antidiag = 0;
+  wavefront_extend_matches_slice(wf_aligner,mwavefront,0,lo,hi,false,&max_antidiag);
+  return max_antidiag;
+}
+FORCE_NO_INLINE bool wavefront_extend_matches_slice_endsfree(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int score,
+    const int lo,
+    const int hi) {
+  return wavefront_extend_matches_slice(wf_aligner,mwavefront,score,lo,hi,true,NULL);
+}
+/*
+ * Wavefront-Extend Inner Kernels (2-bits packed)
+ *   Wavefront offset extension comparing 2-bits packed bases
+ *   The diagonal k ends at offset MIN(plen+k,tlen). Thus, diagonals
+ *   are processed in two ranges (below/above k=tlen-plen) so that
+ *   each one has a linear bound (offset_max = base + k*slope)
+ */
+FORCE_INLINE bool wavefront_extend_matches_packed2bits_range(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int score,
+    const int k_begin,
+    const int k_end,
+    const int offset_max_base,
+    const int offset_max_slope,
+    const bool endsfree,
+    wf_offset_t* const max_antidiag) {
+  // Parameters
+  wavefront_sequences_t* const seqs = &wf_aligner->sequences;
+  const uint8_t* const pattern = seqs->pattern_packed;
+  const uint8_t* const text = seqs->text_packed;
+  const int pattern_offset = seqs->pattern_packed_offset;
+  const int text_offset = seqs->text_packed_offset;
+  wf_offset_t* const offsets = mwavefront->offsets;
+  int k;
+  for (k=k_begin;k<k_end;++k) {
+    // Fetch offset
+    const wf_offset_t offset = offsets[k];
+    if (offset == WAVEFRONT_OFFSET_NULL) continue;
+    // Extend offset
+    const wf_offset_t offset_max = offset_max_base + k*offset_max_slope;
+    const wf_offset_t offset_ext = wavefront_extend_matches_kernel_packed2bits(
+        pattern,text,pattern_offset+WAVEFRONT_V(k,offset),text_offset+offset,offset,offset_max);
+    offsets[k] = offset_ext;
+    // Compute max
+    if (max_antidiag != NULL) {
+      const wf_offset_t antidiag = WAVEFRONT_ANTIDIAGONAL(k,offset_ext);
+      if (*max_antidiag < antidiag) *max_antidiag = antidiag;
+    }
+    // Check ends-free reaching boundaries
+    if (endsfree && wavefront_termination_endsfree(wf_aligner,mwavefront,score,k,offset_ext)) {
+      return true; // Quit (we are done)
+    }
+  }
+  // Alignment not finished
+  return false;
+}
+FORCE_INLINE bool wavefront_extend_matches_packed2bits(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int score,
+    const int lo,
+    const int hi,
+    const bool endsfree,
+    wf_offset_t* const max_antidiag) {
+  // Parameters
+  const int pattern_length = wf_aligner->sequences.pattern_length;
+  const int text_length = wf_aligner->sequences.text_length;
+  const int k_split = MIN(MAX(text_length-pattern_length,lo),hi+1);
+  // Diagonals ending at the pattern's end (offset_max = plen+k)
+  if (wavefront_extend_matches_packed2bits_range(wf_aligner,mwavefront,score,
+      lo,k_split,pattern_length,1,endsfree,max_antidiag)) return true;
+  // Diagonals ending at the text's end (offset_max = tlen)
+  return wavefront_extend_matches_packed2bits_range(wf_aligner,mwavefront,score,
+      k_split,hi+1,text_length,0,endsfree,max_antidiag);
+}
+FORCE_NO_INLINE void wavefront_extend_matches_packed2bits_end2end(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int lo,
+    const int hi) {
+  wavefront_extend_matches_packed2bits(wf_aligner,mwavefront,0,lo,hi,false,NULL);
+}
+FORCE_NO_INLINE wf_offset_t wavefront_extend_matches_packed2bits_end2end_max(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int lo,
+    const int hi) {
+  wf_offset_t max_antidiag = 0;
+  wavefront_extend_matches_packed2bits(wf_aligner,mwavefront,0,lo,hi,false,&max_antidiag);
+  return max_antidiag;
+}
+FORCE_NO_INLINE bool wavefront_extend_matches_packed2bits_endsfree(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int score,
+    const int lo,
+    const int hi) {
+  return wavefront_extend_matches_packed2bits(wf_aligner,mwavefront,score,lo,hi,true,NULL);
 }
 /*
  * Wavefront-Extend Inner Kernel (Custom match function)
@@ -35,7 +35,7 @@
 #include "wavefront_aligner.h"
 
 /*
- * Wavefront-Extend Inner Kernels
+ * Wavefront-Extend Inner Kernels (Scalar)
  */
 void wavefront_extend_matches_packed_end2end(
     wavefront_aligner_t* const wf_aligner,
@@ -54,6 +54,46 @@ bool wavefront_extend_matches_packed_endsfree(
     const int lo,
     const int hi);
 
+/*
+ * Wavefront-Extend Inner Kernels (Text slice; bounded by the text length)
+ */
+void wavefront_extend_matches_slice_end2end(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int lo,
+    const int hi);
+wf_offset_t wavefront_extend_matches_slice_end2end_max(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int lo,
+    const int hi);
+bool wavefront_extend_matches_slice_endsfree(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int score,
+    const int lo,
+    const int hi);
+
+/*
+ * Wavefront-Extend Inner Kernels (2-bits packed)
+ */
+void wavefront_extend_matches_packed2bits_end2end(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int lo,
+    const int hi);
+wf_offset_t wavefront_extend_matches_packed2bits_end2end_max(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int lo,
+    const int hi);
+bool wavefront_extend_matches_packed2bits_endsfree(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int score,
+    const int lo,
+    const int hi);
+
 /*
  * Wavefront-Extend Inner Kernel (Custom match function)
  */
@@ -29,6 +29,7 @@
  * DESCRIPTION: WaveFront-Alignment module for the "extension" of exact matches
  */
 
+#include "wavefront_multiversion.h"
 #include "wavefront_extend.h"
 #include "wavefront_align.h"
 #include "wavefront_compute.h"
@@ -37,7 +38,7 @@
 #include "wavefront_extend_kernels_avx.h"
 #include "wavefront_termination.h"
 
-#if __AVX2__
+#if TARGET_X86
 #include <immintrin.h>
 /*
  * Wavefront-Extend Inner Kernel (Scalar)
@@ -69,21 +70,17 @@ FORCE_INLINE wf_offset_t wavefront_extend_matches_packed_kernel(
 }
 
 /*
- * SIMD clz, use a native instruction when available (AVX512 CD or VL
- * extensions), or emulate the clz behavior.
+ * SIMD clz (AVX2 lacks a native instruction, so emulate the clz behavior;
+ * CPUs with AVX512 CD/VL extensions are dispatched to the AVX512 kernels)
  */
-FORCE_INLINE  __m256i avx2_lzcnt_epi32(__m256i v) {
-  #if __AVX512CD__ && __AVX512VL__
-    return _mm256_lzcnt_epi32(v);
-  #else
-    // Emulate clz for AVX2: https://stackoverflow.com/a/58827596
-    v = _mm256_andnot_si256(_mm256_srli_epi32(v,8),v); // keep 8 MSB
-    v = _mm256_castps_si256(_mm256_cvtepi32_ps(v)); // convert an integer to float
-    v = _mm256_srli_epi32(v,23); // shift down the exponent
-    v = _mm256_subs_epu16(_mm256_set1_epi32(158),v); // undo bias
-    v = _mm256_min_epi16(v,_mm256_set1_epi32(32)); // clamp at 32
-    return v;
-  #endif
+FORCE_INLINE TARGET_AVX2 __m256i avx2_lzcnt_epi32(__m256i v) {
+  // Emulate clz for AVX2: https://stackoverflow.com/a/58827596
+  v = _mm256_andnot_si256(_mm256_srli_epi32(v,8),v); // keep 8 MSB
+  v = _mm256_castps_si256(_mm256_cvtepi32_ps(v)); // convert an integer to float
+  v = _mm256_srli_epi32(v,23); // shift down the exponent
+  v = _mm256_subs_epu16(_mm256_set1_epi32(158),v); // undo bias
+  v = _mm256_min_epi16(v,_mm256_set1_epi32(32)); // clamp at 32
+  return v;
 }
 
 
@@ -91,7 +88,7 @@ FORCE_INLINE  __m256i avx2_lzcnt_epi32(__m256i v) {
 /*
  * Wavefront-Extend Inner Kernel (SIMD AVX2)
  */
-FORCE_NO_INLINE void wavefront_extend_matches_packed_end2end_avx2(
+FORCE_NO_INLINE TARGET_AVX2 void wavefront_extend_matches_packed_end2end_avx2(
     wavefront_aligner_t* const wf_aligner,
     wavefront_t* const mwavefront,
     const int lo,
@@ -171,7 +168,7 @@ FORCE_NO_INLINE void wavefront_extend_matches_packed_end2end_avx2(
 }
 
 
-FORCE_NO_INLINE wf_offset_t wavefront_extend_matches_packed_end2end_max_avx2(
+FORCE_NO_INLINE TARGET_AVX2 wf_offset_t wavefront_extend_matches_packed_end2end_max_avx2(
     wavefront_aligner_t* const wf_aligner,
     wavefront_t* const mwavefront,
     const int lo,
@@ -293,7 +290,7 @@ FORCE_NO_INLINE wf_offset_t wavefront_extend_matches_packed_end2end_max_avx2(
 }
 
 
-FORCE_NO_INLINE bool wavefront_extend_matches_packed_endsfree_avx2(
+FORCE_NO_INLINE TARGET_AVX2 bool wavefront_extend_matches_packed_endsfree_avx2(
     wavefront_aligner_t* const wf_aligner,
     wavefront_t* const mwavefront,
     const int score,
@@ -398,11 +395,10 @@ FORCE_NO_INLINE bool wavefront_extend_matches_packed_endsfree_avx2(
 }
 
 
-#if __AVX512CD__ && __AVX512VL__
 /*
  * Wavefront-Extend Inner Kernel (SIMD AVX512)
  */
-FORCE_NO_INLINE void wavefront_extend_matches_packed_end2end_avx512(
+FORCE_NO_INLINE TARGET_AVX512 void wavefront_extend_matches_packed_end2end_avx512(
     wavefront_aligner_t* const wf_aligner,
     wavefront_t* const mwavefront,
     const int lo,
@@ -484,7 +480,7 @@ FORCE_NO_INLINE void wavefront_extend_matches_packed_end2end_avx512(
 }
 
 
-FORCE_NO_INLINE wf_offset_t wavefront_extend_matches_packed_end2end_max_avx512(
+FORCE_NO_INLINE TARGET_AVX512 wf_offset_t wavefront_extend_matches_packed_end2end_max_avx512(
     wavefront_aligner_t* const wf_aligner,
     wavefront_t* const mwavefront,
     const int lo,
@@ -591,7 +587,7 @@ FORCE_NO_INLINE wf_offset_t wavefront_extend_matches_packed_end2end_max_avx512(
 }
 
 
-FORCE_NO_INLINE bool wavefront_extend_matches_packed_endsfree_avx512(
+FORCE_NO_INLINE TARGET_AVX512 bool wavefront_extend_matches_packed_endsfree_avx512(
     wavefront_aligner_t* const wf_aligner,
     wavefront_t* const mwavefront,
     const int score,
@@ -694,7 +690,337 @@ FORCE_NO_INLINE bool wavefront_extend_matches_packed_endsfree_avx512(
     }
   }
   return false;  
-} 
-#endif
+}
+
+/*
+ * Wavefront-Extend Inner Kernel (Scalar; 2-bits packed)
+ *   Compares blocks of 32 bases (two aligned 64-bits words combined with
+ *   a single shift). The extension is bounded by the end of the diagonal
+ *   (no sentinels can be encoded using 2-bits)
+ */
+FORCE_INLINE uint64_t wavefront_extend_packed2bits_block_load(
+    const uint64_t* const sequence,
+    const int position) {
+  const uint64_t* const words = sequence + (position >> 5);
+  const int shift = (position & 31) << 1;
+  return (words[0] >> shift) | ((words[1] << 1) << (63 - shift));
+}
+FORCE_INLINE wf_offset_t wavefront_extend_matches_packed2bits_kernel(
+    wavefront_sequences_t* const seqs,
+    const int k,
+    wf_offset_t offset) {
+  // Parameters
+  const uint64_t* const pattern_words = (const uint64_t*)seqs->pattern_packed;
+  const uint64_t* const text_words = (const uint64_t*)seqs->text_packed;
+  const wf_offset_t offset_max = MIN(seqs->pattern_length+k,seqs->text_length);
+  int pattern_pos = seqs->pattern_packed_offset + WAVEFRONT_V(k,offset);
+  int text_pos = seqs->text_packed_offset + offset;
+  // Compare 64-bits blocks (32 bases)
+  uint64_t cmp =
+      wavefront_extend_packed2bits_block_load(pattern_words,pattern_pos) ^
+      wavefront_extend_packed2bits_block_load(text_words,text_pos);
+  while (__builtin_expect(cmp==0,0)) {
+    // Increment offset (full block)
+    offset += 32;
+    if (offset >= offset_max) return offset_max; // Last block of the sequence
+    // Next blocks
+    pattern_pos += 32;
+    text_pos += 32;
+    // Compare
+    cmp = wavefront_extend_packed2bits_block_load(pattern_words,pattern_pos) ^
+          wavefront_extend_packed2bits_block_load(text_words,text_pos);
+  }
+  // Count equal bases
+  offset += __builtin_ctzll(cmp) >> 1;
+  return (offset < offset_max) ? offset : offset_max;
+}
+FORCE_INLINE bool wavefront_extend_matches_packed2bits_diagonal(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int score,
+    const int k,
+    const bool endsfree,
+    wf_offset_t* const max_antidiag) {
+  wf_offset_t* const offsets = mwavefront->offsets;
+  const wf_offset_t offset = offsets[k];
+  if (offset < 0) return false;
+  // Extend offset
+  const wf_offset_t offset_ext =
+      wavefront_extend_matches_packed2bits_kernel(&wf_aligner->sequences,k,offset);
+  offsets[k] = offset_ext;
+  // Compute max
+  if (max_antidiag != NULL) {
+    const wf_offset_t antidiag = WAVEFRONT_ANTIDIAGONAL(k,offset_ext);
+    if (*max_antidiag < antidiag) *max_antidiag = antidiag;
+  }
+  // Check ends-free reaching boundaries
+  return endsfree && wavefront_termination_endsfree(wf_aligner,mwavefront,score,k,offset_ext);
+}
+
+/*
+ * Wavefront-Extend Inner Kernels (SIMD AVX2; 2-bits packed)
+ *   Each lane gathers the two aligned 32-bits words holding its block of 16
+ *   bases and combines them with a single shift. Lanes whose block fully
+ *   matches continue with the scalar kernel
+ */
+FORCE_INLINE TARGET_AVX2 __m256i avx2_packed2bits_block_gather(
+    const uint8_t* const sequence,
+    const __m256i positions) {
+  const __m256i words_idx = _mm256_srli_epi32(positions,4);
+  const __m256i shift = _mm256_slli_epi32(_mm256_and_si256(positions,_mm256_set1_epi32(15)),1);
+  const __m256i words_lo = _mm256_i32gather_epi32((int const*)sequence,words_idx,4);
+  const __m256i words_hi = _mm256_i32gather_epi32((int const*)sequence,
+      _mm256_add_epi32(words_idx,_mm256_set1_epi32(1)),4);
+  return _mm256_or_si256(_mm256_srlv_epi32(words_lo,shift),
+      _mm256_sllv_epi32(words_hi,_mm256_sub_epi32(_mm256_set1_epi32(32),shift)));
+}
+FORCE_INLINE TARGET_AVX2 bool wavefront_extend_matches_packed2bits_avx2(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int score,
+    const int lo,
+    const int hi,
+    const bool endsfree,
+    wf_offset_t* const max_antidiag) {
+  // Parameters
+  wavefront_sequences_t* const seqs = &wf_aligner->sequences;
+  const uint8_t* const pattern = seqs->pattern_packed;
+  const uint8_t* const text = seqs->text_packed;
+  wf_offset_t* const offsets = mwavefront->offsets;
+  const int elems_per_register = 8;
+  const int num_of_diagonals = hi - lo + 1;
+  const int loop_peeling_iters = num_of_diagonals % elems_per_register;
+  int k;
+  for (k=lo;k<lo+loop_peeling_iters;k++) {
+    if (wavefront_extend_matches_packed2bits_diagonal(
+        wf_aligner,mwavefront,score,k,endsfree,max_antidiag)) return true;
+  }
+  if (num_of_diagonals < elems_per_register) return false;
+  // Vector constants
+  const __m256i vector_null = _mm256_set1_epi32(-1);
+  const __m256i offsets_null = _mm256_set1_epi32(WAVEFRONT_OFFSET_NULL);
+  const __m256i eights = _mm256_set1_epi32(8);
+  const __m256i sixteens = _mm256_set1_epi32(16);
+  const __m256i thirtyones = _mm256_set1_epi32(31);
+  const __m256i zero_vector = _mm256_setzero_si256();
+  const __m256i pattern_offset = _mm256_set1_epi32(seqs->pattern_packed_offset);
+  const __m256i text_offset = _mm256_set1_epi32(seqs->text_packed_offset);
+  const __m256i pattern_length = _mm256_set1_epi32(seqs->pattern_length);
+  const __m256i text_length = _mm256_set1_epi32(seqs->text_length);
+  const int k_min = lo + loop_peeling_iters;
+  __m256i ks = _mm256_set_epi32(
+      k_min+7,k_min+6,k_min+5,k_min+4,
+      k_min+3,k_min+2,k_min+1,k_min);
+  __m256i max_antidiag_v = _mm256_set1_epi32(0);
+  for (k=k_min;k<=hi;k+=elems_per_register) {
+    __m256i offsets_vector = _mm256_lddqu_si256((__m256i*)&offsets[k]);
+    // NULL offsets will read at index 0 (avoid segfaults)
+    const __m256i null_mask = _mm256_cmpgt_epi32(offsets_vector,vector_null);
+    const __m256i v_vector = _mm256_and_si256(null_mask,
+        _mm256_add_epi32(_mm256_sub_epi32(offsets_vector,ks),pattern_offset));
+    const __m256i h_vector = _mm256_and_si256(null_mask,
+        _mm256_add_epi32(offsets_vector,text_offset));
+    // Compare blocks
+    const __m256i pattern_vector = avx2_packed2bits_block_gather(pattern,v_vector);
+    const __m256i text_vector = avx2_packed2bits_block_gather(text,h_vector);
+    const __m256i xor_result_vector = _mm256_xor_si256(pattern_vector,text_vector);
+    const __m256i match_mask = _mm256_and_si256(null_mask,_mm256_cmpeq_epi32(xor_result_vector,zero_vector));
+    int mask = _mm256_movemask_ps(_mm256_castsi256_ps(match_mask));
+    // Count equal bases (trailing zeros; full blocks advance 16 bases)
+    const __m256i lowest_bit = _mm256_and_si256(xor_result_vector,_mm256_sub_epi32(zero_vector,xor_result_vector));
+    __m256i equal_bases = _mm256_srli_epi32(_mm256_sub_epi32(thirtyones,avx2_lzcnt_epi32(lowest_bit)),1);
+    equal_bases = _mm256_blendv_epi8(equal_bases,sixteens,match_mask);
+    // Bound to the diagonal's end
+    const __m256i offset_max = _mm256_min_epi32(_mm256_add_epi32(pattern_length,ks),text_length);
+    offsets_vector = _mm256_min_epi32(_mm256_add_epi32(offsets_vector,equal_bases),offset_max);
+    offsets_vector = _mm256_blendv_epi8(offsets_null,offsets_vector,null_mask);
+    _mm256_storeu_si256((__m256i*)&offsets[k],offsets_vector);
+    // Continue full-block matches (scalar)
+    while (mask != 0) {
+      const int i = __builtin_ctz(mask);
+      offsets[k+i] = wavefront_extend_matches_packed2bits_kernel(seqs,k+i,offsets[k+i]);
+      mask &= mask - 1;
+    }
+    // Compute max
+    if (max_antidiag != NULL) {
+      offsets_vector = _mm256_lddqu_si256((__m256i*)&offsets[k]);
+      const __m256i antidiag = _mm256_sub_epi32(_mm256_slli_epi32(offsets_vector,1),ks);
+      max_antidiag_v = _mm256_max_epi32(max_antidiag_v,_mm256_and_si256(null_mask,antidiag));
+    }
+    ks = _mm256_add_epi32(ks,eights);
+  }
+  // Reduce max
+  if (max_antidiag != NULL) {
+    wf_offset_t max_antidiagonal_buffer[8];
+    _mm256_storeu_si256((__m256i*)max_antidiagonal_buffer,max_antidiag_v);
+    int i;
+    for (i=0;i<8;i++) {
+      if (*max_antidiag < max_antidiagonal_buffer[i]) *max_antidiag = max_antidiagonal_buffer[i];
+    }
+  }
+  // Check ends-free reaching boundaries
+  if (endsfree) {
+    for (k=k_min;k<=hi;k++) {
+      const wf_offset_t offset = offsets[k];
+      if (offset < 0) continue;
+      if (wavefront_termination_endsfree(wf_aligner,mwavefront,score,k,offset)) {
+        return true; // Quit (we are done)
+      }
+    }
+  }
+  return false;
+}
+FORCE_NO_INLINE TARGET_AVX2 void wavefront_extend_matches_packed2bits_end2end_avx2(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int lo,
+    const int hi) {
+  wavefront_extend_matches_packed2bits_avx2(wf_aligner,mwavefront,0,lo,hi,false,NULL);
+}
+FORCE_NO_INLINE TARGET_AVX2 wf_offset_t wavefront_extend_matches_packed2bits_end2end_max_avx2(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int lo,
+    const int hi) {
+  wf_offset_t max_antidiag = 0;
+  wavefront_extend_matches_packed2bits_avx2(wf_aligner,mwavefront,0,lo,hi,false,&max_antidiag);
+  return max_antidiag;
+}
+FORCE_NO_INLINE TARGET_AVX2 bool wavefront_extend_matches_packed2bits_endsfree_avx2(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int score,
+    const int lo,
+    const int hi) {
+  return wavefront_extend_matches_packed2bits_avx2(wf_aligner,mwavefront,score,lo,hi,true,NULL);
+}
+
+/*
+ * Wavefront-Extend Inner Kernels (SIMD AVX512; 2-bits packed)
+ */
+FORCE_INLINE TARGET_AVX512 __m512i avx512_packed2bits_block_gather(
+    const uint8_t* const sequence,
+    const __mmask16 mask,
+    const __m512i positions) {
+  const __m512i words_idx = _mm512_srli_epi32(positions,4);
+  const __m512i shift = _mm512_slli_epi32(_mm512_and_si512(positions,_mm512_set1_epi32(15)),1);
+  const __m512i words_lo = _mm512_mask_i32gather_epi32(
+      _mm512_setzero_si512(),mask,words_idx,sequence,4);
+  const __m512i words_hi = _mm512_mask_i32gather_epi32(
+      _mm512_setzero_si512(),mask,_mm512_add_epi32(words_idx,_mm512_set1_epi32(1)),sequence,4);
+  return _mm512_or_si512(_mm512_srlv_epi32(words_lo,shift),
+      _mm512_sllv_epi32(words_hi,_mm512_sub_epi32(_mm512_set1_epi32(32),shift)));
+}
+FORCE_INLINE TARGET_AVX512 bool wavefront_extend_matches_packed2bits_avx512(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int score,
+    const int lo,
+    const int hi,
+    const bool endsfree,
+    wf_offset_t* const max_antidiag) {
+  // Parameters
+  wavefront_sequences_t* const seqs = &wf_aligner->sequences;
+  const uint8_t* const pattern = seqs->pattern_packed;
+  const uint8_t* const text = seqs->text_packed;
+  wf_offset_t* const offsets = mwavefront->offsets;
+  const int elems_per_register = 16;
+  const int num_of_diagonals = hi - lo + 1;
+  const int loop_peeling_iters = num_of_diagonals % elems_per_register;
+  int k;
+  for (k=lo;k<lo+loop_peeling_iters;k++) {
+    if (wavefront_extend_matches_packed2bits_diagonal(
+        wf_aligner,mwavefront,score,k,endsfree,max_antidiag)) return true;
+  }
+  if (num_of_diagonals < elems_per_register) return false;
+  // Vector constants
+  const __m512i vector_null = _mm512_set1_epi32(-1);
+  const __m512i offsets_null = _mm512_set1_epi32(WAVEFRONT_OFFSET_NULL);
+  const __m512i sixteens = _mm512_set1_epi32(16);
+  const __m512i thirtyones = _mm512_set1_epi32(31);
+  const __m512i zero_vector = _mm512_setzero_si512();
+  const __m512i pattern_offset = _mm512_set1_epi32(seqs->pattern_packed_offset);
+  const __m512i text_offset = _mm512_set1_epi32(seqs->text_packed_offset);
+  const __m512i pattern_length = _mm512_set1_epi32(seqs->pattern_length);
+  const __m512i text_length = _mm512_set1_epi32(seqs->text_length);
+  const int k_min = lo + loop_peeling_iters;
+  __m512i ks = _mm512_set_epi32(
+      k_min+15,k_min+14,k_min+13,k_min+12,k_min+11,k_min+10,k_min+9,k_min+8,
+      k_min+7,k_min+6,k_min+5,k_min+4,k_min+3,k_min+2,k_min+1,k_min);
+  __m512i max_antidiag_v = _mm512_setzero_si512();
+  for (k=k_min;k<=hi;k+=elems_per_register) {
+    __m512i offsets_vector = _mm512_loadu_si512((__m512i*)&offsets[k]);
+    const __mmask16 null_mask = _mm512_cmpgt_epi32_mask(offsets_vector,vector_null);
+    const __m512i v_vector = _mm512_add_epi32(_mm512_sub_epi32(offsets_vector,ks),pattern_offset);
+    const __m512i h_vector = _mm512_add_epi32(offsets_vector,text_offset);
+    // Compare blocks
+    const __m512i pattern_vector = avx512_packed2bits_block_gather(pattern,null_mask,v_vector);
+    const __m512i text_vector = avx512_packed2bits_block_gather(text,null_mask,h_vector);
+    const __m512i xor_result_vector = _mm512_xor_si512(pattern_vector,text_vector);
+    __mmask16 mask = _mm512_mask_cmpeq_epi32_mask(null_mask,xor_result_vector,zero_vector);
+    // Count equal bases (trailing zeros; full blocks advance 16 bases)
+    const __m512i lowest_bit = _mm512_and_si512(xor_result_vector,_mm512_sub_epi32(zero_vector,xor_result_vector));
+    __m512i equal_bases = _mm512_srli_epi32(_mm512_sub_epi32(thirtyones,_mm512_lzcnt_epi32(lowest_bit)),1);
+    equal_bases = _mm512_mask_blend_epi32(mask,equal_bases,sixteens);
+    // Bound to the diagonal's end
+    const __m512i offset_max = _mm512_min_epi32(_mm512_add_epi32(pattern_length,ks),text_length);
+    offsets_vector = _mm512_mask_min_epi32(offsets_null,null_mask,
+        _mm512_add_epi32(offsets_vector,equal_bases),offset_max);
+    _mm512_storeu_si512((__m512i*)&offsets[k],offsets_vector);
+    // Continue full-block matches (scalar)
+    while (mask != 0) {
+      const int i = __builtin_ctz(mask);
+      offsets[k+i] = wavefront_extend_matches_packed2bits_kernel(seqs,k+i,offsets[k+i]);
+      mask &= mask - 1;
+    }
+    // Compute max
+    if (max_antidiag != NULL) {
+      offsets_vector = _mm512_loadu_si512((__m512i*)&offsets[k]);
+      const __m512i antidiag = _mm512_sub_epi32(_mm512_slli_epi32(offsets_vector,1),ks);
+      max_antidiag_v = _mm512_mask_max_epi32(max_antidiag_v,null_mask,max_antidiag_v,antidiag);
+    }
+    ks = _mm512_add_epi32(ks,sixteens);
+  }
+  // Reduce max
+  if (max_antidiag != NULL) {
+    const wf_offset_t max_antidiag_simd = _mm512_reduce_max_epi32(max_antidiag_v);
+    if (*max_antidiag < max_antidiag_simd) *max_antidiag = max_antidiag_simd;
+  }
+  // Check ends-free reaching boundaries
+  if (endsfree) {
+    for (k=k_min;k<=hi;k++) {
+      const wf_offset_t offset = offsets[k];
+      if (offset < 0) continue;
+      if (wavefront_termination_endsfree(wf_aligner,mwavefront,score,k,offset)) {
+        return true; // Quit (we are done)
+      }
+    }
+  }
+  return false;
+}
+FORCE_NO_INLINE TARGET_AVX512 void wavefront_extend_matches_packed2bits_end2end_avx512(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int lo,
+    const int hi) {
+  wavefront_extend_matches_packed2bits_avx512(wf_aligner,mwavefront,0,lo,hi,false,NULL);
+}
+FORCE_NO_INLINE TARGET_AVX512 wf_offset_t wavefront_extend_matches_packed2bits_end2end_max_avx512(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int lo,
+    const int hi) {
+  wf_offset_t max_antidiag = 0;
+  wavefront_extend_matches_packed2bits_avx512(wf_aligner,mwavefront,0,lo,hi,false,&max_antidiag);
+  return max_antidiag;
+}
+FORCE_NO_INLINE TARGET_AVX512 bool wavefront_extend_matches_packed2bits_endsfree_avx512(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int score,
+    const int lo,
+    const int hi) {
+  return wavefront_extend_matches_packed2bits_avx512(wf_aligner,mwavefront,score,lo,hi,true,NULL);
+}
 
-#endif // AVX2
+#endif // TARGET_X86
@@ -32,10 +32,12 @@
 #ifndef WAVEFRONT_EXTEND_AVX_H_
 #define WAVEFRONT_EXTEND_AVX_H_
 
-#if __AVX2__
-
 #include "wavefront_aligner.h"
 
+#if TARGET_X86
+/*
+ * Wavefront-Extend Inner Kernels (SIMD AVX2)
+ */
 void wavefront_extend_matches_packed_end2end_avx2(
     wavefront_aligner_t* const wf_aligner,
     wavefront_t* const mwavefront,
@@ -55,7 +57,9 @@ bool wavefront_extend_matches_packed_endsfree_avx2(
     const int lo,
     const int hi);
 
-#if __AVX512CD__ && __AVX512VL__
+/*
+ * Wavefront-Extend Inner Kernels (SIMD AVX512)
+ */
 void wavefront_extend_matches_packed_end2end_avx512(
     wavefront_aligner_t* const wf_aligner,
     wavefront_t* const mwavefront,
@@ -74,7 +78,49 @@ bool wavefront_extend_matches_packed_endsfree_avx512(
     const int score,
     const int lo,
     const int hi);
-#endif
-#endif // AVX2
+/*
+ * Wavefront-Extend Inner Kernels (SIMD AVX2; 2-bits packed)
+ */
+void wavefront_extend_matches_packed2bits_end2end_avx2(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int lo,
+    const int hi);
+
+wf_offset_t wavefront_extend_matches_packed2bits_end2end_max_avx2(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int lo,
+    const int hi);
+
+bool wavefront_extend_matches_packed2bits_endsfree_avx2(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int score,
+    const int lo,
+    const int hi);
+
+/*
+ * Wavefront-Extend Inner Kernels (SIMD AVX512; 2-bits packed)
+ */
+void wavefront_extend_matches_packed2bits_end2end_avx512(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int lo,
+    const int hi);
+
+wf_offset_t wavefront_extend_matches_packed2bits_end2end_max_avx512(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int lo,
+    const int hi);
+
+bool wavefront_extend_matches_packed2bits_endsfree_avx512(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int score,
+    const int lo,
+    const int hi);
+#endif // TARGET_X86
 
 #endif /* WAVEFRONT_EXTEND_AVX_H_ */
@@ -532,7 +532,10 @@ bool wavefront_heuristic_cufoff(
   if (wf_heuristic->strategy & wf_heuristic_xdrop) {
     wavefront_heuristic_xdrop(wf_aligner,mwavefront,score);
   } else if (wf_heuristic->strategy & wf_heuristic_zdrop) {
-    if (wavefront_heuristic_zdrop(wf_aligner,mwavefront,score)) return true; // Z-Dropped
+    if (wavefront_heuristic_zdrop(wf_aligner,mwavefront,score)) {
+      if (wf_aligner->system.stats_enabled) wf_aligner->stats.num_heuristic_drops++;
+      return true; // Z-Dropped
+    }
   }
   // Select heuristic (Banded)
   if (wf_heuristic->strategy & wf_heuristic_banded_static) {
@@ -543,6 +546,12 @@ bool wavefront_heuristic_cufoff(
   // Check wavefront length
   if (lo_base == mwavefront->lo && hi_base == mwavefront->hi) return false; // No wavefronts pruned
   if (mwavefront->lo > mwavefront->hi) mwavefront->null = true;
+  // Stats
+  if (wf_aligner->system.stats_enabled) {
+    const int wf_length_reduced = MAX(mwavefront->hi-mwavefront->lo+1,0);
+    wf_aligner->stats.num_heuristic_cutoffs++;
+    wf_aligner->stats.num_heuristic_pruned += (hi_base-lo_base+1) - wf_length_reduced;
+  }
   // DEBUG
   // const int wf_length_base = hi_base-lo_base+1;
   // const int wf_length_reduced = mwavefront->hi-mwavefront->lo+1;
@@ -0,0 +1,272 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignment Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignment Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignment Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: WFA module to select the multiversioned kernels (x86-64-v2/v3/v4) at runtime
+ */
+
+#include "wavefront_multiversion.h"
+#include "wavefront_compute.h"
+#include "wavefront_compute_affine.h"
+#include "wavefront_compute_affine2p.h"
+#include "wavefront_compute_edit.h"
+#include "wavefront_compute_linear.h"
+#include "wavefront_extend.h"
+#include "wavefront_extend_kernels.h"
+#include "wavefront_bialign.h"
+#include "wavefront_backtrace.h"
+
+/*
+ * Selected table (resolved once at wavefront_aligner_new())
+ */
+static const wavefront_multiversion_t* wf_multiversion = NULL;
+
+/*
+ * Setup
+ */
+const wavefront_multiversion_t* wavefront_multiversion_detect(void) {
+  __builtin_cpu_init();
+  const bool level_v2 =
+      __builtin_cpu_supports("sse3") &&
+      __builtin_cpu_supports("ssse3") &&
+      __builtin_cpu_supports("sse4.1") &&
+      __builtin_cpu_supports("sse4.2") &&
+      __builtin_cpu_supports("popcnt");
+  const bool level_v3 = level_v2 &&
+      __builtin_cpu_supports("avx") &&
+      __builtin_cpu_supports("avx2") &&
+      __builtin_cpu_supports("bmi") &&
+      __builtin_cpu_supports("bmi2") &&
+      __builtin_cpu_supports("f16c") &&
+      __builtin_cpu_supports("fma") &&
+      __builtin_cpu_supports("lzcnt") &&
+      __builtin_cpu_supports("movbe");
+  const bool level_v4 = level_v3 &&
+      __builtin_cpu_supports("avx512f") &&
+      __builtin_cpu_supports("avx512bw") &&
+      __builtin_cpu_supports("avx512cd") &&
+      __builtin_cpu_supports("avx512dq") &&
+      __builtin_cpu_supports("avx512vl");
+  if (level_v4) return &wavefront_multiversion_v4;
+  if (level_v3) return &wavefront_multiversion_v3;
+  if (level_v2) return &wavefront_multiversion_v2;
+  return NULL;
+}
+const wavefront_multiversion_t* wavefront_multiversion_init(void) {
+  // Resolve once (concurrent resolutions store the same table)
+  const wavefront_multiversion_t* multiversion =
+      __atomic_load_n(&wf_multiversion,__ATOMIC_ACQUIRE);
+  if (multiversion != NULL) return multiversion;
+  multiversion = wavefront_multiversion_detect();
+  if (multiversion == NULL) {
+    fprintf(stderr,"[WFA::Multiversion] CPU does not support x86-64-v2 "
+        "(minimum ISA level of this build)\n");
+    exit(1);
+  }
+  __atomic_store_n(&wf_multiversion,multiversion,__ATOMIC_RELEASE);
+  return multiversion;
+}
+void wavefront_multiversion_select(
+    const wavefront_multiversion_t* const multiversion) {
+  // Select ISA level (never above the one supported by the CPU)
+  const wavefront_multiversion_t* const supported = wavefront_multiversion_detect();
+  if (supported == NULL) {
+    fprintf(stderr,"[WFA::Multiversion] CPU does not support x86-64-v2 "
+        "(minimum ISA level of this build)\n");
+    exit(1);
+  }
+  __atomic_store_n(&wf_multiversion,
+      (multiversion->level > supported->level) ? supported : multiversion,
+      __ATOMIC_RELEASE);
+}
+const wavefront_multiversion_t* wavefront_multiversion_get(void) {
+  const wavefront_multiversion_t* const multiversion =
+      __atomic_load_n(&wf_multiversion,__ATOMIC_ACQUIRE);
+  return (multiversion != NULL) ? multiversion : wavefront_multiversion_init();
+}
+/*
+ * Dispatch shims (CPU dispatch)
+ */
+wavefront_kernels_isa_t wavefront_dispatch_detect_isa(void) {
+  return wavefront_multiversion_get()->dispatch_detect_isa();
+}
+void wavefront_dispatch_init(
+    wavefront_kernels_t* const kernels,
+    const wavefront_kernels_isa_t isa) {
+  wavefront_multiversion_get()->dispatch_init(kernels,isa);
+}
+char* wavefront_dispatch_isa_name(
+    const wavefront_kernels_isa_t isa) {
+  return wavefront_multiversion_get()->dispatch_isa_name(isa);
+}
+/*
+ * Dispatch shims (Compute)
+ */
+void wavefront_compute_affine(
+    wavefront_aligner_t* const wf_aligner,
+    const int score) {
+  wavefront_multiversion_get()->compute_affine(wf_aligner,score);
+}
+void wavefront_compute_affine2p(
+    wavefront_aligner_t* const wf_aligner,
+    const int score) {
+  wavefront_multiversion_get()->compute_affine2p(wf_aligner,score);
+}
+void wavefront_compute_edit(
+    wavefront_aligner_t* const wf_aligner,
+    const int score) {
+  wavefront_multiversion_get()->compute_edit(wf_aligner,score);
+}
+void wavefront_compute_linear(
+    wavefront_aligner_t* const wf_aligner,
+    const int score) {
+  wavefront_multiversion_get()->compute_linear(wf_aligner,score);
+}
+void wavefront_compute_edit_idm(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const wf_prev,
+    wavefront_t* const wf_curr,
+    const int lo,
+    const int hi) {
+  wavefront_multiversion_get()->compute_edit_idm(wf_aligner,wf_prev,wf_curr,lo,hi);
+}
+void wavefront_compute_edit_idm_piggyback(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const wf_prev,
+    wavefront_t* const wf_curr,
+    const int lo,
+    const int hi,
+    const int score) {
+  wavefront_multiversion_get()->compute_edit_idm_piggyback(wf_aligner,wf_prev,wf_curr,lo,hi,score);
+}
+void wavefront_compute_linear_idm(
+    wavefront_aligner_t* const wf_aligner,
+    const wavefront_set_t* const wavefront_set,
+    const int lo,
+    const int hi) {
+  wavefront_multiversion_get()->compute_linear_idm(wf_aligner,wavefront_set,lo,hi);
+}
+void wavefront_compute_linear_idm_piggyback(
+    wavefront_aligner_t* const wf_aligner,
+    const wavefront_set_t* const wavefront_set,
+    const int lo,
+    const int hi) {
+  wavefront_multiversion_get()->compute_linear_idm_piggyback(wf_aligner,wavefront_set,lo,hi);
+}
+int wavefront_compute_classic_score(
+    wavefront_aligner_t* const wf_aligner,
+    const int pattern_length,
+    const int text_length,
+    const int wf_score) {
+  return wavefront_multiversion_get()->compute_classic_score(
+      wf_aligner,pattern_length,text_length,wf_score);
+}
+void wavefront_compute_limits_output(
+    wavefront_aligner_t* const wf_aligner,
+    const int lo,
+    const int hi,
+    int* const effective_lo,
+    int* const effective_hi) {
+  wavefront_multiversion_get()->compute_limits_output(
+      wf_aligner,lo,hi,effective_lo,effective_hi);
+}
+#ifdef WFA_PARALLEL
+void wavefront_compute_thread_limits(
+    const int thread_id,
+    const int num_theads,
+    const int lo,
+    const int hi,
+    int* const thread_lo,
+    int* const thread_hi) {
+  wavefront_multiversion_get()->compute_thread_limits(
+      thread_id,num_theads,lo,hi,thread_lo,thread_hi);
+}
+#endif
+/*
+ * Dispatch shims (Extend)
+ */
+int wavefront_extend_end2end(
+    wavefront_aligner_t* const wf_aligner,
+    const int score) {
+  return wavefront_multiversion_get()->extend_end2end(wf_aligner,score);
+}
+int wavefront_extend_endsfree(
+    wavefront_aligner_t* const wf_aligner,
+    const int score) {
+  return wavefront_multiversion_get()->extend_endsfree(wf_aligner,score);
+}
+void wavefront_extend_matches_packed_end2end(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int lo,
+    const int hi) {
+  wavefront_multiversion_get()->extend_matches_packed_end2end(wf_aligner,mwavefront,lo,hi);
+}
+void wavefront_extend_matches_packed2bits_end2end(
+    wavefront_aligner_t* const wf_aligner,
+    wavefront_t* const mwavefront,
+    const int lo,
+    const int hi) {
+  wavefront_multiversion_get()->extend_matches_packed2bits_end2end(wf_aligner,mwavefront,lo,hi);
+}
+/*
+ * Dispatch shims (BiWFA)
+ */
+void wavefront_bialign(
+    wavefront_aligner_t* const wf_aligner) {
+  wavefront_multiversion_get()->bialign(wf_aligner);
+}
+/*
+ * Dispatch shims (Backtrace)
+ */
+void wavefront_backtrace_linear(
+    wavefront_aligner_t* const wf_aligner,
+    const int alignment_score,
+    const int alignment_k,
+    const wf_offset_t alignment_offset) {
+  wavefront_multiversion_get()->backtrace_linear(
+      wf_aligner,alignment_score,alignment_k,alignment_offset);
+}
+void wavefront_backtrace_affine(
+    wavefront_aligner_t* const wf_aligner,
+    const affine2p_matrix_type component_begin,
+    const affine2p_matrix_type component_end,
+    const int alignment_score,
+    const int alignment_k,
+    const wf_offset_t alignment_offset) {
+  wavefront_multiversion_get()->backtrace_affine(wf_aligner,
+      component_begin,component_end,alignment_score,alignment_k,alignment_offset);
+}
+void wavefront_backtrace_pcigar(
+    wavefront_aligner_t* const wf_aligner,
+    const int alignment_k,
+    const int alignment_offset,
+    const pcigar_t pcigar_last,
+    const bt_block_idx_t prev_idx_last) {
+  wavefront_multiversion_get()->backtrace_pcigar(
+      wf_aligner,alignment_k,alignment_offset,pcigar_last,prev_idx_last);
+}
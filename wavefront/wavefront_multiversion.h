@@ -0,0 +1,291 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignment Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignment Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignment Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: WFA module to select the multiversioned kernels (x86-64-v2/v3/v4) at runtime
+ */
+
+#ifndef WAVEFRONT_MULTIVERSION_H_
+#define WAVEFRONT_MULTIVERSION_H_
+
+/*
+ * Multiversioned modules (WFA_MULTIVERSION builds)
+ *   The compute, extend, BiWFA-breakpoint, and backtrace modules are
+ *   compiled once per ISA level (x86-64-v2/v3/v4) with -DWFA_MULTIVERSION_LEVEL=N.
+ *   This header must be the first include of these modules so that every
+ *   external symbol they define (or call among themselves) gets the suffix _vN.
+ *   Any new non-static function added to these modules must be listed here.
+ *   The rest of the library calls the unsuffixed entry points (dispatch shims),
+ *   which forward to the table selected at wavefront_aligner_new().
+ */
+#ifdef WFA_MULTIVERSION_LEVEL
+#if WFA_MULTIVERSION_LEVEL == 2
+  #define WFA_MULTIVERSION_SUFFIX _v2
+  #define WFA_MULTIVERSION_NAME "x86-64-v2"
+#elif WFA_MULTIVERSION_LEVEL == 3
+  #define WFA_MULTIVERSION_SUFFIX _v3
+  #define WFA_MULTIVERSION_NAME "x86-64-v3"
+#elif WFA_MULTIVERSION_LEVEL == 4
+  #define WFA_MULTIVERSION_SUFFIX _v4
+  #define WFA_MULTIVERSION_NAME "x86-64-v4"
+#else
+  #error "WFA_MULTIVERSION_LEVEL must be 2, 3, or 4"
+#endif
+#endif
+#ifdef WFA_MULTIVERSION_SUFFIX
+#define WFA_MV_CONCAT(name,suffix) name##suffix
+#define WFA_MV_XCONCAT(name,suffix) WFA_MV_CONCAT(name,suffix)
+#define WFA_MV(name) WFA_MV_XCONCAT(name,WFA_MULTIVERSION_SUFFIX)
+// wavefront_backtrace.c
+#define wavefront_backtrace_affine WFA_MV(wavefront_backtrace_affine)
+#define wavefront_backtrace_cigar_close WFA_MV(wavefront_backtrace_cigar_close)
+#define wavefront_backtrace_cigar_init WFA_MV(wavefront_backtrace_cigar_init)
+#define wavefront_backtrace_cigar_op WFA_MV(wavefront_backtrace_cigar_op)
+#define wavefront_backtrace_del1_ext WFA_MV(wavefront_backtrace_del1_ext)
+#define wavefront_backtrace_del1_open WFA_MV(wavefront_backtrace_del1_open)
+#define wavefront_backtrace_del2_ext WFA_MV(wavefront_backtrace_del2_ext)
+#define wavefront_backtrace_del2_open WFA_MV(wavefront_backtrace_del2_open)
+#define wavefront_backtrace_ins1_ext WFA_MV(wavefront_backtrace_ins1_ext)
+#define wavefront_backtrace_ins1_open WFA_MV(wavefront_backtrace_ins1_open)
+#define wavefront_backtrace_ins2_ext WFA_MV(wavefront_backtrace_ins2_ext)
+#define wavefront_backtrace_ins2_open WFA_MV(wavefront_backtrace_ins2_open)
+#define wavefront_backtrace_linear WFA_MV(wavefront_backtrace_linear)
+#define wavefront_backtrace_matches WFA_MV(wavefront_backtrace_matches)
+#define wavefront_backtrace_misms WFA_MV(wavefront_backtrace_misms)
+#define wavefront_backtrace_pcigar WFA_MV(wavefront_backtrace_pcigar)
+// wavefront_backtrace_offload.c
+#define wavefront_backtrace_offload_affine WFA_MV(wavefront_backtrace_offload_affine)
+#define wavefront_backtrace_offload_blocks_affine WFA_MV(wavefront_backtrace_offload_blocks_affine)
+#define wavefront_backtrace_offload_blocks_linear WFA_MV(wavefront_backtrace_offload_blocks_linear)
+#define wavefront_backtrace_offload_blocks_selective WFA_MV(wavefront_backtrace_offload_blocks_selective)
+#define wavefront_backtrace_offload_linear WFA_MV(wavefront_backtrace_offload_linear)
+#define wavefront_backtrace_offload_occupation_affine WFA_MV(wavefront_backtrace_offload_occupation_affine)
+// wavefront_bialign.c
+#define wavefront_bialign WFA_MV(wavefront_bialign)
+#define wavefront_bialign_alignment WFA_MV(wavefront_bialign_alignment)
+#define wavefront_bialign_base WFA_MV(wavefront_bialign_base)
+#define wavefront_bialign_breakpoint_indel2indel WFA_MV(wavefront_bialign_breakpoint_indel2indel)
+#define wavefront_bialign_breakpoint_indel2indel_avx2 WFA_MV(wavefront_bialign_breakpoint_indel2indel_avx2)
+#define wavefront_bialign_breakpoint_indel2indel_avx512 WFA_MV(wavefront_bialign_breakpoint_indel2indel_avx512)
+#define wavefront_bialign_breakpoint_m2m WFA_MV(wavefront_bialign_breakpoint_m2m)
+#define wavefront_bialign_breakpoint_m2m_avx2 WFA_MV(wavefront_bialign_breakpoint_m2m_avx2)
+#define wavefront_bialign_breakpoint_m2m_avx512 WFA_MV(wavefront_bialign_breakpoint_m2m_avx512)
+#define wavefront_bialign_compute_score WFA_MV(wavefront_bialign_compute_score)
+#define wavefront_bialign_debug WFA_MV(wavefront_bialign_debug)
+#define wavefront_bialign_find_breakpoint WFA_MV(wavefront_bialign_find_breakpoint)
+#define wavefront_bialign_find_breakpoint_exception WFA_MV(wavefront_bialign_find_breakpoint_exception)
+#define wavefront_bialign_find_collision_parallel WFA_MV(wavefront_bialign_find_collision_parallel)
+#define wavefront_bialign_get_worker WFA_MV(wavefront_bialign_get_worker)
+#define wavefront_bialign_init WFA_MV(wavefront_bialign_init)
+#define wavefront_bialign_init_half_0 WFA_MV(wavefront_bialign_init_half_0)
+#define wavefront_bialign_init_half_1 WFA_MV(wavefront_bialign_init_half_1)
+#define wavefront_bialign_max_score_bound WFA_MV(wavefront_bialign_max_score_bound)
+#define wavefront_bialign_overlap WFA_MV(wavefront_bialign_overlap)
+#define wavefront_bialign_overlap_gopen_adjust WFA_MV(wavefront_bialign_overlap_gopen_adjust)
+#define wavefront_bialign_parallel_enabled WFA_MV(wavefront_bialign_parallel_enabled)
+#define wavefront_bialign_parallel_wait WFA_MV(wavefront_bialign_parallel_wait)
+// wavefront_compute.c
+#define wavefront_compute_allocate_output WFA_MV(wavefront_compute_allocate_output)
+#define wavefront_compute_allocate_output_null WFA_MV(wavefront_compute_allocate_output_null)
+#define wavefront_compute_classic_score WFA_MV(wavefront_compute_classic_score)
+#define wavefront_compute_endsfree_allocate_null WFA_MV(wavefront_compute_endsfree_allocate_null)
+#define wavefront_compute_endsfree_init WFA_MV(wavefront_compute_endsfree_init)
+#define wavefront_compute_endsfree_init_offset WFA_MV(wavefront_compute_endsfree_init_offset)
+#define wavefront_compute_endsfree_limits WFA_MV(wavefront_compute_endsfree_limits)
+#define wavefront_compute_endsfree_required WFA_MV(wavefront_compute_endsfree_required)
+#define wavefront_compute_extend_fused_completed WFA_MV(wavefront_compute_extend_fused_completed)
+#define wavefront_compute_fetch_input WFA_MV(wavefront_compute_fetch_input)
+#define wavefront_compute_free_output WFA_MV(wavefront_compute_free_output)
+#define wavefront_compute_get_d1wavefront WFA_MV(wavefront_compute_get_d1wavefront)
+#define wavefront_compute_get_d2wavefront WFA_MV(wavefront_compute_get_d2wavefront)
+#define wavefront_compute_get_i1wavefront WFA_MV(wavefront_compute_get_i1wavefront)
+#define wavefront_compute_get_i2wavefront WFA_MV(wavefront_compute_get_i2wavefront)
+#define wavefront_compute_get_mwavefront WFA_MV(wavefront_compute_get_mwavefront)
+#define wavefront_compute_init_ends WFA_MV(wavefront_compute_init_ends)
+#define wavefront_compute_init_ends_wf_higher WFA_MV(wavefront_compute_init_ends_wf_higher)
+#define wavefront_compute_init_ends_wf_lower WFA_MV(wavefront_compute_init_ends_wf_lower)
+#define wavefront_compute_limits_input WFA_MV(wavefront_compute_limits_input)
+#define wavefront_compute_limits_output WFA_MV(wavefront_compute_limits_output)
+#define wavefront_compute_process_ends WFA_MV(wavefront_compute_process_ends)
+#define wavefront_compute_trim_ends WFA_MV(wavefront_compute_trim_ends)
+#ifdef WFA_PARALLEL
+#define wavefront_compute_num_threads WFA_MV(wavefront_compute_num_threads)
+#define wavefront_compute_thread_limits WFA_MV(wavefront_compute_thread_limits)
+#endif
+// wavefront_compute_affine.c
+#define wavefront_compute_affine WFA_MV(wavefront_compute_affine)
+#define wavefront_compute_affine_dispatcher WFA_MV(wavefront_compute_affine_dispatcher)
+#define wavefront_compute_affine_idm WFA_MV(wavefront_compute_affine_idm)
+#define wavefront_compute_affine_idm_piggyback WFA_MV(wavefront_compute_affine_idm_piggyback)
+#define wavefront_compute_affine_kernel WFA_MV(wavefront_compute_affine_kernel)
+#define wavefront_compute_affine_tiles WFA_MV(wavefront_compute_affine_tiles)
+// wavefront_compute_affine2p.c
+#define wavefront_compute_affine2p WFA_MV(wavefront_compute_affine2p)
+#define wavefront_compute_affine2p_dispatcher WFA_MV(wavefront_compute_affine2p_dispatcher)
+#define wavefront_compute_affine2p_dispatcher_omp WFA_MV(wavefront_compute_affine2p_dispatcher_omp)
+#define wavefront_compute_affine2p_idm WFA_MV(wavefront_compute_affine2p_idm)
+#define wavefront_compute_affine2p_idm_piggyback WFA_MV(wavefront_compute_affine2p_idm_piggyback)
+#define wavefront_compute_affine2p_tiles WFA_MV(wavefront_compute_affine2p_tiles)
+// wavefront_compute_edit.c
+#define wavefront_compute_edit WFA_MV(wavefront_compute_edit)
+#define wavefront_compute_edit_dispatcher WFA_MV(wavefront_compute_edit_dispatcher)
+#define wavefront_compute_edit_dispatcher_omp WFA_MV(wavefront_compute_edit_dispatcher_omp)
+#define wavefront_compute_edit_exact_prune WFA_MV(wavefront_compute_edit_exact_prune)
+#define wavefront_compute_edit_idm WFA_MV(wavefront_compute_edit_idm)
+#define wavefront_compute_edit_idm_piggyback WFA_MV(wavefront_compute_edit_idm_piggyback)
+#define wavefront_compute_edit_tiles WFA_MV(wavefront_compute_edit_tiles)
+#define wavefront_compute_indel_idm WFA_MV(wavefront_compute_indel_idm)
+#define wavefront_compute_indel_idm_piggyback WFA_MV(wavefront_compute_indel_idm_piggyback)
+#define wf_compute_edit_best_score WFA_MV(wf_compute_edit_best_score)
+#define wf_compute_edit_worst_score WFA_MV(wf_compute_edit_worst_score)
+// wavefront_compute_kernels_avx.c
+#define wavefront_compute_affine_idm_avx2 WFA_MV(wavefront_compute_affine_idm_avx2)
+#define wavefront_compute_affine_idm_avx512 WFA_MV(wavefront_compute_affine_idm_avx512)
+#define wavefront_compute_affine_idm_piggyback_avx2 WFA_MV(wavefront_compute_affine_idm_piggyback_avx2)
+#define wavefront_compute_affine_idm_piggyback_avx512 WFA_MV(wavefront_compute_affine_idm_piggyback_avx512)
+#define wavefront_compute_affine2p_idm_avx2 WFA_MV(wavefront_compute_affine2p_idm_avx2)
+#define wavefront_compute_affine2p_idm_avx512 WFA_MV(wavefront_compute_affine2p_idm_avx512)
+#define wavefront_compute_affine2p_idm_piggyback_avx2 WFA_MV(wavefront_compute_affine2p_idm_piggyback_avx2)
+#define wavefront_compute_affine2p_idm_piggyback_avx512 WFA_MV(wavefront_compute_affine2p_idm_piggyback_avx512)
+// wavefront_compute_linear.c
+#define wavefront_compute_linear WFA_MV(wavefront_compute_linear)
+#define wavefront_compute_linear_dispatcher WFA_MV(wavefront_compute_linear_dispatcher)
+#define wavefront_compute_linear_idm WFA_MV(wavefront_compute_linear_idm)
+#define wavefront_compute_linear_idm_piggyback WFA_MV(wavefront_compute_linear_idm_piggyback)
+// wavefront_dispatch.c
+#define wavefront_dispatch_detect_isa WFA_MV(wavefront_dispatch_detect_isa)
+#define wavefront_dispatch_init WFA_MV(wavefront_dispatch_init)
+#define wavefront_dispatch_isa_name WFA_MV(wavefront_dispatch_isa_name)
+// wavefront_extend.c
+#define wavefront_extend_end2end WFA_MV(wavefront_extend_end2end)
+#define wavefront_extend_end2end_dispatcher_seq WFA_MV(wavefront_extend_end2end_dispatcher_seq)
+#define wavefront_extend_end2end_dispatcher_threads WFA_MV(wavefront_extend_end2end_dispatcher_threads)
+#define wavefront_extend_end2end_max WFA_MV(wavefront_extend_end2end_max)
+#define wavefront_extend_end2end_max_dispatcher_seq WFA_MV(wavefront_extend_end2end_max_dispatcher_seq)
+#define wavefront_extend_end2end_max_dispatcher_threads WFA_MV(wavefront_extend_end2end_max_dispatcher_threads)
+#define wavefront_extend_endsfree WFA_MV(wavefront_extend_endsfree)
+#define wavefront_extend_endsfree_dispatcher_seq WFA_MV(wavefront_extend_endsfree_dispatcher_seq)
+#define wavefront_extend_endsfree_dispatcher_threads WFA_MV(wavefront_extend_endsfree_dispatcher_threads)
+// wavefront_extend_kernels.c
+#define wavefront_extend_matches_custom WFA_MV(wavefront_extend_matches_custom)
+#define wavefront_extend_matches_packed2bits_end2end WFA_MV(wavefront_extend_matches_packed2bits_end2end)
+#define wavefront_extend_matches_packed2bits_end2end_max WFA_MV(wavefront_extend_matches_packed2bits_end2end_max)
+#define wavefront_extend_matches_packed2bits_endsfree WFA_MV(wavefront_extend_matches_packed2bits_endsfree)
+#define wavefront_extend_matches_packed_end2end WFA_MV(wavefront_extend_matches_packed_end2end)
+#define wavefront_extend_matches_packed_end2end_max WFA_MV(wavefront_extend_matches_packed_end2end_max)
+#define wavefront_extend_matches_packed_endsfree WFA_MV(wavefront_extend_matches_packed_endsfree)
+#define wavefront_extend_matches_slice_end2end WFA_MV(wavefront_extend_matches_slice_end2end)
+#define wavefront_extend_matches_slice_end2end_max WFA_MV(wavefront_extend_matches_slice_end2end_max)
+#define wavefront_extend_matches_slice_endsfree WFA_MV(wavefront_extend_matches_slice_endsfree)
+// wavefront_extend_kernels_avx.c
+#define wavefront_extend_matches_packed2bits_end2end_avx2 WFA_MV(wavefront_extend_matches_packed2bits_end2end_avx2)
+#define wavefront_extend_matches_packed2bits_end2end_avx512 WFA_MV(wavefront_extend_matches_packed2bits_end2end_avx512)
+#define wavefront_extend_matches_packed2bits_end2end_max_avx2 WFA_MV(wavefront_extend_matches_packed2bits_end2end_max_avx2)
+#define wavefront_extend_matches_packed2bits_end2end_max_avx512 WFA_MV(wavefront_extend_matches_packed2bits_end2end_max_avx512)
+#define wavefront_extend_matches_packed2bits_endsfree_avx2 WFA_MV(wavefront_extend_matches_packed2bits_endsfree_avx2)
+#define wavefront_extend_matches_packed2bits_endsfree_avx512 WFA_MV(wavefront_extend_matches_packed2bits_endsfree_avx512)
+#define wavefront_extend_matches_packed_end2end_avx2 WFA_MV(wavefront_extend_matches_packed_end2end_avx2)
+#define wavefront_extend_matches_packed_end2end_avx512 WFA_MV(wavefront_extend_matches_packed_end2end_avx512)
+#define wavefront_extend_matches_packed_end2end_max_avx2 WFA_MV(wavefront_extend_matches_packed_end2end_max_avx2)
+#define wavefront_extend_matches_packed_end2end_max_avx512 WFA_MV(wavefront_extend_matches_packed_end2end_max_avx512)
+#define wavefront_extend_matches_packed_endsfree_avx2 WFA_MV(wavefront_extend_matches_packed_endsfree_avx2)
+#define wavefront_extend_matches_packed_endsfree_avx512 WFA_MV(wavefront_extend_matches_packed_endsfree_avx512)
+#endif /* WFA_MULTIVERSION_SUFFIX */
+
+#include "utils/commons.h"
+#include "wavefront_aligner.h"
+
+/*
+ * Multiversioned kernels (dispatch table)
+ *   One table per ISA level, defined by each build of wavefront_dispatch.c
+ *   (wavefront_multiversion_v2/v3/v4). It holds the entry points called
+ *   from outside the multiversioned modules.
+ */
+typedef struct {
+  // ISA level
+  int level;                 // x86-64 micro-architecture level (2,3,4)
+  char* name;                // Level name (e.g., "x86-64-v3")
+  // CPU dispatch
+  wavefront_kernels_isa_t (*dispatch_detect_isa)(void);
+  void (*dispatch_init)(wavefront_kernels_t* const,const wavefront_kernels_isa_t);
+  char* (*dispatch_isa_name)(const wavefront_kernels_isa_t);
+  // Compute
+  void (*compute_affine)(wavefront_aligner_t* const,const int);
+  void (*compute_affine2p)(wavefront_aligner_t* const,const int);
+  void (*compute_edit)(wavefront_aligner_t* const,const int);
+  void (*compute_linear)(wavefront_aligner_t* const,const int);
+  void (*compute_edit_idm)(
+      wavefront_aligner_t* const,wavefront_t* const,wavefront_t* const,const int,const int);
+  void (*compute_edit_idm_piggyback)(
+      wavefront_aligner_t* const,wavefront_t* const,wavefront_t* const,const int,const int,const int);
+  void (*compute_linear_idm)(
+      wavefront_aligner_t* const,const wavefront_set_t* const,const int,const int);
+  void (*compute_linear_idm_piggyback)(
+      wavefront_aligner_t* const,const wavefront_set_t* const,const int,const int);
+  int (*compute_classic_score)(wavefront_aligner_t* const,const int,const int,const int);
+  void (*compute_limits_output)(
+      wavefront_aligner_t* const,const int,const int,int* const,int* const);
+#ifdef WFA_PARALLEL
+  void (*compute_thread_limits)(
+      const int,const int,const int,const int,int* const,int* const);
+#endif
+  // Extend
+  int (*extend_end2end)(wavefront_aligner_t* const,const int);
+  int (*extend_endsfree)(wavefront_aligner_t* const,const int);
+  void (*extend_matches_packed_end2end)(
+      wavefront_aligner_t* const,wavefront_t* const,const int,const int);
+  void (*extend_matches_packed2bits_end2end)(
+      wavefront_aligner_t* const,wavefront_t* const,const int,const int);
+  // BiWFA
+  void (*bialign)(wavefront_aligner_t* const);
+  // Backtrace
+  void (*backtrace_linear)(
+      wavefront_aligner_t* const,const int,const int,const wf_offset_t);
+  void (*backtrace_affine)(
+      wavefront_aligner_t* const,const affine2p_matrix_type,const affine2p_matrix_type,
+      const int,const int,const wf_offset_t);
+  void (*backtrace_pcigar)(
+      wavefront_aligner_t* const,const int,const int,const pcigar_t,const bt_block_idx_t);
+} wavefront_multiversion_t;
+
+/*
+ * Tables (one per ISA level)
+ */
+extern const wavefront_multiversion_t wavefront_multiversion_v2;
+extern const wavefront_multiversion_t wavefront_multiversion_v3;
+extern const wavefront_multiversion_t wavefront_multiversion_v4;
+
+/*
+ * Setup
+ */
+const wavefront_multiversion_t* wavefront_multiversion_detect(void);
+const wavefront_multiversion_t* wavefront_multiversion_init(void);
+void wavefront_multiversion_select(
+    const wavefront_multiversion_t* const multiversion);
+const wavefront_multiversion_t* wavefront_multiversion_get(void);
+
+#endif /* WAVEFRONT_MULTIVERSION_H_ */
@@ -34,14 +34,31 @@
 
 /*
  * Wavefront Offset
+ *   Builds defining WFA_OFFSET16 use 16-bit offsets (half the wavefront memory)
+ *   and only align pairs with pattern_length+text_length <= WAVEFRONT_OFFSET_MAX_LENGTH
  */
+#ifdef WFA_OFFSET16
+typedef int16_t wf_offset_t;
+typedef uint16_t wf_unsigned_offset_t;
+#else
 typedef int32_t wf_offset_t;
 typedef uint32_t wf_unsigned_offset_t;
+#endif
+typedef int16_t wf_offset16_t;          // Compressed offset (short sequences)
+typedef uint16_t wf_unsigned_offset16_t;
 
 /*
  * Constants
  */
+#ifdef WFA_OFFSET16
+#define WAVEFRONT_OFFSET_NULL (INT16_MIN/2)
+#define WAVEFRONT_OFFSET_MAX_LENGTH (INT16_MAX/2) // Max pattern_length+text_length
+#else
 #define WAVEFRONT_OFFSET_NULL (INT32_MIN/2)
+#define WAVEFRONT_OFFSET_MAX_LENGTH (INT32_MAX/2) // Max pattern_length+text_length
+#endif
+#define WAVEFRONT_OFFSET16_NULL (INT16_MIN/2)
+#define WAVEFRONT_OFFSET16_MAX_LENGTH (INT16_MAX/2) // Max pattern_length+text_length using 16-bit offsets
 
 /*
  * Translate k and offset to coordinates h,v
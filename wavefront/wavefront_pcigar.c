@@ -48,9 +48,6 @@ pcigar_op_t pcigar_lut[4] = {
     { .operation = 'X', .inc_v = 1, .inc_h = 1, .matrix_type = affine_matrix_M }, // 10 - MISMATCH
     { .operation = 'I', .inc_v = 0, .inc_h = 1, .matrix_type = affine_matrix_I }, // 11 - INSERTION
 };
-// Precomputed string of Matches
-char matches_lut[8] = "MMMMMMMM";
-#define CIGAR_8MATCHES_UINT64 *((uint64_t*)matches_lut)
 
 /*
  * Accessors
@@ -95,8 +92,7 @@ int pcigar_unpack_extend(
     const char* const text,
     const int text_length,
     int v,
-    int h,
-    char* cigar_buffer) {
+    int h) {
   int num_matches = 0;
   // Fetch pattern/text blocks
   uint64_t* pattern_blocks = (uint64_t*)(pattern+v);
@@ -110,9 +106,6 @@ int pcigar_unpack_extend(
     v += 8;
     h += 8;
     num_matches += 8;
-    // Dump matches in block
-    *((uint64_t*)cigar_buffer) = CIGAR_8MATCHES_UINT64;
-    cigar_buffer += 8;
     // Next blocks
     ++pattern_blocks;
     ++text_blocks;
@@ -123,7 +116,6 @@ int pcigar_unpack_extend(
   }
   // Count equal characters
   num_matches += __builtin_ctzl(cmp)/8;
-  *((uint64_t*)cigar_buffer) = CIGAR_8MATCHES_UINT64;
   // Return total matches
   return num_matches;
 }
@@ -133,16 +125,25 @@ int pcigar_unpack_extend_custom(
     alignment_match_funct_t const match_funct,
     void* const match_funct_arguments,
     int v,
-    int h,
-    char* cigar_buffer) {
+    int h) {
   int num_matches = 0;
   while (v < pattern_length && h < text_length) {
     // Check match
     if (!match_funct(v,h,match_funct_arguments)) break;
     ++v; ++h;
     // Increment matches
-    *cigar_buffer = 'M';
-    ++cigar_buffer;
+    ++num_matches;
+  }
+  return num_matches;
+}
+int pcigar_unpack_extend_packed2bits(
+    wavefront_sequences_t* const sequences,
+    int v,
+    int h) {
+  int num_matches = 0;
+  while (wavefront_sequences_cmp(sequences,v,h)) {
+    ++v; ++h;
+    // Increment matches
     ++num_matches;
   }
   return num_matches;
@@ -155,14 +156,12 @@ void pcigar_unpack_linear(
     wavefront_sequences_t* const sequences,
     int* const v_pos,
     int* const h_pos,
-    char* cigar_buffer,
-    int* const cigar_length) {
+    cigar_t* const cigar) {
   // Parameters
   char* const pattern = sequences->pattern;
   const int pattern_length = sequences->pattern_length;
   char* const text = sequences->text;
   const int text_length = sequences->text_length;
-  char* const cigar_buffer_base = cigar_buffer;
   // Compute pcigar length and shift to the end of the word
   int pcigar_length = PCIGAR_MAX_LENGTH;
   if (!PCIGAR_IS_UTILISED(pcigar,PCIGAR_FULL_MASK)) {
@@ -178,26 +177,27 @@ void pcigar_unpack_linear(
     if (sequences->mode == wf_sequences_lambda) { // Custom extend-match function
       num_matches = pcigar_unpack_extend_custom(
           pattern_length,text_length,sequences->match_funct,
-          sequences->match_funct_arguments,v,h,cigar_buffer);
+          sequences->match_funct_arguments,v,h);
+    } else if (sequences->mode == wf_sequences_packed2bits) {
+      num_matches = pcigar_unpack_extend_packed2bits(sequences,v,h);
     } else {
       num_matches = pcigar_unpack_extend(
-          pattern,pattern_length,text,text_length,v,h,cigar_buffer);
+          pattern,pattern_length,text,text_length,v,h);
     }
     // Update location
     v += num_matches;
     h += num_matches;
-    cigar_buffer += num_matches;
+    cigar_append_operation(cigar,'M',num_matches);
     // Extract next CIGAR operation
     const int cigar_op = (int)PCIGAR_EXTRACT(pcigar); // Extract
     PCIGAR_POP_FRONT(pcigar); // Shift
     // Add operation using LUT
     pcigar_op_t* const op = pcigar_lut + cigar_op;
-    *(cigar_buffer++) = op->operation;
+    cigar_append_operation(cigar,op->operation,1);
     v += op->inc_v;
     h += op->inc_h;
   }
-  // Update length/positions
-  *cigar_length = cigar_buffer - cigar_buffer_base;
+  // Update positions
   *v_pos = v;
   *h_pos = h;
 }
@@ -206,15 +206,13 @@ void pcigar_unpack_affine(
     wavefront_sequences_t* const sequences,
     int* const v_pos,
     int* const h_pos,
-    char* cigar_buffer,
-    int* const cigar_length,
+    cigar_t* const cigar,
     affine_matrix_type* const current_matrix_type) {
   // Parameters
   char* const pattern = sequences->pattern;
   const int pattern_length = sequences->pattern_length;
   char* const text = sequences->text;
   const int text_length = sequences->text_length;
-  char* const cigar_buffer_base = cigar_buffer;
   // Compute pcigar length and shift to the end of the word
   int pcigar_length = PCIGAR_MAX_LENGTH;
   if (!PCIGAR_IS_UTILISED(pcigar,PCIGAR_FULL_MASK)) {
@@ -232,15 +230,17 @@ void pcigar_unpack_affine(
       if (sequences->mode == wf_sequences_lambda) { // Custom extend-match function
         num_matches = pcigar_unpack_extend_custom(
             pattern_length,text_length,sequences->match_funct,
-            sequences->match_funct_arguments,v,h,cigar_buffer);
+            sequences->match_funct_arguments,v,h);
+      } else if (sequences->mode == wf_sequences_packed2bits) {
+        num_matches = pcigar_unpack_extend_packed2bits(sequences,v,h);
       } else {
         num_matches = pcigar_unpack_extend(
-            pattern,pattern_length,text,text_length,v,h,cigar_buffer);
+            pattern,pattern_length,text,text_length,v,h);
       }
       // Update location
       v += num_matches;
       h += num_matches;
-      cigar_buffer += num_matches;
+      cigar_append_operation(cigar,'M',num_matches);
     }
     // Extract next CIGAR operation
     const int cigar_op = (int)PCIGAR_EXTRACT(pcigar); // Extract
@@ -253,13 +253,12 @@ void pcigar_unpack_affine(
       continue;
     }
     // Add operation
-    *(cigar_buffer++) = op->operation;
+    cigar_append_operation(cigar,op->operation,1);
     v += op->inc_v;
     h += op->inc_h;
     matrix_type = op->matrix_type;
   }
-  // Update length/positions
-  *cigar_length = cigar_buffer - cigar_buffer_base;
+  // Update positions
   *v_pos = v;
   *h_pos = h;
   *current_matrix_type = matrix_type;
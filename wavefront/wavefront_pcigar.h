@@ -94,15 +94,13 @@ void pcigar_unpack_linear(
     wavefront_sequences_t* const sequences,
     int* const v_pos,
     int* const h_pos,
-    char* cigar_buffer,
-    int* const cigar_length);
+    cigar_t* const cigar);
 void pcigar_unpack_affine(
     pcigar_t pcigar,
     wavefront_sequences_t* const sequences,
     int* const v_pos,
     int* const h_pos,
-    char* cigar_buffer,
-    int* const cigar_length,
+    cigar_t* const cigar,
     affine_matrix_type* const current_matrix_type);
 
 /*
@@ -135,8 +135,6 @@ void wavefront_plot_component(
   const int pattern_length = sequences->pattern_length;
   const int text_begin = sequences->text_begin;
   const int text_length = sequences->text_length;
-  const char* const pattern = sequences->pattern;
-  const char* const text = sequences->text;
   const bool reverse = (wf_aligner->align_mode == wf_align_biwfa_breakpoint_reverse);
   // Traverse all offsets
   int k;
@@ -167,7 +165,7 @@ void wavefront_plot_component(
     if (extend) {
       while (v_local < pattern_length &&
              h_local < text_length &&
-             pattern[v_local] == text[h_local]) {
+             wavefront_sequences_cmp(sequences,v_local,h_local)) {
         if (reverse) {
           v_global--; h_global--;
         } else {
@@ -226,6 +224,7 @@ void wavefront_plot_print_cigar(
     FILE* const stream,
     cigar_t* const cigar,
     const char target_operation) {
+  cigar_expand(cigar); // Lazy expansion
   int i, h=0, v=0, count=0;
   for (i=cigar->begin_offset;i<cigar->end_offset;++i) {
     // Check operation
@@ -271,6 +270,15 @@ void wavefront_plot_print(
     fprintf(stream,"# TextLength %d\n",text_length);
     fprintf(stream,"# Pattern -\n");
     fprintf(stream,"# Text -\n");
+  } else if (sequences->mode == wf_sequences_packed2bits) {
+    int i;
+    fprintf(stream,"# PatternLength %d\n",pattern_length);
+    fprintf(stream,"# Pattern ");
+    for (i=0;i<pattern_length;++i) fputc(wavefront_sequences_get_pattern(sequences,i),stream);
+    fprintf(stream,"\n# TextLength %d\n",text_length);
+    fprintf(stream,"# Text ");
+    for (i=0;i<text_length;++i) fputc(wavefront_sequences_get_text(sequences,i),stream);
+    fprintf(stream,"\n");
   } else {
     fprintf(stream,"# PatternLength %d\n",pattern_length);
     fprintf(stream,"# Pattern %.*s\n",pattern_length,sequences->pattern);
@@ -0,0 +1,218 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignment Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignment Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignment Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: WFA module to discard pairs by a score lower-bound (before aligning)
+ */
+
+#include "wavefront_prefilter.h"
+
+/*
+ * Lower bounds
+ *   Any end-to-end alignment requires |plen-tlen| gap bases in one direction.
+ *   Besides, each base in excess (e.g., more A's in the pattern than in the
+ *   text) that is not removed by those gaps must be paired with an excess
+ *   base of the other sequence, either by a mismatch or by one insertion
+ *   plus one deletion. All penalties are WF-penalties (i.e., WF-score).
+ */
+int wavefront_prefilter_bound(
+    wavefront_penalties_t* const penalties,
+    const int pattern_length,
+    const int text_length,
+    const int excess_pairs) {
+  const int length_diff = ABS(pattern_length-text_length);
+  int gap_bound, pair_bound;
+  switch (penalties->distance_metric) {
+    case indel:
+      gap_bound = length_diff;
+      pair_bound = 2;
+      break;
+    case edit:
+      gap_bound = length_diff;
+      pair_bound = 1;
+      break;
+    case gap_linear:
+      gap_bound = length_diff * penalties->gap_opening1;
+      pair_bound = MIN(penalties->mismatch,2*penalties->gap_opening1);
+      break;
+    case gap_affine:
+      gap_bound = (length_diff==0) ? 0 :
+          penalties->gap_opening1 + length_diff*penalties->gap_extension1;
+      pair_bound = MIN(penalties->mismatch,2*penalties->gap_extension1);
+      break;
+    case gap_affine_2p:
+    default:
+      gap_bound = (length_diff==0) ? 0 : MIN(
+          penalties->gap_opening1 + length_diff*penalties->gap_extension1,
+          penalties->gap_opening2 + length_diff*penalties->gap_extension2);
+      pair_bound = MIN(penalties->mismatch,
+          2*MIN(penalties->gap_extension1,penalties->gap_extension2));
+      break;
+  }
+  const int64_t bound = (int64_t)gap_bound + (int64_t)excess_pairs*pair_bound;
+  return (bound > INT_MAX) ? INT_MAX : (int)bound;
+}
+/*
+ * Base counts
+ *   Only {A,C,G,T} are counted (any other character falls into a
+ *   common bucket), which can only weaken the bound
+ */
+void wavefront_prefilter_count_ascii(
+    const char* const sequence,
+    const int sequence_length,
+    int* const counts) {
+  int count_a = 0, count_c = 0, count_g = 0, count_t = 0, i;
+  PRAGMA_LOOP_VECTORIZE
+  for (i=0;i<sequence_length;++i) {
+    const char c = sequence[i];
+    count_a += (c == 'A');
+    count_c += (c == 'C');
+    count_g += (c == 'G');
+    count_t += (c == 'T');
+  }
+  counts[0] = count_a;
+  counts[1] = count_c;
+  counts[2] = count_g;
+  counts[3] = count_t;
+  counts[4] = sequence_length - (count_a + count_c + count_g + count_t);
+}
+void wavefront_prefilter_count_packed2bits(
+    const uint8_t* const sequence,
+    const int sequence_length,
+    int* const counts) {
+  // Count full bytes (4 bases each)
+  const int num_full_bytes = sequence_length / 4;
+  int count_c = 0, count_g = 0, count_t = 0, i;
+  PRAGMA_LOOP_VECTORIZE
+  for (i=0;i<num_full_bytes;++i) {
+    const uint8_t byte = sequence[i];
+    // Per 2-bit field: count codes 01, 10, and 11 (00 is inferred)
+    const uint8_t lo = byte & 0x55, hi = (byte >> 1) & 0x55;
+    count_c += __builtin_popcount(lo & ~hi & 0x55);
+    count_g += __builtin_popcount(hi & ~lo & 0x55);
+    count_t += __builtin_popcount(lo & hi);
+  }
+  // Count remaining bases
+  for (i=4*num_full_bytes;i<sequence_length;++i) {
+    const int enc = (sequence[i/4] >> (2*(i%4))) & 3;
+    count_c += (enc == 1);
+    count_g += (enc == 2);
+    count_t += (enc == 3);
+  }
+  counts[0] = sequence_length - (count_c + count_g + count_t);
+  counts[1] = count_c;
+  counts[2] = count_g;
+  counts[3] = count_t;
+  counts[4] = 0;
+}
+int wavefront_prefilter_excess_pairs(
+    const int* const pattern_counts,
+    const int* const text_counts) {
+  int pattern_excess = 0, text_excess = 0, i;
+  for (i=0;i<5;++i) {
+    const int diff = pattern_counts[i] - text_counts[i];
+    if (diff > 0) pattern_excess += diff; else text_excess -= diff;
+  }
+  return MIN(pattern_excess,text_excess);
+}
+/*
+ * Prefilter
+ */
+bool wavefront_prefilter_enabled(
+    wavefront_aligner_t* const wf_aligner) {
+  // Only sound for end-to-end alignments (free ends could absorb the gaps)
+  return wf_aligner->system.prefilter != wf_prefilter_none &&
+         wf_aligner->system.max_score != INT_MAX &&
+         wf_aligner->alignment_form.span == alignment_end2end &&
+         !wf_aligner->alignment_form.extension;
+}
+bool wavefront_prefilter_check(
+    wavefront_aligner_t* const wf_aligner,
+    const int score_bound) {
+  // Check bound
+  if (score_bound <= wf_aligner->system.max_score) return false;
+  // Filtered out (no wavefront computed)
+  cigar_clear(wf_aligner->cigar);
+  wf_aligner->cigar->score = -score_bound;
+  wf_aligner->align_status.status = WF_STATUS_FILTERED;
+  wf_aligner->align_status.score = score_bound;
+  wf_aligner->align_status.dropped = false;
+  return true;
+}
+bool wavefront_prefilter_ascii(
+    wavefront_aligner_t* const wf_aligner,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length) {
+  if (!wavefront_prefilter_enabled(wf_aligner)) return false;
+  // Length bound
+  wavefront_penalties_t* const penalties = &wf_aligner->penalties;
+  int excess_pairs = 0;
+  if (wavefront_prefilter_check(wf_aligner,
+      wavefront_prefilter_bound(penalties,pattern_length,text_length,0))) return true;
+  // Base-count bound
+  if (wf_aligner->system.prefilter == wf_prefilter_basecount) {
+    int pattern_counts[5], text_counts[5];
+    wavefront_prefilter_count_ascii(pattern,pattern_length,pattern_counts);
+    wavefront_prefilter_count_ascii(text,text_length,text_counts);
+    excess_pairs = wavefront_prefilter_excess_pairs(pattern_counts,text_counts);
+  }
+  return wavefront_prefilter_check(wf_aligner,
+      wavefront_prefilter_bound(penalties,pattern_length,text_length,excess_pairs));
+}
+bool wavefront_prefilter_packed2bits(
+    wavefront_aligner_t* const wf_aligner,
+    const uint8_t* const pattern,
+    const int pattern_length,
+    const uint8_t* const text,
+    const int text_length) {
+  if (!wavefront_prefilter_enabled(wf_aligner)) return false;
+  // Length bound
+  wavefront_penalties_t* const penalties = &wf_aligner->penalties;
+  int excess_pairs = 0;
+  if (wavefront_prefilter_check(wf_aligner,
+      wavefront_prefilter_bound(penalties,pattern_length,text_length,0))) return true;
+  // Base-count bound
+  if (wf_aligner->system.prefilter == wf_prefilter_basecount) {
+    int pattern_counts[5], text_counts[5];
+    wavefront_prefilter_count_packed2bits(pattern,pattern_length,pattern_counts);
+    wavefront_prefilter_count_packed2bits(text,text_length,text_counts);
+    excess_pairs = wavefront_prefilter_excess_pairs(pattern_counts,text_counts);
+  }
+  return wavefront_prefilter_check(wf_aligner,
+      wavefront_prefilter_bound(penalties,pattern_length,text_length,excess_pairs));
+}
+bool wavefront_prefilter_lambda(
+    wavefront_aligner_t* const wf_aligner,
+    const int pattern_length,
+    const int text_length) {
+  if (!wavefront_prefilter_enabled(wf_aligner)) return false;
+  // Length bound (sequences are not available)
+  return wavefront_prefilter_check(wf_aligner,
+      wavefront_prefilter_bound(&wf_aligner->penalties,pattern_length,text_length,0));
+}
@@ -0,0 +1,77 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignment Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignment Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignment Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: WFA module to discard pairs by a score lower-bound (before aligning)
+ */
+
+#ifndef WAVEFRONT_PREFILTER_H_
+#define WAVEFRONT_PREFILTER_H_
+
+#include "wavefront_aligner.h"
+
+/*
+ * Lower bounds
+ */
+int wavefront_prefilter_bound(
+    wavefront_penalties_t* const penalties,
+    const int pattern_length,
+    const int text_length,
+    const int excess_pairs);
+
+/*
+ * Base counts
+ */
+void wavefront_prefilter_count_ascii(
+    const char* const sequence,
+    const int sequence_length,
+    int* const counts);
+int wavefront_prefilter_excess_pairs(
+    const int* const pattern_counts,
+    const int* const text_counts);
+
+/*
+ * Prefilter (returns true if the pair is filtered out)
+ */
+bool wavefront_prefilter_ascii(
+    wavefront_aligner_t* const wf_aligner,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length);
+bool wavefront_prefilter_packed2bits(
+    wavefront_aligner_t* const wf_aligner,
+    const uint8_t* const pattern,
+    const int pattern_length,
+    const uint8_t* const text,
+    const int text_length);
+bool wavefront_prefilter_lambda(
+    wavefront_aligner_t* const wf_aligner,
+    const int pattern_length,
+    const int text_length);
+
+#endif /* WAVEFRONT_PREFILTER_H_ */
@@ -38,6 +38,11 @@
 #define WF_SEQUENCES_PATTERN_EOS '!'
 #define WF_SEQUENCES_TEXT_EOS    '?'
 
+/*
+ * 2-bits decoding
+ */
+static const char dna_packed2bits_decode[4] = {'A','C','G','T'};
+
 /*
  * Setup
  */
@@ -52,15 +57,34 @@ void wavefront_sequences_allocate(
   // Current state
   wf_sequences->pattern = NULL;
   wf_sequences->text = NULL;
+  wf_sequences->pattern_packed = NULL;
+  wf_sequences->text_packed = NULL;
+  // Pinned pattern
+  wf_sequences->pattern_pinned = false;
+  wf_sequences->pattern_pinned_active = false;
+  wf_sequences->pattern_pinned_mem = NULL;
+  wf_sequences->pattern_pinned_allocated = 0;
+  // Text slice
+  wf_sequences->text_slice = false;
 }
 void wavefront_sequences_free(
     wavefront_sequences_t* const wf_sequences) {
   // Free internal buffers
   if (wf_sequences->seq_buffer != NULL) free(wf_sequences->seq_buffer);
+  if (wf_sequences->pattern_pinned_mem != NULL) free(wf_sequences->pattern_pinned_mem);
 }
 /*
  * Init Sequences
  */
+void wavefront_sequences_restore_pinned(
+    wavefront_sequences_t* const wf_sequences) {
+  // Release any pending text slice
+  wavefront_sequences_release_text_slice(wf_sequences);
+  // Restore the pinned pattern (bounds might have truncated it)
+  if (!wf_sequences->pattern_pinned_active) return;
+  wf_sequences->pattern[wf_sequences->pattern_length] = wf_sequences->pattern_eos;
+  wf_sequences->pattern_pinned_active = false;
+}
 void wavefront_sequences_init_allocate(
     wavefront_sequences_t* const wf_sequences,
     const int pattern_length,
@@ -99,44 +123,34 @@ void wavefront_sequences_init_copy(
   // Add end padding
   buffer_dst[sequence_length] = padding_value;
 }
-void wavefront_sequences_init_decode2bits(
-    char* const buffer_dst,
+void wavefront_sequences_init_copy_packed2bits(
+    uint8_t* const buffer_dst,
     const uint8_t* const sequence,
     const int sequence_length,
-    const int padding_length,
-    const char padding_value,
     const bool reverse) {
-  // Parameters
-  const char dna_packed2bits_decode[4] = {'A','C','G','T'};
   // Compute dimensions
-  const int num_words = DIV_CEIL(sequence_length,8);
-  int buffer_pos = (reverse) ? sequence_length-1 : 0;
-  // Decode and copy sequence
-  int word_num;
-  for (word_num=0;word_num<num_words;++word_num) {
-    // Fetch next word
-    const uint8_t word = sequence[word_num];
-    // Decode 4 letters packed
-    const char letter0 = dna_packed2bits_decode[(word    & 3)];
-    const char letter1 = dna_packed2bits_decode[(word>>2 & 3)];
-    const char letter2 = dna_packed2bits_decode[(word>>4 & 3)];
-    const char letter3 = dna_packed2bits_decode[(word>>6 & 3)];
-    if (reverse) {
-      buffer_dst[buffer_pos  ] = letter0;
-      buffer_dst[buffer_pos-1] = letter1;
-      buffer_dst[buffer_pos-2] = letter2;
-      buffer_dst[buffer_pos-3] = letter3;
-      buffer_pos -= 4;
-    } else {
-      buffer_dst[buffer_pos  ] = letter0;
-      buffer_dst[buffer_pos+1] = letter1;
-      buffer_dst[buffer_pos+2] = letter2;
-      buffer_dst[buffer_pos+3] = letter3;
-      buffer_pos += 4;
+  const int num_bytes = DIV_CEIL(sequence_length,4);
+  // Copy sequence (keeping the 2-bits encoding)
+  if (reverse) {
+    // Reverse bytes (and the 4 bases within each byte)
+    int i;
+    for (i=0;i<num_bytes;++i) {
+      uint8_t byte = sequence[num_bytes-1-i];
+      byte = (uint8_t)((byte >> 4) | (byte << 4));
+      byte = (uint8_t)(((byte >> 2) & 0x33) | ((byte & 0x33) << 2));
+      buffer_dst[i] = byte;
+    }
+    // Shift out the unused bases of the last source byte
+    const int shift = 2*(4*num_bytes - sequence_length);
+    if (shift > 0) {
+      for (i=0;i<num_bytes-1;++i) {
+        buffer_dst[i] = (uint8_t)((buffer_dst[i] >> shift) | (buffer_dst[i+1] << (8-shift)));
+      }
+      buffer_dst[num_bytes-1] >>= shift;
     }
+  } else {
+    memcpy(buffer_dst,sequence,num_bytes);
   }
-  // Add end padding
-  buffer_dst[sequence_length] = padding_value;
 }
 void wavefront_sequences_init_ascii(
     wavefront_sequences_t* const wf_sequences,
@@ -145,6 +159,8 @@ void wavefront_sequences_init_ascii(
     const char* const text,
     const int text_length,
     const bool reverse) {
+  // Restore pinned pattern
+  wavefront_sequences_restore_pinned(wf_sequences);
   // Mode
   wf_sequences->mode = wf_sequences_ascii;
   wf_sequences->reverse = reverse;
@@ -175,6 +191,8 @@ void wavefront_sequences_init_lambda(
     const int pattern_length,
     const int text_length,
     const bool reverse) {
+  // Restore pinned pattern
+  wavefront_sequences_restore_pinned(wf_sequences);
   // Mode
   wf_sequences->mode = wf_sequences_lambda;
   wf_sequences->reverse = reverse;
@@ -196,29 +214,199 @@ void wavefront_sequences_init_packed2bits(
     const uint8_t* const text,
     const int text_length,
     const bool reverse) {
+  // Restore pinned pattern
+  wavefront_sequences_restore_pinned(wf_sequences);
   // Mode
-  wf_sequences->mode = wf_sequences_ascii;
+  wf_sequences->mode = wf_sequences_packed2bits;
   wf_sequences->reverse = reverse;
-  // Allocate buffers
-  wavefront_sequences_init_allocate(wf_sequences,pattern_length,text_length);
-  // Copy internal sequences
-  wavefront_sequences_init_decode2bits(wf_sequences->pattern_buffer,
-      pattern,pattern_length,WF_SEQUENCES_PADDING,WF_SEQUENCES_PATTERN_EOS,reverse);
+  // Allocate buffers (whole 64-bits words, so that both sequences are word-aligned)
+  const int pattern_num_bytes = DIV_CEIL(pattern_length,32)*8;
+  const int text_num_bytes = DIV_CEIL(text_length,32)*8;
+  wavefront_sequences_init_allocate(wf_sequences,pattern_num_bytes,text_num_bytes);
+  wf_sequences->pattern_packed = (uint8_t*)wf_sequences->pattern_buffer;
+  wf_sequences->text_packed = (uint8_t*)wf_sequences->text_buffer;
+  wf_sequences->pattern_buffer = NULL;
+  wf_sequences->text_buffer = NULL;
+  // Copy internal sequences (packed)
+  wavefront_sequences_init_copy_packed2bits(wf_sequences->pattern_packed,pattern,pattern_length,reverse);
   wf_sequences->pattern_buffer_length = pattern_length;
-  wavefront_sequences_init_decode2bits(wf_sequences->text_buffer,
-      text,text_length,WF_SEQUENCES_PADDING,WF_SEQUENCES_TEXT_EOS,reverse);
+  wavefront_sequences_init_copy_packed2bits(wf_sequences->text_packed,text,text_length,reverse);
   wf_sequences->text_buffer_length = text_length;
   // Set pattern
-  wf_sequences->pattern = wf_sequences->pattern_buffer;
+  wf_sequences->pattern = NULL;
   wf_sequences->pattern_begin = 0;
   wf_sequences->pattern_length = pattern_length;
-  wf_sequences->pattern_eos = wf_sequences->pattern[pattern_length];
+  wf_sequences->pattern_packed_offset = 0;
+  // Set text
+  wf_sequences->text = NULL;
+  wf_sequences->text_begin = 0;
+  wf_sequences->text_length = text_length;
+  wf_sequences->text_packed_offset = 0;
+}
+void wavefront_sequences_init_shared(
+    wavefront_sequences_t* const wf_sequences,
+    const wavefront_sequences_t* const wf_sequences_src) {
+  // Restore pinned pattern
+  wavefront_sequences_restore_pinned(wf_sequences);
+  // Mode
+  wf_sequences->mode = wf_sequences_src->mode;
+  wf_sequences->reverse = wf_sequences_src->reverse;
+  // Share the source sequences (never written; no EOS in these modes)
+  wf_sequences->pattern = NULL;
+  wf_sequences->text = NULL;
+  wf_sequences->match_funct = wf_sequences_src->match_funct;
+  wf_sequences->match_funct_arguments = wf_sequences_src->match_funct_arguments;
+  wf_sequences->pattern_packed = wf_sequences_src->pattern_packed;
+  wf_sequences->text_packed = wf_sequences_src->text_packed;
+  wf_sequences->pattern_packed_offset = wf_sequences_src->pattern_packed_offset;
+  wf_sequences->text_packed_offset = wf_sequences_src->text_packed_offset;
+  wf_sequences->pattern_buffer_length = wf_sequences_src->pattern_buffer_length;
+  wf_sequences->text_buffer_length = wf_sequences_src->text_buffer_length;
+  // Set bounds
+  wf_sequences->pattern_begin = wf_sequences_src->pattern_begin;
+  wf_sequences->pattern_length = wf_sequences_src->pattern_length;
+  wf_sequences->text_begin = wf_sequences_src->text_begin;
+  wf_sequences->text_length = wf_sequences_src->text_length;
+}
+/*
+ * Append (incremental alignment)
+ */
+void wavefront_sequences_append(
+    wavefront_sequences_t* const wf_sequences,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length) {
+  // Parameters
+  const int pattern_length_old = wf_sequences->pattern_length;
+  const int text_length_old = wf_sequences->text_length;
+  const int pattern_length_new = pattern_length_old + pattern_length;
+  const int text_length_new = text_length_old + text_length;
+  // Check capacity (pattern buffer ends where the text padding begins)
+  const int pattern_capacity = (wf_sequences->text_buffer - WF_SEQUENCES_PADDING) - wf_sequences->pattern_buffer;
+  const int text_capacity = (wf_sequences->seq_buffer + wf_sequences->seq_buffer_allocated - WF_SEQUENCES_PADDING) - wf_sequences->text_buffer;
+  if (pattern_length_new > pattern_capacity || text_length_new > text_capacity) {
+    // Allocate (geometric growth, amortized over the chunks)
+    const int pattern_capacity_new = MAX(pattern_capacity,2*pattern_length_new);
+    const int text_capacity_new = MAX(text_capacity,2*text_length_new);
+    const int buffer_size = pattern_capacity_new + text_capacity_new + 3*WF_SEQUENCES_PADDING;
+    char* const seq_buffer = calloc(buffer_size,1);
+    char* const pattern_buffer = seq_buffer + WF_SEQUENCES_PADDING;
+    char* const text_buffer = pattern_buffer + pattern_capacity_new + WF_SEQUENCES_PADDING;
+    // Copy sequences aligned so far
+    memcpy(pattern_buffer,wf_sequences->pattern_buffer,pattern_length_old);
+    memcpy(text_buffer,wf_sequences->text_buffer,text_length_old);
+    free(wf_sequences->seq_buffer);
+    wf_sequences->seq_buffer = seq_buffer;
+    wf_sequences->seq_buffer_allocated = buffer_size;
+    wf_sequences->pattern_buffer = pattern_buffer;
+    wf_sequences->text_buffer = text_buffer;
+  }
+  // Append chunks (and move the EOS)
+  wavefront_sequences_init_copy(wf_sequences->pattern_buffer+pattern_length_old,
+      pattern,pattern_length,WF_SEQUENCES_PADDING,WF_SEQUENCES_PATTERN_EOS,false);
+  wavefront_sequences_init_copy(wf_sequences->text_buffer+text_length_old,
+      text,text_length,WF_SEQUENCES_PADDING,WF_SEQUENCES_TEXT_EOS,false);
+  wf_sequences->pattern_buffer_length = pattern_length_new;
+  wf_sequences->text_buffer_length = text_length_new;
+  // Set sequences
+  wf_sequences->pattern = wf_sequences->pattern_buffer;
+  wf_sequences->pattern_length = pattern_length_new;
+  wf_sequences->pattern_eos = wf_sequences->pattern[pattern_length_new];
+  wf_sequences->text = wf_sequences->text_buffer;
+  wf_sequences->text_length = text_length_new;
+  wf_sequences->text_eos = wf_sequences->text[text_length_new];
+}
+/*
+ * Pinned pattern
+ */
+void wavefront_sequences_pin_pattern(
+    wavefront_sequences_t* const wf_sequences,
+    const char* const pattern,
+    const int pattern_length,
+    const bool reverse) {
+  // Restore pinned pattern
+  wavefront_sequences_restore_pinned(wf_sequences);
+  // Allocate pinned buffer
+  const int buffer_size = pattern_length + 2*WF_SEQUENCES_PADDING;
+  if (wf_sequences->pattern_pinned_allocated < buffer_size) {
+    if (wf_sequences->pattern_pinned_mem != NULL) free(wf_sequences->pattern_pinned_mem);
+    wf_sequences->pattern_pinned_mem = calloc(buffer_size,1);
+    wf_sequences->pattern_pinned_allocated = buffer_size;
+  }
+  wf_sequences->pattern_pinned_buffer = wf_sequences->pattern_pinned_mem + WF_SEQUENCES_PADDING;
+  // Copy pattern (padded and oriented, once)
+  wavefront_sequences_init_copy(wf_sequences->pattern_pinned_buffer,
+      pattern,pattern_length,WF_SEQUENCES_PADDING,WF_SEQUENCES_PATTERN_EOS,reverse);
+  wf_sequences->pattern_pinned_length = pattern_length;
+  wf_sequences->pattern_pinned_reverse = reverse;
+  wf_sequences->pattern_pinned = true;
+}
+void wavefront_sequences_unpin_pattern(
+    wavefront_sequences_t* const wf_sequences) {
+  wavefront_sequences_restore_pinned(wf_sequences);
+  wf_sequences->pattern_pinned = false;
+}
+void wavefront_sequences_init_pinned(
+    wavefront_sequences_t* const wf_sequences) {
+  // Mode
+  wf_sequences->mode = wf_sequences_ascii;
+  wf_sequences->reverse = wf_sequences->pattern_pinned_reverse;
+  // Set pattern (pinned)
+  wf_sequences->pattern_buffer = wf_sequences->pattern_pinned_buffer;
+  wf_sequences->pattern_buffer_length = wf_sequences->pattern_pinned_length;
+  wf_sequences->pattern = wf_sequences->pattern_buffer;
+  wf_sequences->pattern_begin = 0;
+  wf_sequences->pattern_length = wf_sequences->pattern_pinned_length;
+  wf_sequences->pattern_eos = wf_sequences->pattern[wf_sequences->pattern_length];
+  wf_sequences->pattern_pinned_active = true;
+}
+void wavefront_sequences_init_text(
+    wavefront_sequences_t* const wf_sequences,
+    const char* const text,
+    const int text_length) {
+  // Restore pinned pattern
+  wavefront_sequences_restore_pinned(wf_sequences);
+  // Allocate buffers (text only) & set pinned pattern
+  wavefront_sequences_init_allocate(wf_sequences,0,text_length);
+  wavefront_sequences_init_pinned(wf_sequences);
+  // Copy internal text
+  wavefront_sequences_init_copy(wf_sequences->text_buffer,
+      text,text_length,WF_SEQUENCES_PADDING,WF_SEQUENCES_TEXT_EOS,wf_sequences->reverse);
+  wf_sequences->text_buffer_length = text_length;
   // Set text
   wf_sequences->text = wf_sequences->text_buffer;
   wf_sequences->text_begin = 0;
   wf_sequences->text_length = text_length;
   wf_sequences->text_eos = wf_sequences->text[text_length];
 }
+bool wavefront_sequences_init_text_slice(
+    wavefront_sequences_t* const wf_sequences,
+    const char* const reference,
+    const int reference_length,
+    const int text_begin,
+    const int text_end) {
+  // Check slice (forward only, and followed by enough reference to pad it)
+  if (wf_sequences->pattern_pinned_reverse) return false;
+  if (text_end + WF_SEQUENCES_PADDING > reference_length) return false;
+  // Restore pinned pattern & set it
+  wavefront_sequences_restore_pinned(wf_sequences);
+  wavefront_sequences_init_pinned(wf_sequences);
+  // Set text (zero-copy and read-only; no EOS, kernels check the text bound)
+  const int text_length = text_end - text_begin;
+  wf_sequences->text_buffer = (char*)reference + text_begin;
+  wf_sequences->text_buffer_length = text_length;
+  wf_sequences->text = wf_sequences->text_buffer;
+  wf_sequences->text_begin = 0;
+  wf_sequences->text_length = text_length;
+  wf_sequences->text_eos = WF_SEQUENCES_TEXT_EOS;
+  wf_sequences->text_slice = true;
+  return true;
+}
+void wavefront_sequences_release_text_slice(
+    wavefront_sequences_t* const wf_sequences) {
+  wf_sequences->text_slice = false;
+}
 /*
  * Accessors
  */
@@ -245,7 +433,18 @@ bool wavefront_sequences_cmp(
     } else {
       return match_funct(pattern_begin+pattern_pos,text_begin+text_pos,match_funct_arguments);
     }
+  } else if (wf_sequences->mode == wf_sequences_packed2bits) {
+    // Check coordinates (EOS)
+    if (pattern_pos >= wf_sequences->pattern_length ||
+        text_pos >= wf_sequences->text_length) return false;
+    // Compare packed bases
+    const int pattern_packed_pos = wf_sequences->pattern_packed_offset + pattern_pos;
+    const int text_packed_pos = wf_sequences->text_packed_offset + text_pos;
+    return WF_PACKED2BITS_GET(wf_sequences->pattern_packed,pattern_packed_pos) ==
+           WF_PACKED2BITS_GET(wf_sequences->text_packed,text_packed_pos);
   } else {
+    // Check coordinates (text slices have no EOS)
+    if (wf_sequences->text_slice && text_pos >= wf_sequences->text_length) return false;
     // Compare regular strings
     return wf_sequences->pattern[pattern_pos] == wf_sequences->text[text_pos];
   }
@@ -255,6 +454,10 @@ char wavefront_sequences_get_pattern(
     const int position) {
   if (wf_sequences->mode == wf_sequences_lambda) {
     return '-';
+  } else if (wf_sequences->mode == wf_sequences_packed2bits) {
+    if (position >= wf_sequences->pattern_length) return WF_SEQUENCES_PATTERN_EOS;
+    const int packed_pos = wf_sequences->pattern_packed_offset + position;
+    return dna_packed2bits_decode[WF_PACKED2BITS_GET(wf_sequences->pattern_packed,packed_pos)];
   } else {
     return wf_sequences->pattern[position];
   }
@@ -264,7 +467,12 @@ char wavefront_sequences_get_text(
     const int position) {
   if (wf_sequences->mode == wf_sequences_lambda) {
     return '-';
+  } else if (wf_sequences->mode == wf_sequences_packed2bits) {
+    if (position >= wf_sequences->text_length) return WF_SEQUENCES_TEXT_EOS;
+    const int packed_pos = wf_sequences->text_packed_offset + position;
+    return dna_packed2bits_decode[WF_PACKED2BITS_GET(wf_sequences->text_packed,packed_pos)];
   } else {
+    if (wf_sequences->text_slice && position >= wf_sequences->text_length) return WF_SEQUENCES_TEXT_EOS;
     return wf_sequences->text[position];
   }
 }
@@ -278,7 +486,16 @@ void wavefront_sequences_set_bounds(
     const int text_begin,
     const int text_end) {
   // Select mode
-  if (wf_sequences->mode != wf_sequences_lambda) {
+  if (wf_sequences->mode == wf_sequences_packed2bits) {
+    // Focus on the new section of the sequences (no EOS needed; kernels check bounds)
+    if (wf_sequences->reverse) {
+      wf_sequences->pattern_packed_offset = wf_sequences->pattern_buffer_length - pattern_end;
+      wf_sequences->text_packed_offset = wf_sequences->text_buffer_length - text_end;
+    } else {
+      wf_sequences->pattern_packed_offset = pattern_begin;
+      wf_sequences->text_packed_offset = text_begin;
+    }
+  } else if (wf_sequences->mode != wf_sequences_lambda) {
     // Restore previous EOS char
     const int pattern_length_old = wf_sequences->pattern_length;
     const int text_length_old = wf_sequences->text_length;
@@ -54,6 +54,12 @@
  */
 typedef int (*alignment_match_funct_t)(int,int,void*);
 
+/*
+ * 2-bits packed sequences (4 bases per byte, first base in the lowest bits)
+ */
+#define WF_PACKED2BITS_GET(sequence,position) \
+  (((sequence)[(position)>>2] >> (((position)&3)<<1)) & 3)
+
 /*
  * Wavefront Sequences
  */
@@ -76,6 +82,11 @@ typedef struct {
   // Lambda Sequence
   alignment_match_funct_t match_funct;   // Custom matching function (match(v,h,args))
   void* match_funct_arguments;           // Generic arguments passed to matching function (args)
+  // Packed2bits Sequence
+  uint8_t* pattern_packed;               // Source pattern sequence (2-bits packed, padded)
+  uint8_t* text_packed;                  // Source text sequence (2-bits packed, padded)
+  int pattern_packed_offset;             // Current pattern begin within the packed sequence
+  int text_packed_offset;                // Current text begin within the packed sequence
   // Internal buffers (ASCII encoded)
   char* seq_buffer;                      // Internal buffer
   int seq_buffer_allocated;              // Internal buffer allocated
@@ -85,6 +96,16 @@ typedef struct {
   int text_buffer_length;                // Source text length
   char pattern_eos;                      // Source pattern char at EOS
   char text_eos;                         // Source pattern char at EOS
+  // Pinned pattern (prepared once, aligned against many texts)
+  bool pattern_pinned;                   // Pattern pinned
+  bool pattern_pinned_reverse;           // Pinned pattern reversed
+  bool pattern_pinned_active;            // Current pattern points into the pinned buffer
+  char* pattern_pinned_mem;              // Pinned buffer
+  int pattern_pinned_allocated;          // Pinned buffer allocated
+  char* pattern_pinned_buffer;           // Pinned pattern (padded and oriented)
+  int pattern_pinned_length;             // Pinned pattern length
+  // Text slice (zero-copy window of an external reference)
+  bool text_slice;                       // Text points into an external reference (read-only; no EOS)
 } wavefront_sequences_t;
 
 /*
@@ -119,6 +140,42 @@ void wavefront_sequences_init_packed2bits(
     const uint8_t* const text,
     const int text_length,
     const bool reverse);
+void wavefront_sequences_init_shared(
+    wavefront_sequences_t* const wf_sequences,
+    const wavefront_sequences_t* const wf_sequences_src);
+
+/*
+ * Append (incremental alignment)
+ */
+void wavefront_sequences_append(
+    wavefront_sequences_t* const wf_sequences,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length);
+
+/*
+ * Pinned pattern
+ */
+void wavefront_sequences_pin_pattern(
+    wavefront_sequences_t* const wf_sequences,
+    const char* const pattern,
+    const int pattern_length,
+    const bool reverse);
+void wavefront_sequences_unpin_pattern(
+    wavefront_sequences_t* const wf_sequences);
+void wavefront_sequences_init_text(
+    wavefront_sequences_t* const wf_sequences,
+    const char* const text,
+    const int text_length);
+bool wavefront_sequences_init_text_slice(
+    wavefront_sequences_t* const wf_sequences,
+    const char* const reference,
+    const int reference_length,
+    const int text_begin,
+    const int text_end);
+void wavefront_sequences_release_text_slice(
+    wavefront_sequences_t* const wf_sequences);
 
 
 /*
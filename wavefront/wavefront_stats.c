@@ -0,0 +1,139 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignment Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignment Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignment Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: WaveFront-Alignment per-alignment statistics
+ */
+
+#include "utils/commons.h"
+#include "system/profiler_timer.h"
+#include "wavefront_stats.h"
+
+/*
+ * Setup
+ */
+void wavefront_stats_clear(
+    wavefront_aligner_stats_t* const stats) {
+  memset(stats,0,sizeof(wavefront_aligner_stats_t));
+}
+void wavefront_stats_add(
+    wavefront_aligner_stats_t* const stats,
+    const wavefront_aligner_stats_t* const stats_src) {
+  // Steps
+  stats->num_steps += stats_src->num_steps;
+  stats->num_diagonals += stats_src->num_diagonals;
+  stats->num_extend_chars += stats_src->num_extend_chars;
+  stats->extend_fused_bytes += stats_src->extend_fused_bytes;
+  // Memory
+  stats->memory_slab += stats_src->memory_slab;
+  stats->memory_mm += stats_src->memory_mm;
+  stats->memory_peak = MAX(stats->memory_peak,stats_src->memory_peak);
+  // BT-Buffer
+  stats->num_compactions += stats_src->num_compactions;
+  // Heuristics
+  stats->num_heuristic_cutoffs += stats_src->num_heuristic_cutoffs;
+  stats->num_heuristic_pruned += stats_src->num_heuristic_pruned;
+  stats->num_heuristic_drops += stats_src->num_heuristic_drops;
+  // BiWFA
+  stats->bialign_breakpoints += stats_src->bialign_breakpoints;
+  stats->bialign_max_depth = MAX(stats->bialign_max_depth,stats_src->bialign_max_depth);
+  // Time
+  stats->time_compute_ns += stats_src->time_compute_ns;
+  stats->time_extend_ns += stats_src->time_extend_ns;
+  stats->time_backtrace_ns += stats_src->time_backtrace_ns;
+  stats->time_compact_ns += stats_src->time_compact_ns;
+}
+/*
+ * Collect
+ */
+uint64_t wavefront_stats_get_time_ns(void) {
+  struct timespec time;
+  timer_get_system_time(&time);
+  return (uint64_t)time.tv_sec*1000000000ull + (uint64_t)time.tv_nsec;
+}
+void wavefront_stats_add_compute(
+    wavefront_aligner_stats_t* const stats,
+    const uint64_t time_begin_ns,
+    const int lo,
+    const int hi) {
+  ++(stats->num_steps);
+  stats->num_diagonals += (hi >= lo) ? (uint64_t)(hi-lo+1) : 0;
+  stats->time_compute_ns += wavefront_stats_get_time_ns() - time_begin_ns;
+}
+void wavefront_stats_add_extend(
+    wavefront_aligner_stats_t* const stats,
+    const uint64_t time_begin_ns) {
+  stats->time_extend_ns += wavefront_stats_get_time_ns() - time_begin_ns;
+}
+uint64_t wavefront_stats_extend_sum(
+    const wf_offset_t* const offsets,
+    const int lo,
+    const int hi) {
+  uint64_t offsets_sum = 0;
+  int k;
+  for (k=lo;k<=hi;++k) {
+    if (offsets[k] >= 0) offsets_sum += offsets[k];
+  }
+  return offsets_sum;
+}
+void wavefront_stats_add_extend_chars(
+    wavefront_aligner_stats_t* const stats,
+    const wf_offset_t* const offsets,
+    const int lo,
+    const int hi,
+    const uint64_t offsets_sum_begin) {
+  // Matches extended plus the mismatch stopping each diagonal
+  uint64_t offsets_sum = 0, num_diagonals = 0;
+  int k;
+  for (k=lo;k<=hi;++k) {
+    if (offsets[k] >= 0) { offsets_sum += offsets[k]; ++num_diagonals; }
+  }
+  // Add (the extend can run on several threads)
+  __atomic_fetch_add(&stats->num_extend_chars,
+      (offsets_sum - offsets_sum_begin) + num_diagonals,__ATOMIC_RELAXED);
+}
+/*
+ * Display
+ */
+void wavefront_stats_print(
+    FILE* const stream,
+    const wavefront_aligner_stats_t* const stats) {
+  fprintf(stream,"[WFA::Stats] Steps %"PRIu64" (%"PRIu64" diagonals, %"PRIu64" chars extended, %"PRIu64" KB fused)\n",
+      stats->num_steps,stats->num_diagonals,stats->num_extend_chars,
+      CONVERT_B_TO_KB(stats->extend_fused_bytes));
+  fprintf(stream,"[WFA::Stats] Memory slab=%"PRIu64" MB, mm=%"PRIu64" MB, peak=%"PRIu64" MB\n",
+      CONVERT_B_TO_MB(stats->memory_slab),CONVERT_B_TO_MB(stats->memory_mm),
+      CONVERT_B_TO_MB(stats->memory_peak));
+  fprintf(stream,"[WFA::Stats] BT-Buffer %"PRIu64" compactions\n",stats->num_compactions);
+  fprintf(stream,"[WFA::Stats] Heuristic %"PRIu64" cutoffs (%"PRIu64" diagonals pruned, %"PRIu64" drops)\n",
+      stats->num_heuristic_cutoffs,stats->num_heuristic_pruned,stats->num_heuristic_drops);
+  fprintf(stream,"[WFA::Stats] BiWFA %"PRIu64" breakpoints (max.depth %d)\n",
+      stats->bialign_breakpoints,stats->bialign_max_depth);
+  fprintf(stream,"[WFA::Stats] Time compute=%.2f ms, extend=%.2f ms, backtrace=%.2f ms, compact=%.2f ms\n",
+      TIMER_CONVERT_NS_TO_MS(stats->time_compute_ns),TIMER_CONVERT_NS_TO_MS(stats->time_extend_ns),
+      TIMER_CONVERT_NS_TO_MS(stats->time_backtrace_ns),TIMER_CONVERT_NS_TO_MS(stats->time_compact_ns));
+}
@@ -0,0 +1,106 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignment Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignment Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignment Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: WaveFront-Alignment per-alignment statistics
+ */
+
+#ifndef WAVEFRONT_STATS_H_
+#define WAVEFRONT_STATS_H_
+
+#include "utils/commons.h"
+#include "wavefront_offset.h"
+
+/*
+ * Alignment Stats (collected only if system.stats_enabled)
+ */
+typedef struct {
+  // Steps
+  uint64_t num_steps;               // Score steps computed (non-null)
+  uint64_t num_diagonals;           // Diagonals computed (M-wavefront, all steps)
+  uint64_t num_extend_chars;        // Characters compared by the extend (matches + mismatch per diagonal)
+  uint64_t extend_fused_bytes;      // M-wavefront bytes not re-streamed by the extend pass (fused compute & extend)
+  // Memory
+  uint64_t memory_slab;             // Wavefront-slab bytes allocated (all sub-aligners, end of alignment)
+  uint64_t memory_mm;               // MM-allocator bytes in use (end of alignment)
+  uint64_t memory_peak;             // Peak memory used (sampled at each memory probe)
+  // BT-Buffer
+  uint64_t num_compactions;         // BT-buffer compactions
+  // Heuristics
+  uint64_t num_heuristic_cutoffs;   // Steps whose wavefronts were pruned by the heuristic
+  uint64_t num_heuristic_pruned;    // Diagonals pruned by the heuristic
+  uint64_t num_heuristic_drops;     // Alignments dropped by the heuristic (Z-drop)
+  // BiWFA
+  uint64_t bialign_breakpoints;     // Breakpoints found
+  int bialign_max_depth;            // Maximum recursion depth reached
+  // Time
+  uint64_t time_compute_ns;         // Compute (including the fused extension, if enabled)
+  uint64_t time_extend_ns;          // Extend
+  uint64_t time_backtrace_ns;       // Backtrace (CIGAR recovery)
+  uint64_t time_compact_ns;         // BT-buffer compaction pauses
+} wavefront_aligner_stats_t;
+
+/*
+ * Setup
+ */
+void wavefront_stats_clear(
+    wavefront_aligner_stats_t* const stats);
+void wavefront_stats_add(
+    wavefront_aligner_stats_t* const stats,
+    const wavefront_aligner_stats_t* const stats_src);
+
+/*
+ * Collect
+ */
+uint64_t wavefront_stats_get_time_ns(void);
+void wavefront_stats_add_compute(
+    wavefront_aligner_stats_t* const stats,
+    const uint64_t time_begin_ns,
+    const int lo,
+    const int hi);
+void wavefront_stats_add_extend(
+    wavefront_aligner_stats_t* const stats,
+    const uint64_t time_begin_ns);
+uint64_t wavefront_stats_extend_sum(
+    const wf_offset_t* const offsets,
+    const int lo,
+    const int hi);
+void wavefront_stats_add_extend_chars(
+    wavefront_aligner_stats_t* const stats,
+    const wf_offset_t* const offsets,
+    const int lo,
+    const int hi,
+    const uint64_t offsets_sum_begin);
+
+/*
+ * Display
+ */
+void wavefront_stats_print(
+    FILE* const stream,
+    const wavefront_aligner_stats_t* const stats);
+
+#endif /* WAVEFRONT_STATS_H_ */
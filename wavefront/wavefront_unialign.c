@@ -89,6 +89,9 @@ void wavefront_unialign_init(
   wf_aligner->component_begin = component_begin;
   wf_aligner->component_end = component_end;
   wavefront_aligner_init(wf_aligner,0);
+  // Fuse compute & extend (end-to-end only; plots sample the non-extended wavefronts)
+  align_status->extend_fused =
+      wf_aligner->system.extend_fused && end2end && wf_aligner->plot == NULL;
   // Clear cigar
   cigar_clear(wf_aligner->cigar);
 }
@@ -118,13 +121,28 @@ bool wavefront_unialign_reached_limits(
     // Check BT-buffer memory
     if (bt_memory > system->max_memory_compact) {
       // Compact BT-buffer
-      wavefront_components_compact_bt_buffer(wf_components,score,wf_aligner->system.verbose);
+      const uint64_t stats_begin_ns = (system->stats_enabled) ? wavefront_stats_get_time_ns() : 0;
+      timer_start(&system->timer_compact);
+      wavefront_components_compact_bt_buffer(wf_components,score,system->max_num_threads,system->verbose);
+      timer_stop(&system->timer_compact);
+      if (system->stats_enabled) {
+        wf_aligner->stats.num_compactions++;
+        wf_aligner->stats.time_compact_ns += wavefront_stats_get_time_ns() - stats_begin_ns;
+      }
       // Set new buffer limit
       bt_memory = wf_backtrace_buffer_get_size_used(wf_components->bt_buffer);
       uint64_t proposed_mem = (double)bt_memory * TELESCOPIC_FACTOR;
       if (system->max_memory_compact < proposed_mem && proposed_mem < system->max_memory_abort) {
         proposed_mem = system->max_memory_compact;
       }
+      // Spill cold segments (if the resident BT-buffer is still over budget) or compress them
+      if (system->bt_spill_path != NULL) {
+        if (wf_backtrace_buffer_get_size_allocated(wf_components->bt_buffer) > system->max_memory_compact) {
+          wf_backtrace_buffer_spill_cold(wf_components->bt_buffer,system->bt_spill_path,system->verbose);
+        }
+      } else if (system->bt_compress) {
+        wf_backtrace_buffer_compress_cold(wf_components->bt_buffer,system->verbose);
+      }
       // Reset (if maximum compacts has been performed)
       if (wf_components->bt_buffer->num_compactions >= system->max_partial_compacts) {
         wf_backtrace_buffer_reset_compaction(wf_components->bt_buffer);
@@ -133,6 +151,9 @@ bool wavefront_unialign_reached_limits(
   }
   // Check overall memory used
   const uint64_t wf_memory_used = wavefront_aligner_get_size(wf_aligner);
+  if (system->stats_enabled) {
+    wf_aligner->stats.memory_peak = MAX(wf_aligner->stats.memory_peak,wf_memory_used);
+  }
   if (wf_memory_used > system->max_memory_abort) {
     wf_aligner->align_status.status = WF_STATUS_OOM;
     wf_aligner->align_status.score = score;
@@ -176,6 +197,8 @@ void wavefront_unialign_terminate(
     wavefront_components_t* const wf_components = &wf_aligner->wf_components;
     const int alignment_end_k = wf_aligner->alignment_end_pos.k;
     const wf_offset_t alignment_end_offset = wf_aligner->alignment_end_pos.offset;
+    const bool stats_enabled = wf_aligner->system.stats_enabled;
+    const uint64_t stats_begin_ns = (stats_enabled) ? wavefront_stats_get_time_ns() : 0;
     if (alignment_end_offset != WAVEFRONT_OFFSET_NULL) {
       if (wf_components->bt_piggyback) {
         // Fetch wavefront
@@ -200,6 +223,7 @@ void wavefront_unialign_terminate(
         }
       }
     }
+    if (stats_enabled) wf_aligner->stats.time_backtrace_ns += wavefront_stats_get_time_ns() - stats_begin_ns;
     /*
      * Post-processing (Extension-Trim, Score, and Ends)
      *
@@ -235,6 +259,21 @@ void wavefront_unialign_terminate(
     }
   }
 }
+/*
+ * Incremental alignment (end reached)
+ */
+bool wavefront_unialign_end_final(
+    wavefront_aligner_t* const wf_aligner) {
+  // Parameters
+  wavefront_align_status_t* const align_status = &wf_aligner->align_status;
+  wavefront_sequences_t* const sequences = &wf_aligner->sequences;
+  const int k = wf_aligner->alignment_end_pos.k;
+  const int offset = wf_aligner->alignment_end_pos.offset;
+  // The end is final only if it lies at the end of a complete sequence
+  if (align_status->text_complete && WAVEFRONT_H(k,offset) >= sequences->text_length) return true;
+  if (align_status->pattern_complete && WAVEFRONT_V(k,offset) >= sequences->pattern_length) return true;
+  return false;
+}
 /*
  * Classic WF-Alignment (Unidirectional)
  */
@@ -253,14 +292,25 @@ int wavefront_unialign(
     const int finished = (*wf_align_extend)(wf_aligner,score);
     if (finished) {
       // WFA_UNIALIGN_DEBUG(); // DEBUG
+      if (align_status->status == WF_STATUS_END_REACHED &&
+          align_status->incremental && !wavefront_unialign_end_final(wf_aligner)) {
+        align_status->status = WF_STATUS_SEQUENCE_EXHAUSTED; // Paused (re-extended when resumed)
+        return align_status->status;
+      }
       if (align_status->status == WF_STATUS_END_REACHED ||
           align_status->status == WF_STATUS_END_UNREACHABLE) {
         wavefront_unialign_terminate(wf_aligner,score);
       }
       return align_status->status;
     }
-    // Compute (s+1)-wavefront
+    // Compute (s+1)-wavefront (unless beyond the maximum score)
     ++score;
+    if (score > wf_aligner->system.max_score) {
+      wf_aligner->cigar->score = -score;
+      align_status->status = WF_STATUS_MAX_SCORE_REACHED;
+      align_status->score = score;
+      return align_status->status;
+    }
     (*wf_align_compute)(wf_aligner,score);
     // Probe limits
     if (wavefront_unialign_reached_limits(wf_aligner,score)) return align_status->status;
@@ -38,6 +38,8 @@
 #include "wavefront_components.h"
 #include "wavefront_sequences.h"
 #include "wavefront_bialigner.h"
+#include "wavefront_dispatch.h"
+#include "wavefront_stats.h"
 
 /*
  * Error codes & messages
@@ -49,6 +51,10 @@
 #define WF_STATUS_MAX_STEPS_REACHED     -100  // Maximum number of WFA-steps reached
 #define WF_STATUS_OOM                   -200  // Maximum memory limit reached
 #define WF_STATUS_UNATTAINABLE          -300  // Alignment unattainable under configured heuristics
+#define WF_STATUS_MAX_SCORE_REACHED     -400  // No alignment within the maximum score
+#define WF_STATUS_FILTERED              -500  // Score lower-bound exceeds the maximum score (not aligned)
+#define WF_STATUS_SEQUENCE_EXHAUSTED    -600  // Incremental alignment paused (append more sequence to continue)
+#define WF_STATUS_SEQUENCE_TOO_LONG     -700  // Sequences exceed the offsets range (e.g., 16-bit offsets build)
 // [INTERNAL]
 #define WF_STATUS_OK                      -1  // Computing alignment (in progress)
 #define WF_STATUS_END_REACHED             -2  // Alignment end reached
@@ -68,6 +74,13 @@ typedef struct {
   bool dropped;                                                   // Heuristically dropped
   int num_null_steps;                                             // Total contiguous null-steps performed
   uint64_t memory_used;                                           // Total memory used
+  // Fused compute & extend
+  bool extend_fused;                                              // Extend M-wavefronts within the compute pass
+  int extend_fused_score;                                         // Last score whose M-wavefront was extended while computed
+  // Incremental alignment (sequences streamed in chunks)
+  bool incremental;                                               // Pause when reaching the end of an open sequence
+  bool pattern_complete;                                          // No more pattern will be appended
+  bool text_complete;                                             // No more text will be appended
   // Wavefront alignment functions
   void (*wf_align_compute)(wavefront_aligner_t* const,const int); // WF Compute function
   int (*wf_align_extend)(wavefront_aligner_t* const,const int);   // WF Extend function
@@ -105,6 +118,7 @@ typedef struct _wavefront_aligner_t {
   affine2p_matrix_type component_begin;       // Alignment begin component
   affine2p_matrix_type component_end;         // Alignment end component
   wavefront_pos_t alignment_end_pos;          // Alignment end position
+  wavefront_kernels_t kernels;                // Wavefront kernels (selected at runtime)
   // Bidirectional Alignment
   wavefront_bialigner_t* bialigner;           // BiWFA aligner
   // CIGAR
@@ -117,6 +131,8 @@ typedef struct _wavefront_aligner_t {
   wavefront_plot_t* plot;                     // Wavefront plot
   // System
   alignment_system_t system;                  // System related parameters
+  wavefront_aligner_stats_t stats;            // Stats of the last alignment (if system.stats_enabled)
+  int pool_id;                                // Identifier within its aligner-pool (-1 if not pooled)
 } wavefront_aligner_t;
 
 /*
@@ -182,6 +198,12 @@ void wavefront_aligner_set_heuristic_banded_adaptive(
 void wavefront_aligner_set_max_alignment_steps(
     wavefront_aligner_t* const wf_aligner,
     const int max_alignment_steps);
+void wavefront_aligner_set_max_score(
+    wavefront_aligner_t* const wf_aligner,
+    const int max_score);
+void wavefront_aligner_set_prefilter(
+    wavefront_aligner_t* const wf_aligner,
+    const wavefront_prefilter_t prefilter);
 void wavefront_aligner_set_max_memory(
     wavefront_aligner_t* const wf_aligner,
     const uint64_t max_memory_resident,
@@ -192,6 +214,21 @@ void wavefront_aligner_set_max_num_threads(
 void wavefront_aligner_set_min_offsets_per_thread(
     wavefront_aligner_t* const wf_aligner,
     const int min_offsets_per_thread);
+void wavefront_aligner_set_extend_fused(
+    wavefront_aligner_t* const wf_aligner,
+    const bool extend_fused);
+void wavefront_aligner_set_stats(
+    wavefront_aligner_t* const wf_aligner,
+    const bool stats_enabled);
+void wavefront_aligner_set_cigar_run_length(
+    wavefront_aligner_t* const wf_aligner,
+    const bool run_length);
+
+/*
+ * Stats
+ */
+wavefront_aligner_stats_t* wavefront_aligner_get_stats(
+    wavefront_aligner_t* const wf_aligner);
 
 /*
  * Wavefront Align